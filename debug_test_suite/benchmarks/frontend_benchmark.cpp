@@ -0,0 +1,711 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../../include/lexer/lexer.h"
+#include "../../include/scan_kernels/scan_kernels.h"
+#include "../../include/scoping/scoping.h"
+#include "../../include/utility/utility.h"
+#include "../../include/interner/interner.h"
+#include "../../include/context/context.h"
+#include "../../include/flat_ast/flat_ast.h"
+#include "../../include/thread_pool/thread_pool.h"
+#include "../../include/ast_cache/ast_cache.h"
+#include "../../include/passes/passes.h"
+
+#include <llvm/IR/Verifier.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <sys/resource.h>
+
+/**
+ * @par Every allocation made through `operator new` is counted, so each phase can report how many allocations it makes and how many bytes they total.
+ */
+namespace allocation_counter {
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> allocated_bytes{0};
+
+    inline void* counted_allocate(std::size_t size, std::size_t alignment) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        void* memory = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            memory = std::malloc(size == 0 ? 1 : size);
+        } else if (posix_memalign(&memory, alignment, size == 0 ? alignment : size) != 0) {
+            memory = nullptr;
+        }
+
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+}
+
+void* operator new(std::size_t size) { return allocation_counter::counted_allocate(size, 0); }
+void* operator new[](std::size_t size) { return allocation_counter::counted_allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocation_counter::counted_allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocation_counter::counted_allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+/**
+ * @par Synthetic `.pyrx` programs. Each generator appends one self contained unit (unit `i` only refers to names it or earlier units define), and `generate_corpus()` repeats it until the target size is reached, so every corpus makes it through semantic analysis and codegen.
+ * Parameters are declared and passed but never read, since codegen does not yet spill arguments to the stack before loading them.
+ */
+namespace corpus {
+
+    /**
+     * @par Thousands of small functions, each calling the one before it.
+     */
+    void function_unit(std::ostringstream& out, int i) {
+        out << "int global_" << i << " = " << (i * 37) % 1000 << ";\n";
+        out << "def int function_" << i << "(int first, int second) {\n";
+        out << "    int total = global_" << i << " * 3 + 7;\n";
+        if (i > 0) {
+            out << "    int previous = function_" << i - 1 << "(total, 2);\n";
+            out << "    total = total + previous;\n";
+        }
+        out << "    float scale = 1.5 * 2.25;\n";
+        out << "    char marker = 'f';\n";
+        out << "    return total;\n";
+        out << "}\n\n";
+    }
+
+    /**
+     * @par Long `else if` chains, followed by deeply nested `if`s.
+     */
+    void if_chain_unit(std::ostringstream& out, int i) {
+        const int chain_length = 32;
+        const int nesting_depth = 12;
+
+        out << "bool flag_" << i << " = false;\n";
+        out << "def int branches_" << i << "(int value) {\n";
+        out << "    int result = 0;\n";
+        out << "    bool ready = true;\n";
+        out << "    if (flag_" << i << ") {\n        result = 1;\n    }";
+        for (int branch = 2; branch <= chain_length; branch++) {
+            std::string condition = (branch % 2 == 0) ? "ready" : "flag_" + std::to_string(i);
+            out << " else if (" << condition << ") {\n";
+            out << "        result = " << branch << ";\n    }";
+        }
+        out << " else {\n        result = 99;\n    }\n";
+
+        for (int depth = 0; depth < nesting_depth; depth++) {
+            out << std::string(4 * (depth + 1), ' ') << "if (ready) {\n";
+        }
+        out << std::string(4 * (nesting_depth + 1), ' ') << "result = result + 1;\n";
+        for (int depth = nesting_depth - 1; depth >= 0; depth--) {
+            out << std::string(4 * (depth + 1), ' ') << "}\n";
+        }
+        out << "    return result;\n";
+        out << "}\n\n";
+    }
+
+    /**
+     * @par Writes a function whose body is one arithmetic expression of `operand_count` operands, mixing every arithmetic operator, followed by a shorter boolean expression using the comparison and logical operators.
+     */
+    void write_expression_function(std::ostringstream& out, int i, int operand_count) {
+        const char* operators[] = {" + ", " - ", " * ", " / ", " % "};
+
+        out << "def int expression_" << i << "() {\n";
+        out << "    int a = " << i % 89 + 1 << ";\n";
+        out << "    int b = 3;\n";
+        out << "    int value = a";
+        for (int operand = 1; operand < operand_count; operand++) {
+            out << operators[(operand + i) % 5];
+            out << ((operand % 3 == 0) ? "b" : std::to_string(operand % 97 + 1));
+            if (operand % 16 == 0) {
+                out << "\n        ";
+            }
+        }
+        out << ";\n";
+        out << "    bool in_range = value % 7 < b + 2 && !(a == b) || value >= -a && (a != 0 || b <= 1);\n";
+        out << "    return value;\n";
+        out << "}\n\n";
+    }
+
+    /**
+     * @par Expressions with hundreds of operands, mixing every operator and precedence level.
+     */
+    void binary_expression_unit(std::ostringstream& out, int i) {
+        write_expression_function(out, i, 256);
+    }
+
+    /**
+     * @par Single expressions of 10k operands each, which show whether expression parsing stays linear in the length of the expression.
+     */
+    void long_expression_unit(std::ostringstream& out, int i) {
+        write_expression_function(out, i, 10000);
+    }
+
+    /**
+     * @par Code that is mostly comments, with a small statement between the blocks.
+     */
+    void comment_unit(std::ostringstream& out, int i) {
+        out << "/*\n";
+        for (int line = 0; line < 6; line++) {
+            out << " * block comment line " << line << " for unit " << i << ", describing { braces }, \"quotes\" and // nested markers\n";
+        }
+        out << " */\n";
+        for (int line = 0; line < 4; line++) {
+            out << "// line comment " << line << " for unit " << i << " with an int, a def, and an if in it\n";
+        }
+        out << "int commented_" << i << " = " << i % 1000 << "; // trailing comment\n\n";
+    }
+
+    /**
+     * @par Functions nested 256 scopes deep, each scope binding its own variable and shadowing the function's `total`, with every statement reading names bound far further out. Shows whether variable lookup stays constant in the nesting depth.
+     */
+    void nested_scope_unit(std::ostringstream& out, int i) {
+        const int nesting_depth = 256;
+
+        out << "int outer_" << i << " = " << i % 1000 << ";\n";
+        out << "def int nested_" << i << "() {\n";
+        out << "    int total = outer_" << i << ";\n";
+        out << "    bool ready = true;\n";
+        for (int depth = 0; depth < nesting_depth; depth++) {
+            const std::string indent(4 * std::min(depth + 1, 8), ' '); // capped, so the corpus is not mostly indentation
+            out << indent << "if (ready) {\n";
+            out << indent << "    int level_" << depth << " = total + outer_" << i << ";\n";
+            out << indent << "    int total = level_" << depth << " - level_" << depth / 2 << ";\n";
+        }
+        for (int depth = nesting_depth - 1; depth >= 0; depth--) {
+            out << std::string(4 * std::min(depth + 1, 8), ' ') << "}\n";
+        }
+        out << "    return total;\n";
+        out << "}\n\n";
+    }
+
+    /**
+     * @par Every other shape, in turn.
+     */
+    void mixed_unit(std::ostringstream& out, int i) {
+        switch (i % 4) {
+            case 0: function_unit(out, i / 4); break;
+            case 1: if_chain_unit(out, i / 4); break;
+            case 2: binary_expression_unit(out, i / 4); break;
+            default: comment_unit(out, i / 4); break;
+        }
+    }
+
+    typedef struct {
+        const char* name;
+        void (*unit)(std::ostringstream&, int);
+    } shape;
+
+    const shape shapes[] = {
+        {"functions", function_unit},
+        {"if_chains", if_chain_unit},
+        {"binary_expressions", binary_expression_unit},
+        {"long_expressions", long_expression_unit},
+        {"comments", comment_unit},
+        {"nested_scopes", nested_scope_unit},
+        {"mixed", mixed_unit},
+    };
+
+    /**
+     * @par Appends units of `corpus_shape` until the program is at least `target_bytes` long.
+     */
+    std::string generate_corpus(const shape& corpus_shape, std::size_t target_bytes) {
+        std::ostringstream out;
+        out << "/*\n  generated front end benchmark corpus (" << corpus_shape.name << ")\n*/\n\n";
+        for (int i = 0; static_cast<std::size_t>(out.tellp()) < target_bytes; i++) {
+            corpus_shape.unit(out, i);
+        }
+        return out.str();
+    }
+}
+
+/**
+ * @par Peak resident set size. Linux lets the peak be reset by writing "5" to `/proc/self/clear_refs`, which lets each phase report its own peak; elsewhere the process wide peak from `getrusage()` is reported.
+ */
+namespace peak_rss {
+    bool reset() {
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        if (!clear_refs) {
+            return false;
+        }
+        clear_refs << "5";
+        clear_refs.flush();
+        return static_cast<bool>(clear_refs);
+    }
+
+    std::size_t read_bytes() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, 6, "VmHWM:") == 0) {
+                return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+            }
+        }
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    }
+}
+
+/**
+ * @struct phase_result
+ * @par What one phase cost: the fastest time over all iterations, the allocations made by the last iteration, and the highest peak RSS seen.
+ */
+typedef struct {
+    const char* name;
+    double seconds;
+    std::size_t peak_rss_bytes;
+    std::size_t allocations;
+    std::size_t allocated_bytes;
+} phase_result;
+
+/**
+ * @par Runs `phase`, folding its time, peak RSS, and allocations into `result`.
+ */
+template <typename Phase>
+static void measure(phase_result& result, Phase phase) {
+    peak_rss::reset();
+    std::size_t allocations_before = allocation_counter::allocations.load();
+    std::size_t bytes_before = allocation_counter::allocated_bytes.load();
+
+    auto start = std::chrono::steady_clock::now();
+    phase();
+    auto stop = std::chrono::steady_clock::now();
+
+    result.seconds = std::min(result.seconds, std::chrono::duration<double>(stop - start).count());
+    result.allocations = allocation_counter::allocations.load() - allocations_before;
+    result.allocated_bytes = allocation_counter::allocated_bytes.load() - bytes_before;
+    result.peak_rss_bytes = std::max(result.peak_rss_bytes, peak_rss::read_bytes());
+}
+
+/**
+ * @par A stand in for an analysis pass, visiting every node of a program the same way over both AST representations: pre-order with an explicit stack, reading each node's kind and folding it into a checksum.
+ * The pointer tree is reached through `ast::for_each_child()`, and the flat tree through `flat_ast::walk()`.
+ */
+namespace traversal {
+    typedef struct {
+        std::size_t nodes;
+        std::size_t checksum;
+    } walk_result;
+
+    walk_result walk_tree(const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        walk_result result = {0, 0};
+        std::vector<ast::top_level_expr*> pending;
+        auto push_list = [&](const ast::node_list& list) {
+            for (auto child = list.rbegin(); child != list.rend(); ++child) {
+                pending.push_back(child->get());
+            }
+        };
+
+        for (const auto& item : program) {
+            if (item.index() == 0) {
+                pending.push_back(std::get<0>(item).get());
+            } else {
+                push_list(std::get<1>(item)->get_body());
+                push_list(std::get<1>(item)->get_parameters());
+            }
+
+            while (!pending.empty()) {
+                ast::top_level_expr* node = pending.back();
+                pending.pop_back();
+                result.nodes++;
+                result.checksum = result.checksum * 31 + node->get_kind();
+
+                std::size_t first_child = pending.size();
+                ast::for_each_child(node, [&](ast::top_level_expr* child) { pending.push_back(child); });
+                std::reverse(pending.begin() + first_child, pending.end());
+            }
+        }
+        return result;
+    }
+
+    walk_result walk_flat(const flat_ast::tree& flat) {
+        walk_result result = {0, 0};
+        flat_ast::walk(flat, [&](flat_ast::node_index node) {
+            result.nodes++;
+            result.checksum = result.checksum * 31 + flat.kinds[node];
+        });
+        return result;
+    }
+}
+
+/**
+ * @par Parses sizes such as "1K", "64M", or "500M" (powers of 1024).
+ */
+static std::size_t parse_size(const std::string& text) {
+    char* suffix = nullptr;
+    double value = std::strtod(text.c_str(), &suffix);
+    switch (*suffix) {
+        case 'k': case 'K': value *= 1024.0; break;
+        case 'm': case 'M': value *= 1024.0 * 1024.0; break;
+        case 'g': case 'G': value *= 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+    }
+    return static_cast<std::size_t>(value);
+}
+
+static std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static void usage() {
+    std::cerr << "usage: frontend_benchmark [--sizes 1K,64K,...] [--shapes functions,if_chains,...] [--threads N] [--output results.json]\n";
+    std::cerr << "shapes:";
+    for (const corpus::shape& corpus_shape : corpus::shapes) {
+        std::cerr << " " << corpus_shape.name;
+    }
+    std::cerr << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> sizes = {"1K", "16K", "256K", "4M", "64M", "500M"};
+    std::vector<std::string> shape_names;
+    std::string output_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--sizes" && i + 1 < argc) {
+            sizes = split(argv[++i]);
+        } else if (argument == "--shapes" && i + 1 < argc) {
+            shape_names = split(argv[++i]);
+        } else if (argument == "--threads" && i + 1 < argc) {
+            thread_pool::set_worker_limit(static_cast<unsigned>(std::stoul(argv[++i]))); // to measure how parsing scales
+        } else if (argument == "--output" && i + 1 < argc) {
+            output_path = argv[++i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    std::vector<const corpus::shape*> selected_shapes;
+    for (const corpus::shape& corpus_shape : corpus::shapes) {
+        if (shape_names.empty() || std::find(shape_names.begin(), shape_names.end(), corpus_shape.name) != shape_names.end()) {
+            selected_shapes.push_back(&corpus_shape);
+        }
+    }
+    if (selected_shapes.empty()) {
+        usage();
+        return 1;
+    }
+
+    utility::initialize_operator_precendence();
+
+    // cache entries go to a scratch directory that is removed on the way out, never the user's cache
+    char cache_directory[] = "/tmp/frontend_benchmark_XXXXXX";
+    if (mkdtemp(cache_directory) == nullptr) {
+        std::cerr << "Could not create a directory for the AST cache\n";
+        return 1;
+    }
+    setenv("PYRX_CACHE_DIR", cache_directory, 1);
+    struct directory_cleanup {
+        std::string path;
+        ~directory_cleanup() {
+            std::error_code error;
+            std::filesystem::remove_all(path, error);
+        }
+    } cache_cleanup{cache_directory};
+
+    bool peak_rss_resettable = peak_rss::reset();
+
+    std::ostringstream json;
+    json.precision(9);
+    json << "{\n";
+    json << "  \"benchmark\": \"frontend\",\n";
+    json << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    json << "  \"threads\": " << thread_pool::worker_count() << ",\n";
+    json << "  \"scan_kernel\": \"" << scan_kernels::level_name(scan_kernels::active_level()) << "\",\n";
+    json << "  \"peak_rss_per_phase\": " << (peak_rss_resettable ? "true" : "false") << ",\n";
+    json << "  \"results\": [";
+
+    bool first_result = true;
+    for (const corpus::shape* corpus_shape : selected_shapes) {
+        for (const std::string& size : sizes) {
+            std::size_t target_bytes = parse_size(size);
+            std::string source = corpus::generate_corpus(*corpus_shape, target_bytes);
+
+            // small corpora are repeated so the timings are not dominated by noise
+            int iterations = static_cast<int>(std::clamp<std::size_t>((4u << 20) / std::max<std::size_t>(source.size(), 1), 1, 25));
+
+            phase_result phases[] = {
+                {"tokenize_file", 1e300, 0, 0, 0},
+                {"parse_top_level", 1e300, 0, 0, 0},
+                {"flatten_ast", 1e300, 0, 0, 0},
+                {"tree_walk", 1e300, 0, 0, 0},
+                {"flat_walk", 1e300, 0, 0, 0},
+                {"semantic_analysis", 1e300, 0, 0, 0},
+                {"codegen", 1e300, 0, 0, 0},
+                {"ast_teardown", 1e300, 0, 0, 0},
+                {"ast_cache_store", 1e300, 0, 0, 0},
+                {"ast_cache_load", 1e300, 0, 0, 0},
+                {"separate_passes", 1e300, 0, 0, 0},
+                {"fused_passes", 1e300, 0, 0, 0},
+                {"consume_tokens", 1e300, 0, 0, 0},
+                {"constant_folding", 1e300, 0, 0, 0},
+            };
+            std::vector<passes::pass_timing> pass_timings;
+            std::size_t token_count = 0;
+            std::size_t statement_count = 0;
+            std::size_t arena_bytes = 0;
+            std::size_t node_count = 0;
+            std::size_t flat_bytes = 0;
+            std::size_t cache_entry_bytes = 0;
+            int line_count = 0;
+
+            for (int iteration = 0; iteration < iterations; iteration++) {
+                scope::reset();
+                sem_analysis_scope::sem_analysis_stack.clear();
+                sem_analysis_scope::defined_functions.clear();
+                sem_analysis_scope::valid_dot_calls.clear();
+
+                context::compilation_context unit;
+                unit.file_name = corpus_shape->name;
+                unit.lexer.source = source;
+                unit.lexer.source_loaded = true;
+
+                std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parsing_output;
+
+                measure(phases[0], [&]() {
+                    lexer::tokenize_file(unit.lexer);
+                });
+
+                // the parser's own cost per token: advancing the cursor and reading each literal payload in place
+                uint64_t payload_checksum = 0;
+                measure(phases[12], [&]() {
+                    utility::init_parser(unit);
+                    while (parser::get_next_token(unit) != lexer::tok_eof) {
+                        const lexer::token& tok = *unit.parser.current_token_record;
+                        if (lexer::has_text(tok)) {
+                            payload_checksum += lexer::token_text(unit.lexer, tok).size();
+                        } else if (tok.kind == lexer::tok_int_val) {
+                            payload_checksum += static_cast<uint64_t>(lexer::token_int(unit.lexer, tok));
+                        }
+                    }
+                });
+                if (payload_checksum == 0 && unit.lexer.token_stream.size() > 1) {
+                    std::cerr << "No literal payloads were read from the " << corpus_shape->name << " corpus\n";
+                    return 1;
+                }
+
+                arena::arena_scope ast_scope(unit.ast_arena);
+
+                measure(phases[1], [&]() {
+                    utility::init_parser(unit);
+                    parser::get_next_token(unit);
+                    parsing_output = utility::parse_top_level(unit);
+                });
+
+                arena_bytes = unit.ast_arena.bytes_used();
+
+                flat_ast::tree flat;
+                measure(phases[2], [&]() {
+                    flat_ast::flatten(flat, parsing_output);
+                });
+
+                traversal::walk_result tree_result;
+                traversal::walk_result flat_result;
+                measure(phases[3], [&]() {
+                    tree_result = traversal::walk_tree(parsing_output);
+                });
+                measure(phases[4], [&]() {
+                    flat_result = traversal::walk_flat(flat);
+                });
+                if (tree_result.nodes != flat_result.nodes || tree_result.checksum != flat_result.checksum) {
+                    std::cerr << "Flattened " << corpus_shape->name << " corpus does not match its tree\n";
+                    return 1;
+                }
+                if (iteration == 0) {
+                    traversal::walk_result expanded_result = traversal::walk_tree(flat_ast::expand(flat));
+                    if (expanded_result.nodes != tree_result.nodes || expanded_result.checksum != tree_result.checksum) {
+                        std::cerr << "Expanding the flattened " << corpus_shape->name << " corpus does not give back its tree\n";
+                        return 1;
+                    }
+                }
+                node_count = flat_ast::node_count(flat);
+                flat_bytes = flat_ast::memory_bytes(flat);
+
+                measure(phases[5], [&]() {
+                    sem_analysis_scope::create_scope();
+                    utility::analyze_program(parsing_output);
+                    sem_analysis_scope::exit_scope();
+                });
+
+                measure(phases[13], [&]() {
+                    passes::pass_manager<passes::constant_folding> folding;
+                    folding.run(parsing_output);
+                });
+                tree_result = traversal::walk_tree(parsing_output); // what the cache is checked against below
+
+                // the driver's two passes, each in a walk of its own and then fused into one walk (the tree is folded by now, so folding finds nothing left to rewrite)
+                std::size_t separate_pure = 0;
+                std::size_t separate_rewrites = 0;
+                measure(phases[10], [&]() {
+                    passes::pass_manager<passes::constant_folding> folding;
+                    folding.run(parsing_output);
+                    passes::pass_manager<passes::purity_analysis> purity;
+                    purity.run(parsing_output);
+                    separate_rewrites = folding.get<passes::constant_folding>().rewrite_count();
+                    separate_pure = purity.get<passes::purity_analysis>().pure_count();
+                });
+                passes::pass_manager<passes::constant_folding, passes::purity_analysis> fused;
+                measure(phases[11], [&]() {
+                    fused = {};
+                    fused.run(parsing_output);
+                });
+                if (fused.get<passes::purity_analysis>().pure_count() != separate_pure
+                    || fused.get<passes::constant_folding>().rewrite_count() != separate_rewrites) {
+                    std::cerr << "Fused passes over the " << corpus_shape->name << " corpus disagree with the same passes run separately\n";
+                    return 1;
+                }
+                pass_timings = fused.timings();
+
+                measure(phases[8], [&]() {
+                    unit.cache_key = ast_cache::cache_key(unit.lexer.source, unit.file_name);
+                    ast_cache::store(unit, parsing_output);
+                });
+                cache_entry_bytes = std::filesystem::file_size(ast_cache::cache_directory() + "/" + unit.cache_key + ast_cache::entry_extension);
+
+                {
+                    arena::bump_arena cached_arena;
+                    arena::arena_scope cached_scope(cached_arena);
+                    std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> cached_program;
+                    bool hit = false;
+                    measure(phases[9], [&]() { // what a warm compile does instead of lexing, parsing and semantic analysis
+                        unit.cache_key = ast_cache::cache_key(unit.lexer.source, unit.file_name);
+                        hit = ast_cache::load(unit, cached_program);
+                    });
+                    if (!hit) {
+                        std::cerr << "The cached " << corpus_shape->name << " corpus could not be read back\n";
+                        return 1;
+                    }
+                    if (unit.pure_functions != fused.get<passes::purity_analysis>().pure()) {
+                        std::cerr << "Purity analysis over the flat " << corpus_shape->name << " corpus disagrees with the same pass over its tree\n";
+                        return 1;
+                    }
+                    if (iteration == 0) {
+                        traversal::walk_result cached_result = traversal::walk_tree(cached_program);
+                        if (cached_result.nodes != tree_result.nodes || cached_result.checksum != tree_result.checksum) {
+                            std::cerr << "The cached " << corpus_shape->name << " corpus does not match its tree\n";
+                            return 1;
+                        }
+                    }
+                }
+
+                measure(phases[6], [&]() {
+                    utility::init_llvm_mods();
+                    for (auto const& ast_node : parsing_output) {
+                        utility::call_codegen(ast_node);
+                    }
+                });
+
+                if (iteration == 0 && llvm::verifyModule(*codegen::LLVM_Module, &llvm::errs())) {
+                    std::cerr << "Generated " << corpus_shape->name << " corpus does not produce a valid module\n";
+                    return 1;
+                }
+
+                token_count = unit.lexer.token_stream.size();
+                statement_count = parsing_output.size();
+                lexer::build_line_table(unit.lexer);
+                line_count = static_cast<int>(unit.lexer.line_starts.size());
+
+                measure(phases[7], [&]() { // the AST refers to LLVM values, so it goes before the module and context
+                    parsing_output.clear();
+                    unit.ast_arena.release();
+                });
+
+                codegen::IR_Builder.reset();
+                codegen::LLVM_Module.reset();
+                codegen::LLVM_Context.reset();
+            }
+
+            json << (first_result ? "\n" : ",\n");
+            first_result = false;
+
+            json << "    {\n";
+            json << "      \"corpus\": \"" << corpus_shape->name << "\",\n";
+            json << "      \"target_bytes\": " << target_bytes << ",\n";
+            json << "      \"bytes\": " << source.size() << ",\n";
+            json << "      \"lines\": " << line_count << ",\n";
+            json << "      \"tokens\": " << token_count << ",\n";
+            json << "      \"statements\": " << statement_count << ",\n";
+            json << "      \"ast_nodes\": " << node_count << ",\n";
+            json << "      \"ast_arena_bytes\": " << arena_bytes << ",\n";
+            json << "      \"flat_ast_bytes\": " << flat_bytes << ",\n";
+            json << "      \"ast_cache_entry_bytes\": " << cache_entry_bytes << ",\n";
+            json << "      \"iterations\": " << iterations << ",\n";
+            json << "      \"phases\": {";
+            for (std::size_t i = 0; i < std::size(phases); i++) {
+                const phase_result& phase = phases[i];
+                json << (i == 0 ? "\n" : ",\n");
+                json << "        \"" << phase.name << "\": {";
+                json << "\"seconds\": " << phase.seconds;
+                json << ", \"bytes_per_second\": " << source.size() / phase.seconds;
+                json << ", \"tokens_per_second\": " << token_count / phase.seconds;
+                json << ", \"peak_rss_bytes\": " << phase.peak_rss_bytes;
+                json << ", \"allocations\": " << phase.allocations;
+                json << ", \"allocations_per_token\": " << static_cast<double>(phase.allocations) / std::max<std::size_t>(token_count, 1);
+                json << ", \"allocated_bytes\": " << phase.allocated_bytes << "}";
+            }
+            json << "\n      },\n";
+            json << "      \"fused_pass_seconds\": {";
+            for (std::size_t i = 0; i < pass_timings.size(); i++) {
+                json << (i == 0 ? "" : ", ") << "\"" << pass_timings[i].name << "\": " << pass_timings[i].seconds;
+            }
+            json << "}\n";
+            json << "    }";
+
+            std::cerr << corpus_shape->name << " " << size << ": " << source.size() << " bytes, " << token_count << " tokens, lex "
+                      << phases[0].seconds * 1e3 << " ms, parse " << phases[1].seconds * 1e3 << " ms, tree walk " << phases[3].seconds * 1e3 << " ms, flat walk "
+                      << phases[4].seconds * 1e3 << " ms, sem "
+                      << phases[5].seconds * 1e3 << " ms, fold " << phases[13].seconds * 1e3 << " ms, codegen " << phases[6].seconds * 1e3 << " ms, teardown "
+                      << phases[7].seconds * 1e3 << " ms, cache store " << phases[8].seconds * 1e3 << " ms, cache load "
+                      << phases[9].seconds * 1e3 << " ms, passes separate " << phases[10].seconds * 1e3 << " ms, fused "
+                      << phases[11].seconds * 1e3 << " ms, consume tokens " << phases[12].seconds * 1e3 << " ms (" << phases[12].allocations << " allocations)\n";
+        }
+    }
+
+    json << "\n  ],\n";
+    json << "  \"interned_symbols\": " << interner::symbol_count() << "\n";
+    json << "}\n";
+
+    if (output_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream output(output_path);
+        if (!output) {
+            std::cerr << "Could not open " << output_path << "\n";
+            return 1;
+        }
+        output << json.str();
+    }
+
+    return 0;
+}
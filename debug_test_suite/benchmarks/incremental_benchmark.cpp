@@ -0,0 +1,261 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../../include/incremental/incremental.h"
+#include "../../include/parser/parser.h"
+#include "../../include/thread_pool/thread_pool.h"
+#include "../../include/utility/utility.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+/**
+ * @par Builds a synthetic program of about `unit_count * 10` lines, mixing top level statements and function definitions.
+ */
+static std::string generate_corpus(int unit_count) {
+    std::ostringstream corpus;
+
+    corpus << "/*\n  generated incremental benchmark corpus\n*/\n\n";
+    for (int i = 0; i < unit_count; i++) {
+        corpus << "int counter_" << i << " = " << (i * 37) % 100000 << ";\n";
+        corpus << "def float compute_value_" << i << "(int first_argument, float second_argument) {\n";
+        corpus << "    // accumulate the intermediate values\n";
+        corpus << "    int running_total = first_argument * 44 - counter_" << i << " + 12;\n";
+        corpus << "    float scaled = second_argument / 3.25 + 0.5;\n";
+        corpus << "    string label = \"compute value number " << i << "\";\n";
+        corpus << "    running_total = running_total + 1;\n";
+        corpus << "    return scaled;\n";
+        corpus << "}\n";
+        corpus << "bool ready_" << i << " = true;\n";
+    }
+
+    return corpus.str();
+}
+
+/**
+ * @par Appends the location of every node of a statement to `locations`, in pre-order.
+ */
+static void collect_locations(const incremental::parsed_statement& statement, std::vector<lexer::source_location>& locations) {
+    std::vector<ast::top_level_expr*> pending;
+    if (statement.node.index() == 0) {
+        pending.push_back(std::get<0>(statement.node).get());
+    } else {
+        const ast::func_defn& function = *std::get<1>(statement.node);
+        locations.push_back(function.get_location());
+        for (const ast::node_ptr<ast::top_level_expr>& parameter : function.get_parameters()) {
+            pending.push_back(parameter.get());
+        }
+        for (const ast::node_ptr<ast::top_level_expr>& expression : function.get_body()) {
+            pending.push_back(expression.get());
+        }
+    }
+
+    while (!pending.empty()) {
+        ast::top_level_expr* node = pending.back();
+        pending.pop_back();
+        locations.push_back(node->get_location());
+        ast::for_each_child(node, [&](ast::top_level_expr* child) {
+            pending.push_back(child);
+        });
+    }
+}
+
+/**
+ * @par Checks that an incrementally updated document holds exactly the tokens and statements a from scratch parse of its text produces, down to the location of every node.
+ */
+static bool matches_full_parse(const incremental::document& doc) {
+    incremental::document fresh;
+    incremental::open_document(fresh, doc.unit.lexer.stream_buffer);
+
+    const lexer::lexer_state& expected_lexer = fresh.unit.lexer;
+    const lexer::lexer_state& actual_lexer = doc.unit.lexer;
+
+    if (expected_lexer.token_stream.size() != actual_lexer.token_stream.size()) {
+        std::cerr << "Token count mismatch after edit\n";
+        return false;
+    }
+
+    for (std::size_t i = 0; i < expected_lexer.token_stream.size(); i++) {
+        const lexer::token& expected = expected_lexer.token_stream[i];
+        const lexer::token& actual = actual_lexer.token_stream[i];
+        bool same_value = true;
+
+        if (lexer::has_text(expected)) {
+            same_value = lexer::token_text(expected_lexer, expected) == lexer::token_text(actual_lexer, actual);
+        } else if (expected.kind == lexer::tok_int_val) {
+            same_value = lexer::token_int(expected_lexer, expected) == lexer::token_int(actual_lexer, actual);
+        } else if (expected.kind == lexer::tok_float_val) {
+            same_value = lexer::token_float(expected_lexer, expected) == lexer::token_float(actual_lexer, actual);
+        } else {
+            same_value = expected.payload == actual.payload;
+        }
+
+        if (expected.kind != actual.kind || expected.location != actual.location || !same_value) {
+            std::cerr << "Token mismatch after edit at index " << i << "\n";
+            return false;
+        }
+    }
+
+    if (fresh.body_start != doc.body_start || fresh.statements.size() != doc.statements.size()) {
+        std::cerr << "Statement count mismatch after edit\n";
+        return false;
+    }
+
+    std::vector<lexer::source_location> expected_locations;
+    std::vector<lexer::source_location> actual_locations;
+    for (std::size_t i = 0; i < fresh.statements.size(); i++) {
+        const incremental::parsed_statement& expected = fresh.statements[i];
+        const incremental::parsed_statement& actual = doc.statements[i];
+        bool same_node = expected.first_token == actual.first_token && expected.node.index() == actual.node.index();
+
+        if (same_node && expected.node.index() == 0) {
+            const auto& expected_expr = std::get<0>(expected.node);
+            const auto& actual_expr = std::get<0>(actual.node);
+            same_node = expected_expr->get_kind() == actual_expr->get_kind()
+                     && expected_expr->get_name() == actual_expr->get_name()
+                     && expected_expr->get_location() == actual_expr->get_location();
+        } else if (same_node) {
+            same_node = std::get<1>(expected.node)->get_return_type() == std::get<1>(actual.node)->get_return_type();
+        }
+
+        if (!same_node) {
+            std::cerr << "Statement mismatch after edit at index " << i << "\n";
+            return false;
+        }
+
+        expected_locations.clear();
+        actual_locations.clear();
+        collect_locations(expected, expected_locations);
+        collect_locations(actual, actual_locations);
+        if (expected_locations != actual_locations) {
+            std::cerr << "Node locations differ after edit at index " << i << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @par Opens a large document on a thread of its own, rejects an edit that breaks one of its function bodies, and destroys the document before the thread exits. Whatever the rejected parse left on the thread's parser stacks would be destroyed after the arena it points into.
+ */
+static bool rejects_edit_then_closes(const std::string& corpus) {
+    bool rejected = false;
+    thread_pool::run_on_new_thread([&]() {
+        incremental::document doc;
+        incremental::open_document(doc, corpus);
+
+        std::size_t semicolon = doc.unit.lexer.stream_buffer.find("    return scaled;", corpus.size() / 2) + 17;
+        rejected = !incremental::apply_edit(doc, {semicolon, 1, ""});
+    });
+
+    return rejected;
+}
+
+int main() {
+    utility::initialize_operator_precendence();
+
+    std::string corpus = generate_corpus(5000);
+    std::size_t middle = corpus.find("compute_value_2500(");
+
+    incremental::document doc;
+    auto open_start = std::chrono::steady_clock::now();
+    incremental::open_document(doc, corpus);
+    auto open_stop = std::chrono::steady_clock::now();
+    double full_ms = std::chrono::duration<double>(open_stop - open_start).count() * 1e3;
+
+    lexer::build_line_table(doc.unit.lexer);
+    std::cout << "Source: " << corpus.size() << " bytes, " << doc.unit.lexer.line_starts.size() << " lines, "
+              << doc.unit.lexer.token_stream.size() << " tokens, " << doc.statements.size() << " statements\n";
+    std::cout << "full lex and parse: " << full_ms << " ms\n";
+
+    struct named_edit {
+        const char* name;
+        std::string marker;
+        std::size_t marker_offset;
+        std::size_t removed_length;
+        std::string inserted_text;
+    };
+
+    std::vector<named_edit> edits = {
+        {"change a literal in a def body", "first_argument * 44", 17, 2, "45"},
+        {"insert a statement in a def body", "    return scaled;", 0, 0, "    scaled = scaled * 2.0;\n"},
+        {"insert a new def", "bool ready_2500", 0, 0, "def int inserted_function(int x) {\n    return x;\n}\n"},
+        {"delete a top level line", "int counter_2501 = ", 0, std::string("int counter_2501 = 92537;\n").size(), ""},
+        {"insert a comment", "bool ready_2501", 0, 0, "// a new comment line\n"},
+        {"rename a def", "compute_value_2502(", 14, 4, "renamed"},
+        {"insert a string holding a brace", "    running_total = running_total + 1;", 0, 0, "    string brace = \"a } in a string\";\n"},
+    };
+
+    for (named_edit& edit : edits) {
+        std::size_t found = doc.unit.lexer.stream_buffer.find(edit.marker, middle);
+        if (found == std::string::npos) {
+            std::cerr << "Edit marker not found: " << edit.name << "\n";
+            return 1;
+        }
+
+        incremental::text_edit change = {found + edit.marker_offset, edit.removed_length, edit.inserted_text};
+        auto start = std::chrono::steady_clock::now();
+        bool applied = incremental::apply_edit(doc, change);
+        auto stop = std::chrono::steady_clock::now();
+        double edit_ms = std::chrono::duration<double>(stop - start).count() * 1e3;
+
+        if (!applied) {
+            std::cerr << "Edit rejected: " << edit.name << ": " << doc.last_error.message << "\n";
+            return 1;
+        }
+
+        const incremental::edit_stats& stats = doc.last_edit;
+        std::cout << edit.name << ": " << edit_ms << " ms (" << full_ms / edit_ms << "x faster than a full parse), "
+                  << stats.tokens_rescanned << " tokens rescanned, " << stats.tokens_reused << " reused, "
+                  << stats.statements_reparsed << " statements reparsed, " << stats.statements_reused << " reused"
+                  << (stats.full_reparse ? ", full reparse" : "") << "\n";
+
+        if (!matches_full_parse(doc)) {
+            return 1;
+        }
+    }
+
+    std::vector<named_edit> broken_edits = {
+        {"drop a semicolon in a def body", "    return scaled;", 17, 1, ""},
+        {"open a string that never closes", "bool ready_2502", 0, 0, "string broken = \"no end\n"},
+        {"open a block that never closes", "bool ready_2503", 0, 0, "def int unfinished() {\n"},
+        {"break an include", "", 0, 0, "include 42\n"},
+    };
+
+    for (named_edit& edit : broken_edits) {
+        std::size_t found = edit.marker.empty() ? 0 : doc.unit.lexer.stream_buffer.find(edit.marker, middle);
+        if (found == std::string::npos) {
+            std::cerr << "Edit marker not found: " << edit.name << "\n";
+            return 1;
+        }
+
+        std::string text_before = doc.unit.lexer.stream_buffer;
+        std::size_t statements_before = doc.statements.size();
+        incremental::text_edit change = {found + edit.marker_offset, edit.removed_length, edit.inserted_text};
+        if (incremental::apply_edit(doc, change)) {
+            std::cerr << "Edit with an error was applied: " << edit.name << "\n";
+            return 1;
+        }
+        std::cout << edit.name << ": rejected (" << doc.last_error.message << ")\n";
+
+        if (doc.unit.lexer.stream_buffer != text_before || doc.statements.size() != statements_before || !matches_full_parse(doc)) {
+            std::cerr << "Document changed by a rejected edit: " << edit.name << "\n";
+            return 1;
+        }
+    }
+
+    if (!rejects_edit_then_closes(generate_corpus(50000))) {
+        std::cerr << "Edit with an error was applied to a large document\n";
+        return 1;
+    }
+    std::cout << "reject an edit to a large document and close it: ok\n";
+
+    return 0;
+}
@@ -0,0 +1,374 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../../include/lexer/lexer.h"
+#include "../../include/scan_kernels/scan_kernels.h"
+#include "../../include/thread_pool/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+/**
+ * @par The previous `if`-chain lexer, kept here verbatim (aside from reading from a string_view) so the table-driven scanner has something to be measured against.
+ */
+namespace legacy {
+
+    typedef std::variant<std::string, int, float, char, bool> stored_value;
+
+    std::vector<lexer::Token_Type> token_stream;
+    std::vector<std::optional<stored_value>> stored_values;
+    std::vector<int> line_count_vec;
+
+    std::string_view source;
+    std::size_t read_offset = 0;
+    int line_count = 1;
+    int previous_character = ' ';
+
+    std::string identifier;
+    std::string string_value;
+    int integer_value;
+    float float_value;
+    char char_value;
+    bool bool_value;
+
+    int next_char() {
+        if (read_offset < source.size()) {
+            return static_cast<unsigned char>(source[read_offset++]);
+        }
+        return EOF;
+    }
+
+    lexer::Token_Type get_token() {
+        while (isspace(previous_character)) {
+            if (previous_character == '\n') line_count++;
+            previous_character = next_char();
+        }
+
+        if (previous_character == ';') { previous_character = next_char(); return lexer::tok_semicolon; }
+        if (previous_character == '=') { previous_character = next_char(); return lexer::tok_assignment; }
+        if (previous_character == '(') { previous_character = next_char(); return lexer::tok_open_paren; }
+        if (previous_character == ')') { previous_character = next_char(); return lexer::tok_close_paren; }
+        if (previous_character == '{') { previous_character = next_char(); return lexer::tok_open_brack; }
+        if (previous_character == '}') { previous_character = next_char(); return lexer::tok_close_brack; }
+        if (previous_character == '[') { previous_character = next_char(); return lexer::tok_open_arr; }
+        if (previous_character == ']') { previous_character = next_char(); return lexer::tok_close_arr; }
+        if (previous_character == '.') { previous_character = next_char(); return lexer::tok_dot; }
+        if (previous_character == ',') { previous_character = next_char(); return lexer::tok_comma; }
+        if (previous_character == EOF) { return lexer::tok_eof; }
+
+        if (previous_character == '+') {
+            previous_character = next_char();
+            if (previous_character == '+') { previous_character = next_char(); return lexer::tok_increment; }
+            return lexer::tok_plus;
+        }
+
+        if (previous_character == '-') {
+            previous_character = next_char();
+            if (previous_character == '-') { previous_character = next_char(); return lexer::tok_decrement; }
+            return lexer::tok_minus;
+        }
+
+        if (previous_character == '*') { previous_character = next_char(); return lexer::tok_mult; }
+
+        if (previous_character == '/') {
+            previous_character = next_char();
+            if (isspace(previous_character)) { previous_character = next_char(); return lexer::tok_div; }
+
+            if (previous_character == '/') {
+                do {
+                    previous_character = next_char();
+                } while (previous_character != '\n' && previous_character != EOF);
+            }
+
+            if (previous_character == '*') {
+                previous_character = next_char();
+                while (true) {
+                    if (previous_character == '*') {
+                        previous_character = next_char();
+                        if (previous_character == '/') {
+                            previous_character = next_char();
+                            return get_token();
+                        }
+                    } else if (previous_character == '\n') {
+                        line_count++;
+                    } else if (previous_character == EOF) {
+                        return lexer::tok_eof;
+                    }
+                    previous_character = next_char();
+                }
+            }
+
+            if (previous_character == EOF) return lexer::tok_eof;
+            if (previous_character == '\n') line_count++;
+
+            previous_character = next_char();
+            return get_token();
+        }
+
+        if (isalpha(previous_character) || previous_character == '_') {
+            identifier.assign(1, static_cast<char>(previous_character));
+            while (isalnum(previous_character = next_char()) || (previous_character == '_')) {
+                identifier += previous_character;
+            }
+
+            if (identifier == "print") return lexer::tok_print;
+            if (identifier == "int") return lexer::tok_int;
+            if (identifier == "float") return lexer::tok_float;
+            if (identifier == "void") return lexer::tok_void;
+            if (identifier == "if") return lexer::tok_if;
+            if (identifier == "else") return lexer::tok_else;
+            if (identifier == "bool") return lexer::tok_bool;
+            if (identifier == "char") return lexer::tok_char;
+            if (identifier == "string") return lexer::tok_string;
+            if (identifier == "for") return lexer::tok_for;
+            if (identifier == "while") return lexer::tok_while;
+            if (identifier == "true") { bool_value = true; return lexer::tok_true; }
+            if (identifier == "false") { bool_value = false; return lexer::tok_false; }
+            if (identifier == "class") return lexer::tok_class;
+            if (identifier == "graph") return lexer::tok_graph;
+            if (identifier == "return") return lexer::tok_return;
+            if (identifier == "def") return lexer::tok_def;
+            if (identifier == "include") return lexer::tok_include;
+            if (identifier == "list") return lexer::tok_list;
+            if (identifier == "for") return lexer::tok_for;
+            if (identifier == "while") return lexer::tok_while;
+
+            return lexer::tok_identifier;
+        }
+
+        if (isdigit(previous_character)) {
+            std::string temp_num;
+            bool is_float = false;
+
+            do {
+                temp_num += previous_character;
+                if (previous_character == '.') is_float = true;
+                previous_character = next_char();
+            } while (isdigit(previous_character) || previous_character == '.');
+
+            if (is_float == true) {
+                float_value = strtod(temp_num.c_str(), nullptr);
+                return lexer::tok_float_val;
+            }
+
+            integer_value = std::stoi(temp_num);
+            return lexer::tok_int_val;
+        }
+
+        if (previous_character == '"') {
+            string_value = "";
+            while (true) {
+                previous_character = next_char();
+                if (previous_character == '"') {
+                    previous_character = next_char();
+                    return lexer::tok_string_val;
+                }
+                if (previous_character == EOF || previous_character == ';') return lexer::tok_eof;
+                if (previous_character == '\n') line_count++; // newlines inside literals were not counted before the parallel lexer needed exact line numbers
+                string_value += previous_character;
+            }
+        }
+
+        if (previous_character == '\'') {
+            previous_character = next_char();
+            char_value = previous_character;
+            previous_character = next_char();
+            previous_character = next_char();
+            return lexer::tok_char_val;
+        }
+
+        return lexer::tok_eof;
+    }
+
+    void tokenize_file() {
+        while (true) {
+            lexer::Token_Type token = get_token();
+            if (token == lexer::tok_eof) {
+                token_stream.emplace_back(token);
+                stored_values.emplace_back(std::nullopt);
+                line_count_vec.emplace_back(line_count);
+                break;
+            }
+            token_stream.emplace_back(token);
+            line_count_vec.emplace_back(line_count);
+
+            switch (token) {
+                case lexer::tok_identifier: stored_values.emplace_back(identifier); break;
+                case lexer::tok_int_val: stored_values.emplace_back(integer_value); break;
+                case lexer::tok_float_val: stored_values.emplace_back(float_value); break;
+                case lexer::tok_char_val: stored_values.emplace_back(char_value); break;
+                case lexer::tok_string_val: stored_values.emplace_back(string_value); break;
+                case lexer::tok_true: case lexer::tok_false: stored_values.emplace_back(bool_value); break;
+                default: stored_values.emplace_back(std::nullopt); break;
+            }
+        }
+    }
+
+    void reset(std::string_view new_source) {
+        token_stream.clear();
+        stored_values.clear();
+        line_count_vec.clear();
+        source = new_source;
+        read_offset = 0;
+        line_count = 1;
+        previous_character = ' ';
+    }
+}
+
+/**
+ * @par Builds a synthetic program with a representative mix of declarations, keywords, literals, and comments.
+ */
+static std::string generate_corpus(int function_count) {
+    std::ostringstream corpus;
+
+    corpus << "/*\n  generated lexer benchmark corpus\n*/\n\n";
+    for (int i = 0; i < function_count; i++) {
+        corpus << "/*\n";
+        corpus << " * generated_function_with_a_descriptive_name_" << i << " combines its arguments with the\n";
+        corpus << " * module level counter, and reports whether the intermediate state was ready.\n";
+        corpus << " */\n";
+        corpus << "int global_counter_for_generated_function_" << i << " = " << (i * 37) % 100000 << ";\n";
+        corpus << "def float compute_value_" << i << "(int first_argument, float second_argument, char flag) {\n";
+        corpus << "    // accumulate the intermediate values\n";
+        corpus << "    int running_total = first_argument * 44 - global_counter_for_generated_function_" << i << " + 12;\n";
+        corpus << "    float scaled = second_argument / 3.25 + 0.5;\n";
+        corpus << "    bool is_ready = true;\n";
+        corpus << "    string label = \"compute value number " << i << "\";\n";
+        corpus << "    string banner = \"a string literal that\n    spans two lines\";\n";
+        corpus << "    if (is_ready) {\n";
+        corpus << "        // deeply nested bodies are mostly indentation\n";
+        corpus << "        print('Y');\n";
+        corpus << "        running_total = running_total + 1;\n";
+        corpus << "    } else {\n";
+        corpus << "        is_ready = false;\n";
+        corpus << "    }\n";
+        corpus << "    return scaled;\n";
+        corpus << "}\n\n";
+    }
+
+    return corpus.str();
+}
+
+/**
+ * @par Runs `tokenize` `iterations` times and reports the best observed throughput.
+ */
+template <typename Tokenize>
+static void report(const char* name, int iterations, std::size_t source_bytes, Tokenize tokenize) {
+    double best_seconds = 1e300;
+    std::size_t token_count = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        token_count = tokenize();
+        auto stop = std::chrono::steady_clock::now();
+        best_seconds = std::min(best_seconds, std::chrono::duration<double>(stop - start).count());
+    }
+
+    std::cout << name << ": " << token_count << " tokens in " << best_seconds * 1e3 << " ms ("
+              << static_cast<std::size_t>(token_count / best_seconds) << " tokens/sec, "
+              << (source_bytes / best_seconds) / (1024.0 * 1024.0) << " MiB/sec)\n";
+}
+
+int main(int argc, char** argv) {
+    std::string corpus;
+
+    if (argc > 1) {
+        std::ifstream file(argv[1]);
+        if (!file) {
+            std::cerr << "File not found.\n";
+            return 1;
+        }
+        corpus.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    } else {
+        corpus = generate_corpus(20000);
+    }
+
+    const int iterations = 5;
+    std::cout << "Source: " << corpus.size() << " bytes\n";
+
+    report("legacy lexer", iterations, corpus.size(), [&]() {
+        legacy::reset(corpus);
+        legacy::tokenize_file();
+        return legacy::token_stream.size();
+    });
+
+    std::istringstream corpus_stream(corpus);
+    lexer::lexer_state state;
+    state.input = &corpus_stream;
+    lexer::load_source_from_stream(state);
+
+    for (int level = scan_kernels::level_scalar; level <= scan_kernels::detect_level(); level++) {
+        scan_kernels::use_level(static_cast<scan_kernels::kernel_level>(level));
+        std::string name = std::string("table lexer (") + scan_kernels::level_name(scan_kernels::active_level()) + ")";
+
+        report(name.c_str(), iterations, corpus.size(), [&]() {
+            lexer::reset_lexer(state);
+            lexer::tokenize_file(state);
+            return state.token_stream.size();
+        });
+
+        if (legacy::token_stream.size() != state.token_stream.size()) {
+            std::cerr << "Token count mismatch between lexers\n";
+            return 1;
+        }
+
+        for (std::size_t i = 0; i < state.token_stream.size(); i++) {
+            const lexer::token& tok = state.token_stream[i];
+            bool may_span_lines = tok.kind == lexer::tok_string_val || tok.kind == lexer::tok_char_val; // the legacy lexer records the line a token ends on, locations point at where it starts
+            if (legacy::token_stream[i] != tok.kind || (!may_span_lines && legacy::line_count_vec[i] != (int)lexer::locate(state, tok.location).line)) {
+                std::cerr << "Token mismatch between lexers at index " << i << "\n";
+                return 1;
+            }
+        }
+    }
+
+    std::vector<lexer::token> sequential_tokens = state.token_stream;
+    std::vector<lexer::source_span> sequential_spans = state.span_table;
+    std::vector<int> sequential_ints = state.int_table;
+
+    for (unsigned thread_count = 1; thread_count <= std::max(4u, thread_pool::worker_count()); thread_count *= 2) {
+        thread_pool::set_worker_limit(thread_count);
+        std::string name = "parallel lexer (" + std::to_string(thread_count) + " threads requested, " + std::to_string(thread_pool::worker_count()) + " available)";
+
+        report(name.c_str(), iterations, corpus.size(), [&]() {
+            lexer::reset_lexer(state);
+            lexer::tokenize_file_parallel(state, thread_count);
+            return state.token_stream.size();
+        });
+
+        if (state.token_stream.size() != sequential_tokens.size()) {
+            std::cerr << "Token count mismatch between sequential and parallel lexers\n";
+            return 1;
+        }
+
+        for (std::size_t i = 0; i < sequential_tokens.size(); i++) {
+            const lexer::token& expected = sequential_tokens[i];
+            const lexer::token& actual = state.token_stream[i];
+            bool same_value = true;
+
+            if (lexer::has_span(expected)) {
+                same_value = sequential_spans[expected.payload].offset == state.span_table[actual.payload].offset;
+            } else if (expected.kind == lexer::tok_int_val) {
+                same_value = sequential_ints[expected.payload] == state.int_table[actual.payload];
+            } else if (expected.kind != lexer::tok_float_val) {
+                same_value = expected.payload == actual.payload;
+            }
+
+            if (expected.kind != actual.kind || expected.location != actual.location || !same_value) {
+                std::cerr << "Token mismatch between sequential and parallel lexers at index " << i << "\n";
+                return 1;
+            }
+        }
+    }
+    thread_pool::set_worker_limit(0);
+
+    return 0;
+}
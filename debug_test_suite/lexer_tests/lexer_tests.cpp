@@ -8,11 +8,10 @@ If LICENSE.md is not included, this version of the source code is provided in br
 
 #include "../../include/lexer/lexer.h"
 #include <iostream>
-#include <variant>
 
-static void print_individual_token(int token, const std::optional<lexer::lexer_stored_values>& value) {
+static void print_individual_token(const lexer::lexer_state& state, const lexer::token& tok) {
 
-    switch (token) {
+    switch (tok.kind) {
         case lexer::tok_eof:
             std::cout << "Token EOF" << "\n";
             break;
@@ -123,10 +122,21 @@ static void print_individual_token(int token, const std::optional<lexer::lexer_s
             break;
     }
 
-    if (value.has_value()) {
-        if (!std::holds_alternative<bool>(value.value())) {
-            std::visit([](const auto& arg) { std::cout << arg << "\n"; }, value.value());
-        } 
+    switch (tok.kind) {
+        case lexer::tok_identifier: case lexer::tok_string_val:
+            std::cout << lexer::token_text(state, tok) << "\n";
+            break;
+        case lexer::tok_int_val:
+            std::cout << lexer::token_int(state, tok) << "\n";
+            break;
+        case lexer::tok_float_val:
+            std::cout << lexer::token_float(state, tok) << "\n";
+            break;
+        case lexer::tok_char_val:
+            std::cout << lexer::token_char(tok) << "\n";
+            break;
+        default:
+            break;
     }
 }
 
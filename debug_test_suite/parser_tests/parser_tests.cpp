@@ -23,14 +23,24 @@ namespace ast {
           std::cout << "Binary Expression " << ast::get_type_as_string(get_expr_type()) << " with operator " << get_op() << "\n"; 
      }
 
+     /**
+      * @fn ast::unary_expr::debug_output()
+      * @code
+      * std::cout << "Unary Expression with operator " << get_op() << "\n"; 
+      * @endcode
+      */
+     void ast::unary_expr::debug_output() {
+          std::cout << "Unary Expression with operator " << get_op() << "\n"; 
+     }
+
      /**
       * @fn ast::identifier_expr::debug_output()
       * @code
-      * std::cout << "Identifier expression (" << identifier_name << ")\n";
+      * std::cout << "Identifier expression (" << interner::name(identifier_name) << ")\n";
       * @endcode
       */
      void ast::identifier_expr::debug_output() {
-          std::cout << "Identifier expression (" << identifier_name << ")\n";
+          std::cout << "Identifier expression (" << interner::name(identifier_name) << ")\n";
      }
 
      /**
@@ -90,7 +100,7 @@ namespace ast {
       * @endcode
       */
      void ast::variable_declaration::debug_output() {
-          std::cout << "Variable declaration of type (" << identifier_name << "): " << ast::get_type_as_string(get_expr_type()) << "\n";
+          std::cout << "Variable declaration of type (" << interner::name(identifier_name) << "): " << ast::get_type_as_string(get_expr_type()) << "\n";
      }
 
      /**
@@ -100,7 +110,7 @@ namespace ast {
       * @endcode
       */
      void ast::variable_definition::debug_output() {
-          std::cout << "Variable definition of type (" << identifier_name << "): " << ast::get_type_as_string(get_expr_type()) << "\n";
+          std::cout << "Variable definition of type (" << interner::name(identifier_name) << "): " << ast::get_type_as_string(get_expr_type()) << "\n";
      }
 
      /**
@@ -110,7 +120,7 @@ namespace ast {
       * @endcode
       */
      void ast::variable_assignment::debug_output() {
-          std::cout << "Variable assignment of type (" << identifier_name << "): " << ast::get_type_as_string(get_expr_type()) << "\n";
+          std::cout << "Variable assignment of type (" << interner::name(identifier_name) << "): " << ast::get_type_as_string(get_expr_type()) << "\n";
      }
 
      /**
@@ -127,11 +137,11 @@ namespace ast {
      /**
       * @fn ast::func_defn::debug_output()
       * @code
-      * std::cout << "Parsing function with name: " << func_name << "\n";
+      * std::cout << "Parsing function with name: " << interner::name(func_name) << "\n";
       * @endcode
       */
      void ast::func_defn::debug_output() {
-          std::cout << "Parsed function with name: " << func_name << "\n";
+          std::cout << "Parsed function with name: " << interner::name(func_name) << "\n";
      }
 
      /**
@@ -167,31 +177,31 @@ namespace ast {
      /**
       * @fn ast::func_call_expr::debug_output()
       * @code
-      * std::cout << "Parsed function call (" << func_name << "\n";
+      * std::cout << "Parsed function call (" << interner::name(func_name) << "\n";
       * @endcode
       */
      void ast::func_call_expr::debug_output() {
-          std::cout << "Parsed function call (" << func_name << ")\n";
+          std::cout << "Parsed function call (" << interner::name(func_name) << ")\n";
      }
 
      /**
       * @fn ast::graph_decl_expr::debug_output()
       * @code
-      *  std::cout << "Parsing graph declaration (" << graph_name << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
+      *  std::cout << "Parsing graph declaration (" << interner::name(graph_name) << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
       * @endcode
       */     
      void ast::graph_decl_expr::debug_output() {
-          std::cout << "Parsing graph declaration (" << graph_name << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
+          std::cout << "Parsing graph declaration (" << interner::name(graph_name) << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
      }
 
      /**
       * @fn ast::list_decl::debug_output()
       * @code
-      *  std::cout << "Parsing list declaration (" << name << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
+      *  std::cout << "Parsing list declaration (" << interner::name(name) << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
       * @endcode
       */
      void ast::list_decl::debug_output() {
-          std::cout << "Parsing list declaration (" << name << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
+          std::cout << "Parsing list declaration (" << interner::name(name) << ") of type " << ast::get_type_as_string(get_expr_type()) << "\n";
      }
 
      /**
@@ -201,7 +211,7 @@ namespace ast {
           for (auto const& arg : args) {
                arg_string = arg_string + arg->get_ast_class() + " ";
           }
-          std::cout << "Parsing method dot call (" << called << ") on " << item_name << " with arguments classes -> " << arg_string << "\n";
+          std::cout << "Parsing method dot call (" << interner::name(called) << ") on " << interner::name(item_name) << " with arguments classes -> " << arg_string << "\n";
       * @endcode
       */
      void ast::method_dot_call::debug_output() {
@@ -209,17 +219,17 @@ namespace ast {
           for (auto const& arg : args) {
                arg_string = arg_string + arg->get_ast_class() + " ";
           }
-          std::cout << "Parsing method dot call (" << called << ") on " << item_name << " with arguments classes -> " << arg_string << "\n";
+          std::cout << "Parsing method dot call (" << interner::name(called) << ") on " << interner::name(item_name) << " with arguments classes -> " << arg_string << "\n";
      }
 
      /**
       * @fn ast::dot_call_var::debug_output()
       * @code
-      *  std::cout << "Parsing variable dot call (" << called << ") on " << item_name << "\n";
+      *  std::cout << "Parsing variable dot call (" << interner::name(called) << ") on " << interner::name(item_name) << "\n";
       * @endcode
       */
      void ast::dot_call_var::debug_output() {
-          std::cout << "Parsing variable dot call (" << called << ") on " << item_name << "\n";
+          std::cout << "Parsing variable dot call (" << interner::name(called) << ") on " << interner::name(item_name) << "\n";
      }
 
      /**
@@ -10,6 +10,7 @@ If LICENSE.md is not included, this version of the source code is provided in br
 #include "../include/utility/utility.h"
 #include "../include/parser/parser.h"
 #include "../include/ast/ast.h"
+#include "../include/module_interface/module_interface.h"
 
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/TargetSelect.h"
@@ -33,6 +34,8 @@ int main(int argc, char** argv) {
 
     std::fstream file;
     std::string file_name = argv[1];
+    context::compilation_context unit;
+    unit.file_name = file_name;
     
     if (file_name.find(".pyrx") == std::string::npos) {
         utility::driver_extension_error("Incorrect file extension on ", file_name);
@@ -43,23 +46,23 @@ int main(int argc, char** argv) {
             fprintf(stderr, "File not found.\n");
             return 0;
         }
-        lexer::input = &file;
+        unit.lexer.input = &file;
     } else {
         fprintf(stderr, ">> "); // prime the inital token
-        lexer::input = &std::cin;
+        unit.lexer.input = &std::cin;
     }
     
     #if (DEBUG_OPTION == 1)
-        lexer::tokenize_file();
-        for (int i = 0; i < lexer::token_stream.size(); i++) {
-           print_individual_token(lexer::token_stream[i], lexer::stored_values[i]);
+        lexer::tokenize_file(unit.lexer);
+        for (int i = 0; i < unit.lexer.token_stream.size(); i++) {
+           print_individual_token(unit.lexer, unit.lexer.token_stream[i]);
         }
         std::cout << "\n";
-        std::cout << "Number of Tokens: " << lexer::token_stream.size() + 1 << "\n";
+        std::cout << "Number of Tokens: " << unit.lexer.token_stream.size() + 1 << "\n";
 
     #elif (DEBUG_OPTION == 2)
         while (true) {
-            int token = lexer::get_token();
+            int token = lexer::get_token(unit.lexer);
             if (token == lexer::tok_eof) {
                 break;
             }
@@ -68,36 +71,32 @@ int main(int argc, char** argv) {
         }
 
     #elif (DEBUG_OPTION == 3)
-        lexer::tokenize_file();
-        for (int i = 0; i < lexer::token_stream.size(); i++) {
-           print_individual_token(lexer::token_stream[i], lexer::stored_values[i]);
+        lexer::tokenize_file(unit.lexer);
+        for (int i = 0; i < unit.lexer.token_stream.size(); i++) {
+           print_individual_token(unit.lexer, unit.lexer.token_stream[i]);
         }
         std::cout << "\n";
-        std::cout << "Number of Tokens: " << lexer::token_stream.size() + 1 << "\n";
+        std::cout << "Number of Tokens: " << unit.lexer.token_stream.size() + 1 << "\n";
 
 
         utility::initialize_operator_precendence();
-        utility::init_parser();
-        utility::primary_driver_loop();
+        utility::init_parser(unit);
+        utility::primary_driver_loop(unit);
 
         file.close();
 
     #elif (DEBUG_OPTION == 4) 
-        lexer::tokenize_file();
-        for (int i = 0; i < lexer::token_stream.size(); i++) {
+        lexer::tokenize_file(unit.lexer);
+        for (int i = 0; i < unit.lexer.token_stream.size(); i++) {
             std::cout << i;
-            if (lexer::stored_values[i] == std::nullopt) {
-                std::cout << " nullopt.\n";
+            if (unit.lexer.token_stream[i].payload == lexer::no_payload) {
+                std::cout << " no payload.\n";
             } else {
-                std::cout << " not nullopt.\n";
+                std::cout << " payload " << unit.lexer.token_stream[i].payload << ".\n";
             }
-            /* else if (lexer::stored_values[i].has_value()) {
-                std::cout << std::get<std::string>(lexer::stored_values[i]);
-            }
-            */
         }
     #elif (DEBUG_OPTION == 5)
-        lexer::tokenize_file();
+        lexer::tokenize_file(unit.lexer);
 
         utility::initialize_operator_precendence();
 
@@ -107,9 +106,9 @@ int main(int argc, char** argv) {
 
         utility::init_llvm_mods();
 
-        utility::init_parser();
+        utility::init_parser(unit);
 
-        utility::primary_driver_loop();
+        utility::primary_driver_loop(unit);
 
         codegen::LLVM_Module->print(llvm::outs(), nullptr);
 
@@ -124,6 +123,12 @@ int main(int argc, char** argv) {
         codegen::LLVM_Module->setDataLayout(jit->getDataLayout());
 
         auto added_ir_module = jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(codegen::LLVM_Module), std::move(codegen::LLVM_Context)));
+        for (const module_interface::interface* module : module_interface::required_modules()) {
+            auto module_context = std::make_unique<llvm::LLVMContext>();
+            std::unique_ptr<llvm::Module> module_ir = module_interface::load_bitcode(*module, *module_context);
+            module_ir->setDataLayout(jit->getDataLayout());
+            llvm::cantFail(jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module_ir), std::move(module_context))));
+        }
         JIT->get()->getMainJITDylib().addGenerator(llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(JIT->get()->getDataLayout().getGlobalPrefix())));
         auto main_symbol = jit->lookup("main");
         if(!main_symbol) {
@@ -136,7 +141,7 @@ int main(int argc, char** argv) {
  
         file.close();
     #elif (DEBUG_OPTION ==6)
-        lexer::tokenize_file();
+        lexer::tokenize_file(unit.lexer);
 
         utility::initialize_operator_precendence();
 
@@ -146,16 +151,16 @@ int main(int argc, char** argv) {
 
         utility::init_llvm_mods();
 
-        utility::init_parser();
+        utility::init_parser(unit);
 
-        utility::primary_driver_loop();
+        utility::primary_driver_loop(unit);
 
         codegen::LLVM_Module->print(llvm::outs(), nullptr);
 
     #elif (DEBUG_OPTION == 7)
         auto start_time = std::chrono::high_resolution_clock::now();
 
-        lexer::tokenize_file();
+        lexer::tokenize_file(unit.lexer);
 
         utility::initialize_operator_precendence();
 
@@ -165,9 +170,9 @@ int main(int argc, char** argv) {
 
         utility::init_llvm_mods();
 
-        utility::init_parser();
+        utility::init_parser(unit);
 
-        utility::primary_driver_loop();
+        utility::primary_driver_loop(unit);
         if (llvm::verifyModule(*codegen::LLVM_Module, &llvm::errs())) {
             llvm::errs() << "Error: Module verification failed.\n";
             exit(1);
@@ -198,7 +203,7 @@ int main(int argc, char** argv) {
         std::cout << "Cumulative Time For Current File: " << cumulative_time.count() << " ms\n";
 
     #else
-        lexer::tokenize_file();
+        lexer::tokenize_file(unit.lexer);
 
         utility::initialize_operator_precendence();
 
@@ -208,9 +213,9 @@ int main(int argc, char** argv) {
 
         utility::init_llvm_mods();
 
-        utility::init_parser();
+        utility::init_parser(unit);
 
-        utility::primary_driver_loop();
+        utility::primary_driver_loop(unit);
 
         file.close();
     #endif
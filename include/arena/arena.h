@@ -0,0 +1,159 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace arena {
+
+    /**
+     * @par A bump allocator that hands out memory from a chain of large blocks. Nothing is freed on its own, instead `release()` returns every block at once, which is how a whole AST is thrown away without visiting any of its nodes.
+     * An arena can own worker arenas (`add_worker()`) for other threads to fill at the same time. They are released along with it, and stay alive until then, so a container allocated from one can keep growing after its thread is done.
+     * @code
+        class bump_arena {
+        private:
+            struct block_header {
+                block_header* previous;
+                std::size_t capacity;
+            };
+
+            block_header* newest_block = nullptr;
+            char* cursor = nullptr;
+            char* limit = nullptr;
+            std::size_t next_block_size = first_block_size;
+            std::size_t used_bytes = 0;
+            std::size_t reserved_bytes = 0;
+            std::vector<std::unique_ptr<bump_arena>> workers;
+
+            void* allocate_slow(std::size_t size, std::size_t alignment);
+
+        public:
+            static constexpr std::size_t first_block_size = 64 * 1024;
+            static constexpr std::size_t largest_block_size = 4 * 1024 * 1024;
+
+            void* allocate(std::size_t size, std::size_t alignment) {
+                char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1));
+                if (cursor == nullptr || aligned + size > limit) {
+                    return allocate_slow(size, alignment);
+                }
+                cursor = aligned + size;
+                used_bytes += size;
+                return aligned;
+            }
+
+            void release();
+            bump_arena& add_worker();
+            std::size_t bytes_used() const;
+            std::size_t bytes_reserved() const;
+        };
+     * @endcode
+     */
+    class bump_arena {
+    private:
+        struct block_header {
+            block_header* previous;
+            std::size_t capacity;
+        };
+
+        block_header* newest_block = nullptr;
+        char* cursor = nullptr;
+        char* limit = nullptr;
+        std::size_t next_block_size = first_block_size;
+        std::size_t used_bytes = 0;
+        std::size_t reserved_bytes = 0;
+        std::vector<std::unique_ptr<bump_arena>> workers;
+
+        void* allocate_slow(std::size_t size, std::size_t alignment);
+
+    public:
+        static constexpr std::size_t first_block_size = 64 * 1024;
+        static constexpr std::size_t largest_block_size = 4 * 1024 * 1024;
+
+        bump_arena() = default;
+        bump_arena(const bump_arena&) = delete;
+        bump_arena& operator=(const bump_arena&) = delete;
+        bump_arena(bump_arena&& other) noexcept;
+        bump_arena& operator=(bump_arena&& other) noexcept;
+        ~bump_arena() { release(); }
+
+        void* allocate(std::size_t size, std::size_t alignment) {
+            char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1));
+            if (cursor == nullptr || aligned + size > limit) {
+                return allocate_slow(size, alignment);
+            }
+            cursor = aligned + size;
+            used_bytes += size;
+            return aligned;
+        }
+
+        void release();
+        bump_arena& add_worker();
+
+        std::size_t bytes_used() const;
+        std::size_t bytes_reserved() const;
+    };
+
+    /**
+     * @par The arena AST nodes are currently being built in. It is installed per thread (by `arena_scope`) since each compilation is parsed start to finish on one thread.
+     */
+    extern thread_local bump_arena* active_arena;
+
+    extern bump_arena& current();
+    extern std::string_view copy_string(std::string_view text);
+
+    /**
+     * @par Makes `target` the active arena of this thread until the scope ends, restoring whichever arena was active before it.
+     */
+    class arena_scope {
+    private:
+        bump_arena* previous;
+
+    public:
+        explicit arena_scope(bump_arena& target) : previous(active_arena) { active_arena = &target; }
+        ~arena_scope() { active_arena = previous; }
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+    };
+
+    /**
+     * @par A standard library allocator over a `bump_arena`, so that containers inside the AST (child lists) are carved out of the same blocks as the nodes holding them. Freeing is a no-op; the memory comes back when the arena is released.
+     * A default constructed allocator binds to the active arena, which lets a node's child list be built up in the parser before the node itself exists.
+     */
+    template <typename T>
+    class arena_allocator {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        bump_arena* owner;
+
+        arena_allocator() : owner(&current()) {}
+        explicit arena_allocator(bump_arena& owner) : owner(&owner) {}
+        template <typename U>
+        arena_allocator(const arena_allocator<U>& other) : owner(other.owner) {}
+
+        T* allocate(std::size_t count) { return static_cast<T*>(owner->allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T*, std::size_t) {}
+    };
+
+    template <typename T, typename U>
+    inline bool operator==(const arena_allocator<T>& left, const arena_allocator<U>& right) { return left.owner == right.owner; }
+    template <typename T, typename U>
+    inline bool operator!=(const arena_allocator<T>& left, const arena_allocator<U>& right) { return left.owner != right.owner; }
+}
+
+#endif // ARENA_H
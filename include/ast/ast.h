@@ -16,9 +16,15 @@ If LICENSE.md is not included, this version of the source code is provided in br
 
 #include "llvm/IR/Value.h"
 #include "../lexer/lexer.h"
+#include "../interner/interner.h"
 #include "../include/types/types.h"
+#include "../arena/arena.h"
 #include <memory>
+#include <new>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <set>
 
@@ -26,29 +32,105 @@ If LICENSE.md is not included, this version of the source code is provided in br
 namespace ast {
 
     /**
-     * @par This is an abstract class that all expression type AST nodes fall under.
+     * @par Every AST node is placed in the active `arena::bump_arena` by `make_node()`, and the whole tree is freed at once by releasing that arena. Ownership still reads the same as it would with `std::unique_ptr`, but dropping a node does nothing, so tearing down an AST never walks it.
+     */
+    struct node_deleter {
+        template <typename T>
+        void operator()(T*) const {}
+    };
+
+    template <typename T>
+    using node_ptr = std::unique_ptr<T, node_deleter>;
+
+    class top_level_expr;
+
+    /**
+     * @par The child list of a node (statements of a body, call arguments, etc...), stored in the same arena as the nodes themselves.
+     */
+    typedef std::vector<node_ptr<top_level_expr>, arena::arena_allocator<node_ptr<top_level_expr>>> node_list;
+
+    /**
+     * @par Builds a node in the active arena.
+     * @code
+        template <typename T, typename... Args>
+        node_ptr<T> make_node(Args&&... args) {
+            void* memory = arena::current().allocate(sizeof(T), alignof(T));
+            return node_ptr<T>(new (memory) T(std::forward<Args>(args)...));
+        }
+     * @endcode
+     */
+    template <typename T, typename... Args>
+    node_ptr<T> make_node(Args&&... args) {
+        void* memory = arena::current().allocate(sizeof(T), alignof(T));
+        return node_ptr<T>(new (memory) T(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @par The storage semantic analysis resolved a variable to, so that codegen can find it by index instead of by name. Slots with `global_slot` set number the globals of the translation unit (those of included modules first); the rest number the variables of the function they are bound in, parameters first.
+     */
+    typedef uint32_t variable_slot;
+    constexpr variable_slot global_slot = 0x80000000u;
+    constexpr variable_slot no_slot = UINT32_MAX; ///< not resolved yet (or not a variable)
+
+    /**
+     * @par Enumeration of every concrete kind of expression node, stored in each node so that code can branch on what a node is without a virtual call or a string compare. The literal kinds are kept together so `is_literal()` is a range check.
+     */
+    enum node_kind : uint8_t {
+        kind_binary,          ///< binary_expr
+        kind_unary,           ///< unary_expr
+        kind_identifier,      ///< identifier_expr
+        kind_int,             ///< integer_expression
+        kind_float,           ///< float_expression
+        kind_char,            ///< char_expression
+        kind_string,          ///< string_expression
+        kind_bool,            ///< bool_expression
+        kind_var_decl,        ///< variable_declaration
+        kind_var_defn,        ///< variable_definition
+        kind_var_assign,      ///< variable_assignment
+        kind_return,          ///< return_expr
+        kind_if,              ///< if_expr
+        kind_else,            ///< else_expr
+        kind_for,             ///< for_expr
+        kind_func_call,       ///< func_call_expr
+        kind_print,           ///< print_expr
+        kind_graph_decl,      ///< graph_decl_expr
+        kind_list_decl,       ///< list_decl
+        kind_method_dot_call, ///< method_dot_call
+        kind_dot_call_var     ///< dot_call_var
+    };
+
+    extern const char* get_kind_as_string(node_kind kind);
+
+    /**
+     * @par This is an abstract class that all expression type AST nodes fall under. Every subclass passes its `node_kind` up to the constructor and provides a static `classof()`, which is what `isa<>()` and `dyn_cast<>()` check.
      * @code
      *  class top_level_expr {
+        private:
+            lexer::source_location location = lexer::no_location;
+            const node_kind kind;
+
+        protected:
+            explicit top_level_expr(node_kind kind) : kind(kind) {}
+
         public:
             virtual ~top_level_expr() = default;
             //virtual void debug_output();
             virtual llvm::Value* codegen() = 0;
-            virtual std::string get_ast_class() const {
-                return "top";
-            }
+            node_kind get_kind() const { return kind; }
+            const char* get_ast_class() const { return get_kind_as_string(kind); }
 
             virtual type_enum::types get_expr_type() const { // PLACEHOLDER
                 return type_enum::types::float_type;
             }
 
-            virtual std::string get_name() const {
-                return ""; 
+            virtual interner::symbol_id get_name() const {
+                return interner::no_symbol; 
             }
 
             virtual void semantic_analysis() {}
 
             virtual bool is_elif() { return false; }
-            virtual std::unique_ptr<top_level_expr> grab_else_if() { return nullptr; }
+            virtual node_ptr<top_level_expr> grab_else_if() { return nullptr; }
 
             virtual llvm::BasicBlock* get_merge_block() { return nullptr; }
             virtual void set_merge_block(llvm::BasicBlock* new_merge_block) {}
@@ -57,15 +139,18 @@ namespace ast {
      */
     class top_level_expr {
     private:
-        int line_number = 0;
+        lexer::source_location location = lexer::no_location;
+        const node_kind kind;
+
+    protected:
+        explicit top_level_expr(node_kind kind) : kind(kind) {}
 
     public:
         virtual ~top_level_expr() = default;
         //virtual void debug_output();
         virtual llvm::Value* codegen() = 0;
-        virtual std::string get_ast_class() const {
-            return "top";
-        }
+        node_kind get_kind() const { return kind; }
+        const char* get_ast_class() const { return get_kind_as_string(kind); }
 
         virtual void set_expr_type(type_enum::types new_type) {}
 
@@ -73,57 +158,103 @@ namespace ast {
             return type_enum::types::float_type;
         }
 
-        virtual std::string get_name() const {
-            return ""; 
+        virtual interner::symbol_id get_name() const {
+            return interner::no_symbol; 
         }
 
         virtual void semantic_analysis() {}
 
         virtual bool is_elif() { return false; }
-        virtual std::unique_ptr<top_level_expr> grab_else_if() { return nullptr; }
+        virtual node_ptr<top_level_expr> grab_else_if() { return nullptr; }
         virtual llvm::BasicBlock* get_merge_block() { return nullptr; }
         virtual void set_merge_block(llvm::BasicBlock* new_merge_block) {}
         virtual type_enum::types get_obj_type() const { return type_enum::float_type; }
-        virtual void set_line_number(int line_num) { line_number = line_num; }
-        virtual int get_line_number() { return line_number; }
+        void set_location(lexer::source_location new_location) { location = new_location; }
+        lexer::source_location get_location() const { return location; }
     };
 
     /**
-     * @par This class holds the data related to function definitions.
+     * @par Returns whether the node is a literal (int, float, char, string or bool), which are the nodes that are never analyzed or generated on their own as statements.
+     */
+    inline bool is_literal(const top_level_expr* node) {
+        return node->get_kind() >= kind_int && node->get_kind() <= kind_bool;
+    }
+
+    /**
+     * @par LLVM style casting over `node_kind`. `isa<T>()` checks a node against `T::classof()`, `dyn_cast<T>()` returns nullptr when the node is not a `T`, and `cast<T>()` is for when the kind has already been checked. None of them use RTTI or allocate.
+     * @code
+        template <typename T>
+        inline bool isa(const top_level_expr* node) { return T::classof(node); }
+
+        template <typename T>
+        inline T* dyn_cast(top_level_expr* node) { return isa<T>(node) ? static_cast<T*>(node) : nullptr; }
+
+        template <typename T>
+        inline T* cast(top_level_expr* node) { return static_cast<T*>(node); }
+     * @endcode
+     */
+    template <typename T>
+    inline bool isa(const top_level_expr* node) { return T::classof(node); }
+    template <typename T>
+    inline bool isa(const node_ptr<top_level_expr>& node) { return T::classof(node.get()); }
+
+    template <typename T>
+    inline T* dyn_cast(top_level_expr* node) { return isa<T>(node) ? static_cast<T*>(node) : nullptr; }
+    template <typename T>
+    inline const T* dyn_cast(const top_level_expr* node) { return isa<T>(node) ? static_cast<const T*>(node) : nullptr; }
+    template <typename T>
+    inline T* dyn_cast(const node_ptr<top_level_expr>& node) { return dyn_cast<T>(node.get()); }
+
+    template <typename T>
+    inline T* cast(top_level_expr* node) { return static_cast<T*>(node); }
+    template <typename T>
+    inline T* cast(const node_ptr<top_level_expr>& node) { return static_cast<T*>(node.get()); }
+
+    /**
+     * @par This class holds the data related to function definitions. `location` is where its `def` starts, which diagnostics about the function point at.
      * @code
         class func_defn {
         private:
+            lexer::source_location location = lexer::no_location;
             type_enum::types return_type;
-            std::string func_name;
-            std::vector<std::unique_ptr<top_level_expr>> expressions;
-            std::vector<std::unique_ptr<top_level_expr>>parameters;
+            interner::symbol_id func_name;
+            node_list expressions;
+            node_list parameters;
         public:
-            func_defn(type_enum::types return_type, std::string name, std::vector<std::unique_ptr<top_level_expr>> expressions, std::vector<std::unique_ptr<top_level_expr>> parameters) :
+            func_defn(type_enum::types return_type, interner::symbol_id name, node_list expressions, node_list parameters) :
                 return_type(return_type),
                 func_name(name),
                 expressions(std::move(expressions)),
                 parameters(std::move(parameters))
                 {}
 
+            void analyze_signature();
             void semantic_analysis();
             ~func_defn() = default;
             void debug_output();
             llvm::Value* codegen();
             type_enum::types get_return_type() {return return_type;}
+        interner::symbol_id get_name() const { return func_name; }
+        const node_list& get_body() const { return expressions; }
+        node_list& get_body() { return expressions; }
+        const node_list& get_parameters() const { return parameters; }
+        void set_location(lexer::source_location new_location) { location = new_location; }
+        lexer::source_location get_location() const { return location; }
     };
      * @endcode
      */
     class func_defn {
     private:
+        lexer::source_location location = lexer::no_location;
         type_enum::types return_type;
-        std::string func_name;
-        std::vector<std::unique_ptr<top_level_expr>> expressions;
-        std::vector<std::unique_ptr<top_level_expr>>parameters;
+        interner::symbol_id func_name;
+        node_list expressions;
+        node_list parameters;
     public:
         func_defn(type_enum::types return_type, 
-            std::string name, 
-            std::vector<std::unique_ptr<top_level_expr>> expressions, 
-            std::vector<std::unique_ptr<top_level_expr>> parameters
+            interner::symbol_id name, 
+            node_list expressions, 
+            node_list parameters
         ) :
             return_type(return_type),
             func_name(name),
@@ -131,11 +262,18 @@ namespace ast {
             parameters(std::move(parameters))
         {}
 
+        void analyze_signature();
         void semantic_analysis();
         ~func_defn() = default;
         void debug_output();
         llvm::Value* codegen();
         type_enum::types get_return_type() {return return_type;}
+        interner::symbol_id get_name() const { return func_name; }
+        const node_list& get_body() const { return expressions; }
+        node_list& get_body() { return expressions; }
+        const node_list& get_parameters() const { return parameters; }
+        void set_location(lexer::source_location new_location) { location = new_location; }
+        lexer::source_location get_location() const { return location; }
     };
 
     /**
@@ -145,39 +283,39 @@ namespace ast {
         class binary_expr : public top_level_expr {
         private: 
             lexer::Token_Type op;
-            std::unique_ptr<top_level_expr> left, right;
+            node_ptr<top_level_expr> left, right;
             type_enum::types type;
 
         public:
-            binary_expr(lexer::Token_Type op, std::unique_ptr<top_level_expr> left, std::unique_ptr<top_level_expr> right) :
+            binary_expr(lexer::Token_Type op, node_ptr<top_level_expr> left, node_ptr<top_level_expr> right) :
+                top_level_expr(kind_binary),
                 op(op),
                 left(std::move(left)),
                 right(std::move(right)),
                 {}
             
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "binary"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_binary; }
+            lexer::Token_Type get_op_token() const { return op; }
+            top_level_expr* get_left() const { return left.get(); }
+            top_level_expr* get_right() const { return right.get(); }
+            void set_left(node_ptr<top_level_expr> new_left) { left = std::move(new_left); }
+            void set_right(node_ptr<top_level_expr> new_right) { right = std::move(new_right); }
             type_enum::types get_expr_type() const override {return type;}
             void set_expr_type(type_enum::types new_type) override { type = new_type; }
             void debug_output();
-            char get_op() { 
+            const char* get_op() { 
                 switch (op) {
-                    case lexer::tok_plus:
-                        return '+';
-                        break;
-                    case lexer::tok_minus:
-                        return '-';
-                        break;
-                    case lexer::tok_mult:
-                        return '*';
-                        break;
-                    case lexer::tok_div:
-                        return '/';
-                        break;
+                    case lexer::tok_plus: return "+";
+                    case lexer::tok_minus: return "-";
+                    ...
+                    case lexer::tok_or: return "||";
                     default:
                         std::abort();
                 }
             }
+            bool is_comparison() const;
+            bool is_logical() const;
             llvm::Value* codegen() override;
         };
      * @endcode
@@ -185,39 +323,105 @@ namespace ast {
     class binary_expr : public top_level_expr {
     private: 
         lexer::Token_Type op;
-        std::unique_ptr<top_level_expr> left, right;
+        node_ptr<top_level_expr> left, right;
         type_enum::types type;
 
     public:
-        binary_expr(lexer::Token_Type op, std::unique_ptr<top_level_expr> left, std::unique_ptr<top_level_expr> right) :
+        binary_expr(lexer::Token_Type op, node_ptr<top_level_expr> left, node_ptr<top_level_expr> right) :
+            top_level_expr(kind_binary),
             op(op),
             left(std::move(left)),
             right(std::move(right))
             {}
         
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "binary"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_binary; }
+        lexer::Token_Type get_op_token() const { return op; }
+        top_level_expr* get_left() const { return left.get(); }
+        top_level_expr* get_right() const { return right.get(); }
+        void set_left(node_ptr<top_level_expr> new_left) { left = std::move(new_left); }
+        void set_right(node_ptr<top_level_expr> new_right) { right = std::move(new_right); }
         type_enum::types get_expr_type() const override {return type;}
         void set_expr_type(type_enum::types new_type) override { type = new_type; }
         void debug_output();
-        char get_op() { 
+        const char* get_op() { 
             switch (op) {
-                case lexer::tok_plus:
-                    return '+';
-                    break;
-                case lexer::tok_minus:
-                    return '-';
-                    break;
-                case lexer::tok_mult:
-                    return '*';
-                    break;
-                case lexer::tok_div:
-                    return '/';
-                    break;
+                case lexer::tok_plus: return "+";
+                case lexer::tok_minus: return "-";
+                case lexer::tok_mult: return "*";
+                case lexer::tok_div: return "/";
+                case lexer::tok_mod: return "%";
+                case lexer::tok_equal: return "==";
+                case lexer::tok_not_equal: return "!=";
+                case lexer::tok_less: return "<";
+                case lexer::tok_less_equal: return "<=";
+                case lexer::tok_greater: return ">";
+                case lexer::tok_greater_equal: return ">=";
+                case lexer::tok_and: return "&&";
+                case lexer::tok_or: return "||";
                 default:
                     std::abort();
             }
          }
+        bool is_comparison() const {
+            return op == lexer::tok_equal || op == lexer::tok_not_equal || op == lexer::tok_less || op == lexer::tok_less_equal || op == lexer::tok_greater || op == lexer::tok_greater_equal;
+        }
+        bool is_logical() const { return op == lexer::tok_and || op == lexer::tok_or; }
+        llvm::Value* codegen() override;
+    };
+
+    /**
+     * @par Stores a prefix operator applied to a single operand: arithmetic negation (`-`) or logical not (`!`).
+     * 
+     * @code
+        class unary_expr : public top_level_expr {
+        private: 
+            lexer::Token_Type op;
+            node_ptr<top_level_expr> operand;
+            type_enum::types type = type_enum::float_type;
+
+        public:
+            unary_expr(lexer::Token_Type op, node_ptr<top_level_expr> operand) :
+                top_level_expr(kind_unary),
+                op(op),
+                operand(std::move(operand))
+                {}
+            
+            void semantic_analysis() override;
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_unary; }
+            lexer::Token_Type get_op_token() const { return op; }
+            top_level_expr* get_operand() const { return operand.get(); }
+            void set_operand(node_ptr<top_level_expr> new_operand) { operand = std::move(new_operand); }
+            type_enum::types get_expr_type() const override {return type;}
+            void set_expr_type(type_enum::types new_type) override { type = new_type; }
+            void debug_output();
+            const char* get_op() { return (op == lexer::tok_not) ? "!" : "-"; }
+            llvm::Value* codegen() override;
+        };
+     * @endcode
+     */
+    class unary_expr : public top_level_expr {
+    private: 
+        lexer::Token_Type op;
+        node_ptr<top_level_expr> operand;
+        type_enum::types type = type_enum::float_type;
+
+    public:
+        unary_expr(lexer::Token_Type op, node_ptr<top_level_expr> operand) :
+            top_level_expr(kind_unary),
+            op(op),
+            operand(std::move(operand))
+            {}
+        
+        void semantic_analysis() override;
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_unary; }
+        lexer::Token_Type get_op_token() const { return op; }
+        top_level_expr* get_operand() const { return operand.get(); }
+        void set_operand(node_ptr<top_level_expr> new_operand) { operand = std::move(new_operand); }
+        type_enum::types get_expr_type() const override {return type;}
+        void set_expr_type(type_enum::types new_type) override { type = new_type; }
+        void debug_output();
+        const char* get_op() { return (op == lexer::tok_not) ? "!" : "-"; }
         llvm::Value* codegen() override;
     };
 
@@ -227,22 +431,26 @@ namespace ast {
      * @code
         class identifier_expr : public top_level_expr {
         private:
-            std::string identifier_name;
+            interner::symbol_id identifier_name;
             type_enum::types type;
-            bool is_global;
+            bool is_global = false;
+            variable_slot slot = no_slot;
 
         public:
-            identifier_expr(const std::string& identifier_name) :
+            identifier_expr(interner::symbol_id identifier_name) :
+                top_level_expr(kind_identifier),
                 identifier_name(identifier_name)
                 {}
             
             void set_is_global(bool global) {is_global = global;}
             bool get_is_global() {return is_global;}
+            void set_slot(variable_slot new_slot) { slot = new_slot; }
+            variable_slot get_slot() const { return slot; }
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "identifier"; }   
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_identifier; }   
             void set_expr_type(type_enum::types new_type) override { type = new_type; }
             type_enum::types get_expr_type() const override {return type;}
-            std::string get_name() const override {return identifier_name;}
+            interner::symbol_id get_name() const override {return identifier_name;}
             void debug_output();
             llvm::Value* codegen() override;
 
@@ -251,22 +459,26 @@ namespace ast {
      */
     class identifier_expr : public top_level_expr {
     private:
-        std::string identifier_name;
+        interner::symbol_id identifier_name;
         type_enum::types type;
-        bool is_global;
+        bool is_global = false;
+        variable_slot slot = no_slot;
 
     public:
-        identifier_expr(const std::string& identifier_name) :
+        identifier_expr(interner::symbol_id identifier_name) :
+            top_level_expr(kind_identifier),
             identifier_name(identifier_name)
             {}
 
         void set_is_global(bool global) {is_global = global;}
         bool get_is_global() {return is_global;}
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "identifier"; }   
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_identifier; }   
         void set_expr_type(type_enum::types new_type) override { type = new_type; }
         type_enum::types get_expr_type() const override {return type;}
-        std::string get_name() const override {return identifier_name;}
+        interner::symbol_id get_name() const override {return identifier_name;}
         void debug_output();
         llvm::Value* codegen() override;
 
@@ -282,8 +494,8 @@ namespace ast {
             type_enum::types type = type_enum::int_type;
 
         public:
-            integer_expression(int held_value) : held_value(held_value) {}
-            std::string get_ast_class() const override { return "int"; }
+            integer_expression(int held_value) : top_level_expr(kind_int), held_value(held_value) {}
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_int; }
             const int get_value() const {return held_value;}
             void debug_output();
             type_enum::types get_expr_type() const override {return type;}
@@ -297,8 +509,8 @@ namespace ast {
         type_enum::types type = type_enum::int_type;
 
     public:
-        integer_expression(int held_value) : held_value(held_value) {}
-        std::string get_ast_class() const override { return "int"; }
+        integer_expression(int held_value) : top_level_expr(kind_int), held_value(held_value) {}
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_int; }
         const int get_value() const {return held_value;}
         void debug_output();
         type_enum::types get_expr_type() const override {return type;}
@@ -311,13 +523,13 @@ namespace ast {
      * @code
         class float_expression : public top_level_expr {
         private:
-            float held_value;
+            double held_value;
             type_enum::types type = type_enum::float_type;
 
         public:
-            float_expression(float held_value) : held_value(held_value) {}
-            std::string get_ast_class() const override { return "float"; }
-            const float get_value() const {return held_value;}
+            float_expression(double held_value) : top_level_expr(kind_float), held_value(held_value) {}
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_float; }
+            const double get_value() const {return held_value;}
             void debug_output();
             type_enum::types get_expr_type() const override {return type;}
             llvm::Value* codegen() override;
@@ -326,13 +538,13 @@ namespace ast {
      */
     class float_expression : public top_level_expr {
     private:
-        float held_value;
+        double held_value;
         type_enum::types type = type_enum::float_type;
 
     public:
-        float_expression(float held_value) : held_value(held_value) {}
-        std::string get_ast_class() const override { return "float"; }
-        const float get_value() const {return held_value;}
+        float_expression(double held_value) : top_level_expr(kind_float), held_value(held_value) {}
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_float; }
+        const double get_value() const {return held_value;}
         void debug_output();
         type_enum::types get_expr_type() const override {return type;}
         llvm::Value* codegen() override;
@@ -348,8 +560,8 @@ namespace ast {
             type_enum::types type = type_enum::char_type;
 
         public:
-            char_expression(char held_value) : held_value(held_value) {}
-            std::string get_ast_class() const override { return "char"; }
+            char_expression(char held_value) : top_level_expr(kind_char), held_value(held_value) {}
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_char; }
             const char get_value() const {return held_value;}
             void debug_output();
             type_enum::types get_expr_type() const override {return type;}
@@ -363,8 +575,8 @@ namespace ast {
         type_enum::types type = type_enum::char_type;
 
     public:
-        char_expression(char held_value) : held_value(held_value) {}
-        std::string get_ast_class() const override { return "char"; }
+        char_expression(char held_value) : top_level_expr(kind_char), held_value(held_value) {}
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_char; }
         const char get_value() const {return held_value;}
         void debug_output();
         type_enum::types get_expr_type() const override {return type;}
@@ -377,13 +589,13 @@ namespace ast {
      * @code
         class string_expression : public top_level_expr {
         private:
-            std::string held_value;
+            std::string_view held_value;
             type_enum::types type = type_enum::string_type;
 
         public:
-            string_expression(std::string held_value) : held_value(held_value) {}
-            std::string get_ast_class() const override { return "string"; }
-            const std::string& get_value() const {return held_value;}
+            string_expression(std::string_view held_value) : top_level_expr(kind_string), held_value(arena::copy_string(held_value)) {}
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_string; }
+            std::string_view get_value() const {return held_value;}
             void debug_output();
             type_enum::typess get_expr_type() const override {return type;}
             llvm::Value* codegen() override;
@@ -392,13 +604,13 @@ namespace ast {
      */
     class string_expression : public top_level_expr {
     private:
-        std::string held_value;
+        std::string_view held_value;
         type_enum::types type = type_enum::string_type;
 
     public:
-        string_expression(std::string held_value) : held_value(held_value) {}
-        std::string get_ast_class() const override { return "string"; }
-        const std::string& get_value() const {return held_value;}
+        string_expression(std::string_view held_value) : top_level_expr(kind_string), held_value(arena::copy_string(held_value)) {}
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_string; }
+        std::string_view get_value() const {return held_value;}
         void debug_output();
         type_enum::types get_expr_type() const override {return type;}
         llvm::Value* codegen() override;
@@ -414,8 +626,8 @@ namespace ast {
             type_enum::types type = bool_type;
 
         public:
-            bool_expression(bool held_value) : held_value(held_value) {}
-            std::string get_ast_class() const override { return "bool"; }
+            bool_expression(bool held_value) : top_level_expr(kind_bool), held_value(held_value) {}
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_bool; }
             const bool get_value() const {return held_value;}
             void debug_output();
             type_enum::types get_expr_type() const override {return type;}
@@ -429,8 +641,8 @@ namespace ast {
         type_enum::types type = type_enum::bool_type;
 
     public:
-        bool_expression(bool held_value) : held_value(held_value) {}
-        std::string get_ast_class() const override { return "bool"; }
+        bool_expression(bool held_value) : top_level_expr(kind_bool), held_value(held_value) {}
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_bool; }
         const bool get_value() const {return held_value;}
         void debug_output();
         type_enum::types get_expr_type() const override {return type;}
@@ -454,20 +666,24 @@ namespace ast {
         class variable_declaration : public top_level_expr {
         private:
             type_enum::types type;
-            std::string identifier_name;
-            bool is_global;
+            interner::symbol_id identifier_name;
+            bool is_global = false;
+            variable_slot slot = no_slot;
 
         public:
-            variable_declaration(type_enum::types var_type, const std::string& identifier_name) :
+            variable_declaration(type_enum::types var_type, interner::symbol_id identifier_name) :
+                top_level_expr(kind_var_decl),
                 type(var_type),
                 identifier_name(identifier_name)
                 {}
             void set_is_global(bool global) {is_global = global;}
             bool get_is_global() {return is_global;}
+            void set_slot(variable_slot new_slot) { slot = new_slot; }
+            variable_slot get_slot() const { return slot; }
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "var_decl"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_var_decl; }
             type_enum::types get_expr_type() const override {return type;} 
-            std::string get_name() const override {return identifier_name;}
+            interner::symbol_id get_name() const override {return identifier_name;}
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -476,20 +692,24 @@ namespace ast {
     class variable_declaration : public top_level_expr {
     private:
         type_enum::types type;
-        std::string identifier_name;
-        bool is_global;
+        interner::symbol_id identifier_name;
+        bool is_global = false;
+        variable_slot slot = no_slot;
 
     public:
-        variable_declaration(type_enum::types var_type, const std::string& identifier_name) :
+        variable_declaration(type_enum::types var_type, interner::symbol_id identifier_name) :
+            top_level_expr(kind_var_decl),
             type(var_type),
             identifier_name(identifier_name)
             {}
         void set_is_global(bool global) {is_global = global;}
         bool get_is_global() {return is_global;}
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "var_decl"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_var_decl; }
         type_enum::types get_expr_type() const override {return type;} 
-        std::string get_name() const override {return identifier_name;}
+        interner::symbol_id get_name() const override {return identifier_name;}
         void debug_output();
         llvm::Value* codegen() override;
     };
@@ -501,22 +721,28 @@ namespace ast {
         class variable_definition : public top_level_expr {
         private:
             type_enum::types type;
-            std::string identifier_name;
-            std::unique_ptr<top_level_expr> assigned_value;
-            bool is_global;
+            interner::symbol_id identifier_name;
+            node_ptr<top_level_expr> assigned_value;
+            bool is_global = false;
+            variable_slot slot = no_slot;
 
         public:
-            variable_definition(type_enum::types var_type, const std::string& identifier_name, std::unique_ptr<top_level_expr> assigned_value) :
+            variable_definition(type_enum::types var_type, interner::symbol_id identifier_name, node_ptr<top_level_expr> assigned_value) :
+                top_level_expr(kind_var_defn),
                 type(var_type),
                 identifier_name(identifier_name),
                 assigned_value(std::move(assigned_value))
                 {}
             void set_is_global(bool global) {is_global = global;}
             bool get_is_global() {return is_global;}
+            void set_slot(variable_slot new_slot) { slot = new_slot; }
+            variable_slot get_slot() const { return slot; }
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "var_defn"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_var_defn; }
+            top_level_expr* get_assigned_value() const { return assigned_value.get(); }
+            void set_assigned_value(node_ptr<top_level_expr> new_value) { assigned_value = std::move(new_value); }
             type_enum::types get_expr_type() const override {return type;} 
-            std::string get_name() const override {return identifier_name;}
+            interner::symbol_id get_name() const override {return identifier_name;}
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -525,12 +751,14 @@ namespace ast {
     class variable_definition : public top_level_expr {
     private:
         type_enum::types type;
-        std::string identifier_name;
-        std::unique_ptr<top_level_expr> assigned_value;
-        bool is_global;
+        interner::symbol_id identifier_name;
+        node_ptr<top_level_expr> assigned_value;
+        bool is_global = false;
+        variable_slot slot = no_slot;
 
     public:
-        variable_definition(type_enum::types var_type, const std::string& identifier_name, std::unique_ptr<top_level_expr> assigned_value) :
+        variable_definition(type_enum::types var_type, interner::symbol_id identifier_name, node_ptr<top_level_expr> assigned_value) :
+            top_level_expr(kind_var_defn),
             type(var_type),
             identifier_name(identifier_name),
             assigned_value(std::move(assigned_value))
@@ -538,10 +766,14 @@ namespace ast {
         
         void set_is_global(bool global) {is_global = global;}
         bool get_is_global() {return is_global;}
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "var_defn"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_var_defn; }
+        top_level_expr* get_assigned_value() const { return assigned_value.get(); }
+        void set_assigned_value(node_ptr<top_level_expr> new_value) { assigned_value = std::move(new_value); }
         type_enum::types get_expr_type() const override {return type;} 
-        std::string get_name() const override {return identifier_name;}
+        interner::symbol_id get_name() const override {return identifier_name;}
         void debug_output();
         llvm::Value* codegen() override;
     };
@@ -552,21 +784,27 @@ namespace ast {
      * @code
         class variable_assignment : public top_level_expr {
         private:
-            std::string identifier_name;
-            std::unique_ptr<top_level_expr> assigned_value;
-            bool is_global;
+            interner::symbol_id identifier_name;
+            node_ptr<top_level_expr> assigned_value;
+            bool is_global = false;
+            variable_slot slot = no_slot;
 
         public:
-            variable_assignment(type_enum::types var_type, const std::string& identifier_name, std::unique_ptr<top_level_expr> assigned_value) :
+            variable_assignment(type_enum::types var_type, interner::symbol_id identifier_name, node_ptr<top_level_expr> assigned_value) :
+                top_level_expr(kind_var_assign),
                 identifier_name(identifier_name),
                 assigned_value(std::move(assigned_value))
                 {}
 
             void set_is_global(bool global) {is_global = global;}
             bool get_is_global() {return is_global;}
+            void set_slot(variable_slot new_slot) { slot = new_slot; }
+            variable_slot get_slot() const { return slot; }
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "var_assign"; }
-            std::string get_name() const override {return identifier_name;}
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_var_assign; }
+            top_level_expr* get_assigned_value() const { return assigned_value.get(); }
+            void set_assigned_value(node_ptr<top_level_expr> new_value) { assigned_value = std::move(new_value); }
+            interner::symbol_id get_name() const override {return identifier_name;}
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -574,21 +812,27 @@ namespace ast {
      */
     class variable_assignment : public top_level_expr {
     private:
-        std::string identifier_name;
-        std::unique_ptr<top_level_expr> assigned_value;
-        bool is_global;
+        interner::symbol_id identifier_name;
+        node_ptr<top_level_expr> assigned_value;
+        bool is_global = false;
+        variable_slot slot = no_slot;
 
     public:
-        variable_assignment(const std::string& identifier_name, std::unique_ptr<top_level_expr> assigned_value) :
+        variable_assignment(interner::symbol_id identifier_name, node_ptr<top_level_expr> assigned_value) :
+            top_level_expr(kind_var_assign),
             identifier_name(identifier_name),
             assigned_value(std::move(assigned_value))
             {}
 
         void set_is_global(bool global) {is_global = global;}
         bool get_is_global() {return is_global;}
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "var_assign"; }
-        std::string get_name() const override {return identifier_name;}
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_var_assign; }
+        top_level_expr* get_assigned_value() const { return assigned_value.get(); }
+        void set_assigned_value(node_ptr<top_level_expr> new_value) { assigned_value = std::move(new_value); }
+        interner::symbol_id get_name() const override {return identifier_name;}
         void debug_output();
         llvm::Value* codegen() override;
     };
@@ -598,16 +842,19 @@ namespace ast {
      * @code
         class return_expr : public top_level_expr {
         private:
-            std::unique_ptr<top_level_expr> returned_value;
+            node_ptr<top_level_expr> returned_value;
             type_enum::types type;
         public:
-            return_expr(std::unique_ptr<top_level_expr> return_val) : 
+            return_expr(node_ptr<top_level_expr> return_val) :
+                top_level_expr(kind_return),
                 returned_value(std::move(return_val)) 
                 {}
             void semantic_analysis() override;
             type_enum::types get_expr_type() const override {return type;} 
             void set_expr_type(type_enum::types new_type) override { type = new_type; }
-            std::string get_ast_class() const override { return "return"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_return; }
+            top_level_expr* get_returned_value() const { return returned_value.get(); }
+            void set_returned_value(node_ptr<top_level_expr> new_value) { returned_value = std::move(new_value); }
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -615,17 +862,20 @@ namespace ast {
      */
     class return_expr : public top_level_expr {
     private:
-        std::unique_ptr<top_level_expr> returned_value;
+        node_ptr<top_level_expr> returned_value;
         type_enum::types type;
     
     public:
-        return_expr(std::unique_ptr<top_level_expr> return_val) : 
+        return_expr(node_ptr<top_level_expr> return_val) :
+            top_level_expr(kind_return),
             returned_value(std::move(return_val)) 
             {}
         void semantic_analysis() override;
         type_enum::types get_expr_type() const override {return type;} 
         void set_expr_type(type_enum::types new_type) override { type = new_type; }
-        std::string get_ast_class() const override { return "return"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_return; }
+        top_level_expr* get_returned_value() const { return returned_value.get(); }
+        void set_returned_value(node_ptr<top_level_expr> new_value) { returned_value = std::move(new_value); }
         void debug_output();
         llvm::Value* codegen() override;
     };
@@ -635,18 +885,26 @@ namespace ast {
      * @code
      *  class if_expr : public top_level_expr {
         private:
-            std::unique_ptr<top_level_expr> condition;
-            std::vector<std::unique_ptr<top_level_expr>> expressions;
-            std::unique_ptr<top_level_expr> else_stmt;
+            node_ptr<top_level_expr> condition;
+            node_list expressions;
+            node_ptr<top_level_expr> else_stmt;
         
         public:
-            if_expr(std::unique_ptr<top_level_expr> condition, std::vector<std::unique_ptr<top_level_expr>> expressions, std::unique_ptr<top_level_expr> else_stmt) :
+            if_expr(node_ptr<top_level_expr> condition, node_list expressions, node_ptr<top_level_expr> else_stmt) :
+                top_level_expr(kind_if),
                 condition(std::move(condition)),
                 expressions(std::move(expressions)),
                 else_stmt(std::move(else_stmt))
                 {}
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "if"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_if; }
+            top_level_expr* get_condition() const { return condition.get(); }
+            const node_list& get_body() const { return expressions; }
+            node_list& get_body() { return expressions; }
+            top_level_expr* get_else() const { return else_stmt.get(); }
+            void set_condition(node_ptr<top_level_expr> new_condition) { condition = std::move(new_condition); }
+            void set_else(node_ptr<top_level_expr> new_else) { else_stmt = std::move(new_else); }
+            node_ptr<top_level_expr> take_else() { return std::move(else_stmt); }
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -654,19 +912,27 @@ namespace ast {
      */
     class if_expr : public top_level_expr {
     private:
-        std::unique_ptr<top_level_expr> condition;
-        std::vector<std::unique_ptr<top_level_expr>> expressions;
-        std::unique_ptr<top_level_expr> else_stmt;
-        llvm::BasicBlock* merge_block;
+        node_ptr<top_level_expr> condition;
+        node_list expressions;
+        node_ptr<top_level_expr> else_stmt;
+        llvm::BasicBlock* merge_block = nullptr; // set by the enclosing if when this is an else if
     
     public:
-        if_expr(std::unique_ptr<top_level_expr> condition, std::vector<std::unique_ptr<top_level_expr>> expressions, std::unique_ptr<top_level_expr> else_stmt) :
+        if_expr(node_ptr<top_level_expr> condition, node_list expressions, node_ptr<top_level_expr> else_stmt) :
+            top_level_expr(kind_if),
             condition(std::move(condition)),
             expressions(std::move(expressions)),
             else_stmt(std::move(else_stmt))
             {}
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "if"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_if; }
+        top_level_expr* get_condition() const { return condition.get(); }
+        const node_list& get_body() const { return expressions; }
+        node_list& get_body() { return expressions; }
+        top_level_expr* get_else() const { return else_stmt.get(); }
+        void set_condition(node_ptr<top_level_expr> new_condition) { condition = std::move(new_condition); }
+        void set_else(node_ptr<top_level_expr> new_else) { else_stmt = std::move(new_else); }
+        node_ptr<top_level_expr> take_else() { return std::move(else_stmt); }
         void debug_output();
         llvm::Value* codegen() override;
         llvm::BasicBlock* get_merge_block() override { return merge_block; }
@@ -678,40 +944,46 @@ namespace ast {
      * @code
         class else_expr : public top_level_expr {
         private:
-            std::vector<std::unique_ptr<top_level_expr>> expressions;
+            node_list expressions;
             bool is_else_if;
         
         public:
-            else_expr(std::vector<std::unique_ptr<top_level_expr>> expressions, bool is_else_if) :
+            else_expr(node_list expressions, bool is_else_if) :
+                top_level_expr(kind_else),
                 expressions(std::move(expressions)),
                 is_else_if(is_else_if)
                 {}
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "else"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_else; }
+            const node_list& get_body() const { return expressions; }
+            node_list& get_body() { return expressions; }
             void debug_output();
             llvm::Value* codegen() override;
             bool is_elif() override { return is_else_if; }
-            std::unique_ptr<top_level_expr> grab_else_if() override { return std::move(expressions.at(0)); }
+            node_ptr<top_level_expr> grab_else_if() override { return std::move(expressions.at(0)); }
 
         };
      * @endcode
      */
     class else_expr : public top_level_expr {
     private:
-        std::vector<std::unique_ptr<top_level_expr>> expressions;
+        node_list expressions;
         bool is_else_if;
     
     public:
-        else_expr(std::vector<std::unique_ptr<top_level_expr>> expressions, bool is_else_if) :
+        else_expr(node_list expressions, bool is_else_if) :
+            top_level_expr(kind_else),
             expressions(std::move(expressions)),
             is_else_if(is_else_if)
             {}
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "else"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_else; }
+        const node_list& get_body() const { return expressions; }
+        node_list& get_body() { return expressions; }
         void debug_output();
         llvm::Value* codegen() override;
         bool is_elif() override { return is_else_if; }
-        std::unique_ptr<top_level_expr> grab_else_if() override { return std::move(expressions.at(0)); }
+        node_ptr<top_level_expr> grab_else_if() override { return std::move(expressions.at(0)); }
 
     };
 
@@ -720,23 +992,29 @@ namespace ast {
      * @code
         class for_expr : public top_level_expr {
         private:
-            std::vector<std::unique_ptr<top_level_expr>> expressions;
-            std::unique_ptr<ast::top_level_expr> variable_defn;
-            std::unique_ptr<ast::top_level_expr> condition;
-            std::unique_ptr<ast::top_level_expr> var_modification;
+            node_list expressions;
+            node_ptr<top_level_expr> variable_defn;
+            node_ptr<top_level_expr> condition;
+            node_ptr<top_level_expr> var_modification;
 
         public:
-            for_expr(std::vector<std::unique_ptr<top_level_expr>> expressions, 
-                std::unique_ptr<ast::top_level_expr> variable_defn,
-                std::unique_ptr<ast::top_level_expr> condition,
-                std::unique_ptr<ast::top_level_expr> var_modification) :
+            for_expr(node_list expressions, 
+                node_ptr<top_level_expr> variable_defn,
+                node_ptr<top_level_expr> condition,
+                node_ptr<top_level_expr> var_modification) :
+                top_level_expr(kind_for),
                 expressions(std::move(expressions)),
                 variable_defn(std::move(variable_defn)),
                 condition(std::move(condition)),
                 var_modification(std::move(var_modification))
                 {}
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "for"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_for; }
+            const node_list& get_body() const { return expressions; }
+            node_list& get_body() { return expressions; }
+            top_level_expr* get_variable_defn() const { return variable_defn.get(); }
+            top_level_expr* get_condition() const { return condition.get(); }
+            top_level_expr* get_var_modification() const { return var_modification.get(); }
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -744,23 +1022,29 @@ namespace ast {
      */
     class for_expr : public top_level_expr {
     private:
-        std::vector<std::unique_ptr<top_level_expr>> expressions;
-        std::unique_ptr<ast::top_level_expr> variable_defn;
-        std::unique_ptr<ast::top_level_expr> condition;
-        std::unique_ptr<ast::top_level_expr> var_modification;
+        node_list expressions;
+        node_ptr<top_level_expr> variable_defn;
+        node_ptr<top_level_expr> condition;
+        node_ptr<top_level_expr> var_modification;
 
     public:
-        for_expr(std::vector<std::unique_ptr<top_level_expr>> expressions, 
-            std::unique_ptr<ast::top_level_expr> variable_defn,
-            std::unique_ptr<ast::top_level_expr> condition,
-            std::unique_ptr<ast::top_level_expr> var_modification) :
+        for_expr(node_list expressions, 
+            node_ptr<top_level_expr> variable_defn,
+            node_ptr<top_level_expr> condition,
+            node_ptr<top_level_expr> var_modification) :
+            top_level_expr(kind_for),
             expressions(std::move(expressions)),
             variable_defn(std::move(variable_defn)),
             condition(std::move(condition)),
             var_modification(std::move(var_modification))
             {}
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "for"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_for; }
+        const node_list& get_body() const { return expressions; }
+        node_list& get_body() { return expressions; }
+        top_level_expr* get_variable_defn() const { return variable_defn.get(); }
+        top_level_expr* get_condition() const { return condition.get(); }
+        top_level_expr* get_var_modification() const { return var_modification.get(); }
         void debug_output();
         llvm::Value* codegen() override;
     };
@@ -770,19 +1054,23 @@ namespace ast {
      * @code
         class func_call_expr : public top_level_expr {
         private:
-            std::string func_name;
-            std::vector<std::unique_ptr<top_level_expr>> arguments;
+            interner::symbol_id func_name;
+            node_list arguments;
             type_enum::types type;
 
         public:
-            func_call_expr(std::string func_name, std::vector<std::unique_ptr<top_level_expr>> args) :
+            func_call_expr(interner::symbol_id func_name, node_list args) :
+                top_level_expr(kind_func_call),
                 func_name(func_name),
                 arguments(std::move(args))
                 {}
             void semantic_analysis() override;
             type_enum::types get_expr_type() const override {return type;}
             void set_expr_type(type_enum::types new_type) override { type = new_type; }
-            std::string get_ast_class() const override { return "func_call"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_func_call; }
+            interner::symbol_id get_name() const override { return func_name; }
+            const node_list& get_arguments() const { return arguments; }
+            node_list& get_arguments() { return arguments; }
             void debug_output();
             llvm::Value* codegen() override;
 
@@ -791,19 +1079,23 @@ namespace ast {
      */
     class func_call_expr : public top_level_expr {
     private:
-        std::string func_name;
-        std::vector<std::unique_ptr<top_level_expr>> arguments;
+        interner::symbol_id func_name;
+        node_list arguments;
         type_enum::types type;
 
     public:
-        func_call_expr(std::string func_name, std::vector<std::unique_ptr<top_level_expr>> args) :
+        func_call_expr(interner::symbol_id func_name, node_list args) :
+            top_level_expr(kind_func_call),
             func_name(func_name),
             arguments(std::move(args))
             {}
         void semantic_analysis() override;
         type_enum::types get_expr_type() const override {return type;}
         void set_expr_type(type_enum::types new_type) override { type = new_type; }
-        std::string get_ast_class() const override { return "func_call"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_func_call; }
+        interner::symbol_id get_name() const override { return func_name; }
+        const node_list& get_arguments() const { return arguments; }
+        node_list& get_arguments() { return arguments; }
         void debug_output();
         llvm::Value* codegen() override;
 
@@ -815,14 +1107,17 @@ namespace ast {
      * @code
         class print_expr : public top_level_expr {
         private:
-            std::unique_ptr<top_level_expr> expression;
+            node_ptr<top_level_expr> expression;
 
         public:
-            print_expr(std::unique_ptr<top_level_expr> expression) :
+            print_expr(node_ptr<top_level_expr> expression) :
+                top_level_expr(kind_print),
                 expression(std::move(expression))
                 {}
             void semantic_analysis() override; 
-            std::string get_ast_class() const override { return "print"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_print; }
+            top_level_expr* get_expression() const { return expression.get(); }
+            void set_expression(node_ptr<top_level_expr> new_expression) { expression = std::move(new_expression); }
             void debug_output();
             llvm::Value* codegen() override;
         };
@@ -830,14 +1125,17 @@ namespace ast {
      */
     class print_expr : public top_level_expr {
     private:
-        std::unique_ptr<top_level_expr> expression;
+        node_ptr<top_level_expr> expression;
 
     public:
-        print_expr(std::unique_ptr<top_level_expr> expression) :
+        print_expr(node_ptr<top_level_expr> expression) :
+            top_level_expr(kind_print),
             expression(std::move(expression))
             {}
         void semantic_analysis() override; 
-        std::string get_ast_class() const override { return "print"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_print; }
+        top_level_expr* get_expression() const { return expression.get(); }
+        void set_expression(node_ptr<top_level_expr> new_expression) { expression = std::move(new_expression); }
         void debug_output();
         llvm::Value* codegen() override;
     };
@@ -848,15 +1146,19 @@ namespace ast {
         class graph_decl_expr : public top_level_expr {
         private:
             type_enum::types type;
-            std::string graph_name;
+            interner::symbol_id graph_name;
+            variable_slot slot = no_slot;
 
         public:
-            else_expr(type_enum::types type, std::string graph_name) :
+            else_expr(type_enum::types type, interner::symbol_id graph_name) :
                 type(type),
                 name(name)
                 {}
+            void set_slot(variable_slot new_slot) { slot = new_slot; }
+            variable_slot get_slot() const { return slot; }
             void semantic_analysis() override;
-            std::string get_ast_class() const override { return "graph_decl"; }
+            static bool classof(const top_level_expr* node) { return node->get_kind() == kind_graph_decl; }
+            interner::symbol_id get_name() const override { return graph_name; }
             void debug_output();
             llvm::Value* codegen() override;
             type_enum::types get_expr_type() const override {return type;}
@@ -866,15 +1168,20 @@ namespace ast {
     class graph_decl_expr : public top_level_expr {
     private:
         type_enum::types type;
-        std::string graph_name;
+        interner::symbol_id graph_name;
+        variable_slot slot = no_slot;
 
     public:
-        graph_decl_expr(type_enum::types type, std::string graph_name) :
+        graph_decl_expr(type_enum::types type, interner::symbol_id graph_name) :
+            top_level_expr(kind_graph_decl),
             type(type),
             graph_name(graph_name)
             {}
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "graph_decl"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_graph_decl; }
+        interner::symbol_id get_name() const override { return graph_name; }
         void debug_output();
         llvm::Value* codegen() override;
         type_enum::types get_expr_type() const override {return type;}
@@ -886,15 +1193,20 @@ namespace ast {
     class list_decl : public top_level_expr {
     private:
         type_enum::types type;
-        std::string name;
+        interner::symbol_id name;
+        variable_slot slot = no_slot;
     
     public:
-        list_decl(type_enum::types type, std::string name) :
+        list_decl(type_enum::types type, interner::symbol_id name) :
+            top_level_expr(kind_list_decl),
             type(type),
             name(name)
             {}
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "list_decl"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_list_decl; }
+        interner::symbol_id get_name() const override { return name; }
         void debug_output();
         llvm::Value* codegen() override;
         type_enum::types get_expr_type() const override {return type;}
@@ -902,33 +1214,45 @@ namespace ast {
     
 
     /**
-     * TODO: docs
+     * @par Stores a call of a method on a standard library object, e.g. `my_list.add(2, 0)`. Semantic analysis resolves `callee`, the function implementing the method for the object's type; nodes read back from the AST cache are resolved by codegen instead.
      */
     class method_dot_call : public top_level_expr {
     private:
-        std::string item_name;
-        std::string called;
-        type_enum::types obj_type;
-        type_enum::types type;
+        interner::symbol_id item_name;
+        interner::symbol_id called;
+        type_enum::types obj_type = type_enum::void_type;
+        type_enum::types type = type_enum::void_type;
         bool is_class;
-        std::vector<std::unique_ptr<top_level_expr>> args;
-        std::string aggregate_type;
+        node_list args;
+        interner::symbol_id aggregate_type = interner::no_symbol;
+        variable_slot slot = no_slot;
+        llvm::Function* callee = nullptr;
 
     public:
-        method_dot_call(std::string item_name, std::string called, std::vector<std::unique_ptr<top_level_expr>> args) :
+        method_dot_call(interner::symbol_id item_name, interner::symbol_id called, node_list args) :
+            top_level_expr(kind_method_dot_call),
             item_name(item_name),
             called(called),
             args(std::move(args))
             {}
 
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "function_dot_call"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_method_dot_call; }
+        interner::symbol_id get_item_name() const { return item_name; }
+        interner::symbol_id get_called() const { return called; }
+        const node_list& get_arguments() const { return args; }
+        node_list& get_arguments() { return args; }
         void debug_output();
         void set_is_class(bool is_class) { is_class = is_class; }
         bool get_is_class() { return is_class; }
-        void set_aggregate_type(const std::string &ag_type) { aggregate_type = ag_type; }
-        const std::string& get_ag_type() { return aggregate_type; }
+        void set_aggregate_type(interner::symbol_id ag_type) { aggregate_type = ag_type; }
+        interner::symbol_id get_ag_type() { return aggregate_type; }
+        void set_obj_type(type_enum::types new_obj_type) { obj_type = new_obj_type; }
+        void set_slot(variable_slot new_slot) { slot = new_slot; }
+        variable_slot get_slot() const { return slot; }
+        void set_callee(llvm::Function* function) { callee = function; }
         llvm::Value* codegen() override;
+        void set_expr_type(type_enum::types new_type) override { type = new_type; }
         type_enum::types get_expr_type() const override {return type;}   
         type_enum::types get_obj_type() const override { return obj_type; }    
 
@@ -938,19 +1262,22 @@ namespace ast {
      * TODO: docs
      */
     class dot_call_var : public top_level_expr {
-        std::string item_name;
-        std::string called;
+        interner::symbol_id item_name;
+        interner::symbol_id called;
         type_enum::types type;
         bool is_class;
 
     public:
-        dot_call_var(std::string item_name, std::string called) :
+        dot_call_var(interner::symbol_id item_name, interner::symbol_id called) :
+            top_level_expr(kind_dot_call_var),
             item_name(item_name),
             called(called)
             {}
 
         void semantic_analysis() override;
-        std::string get_ast_class() const override { return "dot_call_var"; }
+        static bool classof(const top_level_expr* node) { return node->get_kind() == kind_dot_call_var; }
+        interner::symbol_id get_item_name() const { return item_name; }
+        interner::symbol_id get_called() const { return called; }
         void debug_output();
         void set_is_class(bool is_class) { is_class = is_class; }
         bool get_is_class() { return is_class; }
@@ -958,6 +1285,165 @@ namespace ast {
         type_enum::types get_expr_type() const override {return type;}   
     };
     
+    /**
+     * @par Sets and reads the slot of a function parameter, which is parsed as a variable declaration (or a definition).
+     */
+    inline void set_parameter_slot(top_level_expr* parameter, variable_slot slot) {
+        if (parameter->get_kind() == kind_var_decl) {
+            cast<variable_declaration>(parameter)->set_slot(slot);
+        } else if (parameter->get_kind() == kind_var_defn) {
+            cast<variable_definition>(parameter)->set_slot(slot);
+        }
+    }
+
+    inline variable_slot get_parameter_slot(top_level_expr* parameter) {
+        if (parameter->get_kind() == kind_var_decl) {
+            return cast<variable_declaration>(parameter)->get_slot();
+        } else if (parameter->get_kind() == kind_var_defn) {
+            return cast<variable_definition>(parameter)->get_slot();
+        }
+        return no_slot;
+    }
+
+    /**
+     * @par Calls `visit` on every direct child of `node` in source order, skipping the children that are absent (such as the value of a bare `return;`). Passes that need to reach every node of a tree use this rather than each reimplementing the per kind layout.
+     * @code
+        switch (node->get_kind()) {
+            case kind_binary:
+                visit(cast<binary_expr>(node)->get_left());
+                visit(cast<binary_expr>(node)->get_right());
+                break;
+            ...
+            case kind_if: {
+                if_expr* if_node = cast<if_expr>(node);
+                visit(if_node->get_condition());
+                for (const node_ptr<top_level_expr>& child : if_node->get_body()) {
+                    visit(child.get());
+                }
+                if (if_node->get_else() != nullptr) {
+                    visit(if_node->get_else());
+                }
+                break;
+            }
+            ...
+            default: // literals, identifiers and declarations have no children
+                break;
+        }
+     * @endcode
+     */
+    template <typename Visit>
+    inline void for_each_child(top_level_expr* node, Visit&& visit) {
+        auto visit_optional = [&](top_level_expr* child) {
+            if (child != nullptr) {
+                visit(child);
+            }
+        };
+        auto visit_list = [&](const node_list& children) {
+            for (const node_ptr<top_level_expr>& child : children) {
+                visit(child.get());
+            }
+        };
+
+        switch (node->get_kind()) {
+            case kind_binary:
+                visit(cast<binary_expr>(node)->get_left());
+                visit(cast<binary_expr>(node)->get_right());
+                break;
+            case kind_unary:
+                visit(cast<unary_expr>(node)->get_operand());
+                break;
+            case kind_var_defn:
+                visit(cast<variable_definition>(node)->get_assigned_value());
+                break;
+            case kind_var_assign:
+                visit(cast<variable_assignment>(node)->get_assigned_value());
+                break;
+            case kind_return:
+                visit_optional(cast<return_expr>(node)->get_returned_value());
+                break;
+            case kind_if: {
+                if_expr* if_node = cast<if_expr>(node);
+                visit(if_node->get_condition());
+                visit_list(if_node->get_body());
+                visit_optional(if_node->get_else());
+                break;
+            }
+            case kind_else:
+                visit_list(cast<else_expr>(node)->get_body());
+                break;
+            case kind_for: {
+                for_expr* for_node = cast<for_expr>(node);
+                visit_optional(for_node->get_variable_defn());
+                visit_optional(for_node->get_condition());
+                visit_optional(for_node->get_var_modification());
+                visit_list(for_node->get_body());
+                break;
+            }
+            case kind_func_call:
+                visit_list(cast<func_call_expr>(node)->get_arguments());
+                break;
+            case kind_print:
+                visit(cast<print_expr>(node)->get_expression());
+                break;
+            case kind_method_dot_call:
+                visit_list(cast<method_dot_call>(node)->get_arguments());
+                break;
+            default: // literals, identifiers and declarations have no children
+                break;
+        }
+    }
+
+    /**
+     * @par Walks the operator tree rooted at `root` (its unary and binary nodes, down to the first node that is not an operator on every path) in post-order, left operand first, without recursing, so an expression nested hundreds of thousands deep cannot overflow the call stack.
+     * `operand(node)` is called for every node below the operators that is not an operator itself, and `combine(node)` for every operator once everything under it has been visited, which is the order a recursive walk would visit them in.
+     * @code
+        stack.push_back({root, false});
+        while (stack.size() > base) {
+            pending current = stack.back();
+            stack.pop_back();
+            node_kind kind = current.node->get_kind();
+            if (kind != kind_binary && kind != kind_unary) {
+                operand(current.node);
+            } else if (current.operands_done) {
+                combine(current.node);
+            } else {
+                stack.push_back({current.node, true});
+                ... // then its operands, last first
+            }
+        }
+     * @endcode
+     */
+    template <typename Operand, typename Combine>
+    inline void walk_operator_tree(top_level_expr* root, Operand&& operand, Combine&& combine) {
+        struct pending {
+            top_level_expr* node;
+            bool operands_done;
+        };
+        thread_local std::vector<pending> stack; // a walk started from a callback runs above the entries of the one that called it
+        const std::size_t base = stack.size();
+
+        stack.push_back({root, false});
+        while (stack.size() > base) {
+            pending current = stack.back();
+            stack.pop_back();
+            node_kind kind = current.node->get_kind();
+
+            if (kind != kind_binary && kind != kind_unary) {
+                operand(current.node);
+            } else if (current.operands_done) {
+                combine(current.node);
+            } else {
+                stack.push_back({current.node, true});
+                if (kind == kind_binary) {
+                    stack.push_back({cast<binary_expr>(current.node)->get_right(), false});
+                    stack.push_back({cast<binary_expr>(current.node)->get_left(), false});
+                } else {
+                    stack.push_back({cast<unary_expr>(current.node)->get_operand(), false});
+                }
+            }
+        }
+    }
+
     extern std::string get_type_as_string(type_enum::types type);
 
 }
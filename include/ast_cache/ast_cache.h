@@ -0,0 +1,46 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef AST_CACHE_H
+#define AST_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "../ast/ast.h"
+#include "../context/context.h"
+
+namespace ast_cache {
+
+    /**
+     * @par Version of the on disk layout. Bump it whenever what an entry holds (or what the AST means) changes, so entries written by older compilers are never read back.
+     */
+    constexpr uint32_t format_version = 5;
+
+    /**
+     * @par The file name extension of a cache entry.
+     */
+    constexpr const char* entry_extension = ".pyrxast";
+
+    /**
+     * @par Returns the directory entries are kept in, or an empty string when caching is off, which it is unless asked for: `$PYRX_CACHE_DIR` if it names a directory, otherwise, with `PYRX_CACHE=1`, `$XDG_CACHE_HOME/pyroxene` or `$HOME/.cache/pyroxene`.
+     */
+    extern std::string cache_directory();
+
+    /**
+     * @par Returns the key of the entry for `source`, read from the file at `source_path`: a hash of the source text, of the file's canonical path and of the compiler that would read it, or an empty string if caching is off.
+     */
+    extern std::string cache_key(std::string_view source, const std::string& source_path);
+
+    extern bool load(context::compilation_context& ctx, std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program);
+    extern void store(const context::compilation_context& ctx, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program);
+}
+
+#endif // AST_CACHE_H
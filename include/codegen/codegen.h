@@ -20,28 +20,29 @@ namespace codegen {
 
     /**
      * @par Contains global state, and stores all LLVM related data within it. It manages, and ensures safety when generating IR.
+     * Like the rest of the code generation state it is thread local, so each thread compiling a unit has its own (see `utility::compile_translation_unit()`).
      */
-    extern std::unique_ptr<llvm::LLVMContext> LLVM_Context;
+    extern thread_local std::unique_ptr<llvm::LLVMContext> LLVM_Context;
 
     /**
      * @par The module contains all of the information about a single unit of compiled code, so singular compiled program. Multiple modules can exist in a context.
      */
-    extern std::unique_ptr<llvm::Module> LLVM_Module;
+    extern thread_local std::unique_ptr<llvm::Module> LLVM_Module;
 
     /**
      * @par The IR Builder is called whenever we want to generate an instruction, such as stack allocation, or load and store instructions.
      */
-    extern std::unique_ptr<llvm::IRBuilder<>> IR_Builder;
+    extern thread_local std::unique_ptr<llvm::IRBuilder<>> IR_Builder;
 
     /**
      * @par This stores the global entry point for control flow to be returned back to
      */
-    extern llvm::BasicBlock* top_level_entry;
+    extern thread_local llvm::BasicBlock* top_level_entry;
 
     /**
      * The printf function definition
      */
-    extern llvm::FunctionCallee print_f_function;
+    extern thread_local llvm::FunctionCallee print_f_function;
 
     extern llvm::Type* get_llvm_type(type_enum::types current_type);
 
@@ -49,27 +50,11 @@ namespace codegen {
     extern llvm::Value* binary_local_helper_minus(llvm::Value* left, llvm::Value* right, bool is_global, type_enum::types type);     
     extern llvm::Value* binary_local_helper_mult(llvm::Value* left, llvm::Value* right, bool is_global, type_enum::types type);    
     extern llvm::Value* binary_local_helper_div(llvm::Value* left, llvm::Value* right, bool is_global, type_enum::types type);    
+    extern llvm::Value* binary_local_helper_mod(llvm::Value* left, llvm::Value* right, type_enum::types type);
+    extern llvm::Value* binary_local_helper_compare(lexer::Token_Type op, llvm::Value* left, llvm::Value* right, type_enum::types operand_type);
+    extern llvm::Value* binary_local_helper_logical(lexer::Token_Type op, llvm::Value* left, llvm::Value* right);
 
-    extern std::string get_llvm_type_as_string(llvm::Type* type);    
-
-    namespace graph_handlers {
-        extern llvm::Value* graph_add_node_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_contains_node_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_remove_node_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_size_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_add_edge_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_remove_edge_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_num_edge_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-
-        extern llvm::Value* graph_BFS_printer_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* graph_DFS_printer_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-    }
-    namespace list_handlers {
-        extern llvm::Value* list_at_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* list_add_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* list_remove_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-        extern llvm::Value* list_size_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args);
-    }
+    extern std::string get_llvm_type_as_string(llvm::Type* type);
 }
 namespace ast {
 }
@@ -0,0 +1,115 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "../lexer/lexer.h"
+#include "../arena/arena.h"
+#include "../interner/interner.h"
+
+namespace module_interface {
+    struct interface;
+}
+
+namespace context {
+
+    /**
+     * @struct parser_state
+     * @par The parser's position in the token stream of a single compilation.
+     *
+     * @var parser_state::current_token
+     * Tracks the current token being processed from the token stream.
+     *
+     * @var parser_state::current_token_as_token
+     * Stores the current token as an enumerated `lexer::Token_Type` as opposed to a raw integer.
+     *
+     * @var parser_state::current_token_record
+     * Points at the packed record of the current token in the token stream, so its payload is read in place rather than copied on every advance.
+     *
+     * @var parser_state::current_token_index
+     * Stores the index of the token we are parsing in the token stream.
+     *
+     * @var parser_state::token_index_max
+     * Stores the length of the token stream so that we don't attempt to access out of bounds elements.
+     *
+     * @var parser_state::source
+     * The lexed file the tokens are read from (normally the `lexer` of the same `compilation_context`). Only read through this, so several parser states can walk one token stream at once.
+     */
+    struct parser_state {
+        int current_token = lexer::tok_eof;
+        lexer::Token_Type current_token_as_token = lexer::tok_eof;
+        const lexer::token* current_token_record = nullptr;
+        int current_token_index = 0;
+        int token_index_max = 0;
+        const lexer::lexer_state* source = nullptr;
+    };
+
+    /**
+     * @struct compilation_context
+     * @par Owns everything needed to compile one .pyrx file (translation unit), so that several files can be compiled by separate threads in the same process.
+     * It is passed explicitly through the lexer, the parser and `utility::primary_driver_loop()`. Code generation and semantic analysis state is reached from AST methods, so it lives in `thread_local` storage instead, and a file is compiled start to finish on one thread.
+     *
+     * @var compilation_context::file_name
+     * The path of the source file being compiled.
+     *
+     * @var compilation_context::lexer
+     * The source buffer, token stream, and side tables of this file.
+     *
+     * @var compilation_context::parser
+     * The parser's position in `lexer.token_stream`.
+     *
+     * @var compilation_context::library_and_include
+     * A list of all include statements in this file: standard library names, and the paths of included .pyrx modules as written.
+     *
+     * @var compilation_context::modules
+     * The interfaces of the modules this file includes, once they have been loaded (or built).
+     *
+     * @var compilation_context::module_chain
+     * The modules whose compilation led to this one, outermost first (empty for a file given on the command line), so that a module including itself is reported instead of waited on forever.
+     *
+     * @var compilation_context::exports
+     * Set while compiling a module: where its exports are collected once it has been analyzed.
+     *
+     * @var compilation_context::ast_arena
+     * Holds every AST node (and child list) parsed from this file, so the tree is freed in one go once code generation is done with it.
+     *
+     * @var compilation_context::cache_key
+     * The key of this file's entry in the AST cache (see `ast_cache::cache_key()`), or empty if its tree should not be cached.
+     *
+     * @var compilation_context::pure_functions
+     * The functions purity analysis found to be pure, whether from the freshly analyzed tree or from the cached one, which codegen marks as not touching memory once they are generated.
+     *
+     * @var compilation_context::LLVM_Context
+     * The LLVM context and module the file was compiled into, moved out of `codegen` once compilation finishes so that they can be handed to the JIT.
+     */
+    struct compilation_context {
+        std::string file_name;
+        lexer::lexer_state lexer;
+        parser_state parser;
+        std::set<std::string> library_and_include;
+        std::vector<const module_interface::interface*> modules;
+        std::vector<std::string> module_chain;
+        module_interface::interface* exports = nullptr;
+        arena::bump_arena ast_arena;
+        std::string cache_key;
+        std::unordered_set<interner::symbol_id> pure_functions;
+        std::unique_ptr<llvm::LLVMContext> LLVM_Context;
+        std::unique_ptr<llvm::Module> LLVM_Module;
+    };
+
+}
+
+#endif
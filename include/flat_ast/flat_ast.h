@@ -0,0 +1,312 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef FLAT_AST_H
+#define FLAT_AST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+#include "../ast/ast.h"
+#include "../interner/interner.h"
+#include "../lexer/lexer.h"
+#include "../types/types.h"
+
+namespace flat_ast {
+
+    /**
+     * @par Refers to a node of a `flat_ast::tree` by its position in `tree::kinds`.
+     */
+    typedef uint32_t node_index;
+
+    /**
+     * @par Stands in for an absent child (such as the value of a bare `return;`).
+     */
+    constexpr node_index no_node = UINT32_MAX;
+
+    /**
+     * @struct child_range
+     * @par A list of children, stored as `count` consecutive entries of `tree::children` starting at `first`.
+     */
+    typedef struct {
+        uint32_t first;
+        uint32_t count;
+    } child_range;
+
+    /**
+     * @par The per kind records. A node's children are indices rather than pointers, and a record holds only what its kind needs.
+     */
+    typedef struct { lexer::Token_Type op; node_index left; node_index right; } binary_node;
+    typedef struct { lexer::Token_Type op; node_index operand; } unary_node;
+    typedef struct { interner::symbol_id name; type_enum::types type; } declaration_node; ///< var_decl, graph_decl and list_decl
+    typedef struct { interner::symbol_id name; type_enum::types type; node_index value; } definition_node;
+    typedef struct { interner::symbol_id name; node_index value; } assignment_node;
+    typedef struct { node_index condition; child_range body; node_index else_branch; } if_node;
+    typedef struct { child_range body; bool is_else_if; } else_node;
+    typedef struct { node_index variable_defn; node_index condition; node_index var_modification; child_range body; } for_node;
+    typedef struct { interner::symbol_id name; child_range arguments; } call_node;
+    typedef struct { interner::symbol_id item_name; interner::symbol_id called; child_range arguments; type_enum::types obj_type; interner::symbol_id aggregate_type; } method_call_node;
+    typedef struct { interner::symbol_id item_name; interner::symbol_id called; } member_node;
+    typedef struct { type_enum::types return_type; interner::symbol_id name; child_range parameters; child_range body; lexer::source_location location; } function_node;
+
+    /**
+     * @struct top_level_item
+     * @par A top level statement (`is_function` false, `index` is a `node_index`) or function definition (`index` is a slot of `tree::functions`), in source order.
+     */
+    typedef struct {
+        bool is_function;
+        uint32_t index;
+    } top_level_item;
+
+    /**
+     * @struct tree
+     * @par A whole program's AST as a handful of contiguous arrays. Every node is an entry of the four per node arrays (kind, slot, type and location), and its own fields live at `slots[node]` in the array for its kind, so walking one kind of node touches one dense array instead of following pointers around the heap.
+     * A tree is built from a parsed program with `flatten()`, and turned back into the node classes the passes run on with `expand()`.
+     *
+     * @var tree::kinds
+     * The `ast::node_kind` of every node.
+     *
+     * @var tree::slots
+     * Where every node's record is, within the array for its kind.
+     *
+     * @var tree::types
+     * The expression type of every node, as the parser or semantic analysis left it.
+     *
+     * @var tree::locations
+     * Where every node starts in the source.
+     *
+     * @var tree::is_global
+     * Whether semantic analysis resolved an identifier, declaration, definition or assignment to a global variable (false for every other node).
+     *
+     * @var tree::variable_slots
+     * The slot semantic analysis resolved an identifier, declaration, definition, assignment, graph or list declaration, method call or parameter to (`ast::no_slot` for every other node).
+     *
+     * @var tree::children
+     * Backing storage for every `child_range`.
+     *
+     * @var tree::string_pool
+     * The characters of every string literal, which `strings` holds spans into.
+     *
+     * @var tree::roots
+     * The top level statements and functions of the program, in source order.
+     */
+    struct tree {
+        std::vector<ast::node_kind> kinds;
+        std::vector<uint32_t> slots;
+        std::vector<int8_t> types;
+        std::vector<lexer::source_location> locations;
+        std::vector<bool> is_global;
+        std::vector<ast::variable_slot> variable_slots;
+
+        std::vector<binary_node> binaries;
+        std::vector<unary_node> unaries;
+        std::vector<interner::symbol_id> identifiers;
+        std::vector<int> ints;
+        std::vector<double> floats;
+        std::vector<char> chars;
+        std::vector<lexer::source_span> strings;
+        std::vector<bool> bools;
+        std::vector<declaration_node> declarations;
+        std::vector<definition_node> definitions;
+        std::vector<assignment_node> assignments;
+        std::vector<node_index> returns;
+        std::vector<if_node> ifs;
+        std::vector<else_node> elses;
+        std::vector<for_node> fors;
+        std::vector<call_node> calls;
+        std::vector<node_index> prints;
+        std::vector<method_call_node> method_calls;
+        std::vector<member_node> members;
+        std::vector<function_node> functions;
+
+        std::vector<node_index> children;
+        std::string string_pool;
+        std::vector<top_level_item> roots;
+    };
+
+    /**
+     * @par Returns the number of nodes in the tree (not counting function definitions, which are not expressions).
+     */
+    inline std::size_t node_count(const tree& flat) {
+        return flat.kinds.size();
+    }
+
+    /**
+     * @par Returns a child range's entries as a pointer range into `tree::children`.
+     */
+    inline const node_index* range_begin(const tree& flat, child_range range) { return flat.children.data() + range.first; }
+    inline const node_index* range_end(const tree& flat, child_range range) { return flat.children.data() + range.first + range.count; }
+
+    /**
+     * @par Returns the text of a string literal node.
+     */
+    inline std::string_view string_value(const tree& flat, node_index node) {
+        const lexer::source_span& span = flat.strings[flat.slots[node]];
+        return std::string_view(flat.string_pool).substr(span.offset, span.length);
+    }
+
+    /**
+     * @par Calls `visit` on every direct child of `node` in source order, skipping absent ones. The counterpart of `ast::for_each_child()`.
+     * @code
+        uint32_t slot = flat.slots[node];
+        switch (flat.kinds[node]) {
+            case ast::kind_binary:
+                visit(flat.binaries[slot].left);
+                visit(flat.binaries[slot].right);
+                break;
+            ...
+            default:
+                break;
+        }
+     * @endcode
+     */
+    template <typename Visit>
+    inline void for_each_child(const tree& flat, node_index node, Visit&& visit) {
+        auto visit_optional = [&](node_index child) {
+            if (child != no_node) {
+                visit(child);
+            }
+        };
+        auto visit_range = [&](child_range range) {
+            for (const node_index* child = range_begin(flat, range); child != range_end(flat, range); ++child) {
+                visit(*child);
+            }
+        };
+
+        uint32_t slot = flat.slots[node];
+        switch (flat.kinds[node]) {
+            case ast::kind_binary:
+                visit(flat.binaries[slot].left);
+                visit(flat.binaries[slot].right);
+                break;
+            case ast::kind_unary:
+                visit(flat.unaries[slot].operand);
+                break;
+            case ast::kind_var_defn:
+                visit(flat.definitions[slot].value);
+                break;
+            case ast::kind_var_assign:
+                visit(flat.assignments[slot].value);
+                break;
+            case ast::kind_return:
+                visit_optional(flat.returns[slot]);
+                break;
+            case ast::kind_if:
+                visit(flat.ifs[slot].condition);
+                visit_range(flat.ifs[slot].body);
+                visit_optional(flat.ifs[slot].else_branch);
+                break;
+            case ast::kind_else:
+                visit_range(flat.elses[slot].body);
+                break;
+            case ast::kind_for:
+                visit_optional(flat.fors[slot].variable_defn);
+                visit_optional(flat.fors[slot].condition);
+                visit_optional(flat.fors[slot].var_modification);
+                visit_range(flat.fors[slot].body);
+                break;
+            case ast::kind_func_call:
+                visit_range(flat.calls[slot].arguments);
+                break;
+            case ast::kind_print:
+                visit(flat.prints[slot]);
+                break;
+            case ast::kind_method_dot_call:
+                visit_range(flat.method_calls[slot].arguments);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @par Calls `visit` with a reference to every interned name the tree holds (identifiers, declared and called names, method receivers and their aggregate types, and function names), so they can be rewritten in place when the tree moves between processes.
+     */
+    template <typename Visit>
+    inline void for_each_symbol(tree& flat, Visit&& visit) {
+        for (interner::symbol_id& identifier : flat.identifiers) {
+            visit(identifier);
+        }
+        for (declaration_node& declaration : flat.declarations) {
+            visit(declaration.name);
+        }
+        for (definition_node& definition : flat.definitions) {
+            visit(definition.name);
+        }
+        for (assignment_node& assignment : flat.assignments) {
+            visit(assignment.name);
+        }
+        for (call_node& call : flat.calls) {
+            visit(call.name);
+        }
+        for (method_call_node& call : flat.method_calls) {
+            visit(call.item_name);
+            visit(call.called);
+            visit(call.aggregate_type);
+        }
+        for (member_node& member : flat.members) {
+            visit(member.item_name);
+            visit(member.called);
+        }
+        for (function_node& function : flat.functions) {
+            visit(function.name);
+        }
+    }
+
+    /**
+     * @par Visits every node reachable from the roots in pre-order (parents before children, children in source order), calling `enter_root(root)` as each root is started and then `visit(node)` for its nodes. Function definitions are entered through their parameters and then their body.
+     * The walk keeps its own stack, so it does not recurse however deep the tree is.
+     */
+    template <typename EnterRoot, typename Visit>
+    inline void walk(const tree& flat, EnterRoot&& enter_root, Visit&& visit) {
+        std::vector<node_index> pending;
+        auto push_range = [&](child_range range) {
+            for (const node_index* child = range_end(flat, range); child != range_begin(flat, range); ) {
+                pending.push_back(*--child);
+            }
+        };
+
+        for (const top_level_item& root : flat.roots) {
+            enter_root(root);
+            if (root.is_function) {
+                const function_node& function = flat.functions[root.index];
+                push_range(function.body);
+                push_range(function.parameters);
+            } else {
+                pending.push_back(root.index);
+            }
+
+            while (!pending.empty()) {
+                node_index node = pending.back();
+                pending.pop_back();
+                visit(node);
+
+                std::size_t first_child = pending.size();
+                for_each_child(flat, node, [&](node_index child) { pending.push_back(child); });
+                std::reverse(pending.begin() + first_child, pending.end());
+            }
+        }
+    }
+
+    /**
+     * @par Visits every node reachable from the roots, as above, for a visitor that does not care which root a node is under.
+     */
+    template <typename Visit>
+    inline void walk(const tree& flat, Visit&& visit) {
+        walk(flat, [](const top_level_item&) {}, visit);
+    }
+
+    extern void flatten(tree& flat, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program);
+    extern std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> expand(const tree& flat);
+    extern std::size_t memory_bytes(const tree& flat);
+}
+
+#endif // FLAT_AST_H
@@ -0,0 +1,96 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+#include "../ast/ast.h"
+#include "../context/context.h"
+
+namespace incremental {
+
+    /**
+     * @struct text_edit
+     * @par A single change to a document, in the form editors report them: `removed_length` characters starting at `offset` are replaced by `inserted_text`.
+     */
+    typedef struct {
+        std::size_t offset;
+        std::size_t removed_length;
+        std::string inserted_text;
+    } text_edit;
+
+    /**
+     * @struct parsed_statement
+     * @par A top level statement or function definition of a document, and the index of the token it starts at.
+     */
+    struct parsed_statement {
+        std::size_t first_token;
+        std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>> node;
+    };
+
+    /**
+     * @struct edit_stats
+     * @par How much of the document the most recent `apply_edit()` had to redo, and how much it kept.
+     */
+    typedef struct {
+        std::size_t tokens_rescanned;
+        std::size_t tokens_reused;
+        std::size_t statements_reparsed;
+        std::size_t statements_reused;
+        bool full_reparse;
+    } edit_stats;
+
+    /**
+     * @struct edit_error
+     * @par Why `apply_edit()` rejected an edit: the lexer or parser error in the text the edit would have produced, and where in that text it is. An empty `message` means the last edit was applied.
+     */
+    typedef struct {
+        std::string message;
+        lexer::source_location location;
+    } edit_error;
+
+    /**
+     * @struct document
+     * @par An editor buffer that is kept lexed and parsed as it changes. Only the front end runs, so documents never touch the standard library or LLVM.
+     *
+     * @var document::unit
+     * The lexer and parser state of the buffer. The text itself lives in `unit.lexer.stream_buffer`.
+     *
+     * @var document::body_start
+     * The index of the first token after the include statements.
+     *
+     * @var document::statements
+     * The parsed top level statements, in source order. Every one of them is identical to what parsing the current text from scratch would produce.
+     *
+     * @var document::parsed_arena_bytes
+     * How much of `unit.ast_arena` the last full parse used. Reparsed statements leave the ones they replace behind in the arena, and once those outweigh the live tree `apply_edit()` parses from scratch to drop them.
+     *
+     * @var document::last_edit
+     * What the most recent applied edit cost.
+     *
+     * @var document::last_error
+     * Why the most recent edit was rejected, if it was.
+     */
+    struct document {
+        context::compilation_context unit;
+        std::size_t body_start = 0;
+        std::vector<parsed_statement> statements;
+        std::size_t parsed_arena_bytes = 0;
+        edit_stats last_edit = {};
+        edit_error last_error = {"", lexer::no_location};
+    };
+
+    extern void open_document(document& doc, std::string text);
+    extern bool apply_edit(document& doc, const text_edit& edit);
+}
+
+#endif
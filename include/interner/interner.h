@@ -0,0 +1,64 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace interner {
+
+    /**
+     * @struct symbol_id
+     * @par A dense 32 bit handle for an interned identifier. Equal names always intern to the same id, so identifiers are compared and used as table keys without touching their text.
+     * It is a distinct type rather than a bare integer so that it cannot silently be printed, concatenated, or handed to LLVM as a name; use `interner::name()` for the text.
+     *
+     * @var symbol_id::value
+     * The index of the name in the interner, assigned in the order names are first seen.
+     */
+    struct symbol_id {
+        uint32_t value;
+
+        bool operator==(symbol_id other) const { return value == other.value; }
+        bool operator!=(symbol_id other) const { return value != other.value; }
+        bool operator<(symbol_id other) const { return value < other.value; }
+    };
+
+    /**
+     * @par Stands in for "no name", e.g. the name of an AST node that has none. Never returned by `intern()`.
+     */
+    constexpr symbol_id no_symbol{UINT32_MAX};
+
+    /**
+     * @par Returns the id of `text`, assigning the next free id the first time a name is seen. Safe to call from several threads at once.
+     */
+    extern symbol_id intern(std::string_view text);
+
+    /**
+     * @par Returns the text of an interned name. The reference stays valid for the life of the process.
+     */
+    extern const std::string& name(symbol_id symbol);
+
+    /**
+     * @par Returns the number of distinct names interned so far.
+     */
+    extern std::size_t symbol_count();
+}
+
+namespace std {
+    template <>
+    struct hash<interner::symbol_id> {
+        std::size_t operator()(interner::symbol_id symbol) const { return symbol.value; }
+    };
+}
+
+#endif // INTERNER_H
@@ -10,18 +10,16 @@ If LICENSE.md is not included, this version of the source code is provided in br
 #define LEXER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <istream>
 #include <optional>
 #include <variant>
+#include <cstdint>
+#include "../interner/interner.h"
 
 namespace lexer {
 
-    /**
-     * @par Tracks the current line number being processed in the input stream.
-     */
-    extern int line_count;
-
     /**
      * @par Enumeration of all possible tokens that are valid, that defines all the types of tokens, using negative values to avoid ASCII collisions.
      */
@@ -57,8 +55,18 @@ namespace lexer {
         tok_minus = -82,       ///< Minus operator
         tok_mult = -83,        ///< Multiplication operator
         tok_div = -84,         ///< Division operator
+        tok_mod = -85,         ///< Modulus operator
         tok_while = -90,       ///< While loop keyword
         tok_assignment = -100, ///< Assignment operator
+        tok_equal = -101,      ///< Equality operator
+        tok_not_equal = -102,  ///< Inequality operator
+        tok_less = -103,       ///< Less than operator
+        tok_less_equal = -104, ///< Less than or equal operator
+        tok_greater = -105,    ///< Greater than operator
+        tok_greater_equal = -106, ///< Greater than or equal operator
+        tok_and = -107,        ///< Logical and operator
+        tok_or = -108,         ///< Logical or operator
+        tok_not = -109,        ///< Logical not operator
         tok_class = -110,      ///< Class keyword
         tok_graph = -120,      ///< Graph keyword
         tok_print = -125,      ///< Print keyword
@@ -70,66 +78,198 @@ namespace lexer {
     };
 
     /**
-     * 
-     * @par A type definition using std::variant to store different values associated with tokens, that can store strings, integers, floats, characters, or booleans.
+     * @struct source_span
+     * @par An offset/length view into `lexer_state::source`, used so that identifiers and string literals are never copied out of the input buffer while lexing.
+     *
+     * @var source_span::offset
+     * The byte offset of the first character in the source buffer.
+     *
+     * @var source_span::length
+     * The number of bytes covered by the span.
+     */
+    typedef struct {
+        uint32_t offset;
+        uint32_t length;
+    } source_span;
+
+    /**
+     * @par Marks a token that carries no associated value (punctuation, keywords, operators, etc...).
      */
-    typedef std::variant<std::string, int, float, char, bool> lexer_stored_values;
+    constexpr uint32_t no_payload = UINT32_MAX;
 
     /**
-     * @par A vector that stores tokens lexed from the input stream.
+     * @par A position in the source, stored as the byte offset it is at. Lines and columns are only worked out (with `locate()`) when a diagnostic is printed.
      */
-    extern std::vector<Token_Type> token_stream;
+    typedef uint32_t source_location;
 
     /**
-     * @par A vector that stores the optional values associated with each token, that can be strings, integers, floats, characters, booleans, or std::nullopt.
+     * @par Marks something that has no position in the source (such as the standard library, or an error about the file as a whole).
      */
-    extern std::vector<std::optional<lexer_stored_values>> stored_values;
+    constexpr source_location no_location = UINT32_MAX;
 
     /**
-     * @par A vecor that holds the adjacent line number for error reporting.
+     * @struct source_position
+     * @par The 1 based line and column a `source_location` points at.
      */
-    extern std::vector<int> line_count_vec;
+    typedef struct {
+        uint32_t line;
+        uint32_t column;
+    } source_position;
 
     /**
-     * @par Stores the current identifier from the input stream if applicable.
+     * @struct token
+     * @par A single packed (12 byte) token record. Literal values live in the side tables below, and the payload field indexes into the one matching the token kind.
+     *
+     * @var token::kind
+     * The type of token.
+     *
+     * @var token::payload
+     * The interned `interner::symbol_id` of an identifier, or an index into `span_table` (strings), `int_table`, or `float_table`. Characters and booleans are small enough to be stored directly, and everything else holds `no_payload`.
+     *
+     * @var token::location
+     * The offset of the token's first character, which is both how diagnostics find its line and column and how `relex_edit()` finds the tokens an edit touched.
      */
-    extern std::string identifier;
+    typedef struct {
+        Token_Type kind;
+        uint32_t payload;
+        source_location location;
+    } token;
 
     /**
-     * @par Stores the current integer value from the input stream if applicable.
+     * @struct lexer_state
+     * @par Everything the lexer reads and writes for a single source file. Each `context::compilation_context` owns one, so that several files can be lexed at the same time.
+     *
+     * @var lexer_state::input
+     * Pointer to the input stream (a .pyrx file), only read when the source is not memory mapped.
+     *
+     * @var lexer_state::source
+     * The entire source being lexed, either a read-only memory mapping of the input file or a buffer filled from `input`.
+     *
+     * @var lexer_state::token_stream
+     * The packed tokens lexed from the source.
+     *
+     * @var lexer_state::span_table
+     * Side table holding the source spans of string literal tokens.
+     *
+     * @var lexer_state::int_table
+     * Side table holding the values of integer literal tokens.
+     *
+     * @var lexer_state::float_table
+     * Side table holding the values of float literal tokens.
+     *
+     * @var lexer_state::identifier
+     * The values of the most recent token returned by `get_token()`, if applicable.
+     *
+     * @var lexer_state::read_offset
+     * Where `get_token()` resumes scanning from, along with the lookahead character it is holding.
+     *
+     * @var lexer_state::line_starts
+     * The offset every line of the source starts at. Built by `build_line_table()` the first time a location is resolved, and cleared whenever the source changes.
+     *
+     * @var lexer_state::stream_buffer
+     * Backing storage for `source` when it is not memory mapped (read from a stream, or an editor buffer).
+     *
+     * @var lexer_state::mapped_address
+     * Base address and length of the active memory mapping (nullptr when the source is not mapped).
+     *
+     * @var lexer_state::source_loaded
+     * Whether `source` has been populated by either `map_source_file()` or `load_source_from_stream()`.
      */
-    extern int integer_value;
+    struct lexer_state {
+        std::istream* input = nullptr;
+        std::string_view source;
+
+        std::vector<token> token_stream;
+        std::vector<source_span> span_table;
+        std::vector<int> int_table;
+        std::vector<float> float_table;
+
+        std::vector<uint32_t> line_starts;
+
+        source_span identifier;
+        int integer_value;
+        float float_value;
+        bool bool_value;
+        char char_value;
+        source_span string_value;
+
+        std::size_t read_offset = 0;
+        int previous_character = ' ';
+
+        std::string stream_buffer;
+        void* mapped_address = nullptr;
+        std::size_t mapped_length = 0;
+        bool source_loaded = false;
+    };
+
+    extern bool map_source_file(lexer_state& state, const std::string& file_name);
+    extern void load_source_from_stream(lexer_state& state);
+    extern void release_source(lexer_state& state);
 
     /**
-     * @par Stores the current float value from the input stream if applicable.
+     * @par Returns the text a span covers, without copying it out of the source buffer.
      */
-    extern float float_value;
+    inline std::string_view span_text(const lexer_state& state, const source_span& span) {
+        return state.source.substr(span.offset, span.length);
+    }
 
     /**
-     * @par Stores the current boolean value from the input stream if applicable.
+     * @par Returns whether the token's payload indexes into `span_table`.
      */
-    extern bool bool_value;
+    inline bool has_span(const token& tok) {
+        return tok.kind == tok_string_val;
+    }
 
     /**
-     * @par Stores the current character value from the input stream if applicable.
+     * @par Returns whether the token carries text, either as an interned identifier or a string literal span.
      */
-    extern char char_value;
+    inline bool has_text(const token& tok) {
+        return tok.kind == tok_identifier || tok.kind == tok_string_val;
+    }
 
     /**
-     * @par Stores the current string value from the input stream if applicable.
+     * @par Payload accessors, which are only valid for tokens of the matching kind (`has_text()` for the text and symbol accessors).
      */
-    extern std::string string_value;
+    inline std::string_view token_text(const lexer_state& state, const token& tok) {
+        if (tok.kind == tok_identifier) {
+            return interner::name(interner::symbol_id{tok.payload});
+        }
+        return span_text(state, state.span_table[tok.payload]);
+    }
+    inline interner::symbol_id token_symbol(const lexer_state& state, const token& tok) {
+        if (tok.kind == tok_identifier) {
+            return interner::symbol_id{tok.payload};
+        }
+        return interner::intern(span_text(state, state.span_table[tok.payload]));
+    }
+    inline int token_int(const lexer_state& state, const token& tok) { return state.int_table[tok.payload]; }
+    inline float token_float(const lexer_state& state, const token& tok) { return state.float_table[tok.payload]; }
+    inline char token_char(const token& tok) { return static_cast<char>(tok.payload); }
+    inline bool token_bool(const token& tok) { return tok.payload != 0; }
+
+    extern Token_Type get_token(lexer_state& state); 
+
+    extern void reset_lexer(lexer_state& state);
+
+    extern void tokenize_file(lexer_state& state);
+    extern void tokenize_file_parallel(lexer_state& state, unsigned thread_count);
 
     /**
-     * @par Pointer to the input stream (a .pyrx file).
+     * @struct token_damage
+     * @par Describes what `relex_edit()` changed: the `removed` tokens starting at index `first` of the old token stream were replaced by `inserted` freshly scanned tokens. Every token outside that range was kept.
      */
-    extern std::istream* input;
+    typedef struct {
+        std::size_t first;
+        std::size_t removed;
+        std::size_t inserted;
+    } token_damage;
 
-    extern Token_Type get_token(); 
+    extern token_damage relex_edit(lexer_state& state, std::size_t edit_offset, std::size_t removed_length, std::size_t inserted_length);
 
-    extern void tokenize_file();
+    extern void build_line_table(lexer_state& state);
+    extern source_position locate(lexer_state& state, source_location location);
 
-    extern Token_Type peek_token(int token_number);
+    extern Token_Type peek_token(const lexer_state& state, int token_number);
 
     extern bool is_operator(Token_Type token);
 }
@@ -0,0 +1,98 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef MODULE_INTERFACE_H
+#define MODULE_INTERFACE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "../ast/ast.h"
+#include "../context/context.h"
+
+namespace module_interface {
+
+    /**
+     * @par Version of the interface file layout. Bump it whenever what an interface records changes.
+     */
+    constexpr uint32_t format_version = 1;
+
+    /**
+     * @par The file name extensions of a module's interface and of its compiled bitcode, which are kept side by side in the cache directory (see `ast_cache::cache_directory()`).
+     */
+    constexpr const char* interface_extension = ".pyrxi";
+    constexpr const char* bitcode_extension = ".bc";
+
+    /**
+     * @struct exported_function
+     * @par The signature of a top level function of a module, as `sem_analysis_scope::defined_functions` holds it.
+     */
+    typedef struct {
+        interner::symbol_id name;
+        type_enum::types return_type;
+        std::vector<type_enum::types> parameters;
+    } exported_function;
+
+    /**
+     * @struct exported_global
+     * @par A global variable of a module, and its type.
+     */
+    typedef struct {
+        interner::symbol_id name;
+        type_enum::types type;
+    } exported_global;
+
+    /**
+     * @struct dependency
+     * @par A module another module includes, and the fingerprint of the interface it was checked against.
+     */
+    typedef struct {
+        std::string path;
+        uint64_t fingerprint;
+    } dependency;
+
+    /**
+     * @struct interface
+     * @par Everything an including file needs from a module, without parsing it: what it exports, and its compiled bitcode for the JIT.
+     *
+     * @var interface::source_path
+     * The canonical path of the module's source.
+     *
+     * @var interface::fingerprint
+     * A hash of the exports. Files that include the module only have to be checked again when it changes, not whenever the module's source does.
+     *
+     * @var interface::dependencies
+     * The modules this module includes itself. An interface checked against a dependency whose fingerprint has since changed is stale, and the module is rebuilt.
+     *
+     * @var interface::bitcode
+     * The module's LLVM bitcode, with definitions for every export.
+     */
+    struct interface {
+        std::string source_path;
+        uint64_t fingerprint = 0;
+        std::vector<exported_function> functions;
+        std::vector<exported_global> globals;
+        std::vector<dependency> dependencies;
+        std::string bitcode;
+    };
+
+    extern bool is_module_include(const std::string& item);
+    extern std::string resolve_path(const std::string& including_file, const std::string& item);
+    extern const interface& require(const std::string& path, const std::vector<std::string>& include_chain);
+    extern void collect_exports(context::compilation_context& ctx, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program);
+    extern void import_semantics(const interface& module);
+    extern void declare_exports(const interface& module);
+    extern std::vector<const interface*> required_modules();
+    extern std::unique_ptr<llvm::Module> load_bitcode(const interface& module, llvm::LLVMContext& llvm_context);
+}
+
+#endif // MODULE_INTERFACE_H
@@ -10,95 +10,107 @@ If LICENSE.md is not included, this version of the source code is provided in br
 #define PARSER_H
 
 #include <memory>
-#include <map>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include "../ast/ast.h"
 #include "../types/types.h"
 #include "../lexer/lexer.h"
+#include "../context/context.h"
 #include "../utility/utility.h"
 
 namespace parser {
 
     /**
-     * @par Tracks the current token being processed from `lexer::token_stream`.
+     * @par Stores the location of the token most recently consumed by the parser on this thread. Codegen and semantic analysis report their errors against it, so it is kept per thread rather than in `context::parser_state`.
      */
-    extern int current_token;
+    extern thread_local lexer::source_location current_location;
 
     /**
-     * @par Stores the current token as an enumerated `lexer::Token_Type` as opposed to a raw integer.
+     * @par Stores the binding power of every infix operator (0 for tokens that are not one), indexed by the negated token value so that a lookup is a single load. Higher values bind tighter.
+     * It is filled in once at startup and only read afterwards, so it is shared between threads.
      */
-    extern lexer::Token_Type current_token_as_token;
+    constexpr std::size_t operator_precedence_size = 512;
+    extern std::array<uint8_t, operator_precedence_size> operator_precedence;
 
     /**
-     * @par Stores the current value adjacent to the current token (can be an std::nullopt)
+     * @par Returns the slot of `operator_precedence` that holds the binding power of `token`.
      */
-    extern std::optional<lexer::lexer_stored_values> current_value;
+    inline std::size_t precedence_index(lexer::Token_Type token) {
+        return static_cast<std::size_t>(-static_cast<int>(token));
+    }
 
     /**
-     * @par Stores the current line
+     * @par Returns the binding power of `token` as an infix operator, or 0 if it is not one.
      */
-    extern int current_line;
+    inline int get_precedence(lexer::Token_Type token) {
+        std::size_t index = precedence_index(token);
+        return (index < operator_precedence_size) ? operator_precedence[index] : 0;
+    }
+    
 
-    /**
-     * @par Stores the precedence of operators, so that the parser knows which order to traverse an expression.
-     */
-    extern std::map<lexer::Token_Type, int> operator_precedence;
+    int get_next_token(context::compilation_context& ctx);
 
     /**
-     * @par Stores the index of the token we are parsing in the lexer::token_stream
+     * @par Returns the kind of the token after the current one, read straight from the record after `current_token_record`. A token stream always ends in `tok_eof`, so only that last token has no successor.
+     * @code
+        if (ctx.parser.current_token_index >= ctx.parser.token_index_max) {
+            return lexer::tok_eof;
+        }
+        return ctx.parser.current_token_record[1].kind;
+     * @endcode
      */
-    extern int current_token_index;
-
-    /**
-     * @par Stores the length of the lexer::token_stream so that we don't attempt to access out of bounds elements.
-     */
-    extern int token_index_max;
-    
-
-    int get_next_token();
+    inline lexer::Token_Type peek_next_token(const context::compilation_context& ctx) {
+        if (ctx.parser.current_token_index >= ctx.parser.token_index_max) {
+            return lexer::tok_eof;
+        }
+        return ctx.parser.current_token_record[1].kind;
+    }
 
 
-    std::unique_ptr<ast::top_level_expr> parse_expression();
-    std::unique_ptr<ast::top_level_expr> parse_primary_expression(lexer::Token_Type prev_tok, lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_binary_expr(std::unique_ptr<ast::top_level_expr> left, std::unique_ptr<ast::top_level_expr> right, lexer::Token_Type operand);
+    ast::node_ptr<ast::top_level_expr> parse_expression(context::compilation_context& ctx);
+    ast::node_ptr<ast::top_level_expr> parse_expression_with_precedence(context::compilation_context& ctx, int minimum_precedence);
+    ast::node_ptr<ast::top_level_expr> parse_primary_expression(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_binary_expr(context::compilation_context& ctx, ast::node_ptr<ast::top_level_expr> left, ast::node_ptr<ast::top_level_expr> right, lexer::Token_Type operand);
 
-    std::unique_ptr<ast::top_level_expr> parse_var_decl_defn();
-    std::unique_ptr<ast::top_level_expr> parse_var_decl(type_enum::types type, std::string identifier);
-    std::unique_ptr<ast::top_level_expr> parse_var_defn(type_enum::types type, std::string identifier);
-    std::unique_ptr<ast::top_level_expr> parse_var_assign();
+    ast::node_ptr<ast::top_level_expr> parse_var_decl_defn(context::compilation_context& ctx);
+    ast::node_ptr<ast::top_level_expr> parse_var_decl(context::compilation_context& ctx, type_enum::types type, interner::symbol_id identifier);
+    ast::node_ptr<ast::top_level_expr> parse_var_defn(context::compilation_context& ctx, type_enum::types type, interner::symbol_id identifier);
+    ast::node_ptr<ast::top_level_expr> parse_var_assign(context::compilation_context& ctx);
 
-    std::unique_ptr<ast::top_level_expr> parse_func_call(lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_identifier_expr(lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_int_expr(lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_float_expr(lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_char_expr(lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_string_expr(lexer::lexer_stored_values value);
-    std::unique_ptr<ast::top_level_expr> parse_bool_expr(lexer::lexer_stored_values value);
+    ast::node_ptr<ast::top_level_expr> parse_func_call(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_identifier_expr(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_int_expr(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_float_expr(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_char_expr(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_string_expr(context::compilation_context& ctx, const lexer::token& tok);
+    ast::node_ptr<ast::top_level_expr> parse_bool_expr(context::compilation_context& ctx, const lexer::token& tok);
 
-    std::unique_ptr<ast::func_defn> parse_function();
-    std::unique_ptr<ast::top_level_expr> parse_return();
+    ast::node_ptr<ast::func_defn> parse_function(context::compilation_context& ctx);
+    ast::node_ptr<ast::top_level_expr> parse_return(context::compilation_context& ctx);
 
-    std::unique_ptr<ast::top_level_expr> parse_if();
-    std::unique_ptr<ast::top_level_expr> parse_else();
+    ast::node_ptr<ast::top_level_expr> parse_if(context::compilation_context& ctx);
+    ast::node_ptr<ast::top_level_expr> parse_else(context::compilation_context& ctx);
 
-    std::unique_ptr<ast::top_level_expr> parse_for();
-    std::unique_ptr<ast::top_level_expr> parse_while();
+    ast::node_ptr<ast::top_level_expr> parse_for(context::compilation_context& ctx);
+    ast::node_ptr<ast::top_level_expr> parse_while(context::compilation_context& ctx);
 
-    std::unique_ptr<ast::top_level_expr> parse_print();
+    ast::node_ptr<ast::top_level_expr> parse_print(context::compilation_context& ctx);
 
-    std::unique_ptr<ast::top_level_expr> parse_graph_decl();
-    std::unique_ptr<ast::top_level_expr> parse_list_decl();
+    ast::node_ptr<ast::top_level_expr> parse_graph_decl(context::compilation_context& ctx);
+    ast::node_ptr<ast::top_level_expr> parse_list_decl(context::compilation_context& ctx);
 
-    std::unique_ptr<ast::top_level_expr> parse_method_dot_call();
+    ast::node_ptr<ast::top_level_expr> parse_method_dot_call(context::compilation_context& ctx);
 
-    std::string parse_include();
+    std::string parse_include(context::compilation_context& ctx);
 
 
 
     namespace {
-        std::string dot_call_method_helper();
-        std::vector<std::unique_ptr<ast::top_level_expr>> parse_block();
-        type_enum::types parse_type();
+        interner::symbol_id dot_call_method_helper(context::compilation_context& ctx);
+        ast::node_list parse_block(context::compilation_context& ctx);
+        ast::node_ptr<ast::top_level_expr> parse_block_statement(context::compilation_context& ctx);
+        type_enum::types parse_type(context::compilation_context& ctx);
     }
 }
 
@@ -0,0 +1,506 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef PASSES_H
+#define PASSES_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "../ast/ast.h"
+#include "../flat_ast/flat_ast.h"
+#include "../interner/interner.h"
+
+namespace passes {
+
+    /**
+     * @par The base of every pass, using the curiously recurring template pattern: `Derived` hides whichever hooks it cares about, and `enter()` reaches them through a `static_cast` instead of a virtual call, so a hook the pass does not define costs nothing and the rest can be inlined into the walk.
+     * The hooks, in the order a walk calls them:
+     * - `start()` once, before anything is visited, and `finish()` once at the end.
+     * - `enter_function()` / `leave_function()` around a function definition's parameters and body.
+     * - `enter_node()` for every node before its children, then the `visit_<kind>()` hook for its kind (also before its children).
+     * - `enter_block()` / `leave_block()` around every statement list: the body of a function, `if`, `else` or `for` (with that node as the owner), and each top level statement (with no owner). Right after `enter_block()`, `skips_block()` lets a pass report the block as dead (the branch a constant `if` does not take), and then no pass walks its statements, though it is still left.
+     * - `leave_node()` for every node after all of its children.
+     * @code
+        void enter(ast::top_level_expr* node) {
+            Derived& self = static_cast<Derived&>(*this);
+            self.enter_node(*node);
+            switch (node->get_kind()) {
+                case ast::kind_binary: self.visit_binary(*ast::cast<ast::binary_expr>(node)); break;
+                ...
+            }
+        }
+     * @endcode
+     */
+    template <typename Derived>
+    class visitor {
+    public:
+        void start() {}
+        void finish() {}
+        void enter_function(ast::func_defn&) {}
+        void leave_function(ast::func_defn&) {}
+        void enter_node(ast::top_level_expr&) {}
+        void leave_node(ast::top_level_expr&) {}
+        void enter_block(ast::top_level_expr*, ast::node_list&) {}
+        void leave_block(ast::top_level_expr*, ast::node_list&) {}
+        bool skips_block(ast::top_level_expr*, const ast::node_list&) const { return false; }
+
+        void visit_binary(ast::binary_expr&) {}
+        void visit_unary(ast::unary_expr&) {}
+        void visit_identifier(ast::identifier_expr&) {}
+        void visit_integer(ast::integer_expression&) {}
+        void visit_float(ast::float_expression&) {}
+        void visit_char(ast::char_expression&) {}
+        void visit_string(ast::string_expression&) {}
+        void visit_bool(ast::bool_expression&) {}
+        void visit_var_decl(ast::variable_declaration&) {}
+        void visit_var_defn(ast::variable_definition&) {}
+        void visit_var_assign(ast::variable_assignment&) {}
+        void visit_return(ast::return_expr&) {}
+        void visit_if(ast::if_expr&) {}
+        void visit_else(ast::else_expr&) {}
+        void visit_for(ast::for_expr&) {}
+        void visit_func_call(ast::func_call_expr&) {}
+        void visit_print(ast::print_expr&) {}
+        void visit_graph_decl(ast::graph_decl_expr&) {}
+        void visit_list_decl(ast::list_decl&) {}
+        void visit_method_dot_call(ast::method_dot_call&) {}
+        void visit_dot_call_var(ast::dot_call_var&) {}
+
+        void enter(ast::top_level_expr* node) {
+            Derived& self = static_cast<Derived&>(*this);
+            self.enter_node(*node);
+            switch (node->get_kind()) {
+                case ast::kind_binary: self.visit_binary(*ast::cast<ast::binary_expr>(node)); break;
+                case ast::kind_unary: self.visit_unary(*ast::cast<ast::unary_expr>(node)); break;
+                case ast::kind_identifier: self.visit_identifier(*ast::cast<ast::identifier_expr>(node)); break;
+                case ast::kind_int: self.visit_integer(*ast::cast<ast::integer_expression>(node)); break;
+                case ast::kind_float: self.visit_float(*ast::cast<ast::float_expression>(node)); break;
+                case ast::kind_char: self.visit_char(*ast::cast<ast::char_expression>(node)); break;
+                case ast::kind_string: self.visit_string(*ast::cast<ast::string_expression>(node)); break;
+                case ast::kind_bool: self.visit_bool(*ast::cast<ast::bool_expression>(node)); break;
+                case ast::kind_var_decl: self.visit_var_decl(*ast::cast<ast::variable_declaration>(node)); break;
+                case ast::kind_var_defn: self.visit_var_defn(*ast::cast<ast::variable_definition>(node)); break;
+                case ast::kind_var_assign: self.visit_var_assign(*ast::cast<ast::variable_assignment>(node)); break;
+                case ast::kind_return: self.visit_return(*ast::cast<ast::return_expr>(node)); break;
+                case ast::kind_if: self.visit_if(*ast::cast<ast::if_expr>(node)); break;
+                case ast::kind_else: self.visit_else(*ast::cast<ast::else_expr>(node)); break;
+                case ast::kind_for: self.visit_for(*ast::cast<ast::for_expr>(node)); break;
+                case ast::kind_func_call: self.visit_func_call(*ast::cast<ast::func_call_expr>(node)); break;
+                case ast::kind_print: self.visit_print(*ast::cast<ast::print_expr>(node)); break;
+                case ast::kind_graph_decl: self.visit_graph_decl(*ast::cast<ast::graph_decl_expr>(node)); break;
+                case ast::kind_list_decl: self.visit_list_decl(*ast::cast<ast::list_decl>(node)); break;
+                case ast::kind_method_dot_call: self.visit_method_dot_call(*ast::cast<ast::method_dot_call>(node)); break;
+                case ast::kind_dot_call_var: self.visit_dot_call_var(*ast::cast<ast::dot_call_var>(node)); break;
+            }
+        }
+
+        void leave(ast::top_level_expr* node) {
+            static_cast<Derived&>(*this).leave_node(*node);
+        }
+    };
+
+    /**
+     * @struct pass_timing
+     * @par How long one pass of a `pass_manager` took, out of the shared walk.
+     */
+    typedef struct {
+        const char* name;
+        double seconds;
+    } pass_timing;
+
+    /**
+     * @par While walking, one node in this many has its hooks timed pass by pass, and each pass is charged that time scaled back up. Timing every hook would cost far more than the hooks themselves.
+     */
+    constexpr uint32_t timing_sample_interval = 64;
+
+    /**
+     * @par Runs several passes over a program in a single walk: every node is reached once, and each pass's hooks run on it in the order the passes are listed. The passes therefore have to be independent, none relying on what another has worked out about the same tree.
+     * Each pass is a `visitor` with a `static constexpr const char* name`, and after `run()` `timings()` reports what each of them cost. The walk keeps its own stack, so it does not recurse however deep the tree is.
+     * A pass may rewrite the tree as it goes, as long as it only touches what the walk is done with: the children of the node it is leaving, and the statements of the block it is leaving. Each top level statement is walked as a block of its own, so the program is rebuilt from whatever those blocks hold afterwards.
+     * @code
+        passes::pass_manager<passes::constant_folding, passes::purity_analysis> manager;
+        manager.run(program);
+        bool pure = manager.get<passes::purity_analysis>().is_pure(name);
+        for (const passes::pass_timing& timing : manager.timings()) { ... }
+     * @endcode
+     */
+    template <typename... Passes>
+    class pass_manager {
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        enum walk_step : uint8_t {
+            enter_step,
+            leave_step,
+            enter_block_step,
+            leave_block_step
+        };
+
+        /**
+         * @par A node, or a statement list and the node that owns it, still to be entered or left.
+         */
+        struct pending_node {
+            ast::top_level_expr* node;
+            ast::node_list* block;
+            walk_step step;
+        };
+
+        std::tuple<Passes...> passes;
+        std::array<clock::duration, sizeof...(Passes)> sampled_time = {};
+        std::array<clock::duration, sizeof...(Passes)> whole_time = {};
+        clock::duration walk_time = {};
+        clock::duration clock_overhead = {};
+        std::size_t nodes_walked = 0;
+        std::vector<pending_node> pending;
+
+        template <typename Event, std::size_t... Index>
+        void for_each_pass(Event&& event, bool timed, std::index_sequence<Index...>) {
+            if (!timed) {
+                (event(std::get<Index>(passes)), ...);
+                return;
+            }
+            auto run_timed = [&](auto& pass, clock::duration& spent) {
+                clock::time_point begin = clock::now();
+                event(pass);
+                clock::duration elapsed = clock::now() - begin;
+                spent += elapsed > clock_overhead ? elapsed - clock_overhead : clock::duration::zero();
+            };
+            (run_timed(std::get<Index>(passes), sampled_time[Index]), ...);
+        }
+
+        template <typename Event>
+        void for_each_pass(Event&& event, bool timed) {
+            for_each_pass(event, timed, std::index_sequence_for<Passes...>());
+        }
+
+        template <std::size_t... Index>
+        bool any_pass_skips(ast::top_level_expr* owner, const ast::node_list& block, std::index_sequence<Index...>) const {
+            return (std::get<Index>(passes).skips_block(owner, block) || ...);
+        }
+
+        template <typename Event, std::size_t... Index>
+        void for_each_pass_whole(Event&& event, std::index_sequence<Index...>) {
+            auto run_timed = [&](auto& pass, clock::duration& spent) {
+                clock::time_point begin = clock::now();
+                event(pass);
+                spent += clock::now() - begin;
+            };
+            (run_timed(std::get<Index>(passes), whole_time[Index]), ...);
+        }
+
+        /**
+         * @par Finds what reading the clock twice costs by itself, which is as much as a hook on a single node often takes and would otherwise be charged to every sample.
+         */
+        void measure_clock_overhead() {
+            clock_overhead = clock::duration::max();
+            for (int attempt = 0; attempt < 256; attempt++) {
+                clock::time_point begin = clock::now();
+                clock_overhead = std::min(clock_overhead, clock::now() - begin);
+            }
+        }
+
+        /**
+         * @par Queues the children of `node` in source order, with the statement lists among them as blocks.
+         */
+        void push_children(ast::top_level_expr* node) {
+            auto push_optional = [&](ast::top_level_expr* child) {
+                if (child != nullptr) {
+                    pending.push_back({child, nullptr, enter_step});
+                }
+            };
+
+            std::size_t first_child = pending.size();
+            switch (node->get_kind()) {
+                case ast::kind_binary: // the commonest node with children, queued without going through for_each_child()
+                    pending.push_back({ast::cast<ast::binary_expr>(node)->get_right(), nullptr, enter_step});
+                    pending.push_back({ast::cast<ast::binary_expr>(node)->get_left(), nullptr, enter_step});
+                    return;
+                case ast::kind_if: {
+                    ast::if_expr* if_node = ast::cast<ast::if_expr>(node);
+                    pending.push_back({if_node->get_condition(), nullptr, enter_step});
+                    pending.push_back({node, &if_node->get_body(), enter_block_step});
+                    push_optional(if_node->get_else());
+                    break;
+                }
+                case ast::kind_else:
+                    pending.push_back({node, &ast::cast<ast::else_expr>(node)->get_body(), enter_block_step});
+                    break;
+                case ast::kind_for: {
+                    ast::for_expr* for_node = ast::cast<ast::for_expr>(node);
+                    push_optional(for_node->get_variable_defn());
+                    push_optional(for_node->get_condition());
+                    push_optional(for_node->get_var_modification());
+                    pending.push_back({node, &for_node->get_body(), enter_block_step});
+                    break;
+                }
+                default:
+                    ast::for_each_child(node, [&](ast::top_level_expr* child) { pending.push_back({child, nullptr, enter_step}); });
+                    break;
+            }
+            std::reverse(pending.begin() + first_child, pending.end());
+        }
+
+        void walk(pending_node root) {
+            pending.push_back(root);
+            while (!pending.empty()) {
+                pending_node current = pending.back();
+                pending.pop_back();
+                bool timed = (nodes_walked % timing_sample_interval) == 0;
+
+                switch (current.step) {
+                    case leave_step:
+                        for_each_pass([&](auto& pass) { pass.leave(current.node); }, timed);
+                        break;
+                    case enter_block_step:
+                        for_each_pass([&](auto& pass) { pass.enter_block(current.node, *current.block); }, timed);
+                        pending.push_back({current.node, current.block, leave_block_step});
+                        if (any_pass_skips(current.node, *current.block, std::index_sequence_for<Passes...>())) {
+                            break;
+                        }
+                        for (auto statement = current.block->rbegin(); statement != current.block->rend(); ++statement) {
+                            pending.push_back({statement->get(), nullptr, enter_step});
+                        }
+                        break;
+                    case leave_block_step:
+                        for_each_pass([&](auto& pass) { pass.leave_block(current.node, *current.block); }, timed);
+                        break;
+                    case enter_step:
+                        nodes_walked++;
+                        for_each_pass([&](auto& pass) { pass.enter(current.node); }, timed);
+                        if (ast::is_literal(current.node) || current.node->get_kind() == ast::kind_identifier) { // no children, so it is left right away
+                            for_each_pass([&](auto& pass) { pass.leave(current.node); }, timed);
+                            break;
+                        }
+                        pending.push_back({current.node, nullptr, leave_step});
+                        push_children(current.node);
+                        break;
+                }
+            }
+        }
+
+    public:
+        template <typename Pass>
+        Pass& get() { return std::get<Pass>(passes); }
+
+        void run(std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+            measure_clock_overhead();
+            clock::time_point begin = clock::now();
+            for_each_pass_whole([](auto& pass) { pass.start(); }, std::index_sequence_for<Passes...>());
+
+            std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> rebuilt;
+            rebuilt.reserve(program.size());
+            ast::node_list statement; // reused, so walking a top level statement as a block does not allocate
+            for (auto& item : program) {
+                if (item.index() == 0) {
+                    statement.clear();
+                    statement.push_back(std::move(std::get<0>(item)));
+                    walk({nullptr, &statement, enter_block_step});
+                    for (ast::node_ptr<ast::top_level_expr>& remaining : statement) {
+                        rebuilt.emplace_back(std::in_place_index<0>, std::move(remaining));
+                    }
+                    continue;
+                }
+                ast::func_defn& function = *std::get<1>(item);
+                for_each_pass_whole([&](auto& pass) { pass.enter_function(function); }, std::index_sequence_for<Passes...>());
+                for (const ast::node_ptr<ast::top_level_expr>& parameter : function.get_parameters()) {
+                    walk({parameter.get(), nullptr, enter_step});
+                }
+                walk({nullptr, &function.get_body(), enter_block_step});
+                for_each_pass_whole([&](auto& pass) { pass.leave_function(function); }, std::index_sequence_for<Passes...>());
+                rebuilt.push_back(std::move(item));
+            }
+            program = std::move(rebuilt);
+
+            for_each_pass_whole([](auto& pass) { pass.finish(); }, std::index_sequence_for<Passes...>());
+            walk_time += clock::now() - begin;
+        }
+
+        std::size_t node_count() const { return nodes_walked; }
+
+        /**
+         * @par Returns the time of the whole walk, every pass included.
+         */
+        double total_seconds() const { return std::chrono::duration<double>(walk_time).count(); }
+
+        /**
+         * @par Returns each pass's share of the walk, in the order the passes are listed. Per node time is estimated from the sampled nodes; `start()`, `finish()` and the function hooks are timed in full.
+         */
+        std::vector<pass_timing> timings() const {
+            std::vector<pass_timing> result;
+            std::size_t index = 0;
+            auto add = [&](const char* name) {
+                double per_node = std::chrono::duration<double>(sampled_time[index]).count() * timing_sample_interval;
+                result.push_back({name, per_node + std::chrono::duration<double>(whole_time[index]).count()});
+                index++;
+            };
+            (add(Passes::name), ...);
+            return result;
+        }
+    };
+
+    /**
+     * @par Works out which functions are pure: they print nothing, never read or write a global, make no method calls on lists or graphs, create none, and only call functions that are pure themselves. Needs the tree after semantic analysis, which is what resolves names to globals.
+     * Each function's own effects and callees are gathered during the walk, and `finish()` then drops every function that calls one that is not pure (or that is not defined in the program) until nothing changes, so mutual recursion between otherwise pure functions stays pure.
+     * A program read back from the AST cache is analyzed as the flat tree it was stored as, with `run()`, which reaches the same nodes through `flat_ast::walk()` without expanding the tree first.
+     */
+    class purity_analysis : public visitor<purity_analysis> {
+    private:
+        struct function_facts {
+            bool has_effects = false;
+            std::vector<interner::symbol_id> callees;
+        };
+
+        std::unordered_map<interner::symbol_id, function_facts> functions;
+        std::unordered_set<interner::symbol_id> pure_functions;
+        function_facts* current = nullptr;
+
+        void mark_effect() {
+            if (current != nullptr) {
+                current->has_effects = true;
+            }
+        }
+
+        void begin_function(interner::symbol_id name);
+
+    public:
+        static constexpr const char* name = "purity_analysis";
+
+        void enter_function(ast::func_defn& function) { begin_function(function.get_name()); }
+        void leave_function(ast::func_defn&) { current = nullptr; }
+        void finish();
+        void run(const flat_ast::tree& flat);
+
+        void visit_identifier(ast::identifier_expr& node) { if (node.get_is_global()) mark_effect(); }
+        void visit_var_decl(ast::variable_declaration& node) { if (node.get_is_global()) mark_effect(); }
+        void visit_var_defn(ast::variable_definition& node) { if (node.get_is_global()) mark_effect(); }
+        void visit_var_assign(ast::variable_assignment& node) { if (node.get_is_global()) mark_effect(); }
+        void visit_print(ast::print_expr&) { mark_effect(); }
+        void visit_graph_decl(ast::graph_decl_expr&) { mark_effect(); }
+        void visit_list_decl(ast::list_decl&) { mark_effect(); }
+        void visit_method_dot_call(ast::method_dot_call&) { mark_effect(); }
+        void visit_dot_call_var(ast::dot_call_var&) { mark_effect(); }
+        void visit_func_call(ast::func_call_expr& node) {
+            if (current != nullptr) {
+                current->callees.push_back(node.get_name());
+            }
+        }
+
+        bool is_pure(interner::symbol_id function) const { return pure_functions.count(function) != 0; }
+        std::size_t pure_count() const { return pure_functions.size(); }
+        const std::unordered_set<interner::symbol_id>& pure() const { return pure_functions; }
+    };
+
+    /**
+     * @struct constant_value
+     * @par A value known at compile time, held the way the generated code holds it: ints as 32 bit values, floats as doubles, and chars and bools as the unsigned `i8` and `i1` they are compared as.
+     */
+    typedef struct {
+        type_enum::types type;
+        int64_t integer;
+        double floating;
+    } constant_value;
+
+    /**
+     * @par The locals of the body being folded whose value is known at the current statement, by slot.
+     */
+    typedef std::unordered_map<ast::variable_slot, constant_value> known_locals;
+
+    /**
+     * @par Rewrites an analyzed program so that codegen only sees what is left to compute at run time: operators whose operands are constant become literals, reads of a local whose value is the same on every path to them become that value, and an `if` whose condition is constant is replaced by the branch it takes (or dropped).
+     * Values are computed the way the generated code would compute them (wrapping 32 bit ints, doubles, and unsigned `i8` / `i1` comparisons), and whatever codegen rejects or leaves to run time, such as arithmetic on chars or a division by zero, is left alone. Globals are never propagated, since any function may change them.
+     * Every node leaves its value (if it is constant) on a stack where its children's sit right above where it was entered, and replaces its constant children with literals. The known locals are one table with an undo log, so a block costs only the changes made in it: the then and else bodies of an `if` each take theirs back when they are left, and the `if` applies whatever holds after it. A block's statements are rebuilt once it has been left: the branch a constant `if` takes goes in its place (the other one is never walked), and whatever follows a `return` is dropped.
+     */
+    class constant_folding : public visitor<constant_folding> {
+    private:
+        /**
+         * @struct folded_value
+         * @par What a finished node left for the node holding it: its value if it is constant, and whether control cannot get past it (a `return`, or a constant `if` whose branch returns).
+         */
+        struct folded_value {
+            std::optional<constant_value> value;
+            bool returns;
+        };
+
+        /**
+         * @struct block_state
+         * @par A block being walked: whether it has returned, whether it is the branch a constant `if` does not take (and so is not walked at all), where its statements' entries start on `values`, and where its changes to `known` start on `undo_log`.
+         */
+        struct block_state {
+            bool returned;
+            bool dead;
+            std::size_t first_statement;
+            std::size_t first_change;
+        };
+
+        /**
+         * @struct known_change
+         * @par A change to `known`, with what the slot held before it, so a block's changes can be taken back when it is left.
+         */
+        struct known_change {
+            ast::variable_slot slot;
+            std::optional<constant_value> previous;
+        };
+
+        /**
+         * @struct branch_result
+         * @par Where the final values of the locals the then or else body of an `if` changed (nothing for one it forgot) start on `branch_changes`, and whether it returned, kept until the `if` itself is left.
+         */
+        struct branch_result {
+            std::size_t first_change;
+            bool returned;
+        };
+
+        std::vector<std::size_t> first_child;
+        std::vector<folded_value> values;
+        std::vector<block_state> blocks;
+        std::vector<branch_result> branches;
+        std::vector<std::pair<ast::variable_slot, std::optional<constant_value>>> branch_changes;
+        known_locals known;
+        std::vector<known_change> undo_log;
+        known_locals top_level;
+
+        uint32_t loop_depth = 0;
+        bool loop_assigns_unknown = false;
+        std::vector<ast::variable_slot> loop_assigned;
+        std::size_t rewrites = 0;
+
+        void set_known(ast::variable_slot slot, const std::optional<constant_value>& value);
+        std::optional<constant_value> known_value(ast::variable_slot slot) const;
+        ast::node_ptr<ast::top_level_expr> literal_for(ast::top_level_expr* node, const std::optional<constant_value>& value);
+        bool leave_if(ast::if_expr& node, const folded_value& condition);
+        void simplify_else_ifs(ast::if_expr& node);
+
+    public:
+        static constexpr const char* name = "constant_folding";
+
+        void enter_function(ast::func_defn&);
+        void leave_function(ast::func_defn&);
+        void enter_node(ast::top_level_expr& node);
+        void leave_node(ast::top_level_expr& node);
+        void enter_block(ast::top_level_expr* owner, ast::node_list& block);
+        void leave_block(ast::top_level_expr* owner, ast::node_list& block);
+        bool skips_block(ast::top_level_expr*, const ast::node_list&) const { return loop_depth == 0 && blocks.back().dead; }
+
+        /**
+         * @par Returns how many nodes were replaced by literals, or dropped as constant or unreachable.
+         */
+        std::size_t rewrite_count() const { return rewrites; }
+    };
+}
+
+#endif // PASSES_H
@@ -0,0 +1,73 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef SCAN_KERNELS_H
+#define SCAN_KERNELS_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace scan_kernels {
+
+    /**
+     * @par The instruction sets the bulk scanning kernels are implemented for. The best supported one is picked at runtime.
+     */
+    enum kernel_level {
+        level_scalar, ///< Portable byte at a time loops
+        level_sse2,   ///< 16 bytes at a time (always available on x86-64)
+        level_avx2    ///< 32 bytes at a time
+    };
+
+    /**
+     * @struct kernel_table
+     * @par The set of kernels for one instruction set. Every kernel scans `data[position, end)` and never reads outside of it.
+     *
+     * @var kernel_table::skip_whitespace
+     * Returns the offset of the first non-whitespace character.
+     *
+     * @var kernel_table::skip_identifier
+     * Returns the offset of the first character that cannot continue an identifier ([A-Za-z0-9_]).
+     *
+     * @var kernel_table::find_newline
+     * Returns the offset of the next '\n', or `end` (used to skip inline comments and to build line tables).
+     *
+     * @var kernel_table::find_comment_end
+     * Returns the offset of the next "*\/", or `end` if there is none.
+     *
+     * @var kernel_table::count_newlines
+     * Returns the number of '\n' characters in the range (used to size line tables).
+     */
+    typedef struct {
+        std::size_t (*skip_whitespace)(const char* data, std::size_t position, std::size_t end);
+        std::size_t (*skip_identifier)(const char* data, std::size_t position, std::size_t end);
+        std::size_t (*find_newline)(const char* data, std::size_t position, std::size_t end);
+        std::size_t (*find_comment_end)(const char* data, std::size_t position, std::size_t end);
+        std::size_t (*count_newlines)(const char* data, std::size_t position, std::size_t end);
+    } kernel_table;
+
+    /**
+     * @par The kernels the lexer calls. Unless `use_level()` picked a level during setup, they are selected from the CPU's capabilities once, by whichever thread lexes first.
+     */
+    extern std::atomic<const kernel_table*> active;
+
+    extern kernel_level detect_level();
+    extern kernel_level active_level();
+    extern void use_level(kernel_level level);
+    extern const kernel_table& detected_kernels();
+    extern const char* level_name(kernel_level level);
+
+    /**
+     * @par Returns the active kernel table, selecting one first if needed.
+     */
+    inline const kernel_table& kernels() {
+        const kernel_table* table = active.load(std::memory_order_acquire);
+        return table != nullptr ? *table : detected_kernels();
+    }
+}
+
+#endif // SCAN_KERNELS_H
@@ -2,55 +2,38 @@
 #define SCOPING_H
 
 #include "../include/codegen/codegen.h"
+#include "../include/interner/interner.h"
+#include <cstdint>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace scope {
 
     /**
-     * @par Enum to indicate whether a scoped value is a variable or an argument
+     * @par Where every variable of the translation unit is stored, indexed by the slot semantic analysis resolved it to (see `ast::variable_slot`), so that codegen never looks a variable up by name.
+     * `global_slots` holds the globals of the unit. `local_slots` holds the variables of every function being generated, each in its own frame starting at `frame_start`; the statements outside of any function make up the first frame.
      */
-    enum var_or_arg { 
-        Variable, ///< Indicates a variable
-        Argument  ///< Indicates an argument
-    };
+    extern thread_local std::vector<llvm::Value*> global_slots;
+    extern thread_local std::vector<llvm::Value*> local_slots;
+    extern thread_local std::size_t frame_start;
 
     /**
-     * @struct llvm_var_info
-     * @par Stores allocation, and type information related to a variable.
-     *
-     * This structure holds information about a variable's allocation, type, and initialization status.
-     *
-     * @var llvm_var_info::allocation
-     * The variable allocation (can be an llvm::Argument* or llvm::AllocaInst*).
-     *
-     * @var llvm_var_info::var_arg
-     * Indicates whether the variable is an argument or a regular variable.
-     *
-     * @var llvm_var_info::type
-     * Holds the type of the variable.
-     *
-     * @var llvm_var_info::is_init
-     * Indicates whether the variable has been initialized with a value.
+     * @par How many blocks deep codegen currently is. 0 is the global scope.
      */
-    typedef struct {
-        llvm::Value* allocation; 
-        var_or_arg var_arg; 
-        llvm::Type* type; 
-        bool is_init; 
-    } llvm_var_info;
-
-    /**
-     * @par Thus holds all of the information related to scope. It will also allow for variable shadowing
-     */
-    extern std::vector<std::map<std::string, llvm_var_info>> scoping_stack;
+    extern thread_local int scope_depth;
     
     extern void create_scope();
     extern void exit_scope();
-    extern void add_var_to_current_scope(const std::string &name, llvm::AllocaInst* allocation, llvm::Type* type, bool is_init);
-    extern void add_var_to_current_scope(const std::string &name, llvm::Argument* allocation, llvm::Type* type);
-    extern llvm_var_info* variable_lookup(const std::string &var_name);
-    extern bool variable_exists_in_current_scope(const std::string &name);
+    extern std::size_t enter_function();
+    extern void exit_function(std::size_t enclosing_frame_start);
+    extern void bind_slot(ast::variable_slot slot, llvm::Value* storage);
+    extern llvm::Value* slot_storage(ast::variable_slot slot);
+    extern llvm::Type* stored_type(llvm::Value* storage);
     extern bool is_llvm_scope_global();
+    extern void reset();
 
 }
 
@@ -63,55 +46,208 @@ namespace sem_analysis_scope {
          * The type of the variable.
          * 
          * @var complex_dt
-         * Stores information about the type complexity.
+         * The interned name of the complex data type ("list", "graph"), or "base_literal" for plain values.
          * 
          * @var is_init
          * Indicates whether the variable has been assigned a value.
          */
         typedef struct {
             type_enum::types type;
-            std::string complex_dt;
+            interner::symbol_id complex_dt;
             bool is_init;
         } sem_analysis_info;
 
+        typedef std::map<interner::symbol_id, std::pair<type_enum::types /* return type */, std::map<int /* arg number */, type_enum::types /* arg type */>>> function_table;
+
+        /**
+         * @struct dot_call_key
+         * @par What a method dot call is dispatched on: the complex data type of the object ("list", "graph"), the type of the values it holds, and the name of the method.
+         */
+        struct dot_call_key {
+            interner::symbol_id aggregate_type;
+            type_enum::types element_type;
+            interner::symbol_id method;
+
+            bool operator==(const dot_call_key& other) const { return aggregate_type == other.aggregate_type && element_type == other.element_type && method == other.method; }
+        };
+
+        struct dot_call_key_hash {
+            std::size_t operator()(const dot_call_key& key) const {
+                uint64_t packed = (static_cast<uint64_t>(key.aggregate_type.value) << 40) ^ (static_cast<uint64_t>(key.method.value) << 8) ^ static_cast<uint64_t>(key.element_type);
+                return static_cast<std::size_t>((packed * 0x9E3779B97F4A7C15ull) >> 16);
+            }
+        };
+
+        /**
+         * @struct dot_call_target
+         * @par One method of a standard library data type, instantiated for one element type.
+         *
+         * @var return_type
+         * The type the call evaluates to. Methods that give back an element already have the element type here.
+         *
+         * @var parameter_types
+         * The types the arguments of the call must have, in order. Parameters taking an element already have the element type here.
+         *
+         * @var function
+         * The function of the unit's module that implements the method. It takes the object first and the arguments of the call after it. `nullptr` if the library does not define it.
+         */
+        typedef struct {
+            type_enum::types return_type;
+            std::vector<type_enum::types> parameter_types;
+            llvm::Function* function;
+        } dot_call_target;
+
+        typedef std::unordered_map<dot_call_key, dot_call_target, dot_call_key_hash> dot_call_table;
+
         /**
          * @par A map of defined functions that holds the name, the function return type, and a mpa of arguments as well as their return type
          */
-        extern std::map<std::string, std::pair<type_enum::types /* return type */, std::map<int /* arg number */, type_enum::types /* arg type */>>> defined_functions;
+        extern thread_local function_table defined_functions;
         
         /**
-         * @par A stack of hashmaps, where each map indicates the current level of scope. The map is of identifier names and related type and initialization information.
+         * @struct scoped_variable
+         * @par One binding of a variable on the semantic analysis scope stack. Bindings of the same name are chained from the innermost scope outwards, so the one a name currently refers to is always the head of its chain.
+         *
+         * @var info
+         * The type and initialization information of the variable.
+         *
+         * @var scope_level
+         * The depth of the scope the variable was bound in (0 is the global scope).
+         *
+         * @var slot
+         * Where codegen stores the variable, which every use of it is resolved to.
+         *
+         * @var shadowed
+         * The index of the binding of the same name in an enclosing scope, or `scope_table::no_binding`.
+         *
+         * @var table_index
+         * The hash table slot of the name, which the binding is unlinked from when its scope exits.
          */
-        extern std::vector<std::map<std::string, sem_analysis_info>> sem_analysis_stack;
+        typedef struct {
+            sem_analysis_info info;
+            int scope_level;
+            ast::variable_slot slot;
+            uint32_t shadowed;
+            uint32_t table_index;
+        } scoped_variable;
 
         /**
-         * @par Contains information about valid method calls on complex data types.
+         * @class scope_table
+         * @par The semantic analysis scope stack, kept as a single open addressing hash table of names instead of one map per scope.
+         * Each slot of the table holds a name and its innermost binding. Bindings are appended to one array in the order they are made, which doubles as the undo log: exiting a scope pops the bindings made since it was entered and relinks each name to the binding it shadowed.
+         * Looking a name up is then one hash probe, however deeply scopes are nested.
+         * Each new binding is also given the next storage slot: globals are numbered through the whole unit, and the variables of a function from 0 for each function.
+         * A table can also be shown the first bindings of another thread's table as its global scope (see `see_globals()`), which it reads but never writes; names it does not bind itself are looked up there.
          */
-        extern std::map<std::string, std::set<std::pair<std::string, type_enum::types>>> valid_dot_calls;
+        class scope_table {
+            public:
+                static constexpr uint32_t no_binding = UINT32_MAX;
+
+                void push_scope();
+                bool pop_scope();
+                ast::variable_slot bind(interner::symbol_id name, const sem_analysis_info& info);
+                const scoped_variable* lookup(interner::symbol_id name) const;
+                bool mark_initialized(interner::symbol_id name);
+                void see_globals(const scope_table* globals, std::size_t visible_bindings) { shared_globals = globals; visible_globals = visible_bindings; }
+                std::size_t binding_count() const { return bindings.size(); }
+                ast::variable_slot enter_function();
+                void exit_function(ast::variable_slot enclosing_next_slot) { next_local_slot = enclosing_next_slot; }
+                int depth() const { return static_cast<int>(scope_starts.size()); }
+                bool empty() const { return scope_starts.empty(); }
+                void clear();
+
+            private:
+                /**
+                 * @struct slot
+                 * @par A name in the table and the head of its chain of bindings. A slot is free while its name is `interner::no_symbol`.
+                 */
+                struct slot {
+                    interner::symbol_id name;
+                    uint32_t binding;
+                };
+
+                std::vector<slot> slots;
+                std::size_t used_slots = 0;
+                std::vector<scoped_variable> bindings;
+                std::vector<std::size_t> scope_starts;
+                ast::variable_slot next_global_slot = 0;
+                ast::variable_slot next_local_slot = 0;
+                const scope_table* shared_globals = nullptr;
+                std::size_t visible_globals = 0;
+
+                uint32_t find_slot(interner::symbol_id name) const;
+                void grow();
+        };
+
+        /**
+         * @par The scopes currently open during semantic analysis, from the global scope inwards, and the variables bound in each.
+         */
+        extern thread_local scope_table sem_analysis_stack;
+
+        /**
+         * @par The methods that can be called on the complex data types of the unit, filled in when a standard library module is linked (see `utility::link_bc_module()`).
+         */
+        extern thread_local dot_call_table valid_dot_calls;
+
+        /**
+         * @struct body_analysis
+         * @par What analyzing one function body did with the globals of its unit. Bodies are analyzed independently of each other against a read-only global scope, so a body never marks a global initialized for the bodies after it; that is settled once all of them are done, in source order.
+         *
+         * @var initialized_globals
+         * The slots of the globals the body assigns.
+         *
+         * @var deferred_reads
+         * The globals the body reads that were declared without a value and that it had not assigned itself yet, and where. Each read is fine if a body before this one assigns the global.
+         */
+        typedef struct {
+            std::vector<ast::variable_slot> initialized_globals;
+            std::vector<std::pair<ast::variable_slot, lexer::source_location>> deferred_reads;
+        } body_analysis;
+
+        /**
+         * @class shared_scope
+         * @par While alive, semantic analysis on the thread that made it checks function bodies against another thread's unit: its global scope, functions and methods are read in place, and never written. The thread's own scope stack and tables are put back when it is destroyed.
+         */
+        class shared_scope {
+            public:
+                shared_scope(const scope_table& globals, const function_table& functions, const dot_call_table& dot_calls);
+                ~shared_scope();
+                void enter_body(std::size_t visible_globals, body_analysis& record);
+
+            private:
+                const scope_table& globals;
+                scope_table saved_stack;
+                const function_table* saved_functions;
+                const dot_call_table* saved_dot_calls;
+                body_analysis* saved_body;
+        };
 
 
         extern void create_scope();
         extern void exit_scope();
-        extern void add_var_to_current_scope(const std::string &name, type_enum::types type, bool is_init, const std::string &complex_dt);
-        extern type_enum::types get_var_type(const std::string &name);
-        extern void add_function_defn(std::string name, type_enum::types ret_type, std::vector<type_enum::types> argument_types);
-        extern type_enum::types get_func_ret_type(const std::string& name);
-        extern bool global_contains_func_defn(const std::string& name);
-        extern const std::map<int, type_enum::types>& get_arg_type_map(const std::string& name);
-        extern type_enum::types get_param_type(const std::string& name, int arg_number);
-        extern int get_num_params(const std::string& name);
-        extern bool variable_exists_in_current_scope(const std::string &name);
-        extern bool var_initialized(const std::string& name);
-        extern bool var_exists(const std::string& name);
-        extern void set_var_init(const std::string& name);
-        extern int get_var_scope_level(const std::string& name);
+        extern ast::variable_slot add_var_to_current_scope(interner::symbol_id name, type_enum::types type, bool is_init, interner::symbol_id complex_dt);
+        extern ast::variable_slot enter_function();
+        extern void exit_function(ast::variable_slot enclosing_next_slot);
+        extern type_enum::types get_var_type(interner::symbol_id name);
+        extern void add_function_defn(interner::symbol_id name, type_enum::types ret_type, std::vector<type_enum::types> argument_types);
+        extern type_enum::types get_func_ret_type(interner::symbol_id name);
+        extern bool global_contains_func_defn(interner::symbol_id name);
+        extern const std::map<int, type_enum::types>& get_arg_type_map(interner::symbol_id name);
+        extern type_enum::types get_param_type(interner::symbol_id name, int arg_number);
+        extern int get_num_params(interner::symbol_id name);
+        extern bool variable_exists_in_current_scope(interner::symbol_id name);
+        extern bool var_initialized(interner::symbol_id name);
+        extern bool var_exists(interner::symbol_id name);
+        extern void set_var_init(interner::symbol_id name);
+        extern int get_var_scope_level(interner::symbol_id name);
         extern int get_scope_stack_size();
-        extern std::string get_var_complex_dt(const std::string& name);
+        extern interner::symbol_id get_var_complex_dt(interner::symbol_id name);
+        extern const scoped_variable* lookup_var(interner::symbol_id name);
+        extern bool global_initialized(const scoped_variable* variable, lexer::source_location location);
 
 
-        extern void add_method_to_valid_dot_calls(const std::string &aggregate_type, const std::string &method, const type_enum::types type);
-        extern bool method_valid_dot_call(const std::string &aggregate_type, const std::string &method);
-        extern type_enum::types get_dot_call_type(const std::string &aggregate_type, const std::string &method);
+        extern void add_method_to_valid_dot_calls(const dot_call_key& key, type_enum::types return_type, std::vector<type_enum::types> parameter_types, llvm::Function* function);
+        extern const dot_call_target* find_dot_call(const dot_call_key& key);
 }
 
 namespace complex_dt_scope {
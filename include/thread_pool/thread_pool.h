@@ -0,0 +1,38 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace thread_pool {
+
+    /**
+     * @par Returns how many threads (including the caller) `parallel_for()` spreads work across: `$PYRX_THREADS` if it is set to a positive number, otherwise the hardware's thread count, lowered by `set_worker_limit()`.
+     */
+    extern unsigned worker_count();
+
+    /**
+     * @par Limits the number of threads used by later calls to `parallel_for()` (0 restores the hardware default). Used by the benchmarks to measure scaling.
+     */
+    extern void set_worker_limit(unsigned limit);
+
+    /**
+     * @par Runs `task(0)` through `task(task_count - 1)` on the shared worker threads and the calling thread, returning once all of them have finished. Calls made from inside a task run inline on that thread, and calls from several other threads at once run one after another.
+     */
+    extern void parallel_for(std::size_t task_count, const std::function<void(std::size_t)>& task);
+
+    /**
+     * @par Runs `work` on a new thread and waits for it, for work that needs thread local state of its own. The new thread counts as part of the caller's task: if the caller is running one, `parallel_for()` calls made by `work` run inline too, instead of posting a second job to the pool while the caller's is still running.
+     */
+    extern void run_on_new_thread(const std::function<void()>& work);
+}
+
+#endif // THREAD_POOL_H
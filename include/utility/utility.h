@@ -22,40 +22,78 @@ If LICENSE.md is not included, this version of the source code is provided in br
 #include "../ast/ast.h"
 #include "../codegen/codegen.h"
 #include "../scoping/scoping.h"
+#include "../context/context.h"
+#include "../passes/passes.h"
 
 #define PARSER_PRINT_UTIL 1
 
 namespace utility {
 
+    extern thread_local lexer::lexer_state* diagnostic_source;
+
+    /**
+     * @struct deferred_lexer_error
+     * @par What `lexer_error()` throws instead of exiting while `defer_lexer_errors` is set on the thread, so an editor buffer with a lexing error can be kept as it was.
+     */
+    struct deferred_lexer_error {
+        std::string message;
+        lexer::source_location location;
+    };
+    extern thread_local bool defer_lexer_errors;
+
+    /**
+     * @struct deferred_parser_error
+     * @par What `parser_error()` throws instead of exiting while `defer_parser_errors` is set on the thread, so a speculative parse can be abandoned and redone where the error is reported in order.
+     */
+    struct deferred_parser_error {
+        std::string message;
+        lexer::source_location location;
+    };
+    extern thread_local bool defer_parser_errors;
+
     /**
-     * @par A list of all include statements.
+     * @struct deferred_sem_analysis_error
+     * @par What `sem_analysis_error()` and `scoping_error()` throw instead of exiting while `defer_sem_analysis_errors` is set on the thread. Function bodies are analyzed out of order, so their errors are held until the one that comes first in the source is known.
      */
-    extern std::set<std::string> library_and_include;
+    struct deferred_sem_analysis_error {
+        bool is_scoping_error;
+        std::string message;
+        lexer::source_location location;
+    };
+    extern thread_local bool defer_sem_analysis_errors;
 
     extern void driver_extension_error(const std::string& message, const std::string& file_name);
     extern void driver_args_error(const int num_args);
-    extern void lexer_error(const std::string& message, int line);
-    extern void parser_error(const std::string& message, int line);
-    extern void codegen_error(const std::string& message, int line);
-    extern void scoping_error(const std::string& message, int line);
-    extern void sem_analysis_error(const std::string& message, int line);
-    extern void output_current_token();
+    extern void module_error(const std::string& message, const std::string& file_name);
+    extern void lexer_error(const std::string& message, lexer::source_location location);
+    extern void parser_error(const std::string& message, lexer::source_location location);
+    extern void codegen_error(const std::string& message, lexer::source_location location);
+    extern void scoping_error(const std::string& message, lexer::source_location location);
+    extern void sem_analysis_error(const std::string& message, lexer::source_location location);
+    extern void output_current_token(const context::compilation_context& ctx);
     extern void initialize_operator_precendence();
 
     extern void init_llvm_mods();
 
-    extern void init_parser();
-    extern void primary_driver_loop();
+    extern void init_parser(context::compilation_context& ctx);
+    extern void primary_driver_loop(context::compilation_context& ctx);
+    extern void cached_driver_loop(context::compilation_context& ctx, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program);
+    extern void compile_translation_unit(context::compilation_context& ctx);
+    extern bool parse_top_level_statement(context::compilation_context& ctx, std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& parsing_output);
+    extern std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parse_top_level(context::compilation_context& ctx);
+    extern void analyze_program(const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program);
+    extern void call_sem_analysis(const std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>& ast_node);
+    extern void call_codegen(const std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>& ast_node);
 
     namespace {
-        void link_bc_module();
-        void process_includes();
+        void link_bc_module(context::compilation_context& ctx);
+        void process_includes(context::compilation_context& ctx);
+        void build_includes(context::compilation_context& ctx);
         void declare_graph_functions();
         void declare_list_functions();
-        void compile_include_ir(const std::string& item);
-        std::vector<std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>> parse_top_level();
-        void call_sem_analysis(const std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>& ast_node);
-        void call_codegen(const std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>& ast_node);
+        void compile_include_ir(context::compilation_context& ctx, const std::string& item);
+        void report_pass_timings(const std::vector<passes::pass_timing>& timings, std::size_t node_count, double total_seconds);
+        void mark_pure_functions(const std::unordered_set<interner::symbol_id>& pure_functions);
     }
 
 }
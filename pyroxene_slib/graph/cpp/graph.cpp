@@ -8,6 +8,6 @@ void graph_error(const std::string& message) {
 
 
 template class slib_graph<int>;
-template class slib_graph<float>;
+template class slib_graph<double>;
 template class slib_graph<char>;
 template class slib_graph<bool>;
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "list.h"
 
 template class slib_list<int>;
-template class slib_list<float>;
+template class slib_list<double>;
 template class slib_list<char>;
 template class slib_list<bool>;
 
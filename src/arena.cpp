@@ -0,0 +1,174 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/arena/arena.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace arena {
+
+    thread_local bump_arena* active_arena = nullptr;
+
+    bump_arena::bump_arena(bump_arena&& other) noexcept :
+        newest_block(other.newest_block),
+        cursor(other.cursor),
+        limit(other.limit),
+        next_block_size(other.next_block_size),
+        used_bytes(other.used_bytes),
+        reserved_bytes(other.reserved_bytes),
+        workers(std::move(other.workers))
+    {
+        other.newest_block = nullptr;
+        other.cursor = nullptr;
+        other.limit = nullptr;
+        other.next_block_size = first_block_size;
+        other.used_bytes = 0;
+        other.reserved_bytes = 0;
+    }
+
+    bump_arena& bump_arena::operator=(bump_arena&& other) noexcept {
+        if (this != &other) {
+            release();
+            std::swap(newest_block, other.newest_block);
+            std::swap(cursor, other.cursor);
+            std::swap(limit, other.limit);
+            std::swap(next_block_size, other.next_block_size);
+            std::swap(used_bytes, other.used_bytes);
+            std::swap(reserved_bytes, other.reserved_bytes);
+            std::swap(workers, other.workers);
+        }
+        return *this;
+    }
+
+    /**
+     * @par Starts a new block once the current one is full. Blocks double in size up to `largest_block_size`, so a large file needs few of them, and a request too big for that gets a block of its own.
+     * @code
+        std::size_t capacity = std::max(next_block_size, size + alignment + sizeof(block_header));
+        next_block_size = std::min(next_block_size * 2, largest_block_size);
+
+        block_header* block = static_cast<block_header*>(::operator new(capacity));
+        block->previous = newest_block;
+        block->capacity = capacity;
+        newest_block = block;
+        reserved_bytes += capacity;
+
+        cursor = reinterpret_cast<char*>(block + 1);
+        limit = reinterpret_cast<char*>(block) + capacity;
+        return allocate(size, alignment);
+     * @endcode
+     */
+    void* bump_arena::allocate_slow(std::size_t size, std::size_t alignment) {
+        std::size_t capacity = std::max(next_block_size, size + alignment + sizeof(block_header));
+        next_block_size = std::min(next_block_size * 2, largest_block_size);
+
+        block_header* block = static_cast<block_header*>(::operator new(capacity));
+        block->previous = newest_block;
+        block->capacity = capacity;
+        newest_block = block;
+        reserved_bytes += capacity;
+
+        cursor = reinterpret_cast<char*>(block + 1);
+        limit = reinterpret_cast<char*>(block) + capacity;
+        return allocate(size, alignment);
+    }
+
+    /**
+     * @par Frees every block in one pass over the block chain, and the worker arenas with theirs. Nothing allocated from the arena is destroyed, so whatever lives in it must not own memory from anywhere else.
+     * @code
+        while (newest_block != nullptr) {
+            block_header* previous = newest_block->previous;
+            ::operator delete(newest_block);
+            newest_block = previous;
+        }
+        cursor = nullptr;
+        limit = nullptr;
+        next_block_size = first_block_size;
+        used_bytes = 0;
+        reserved_bytes = 0;
+        workers.clear();
+     * @endcode
+     */
+    void bump_arena::release() {
+        while (newest_block != nullptr) {
+            block_header* previous = newest_block->previous;
+            ::operator delete(newest_block);
+            newest_block = previous;
+        }
+        cursor = nullptr;
+        limit = nullptr;
+        next_block_size = first_block_size;
+        used_bytes = 0;
+        reserved_bytes = 0;
+        workers.clear();
+    }
+
+    /**
+     * @par Adds an empty arena owned by this one and returns it, for another thread to allocate from. Adding workers is not thread safe, so they are added before the threads start.
+     * @code
+        workers.push_back(std::make_unique<bump_arena>());
+        return *workers.back();
+     * @endcode
+     */
+    bump_arena& bump_arena::add_worker() {
+        workers.push_back(std::make_unique<bump_arena>());
+        return *workers.back();
+    }
+
+    /**
+     * @par Bytes handed out by this arena and its workers.
+     */
+    std::size_t bump_arena::bytes_used() const {
+        std::size_t total = used_bytes;
+        for (const std::unique_ptr<bump_arena>& worker : workers) {
+            total += worker->bytes_used();
+        }
+        return total;
+    }
+
+    /**
+     * @par Bytes in the blocks of this arena and its workers.
+     */
+    std::size_t bump_arena::bytes_reserved() const {
+        std::size_t total = reserved_bytes;
+        for (const std::unique_ptr<bump_arena>& worker : workers) {
+            total += worker->bytes_reserved();
+        }
+        return total;
+    }
+
+    /**
+     * @par Returns the active arena. Code that builds nodes without installing one (a tool parsing outside of a compilation) falls back to an arena owned by the thread, which lives until the thread exits.
+     * @code
+        if (active_arena != nullptr) {
+            return *active_arena;
+        }
+        thread_local bump_arena fallback;
+        return fallback;
+     * @endcode
+     */
+    bump_arena& current() {
+        if (active_arena != nullptr) {
+            return *active_arena;
+        }
+        thread_local bump_arena fallback;
+        return fallback;
+    }
+
+    /**
+     * @par Copies `text` into the active arena, for strings that have to outlive the buffer they were read from (the source of an edited document changes under its AST).
+     */
+    std::string_view copy_string(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+        char* copy = static_cast<char*>(current().allocate(text.size(), 1));
+        std::memcpy(copy, text.data(), text.size());
+        return std::string_view(copy, text.size());
+    }
+}
@@ -51,4 +51,35 @@ namespace ast {
     }
 
     
-}
\ No newline at end of file
+
+    /**
+     * <h4> This function maps node kinds to the names debug output and the parser tests print for them. </h4>
+     */
+    const char* get_kind_as_string(node_kind kind) {
+        switch (kind) {
+            case kind_binary: return "binary";
+            case kind_unary: return "unary";
+            case kind_identifier: return "identifier";
+            case kind_int: return "int";
+            case kind_float: return "float";
+            case kind_char: return "char";
+            case kind_string: return "string";
+            case kind_bool: return "bool";
+            case kind_var_decl: return "var_decl";
+            case kind_var_defn: return "var_defn";
+            case kind_var_assign: return "var_assign";
+            case kind_return: return "return";
+            case kind_if: return "if";
+            case kind_else: return "else";
+            case kind_for: return "for";
+            case kind_func_call: return "func_call";
+            case kind_print: return "print";
+            case kind_graph_decl: return "graph_decl";
+            case kind_list_decl: return "list_decl";
+            case kind_method_dot_call: return "function_dot_call";
+            case kind_dot_call_var: return "dot_call_var";
+        }
+        return "top";
+    }
+
+}
@@ -0,0 +1,557 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/ast_cache/ast_cache.h"
+#include "../include/flat_ast/flat_ast.h"
+#include "../include/module_interface/module_interface.h"
+#include "../include/parser/parser.h"
+#include "../include/passes/passes.h"
+#include "../include/scoping/scoping.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <sys/stat.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace ast_cache {
+
+    namespace {
+
+        /**
+         * @par Opens every entry, so a file that happens to share the extension is never mistaken for one.
+         */
+        constexpr char entry_magic[8] = {'P', 'Y', 'R', 'X', 'A', 'S', 'T', '\0'};
+
+        /**
+         * @par A 64 bit hash of `bytes`, continuing from `hash`. It takes eight bytes per step (FNV-1a style multiply, with a shift to fold the high bits back down), so hashing a large source or entry costs little next to reading it.
+         * @code
+            const char* cursor = bytes.data();
+            const char* end = cursor + bytes.size();
+            for (; end - cursor >= 8; cursor += 8) {
+                uint64_t word;
+                std::memcpy(&word, cursor, 8);
+                hash = (hash ^ word) * 1099511628211ull;
+                hash ^= hash >> 29;
+            }
+            for (; cursor != end; cursor++) {
+                hash = (hash ^ static_cast<unsigned char>(*cursor)) * 1099511628211ull;
+            }
+            return hash ^ bytes.size();
+         * @endcode
+         */
+        uint64_t hash_bytes(std::string_view bytes, uint64_t hash = 14695981039346656037ull) {
+            const char* cursor = bytes.data();
+            const char* end = cursor + bytes.size();
+            for (; end - cursor >= 8; cursor += 8) {
+                uint64_t word;
+                std::memcpy(&word, cursor, 8);
+                hash = (hash ^ word) * 1099511628211ull;
+                hash ^= hash >> 29;
+            }
+            for (; cursor != end; cursor++) {
+                hash = (hash ^ static_cast<unsigned char>(*cursor)) * 1099511628211ull;
+            }
+            return hash ^ bytes.size();
+        }
+
+        /**
+         * @par Identifies the compiler reading and writing entries: the format version, the C++ compiler it was built with, and the size and modification time of the running executable, so that rebuilding the compiler in any way retires every entry it wrote before.
+         * @code
+            static const uint64_t identity = []() {
+                std::string stamp = std::to_string(format_version) + " " + __VERSION__;
+                struct stat executable;
+                if (stat("/proc/self/exe", &executable) == 0) {
+                    stamp += " " + std::to_string(executable.st_size) + " " + std::to_string(executable.st_mtime);
+                }
+                return hash_bytes(stamp);
+            }();
+            return identity;
+         * @endcode
+         */
+        uint64_t compiler_identity() {
+            static const uint64_t identity = []() {
+                std::string stamp = std::to_string(format_version) + " " + __VERSION__;
+                struct stat executable;
+                if (stat("/proc/self/exe", &executable) == 0) {
+                    stamp += " " + std::to_string(executable.st_size) + " " + std::to_string(executable.st_mtime);
+                }
+                return hash_bytes(stamp);
+            }();
+            return identity;
+        }
+
+        /**
+         * @struct entry_header
+         * @par The fixed size start of an entry. `source_bytes` guards against two sources whose hashes collide, and `end_location` is where the parser stopped, which semantic analysis and codegen report their errors against. `payload_hash` covers everything after the header, so an entry damaged on disk is a miss rather than a wrong tree.
+         */
+        typedef struct {
+            char magic[8];
+            uint32_t version;
+            uint64_t identity;
+            uint64_t source_bytes;
+            lexer::source_location end_location;
+            uint64_t payload_hash;
+        } entry_header;
+
+        /**
+         * @par Appends an entry's contents to a byte buffer. Arrays of plain records are copied wholesale; the reader is the same build of the compiler (see `compiler_identity()`), so the records have the same layout on both ends.
+         */
+        class writer {
+            public:
+                std::string bytes;
+
+                template <typename T>
+                void value(const T& item) {
+                    static_assert(std::is_trivially_copyable<T>::value, "only plain records are written directly");
+                    bytes.append(reinterpret_cast<const char*>(&item), sizeof(T));
+                }
+
+                template <typename T>
+                bool array(std::vector<T>& items) {
+                    value<uint64_t>(items.size());
+                    bytes.append(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(T));
+                    return true;
+                }
+
+                bool bits(std::vector<bool>& items) {
+                    value<uint64_t>(items.size());
+                    for (bool item : items) {
+                        bytes.push_back(item ? 1 : 0);
+                    }
+                    return true;
+                }
+
+                bool text(std::string& item) {
+                    value<uint64_t>(item.size());
+                    bytes.append(item);
+                    return true;
+                }
+        };
+
+        /**
+         * @par Reads back what `writer` wrote. Every read is bounds checked and returns false once the entry runs out, so a truncated entry is just a miss.
+         */
+        class reader {
+            public:
+                const char* cursor;
+                const char* end;
+
+                reader(const std::string& bytes) : cursor(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+                template <typename T>
+                bool value(T& item) {
+                    static_assert(std::is_trivially_copyable<T>::value, "only plain records are read directly");
+                    if (static_cast<std::size_t>(end - cursor) < sizeof(T)) {
+                        return false;
+                    }
+                    std::memcpy(&item, cursor, sizeof(T));
+                    cursor += sizeof(T);
+                    return true;
+                }
+
+                template <typename T>
+                bool array(std::vector<T>& items) {
+                    uint64_t count;
+                    if (!value(count) || count > static_cast<std::size_t>(end - cursor) / sizeof(T)) {
+                        return false;
+                    }
+                    items.resize(count);
+                    std::memcpy(items.data(), cursor, count * sizeof(T));
+                    cursor += count * sizeof(T);
+                    return true;
+                }
+
+                bool bits(std::vector<bool>& items) {
+                    uint64_t count;
+                    if (!value(count) || count > static_cast<std::size_t>(end - cursor)) {
+                        return false;
+                    }
+                    items.assign(cursor, cursor + count);
+                    cursor += count;
+                    return true;
+                }
+
+                bool text(std::string& item) {
+                    uint64_t count;
+                    if (!value(count) || count > static_cast<std::size_t>(end - cursor)) {
+                        return false;
+                    }
+                    item.assign(cursor, count);
+                    cursor += count;
+                    return true;
+                }
+        };
+
+        /**
+         * @struct signature_argument
+         * @par One argument of a function signature as it is stored: its position and its type.
+         */
+        typedef struct {
+            int number;
+            type_enum::types type;
+        } signature_argument;
+
+        /**
+         * @par Writes or reads (depending on `archive`) every array of a flat tree, in one fixed order.
+         */
+        template <typename Archive>
+        bool transfer_tree(Archive& archive, flat_ast::tree& flat) {
+            return archive.array(flat.kinds) && archive.array(flat.slots) && archive.array(flat.types) && archive.array(flat.locations) && archive.bits(flat.is_global)
+                && archive.array(flat.variable_slots) && archive.array(flat.binaries) && archive.array(flat.unaries) && archive.array(flat.identifiers) && archive.array(flat.ints)
+                && archive.array(flat.floats) && archive.array(flat.chars) && archive.array(flat.strings) && archive.bits(flat.bools)
+                && archive.array(flat.declarations) && archive.array(flat.definitions) && archive.array(flat.assignments) && archive.array(flat.returns)
+                && archive.array(flat.ifs) && archive.array(flat.elses) && archive.array(flat.fors) && archive.array(flat.calls)
+                && archive.array(flat.prints) && archive.array(flat.method_calls) && archive.array(flat.members) && archive.array(flat.functions)
+                && archive.array(flat.children) && archive.text(flat.string_pool) && archive.array(flat.roots);
+        }
+
+        /**
+         * @par Returns where the entry with key `key` lives.
+         */
+        std::string entry_path(const std::string& key) {
+            return cache_directory() + "/" + key + entry_extension;
+        }
+    }
+
+    /**
+     * @par Picks the cache directory from the environment (see the declaration).
+     * @code
+        if (const char* directory = std::getenv("PYRX_CACHE_DIR"); directory != nullptr && *directory != '\0') {
+            return directory;
+        }
+        const char* enabled = std::getenv("PYRX_CACHE");
+        if (enabled == nullptr || std::string_view(enabled) != "1") {
+            return "";
+        }
+        if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache != nullptr && *xdg_cache != '\0') {
+            return std::string(xdg_cache) + "/pyroxene";
+        }
+        if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+            return std::string(home) + "/.cache/pyroxene";
+        }
+        return "";
+     * @endcode
+     */
+    std::string cache_directory() {
+        if (const char* directory = std::getenv("PYRX_CACHE_DIR"); directory != nullptr && *directory != '\0') {
+            return directory;
+        }
+        const char* enabled = std::getenv("PYRX_CACHE");
+        if (enabled == nullptr || std::string_view(enabled) != "1") {
+            return "";
+        }
+        if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache != nullptr && *xdg_cache != '\0') {
+            return std::string(xdg_cache) + "/pyroxene";
+        }
+        if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+            return std::string(home) + "/.cache/pyroxene";
+        }
+        return "";
+    }
+
+    /**
+     * @par Hashes the source together with the compiler's identity and where the file is, so the same file compiled by a different build of the compiler gets a different key, and so do copies of the same text in different directories (whose relative includes resolve to different modules).
+     * @code
+        if (cache_directory().empty()) {
+            return "";
+        }
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(source_path, error);
+        std::string location = (error ? std::filesystem::path(source_path).lexically_normal() : canonical).string();
+        uint64_t hash = hash_bytes(location, hash_bytes(source, compiler_identity()));
+        ...
+        return std::string(digits, 16);
+     * @endcode
+     */
+    std::string cache_key(std::string_view source, const std::string& source_path) {
+        if (cache_directory().empty()) {
+            return "";
+        }
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(source_path, error);
+        std::string location = (error ? std::filesystem::path(source_path).lexically_normal() : canonical).string();
+        uint64_t hash = hash_bytes(location, hash_bytes(source, compiler_identity()));
+
+        static const char hex_digits[] = "0123456789abcdef";
+        char digits[16];
+        for (int i = 15; i >= 0; i--) {
+            digits[i] = hex_digits[hash & 0xf];
+            hash >>= 4;
+        }
+        return std::string(digits, 16);
+    }
+
+    /**
+     * @par Looks up the entry for `ctx.cache_key`. On a hit, the analyzed program is rebuilt into `program` (in the active arena) and `ctx.library_and_include` and the function signatures of `sem_analysis_scope::defined_functions` are restored (as is `parser::current_location`), leaving the unit exactly where semantic analysis would have; codegen can run straight away. Returns false (touching nothing) if there is no usable entry, including when a module the unit includes has changed its interface since the entry was written.
+     * Names are stored as text and interned again on the way in, since symbol ids are only meaningful within one process.
+     * @code
+        std::ifstream file(entry_path(ctx.cache_key), std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        std::string bytes(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        if (!file.read(bytes.data(), bytes.size())) {
+            return false;
+        }
+        reader input(bytes);
+
+        entry_header header;
+        if (!input.value(header) || std::memcmp(header.magic, entry_magic, sizeof(entry_magic)) != 0 || header.version != format_version
+            || header.identity != compiler_identity() || header.source_bytes != ctx.lexer.source.size()
+            || header.payload_hash != hash_bytes(std::string_view(bytes).substr(sizeof(entry_header)))) {
+            return false;
+        }
+
+        // includes, the interface fingerprints of included modules (which must still match), then the names (interned into `symbols`), then the function signatures and the tree itself
+        ...
+        bool symbols_valid = true;
+        flat_ast::for_each_symbol(flat, [&](interner::symbol_id& symbol) { symbol = resolve(symbol); });
+        ...
+        passes::purity_analysis purity;
+        purity.run(flat);
+        ctx.pure_functions = purity.pure();
+        program = flat_ast::expand(flat);
+        return true;
+     * @endcode
+     */
+    bool load(context::compilation_context& ctx, std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        std::ifstream file(entry_path(ctx.cache_key), std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        std::string bytes(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        if (!file.read(bytes.data(), bytes.size())) {
+            return false;
+        }
+        reader input(bytes);
+
+        entry_header header;
+        if (!input.value(header) || std::memcmp(header.magic, entry_magic, sizeof(entry_magic)) != 0 || header.version != format_version
+            || header.identity != compiler_identity() || header.source_bytes != ctx.lexer.source.size()
+            || header.payload_hash != hash_bytes(std::string_view(bytes).substr(sizeof(entry_header)))) {
+            return false;
+        }
+
+        uint64_t include_count;
+        if (!input.value(include_count)) {
+            return false;
+        }
+        std::set<std::string> includes;
+        for (uint64_t i = 0; i < include_count; i++) {
+            std::string include_item;
+            if (!input.text(include_item)) {
+                return false;
+            }
+            includes.insert(std::move(include_item));
+        }
+
+        uint64_t module_count;
+        if (!input.value(module_count)) {
+            return false;
+        }
+        for (uint64_t i = 0; i < module_count; i++) {
+            std::string module_path;
+            uint64_t fingerprint;
+            if (!input.text(module_path) || !input.value(fingerprint) || module_interface::require(module_path, ctx.module_chain).fingerprint != fingerprint) {
+                return false; // the tree was checked against a different interface
+            }
+        }
+
+        uint64_t symbol_count;
+        if (!input.value(symbol_count)) {
+            return false;
+        }
+        std::vector<interner::symbol_id> symbols;
+        for (uint64_t i = 0; i < symbol_count; i++) {
+            std::string symbol_name;
+            if (!input.text(symbol_name)) {
+                return false;
+            }
+            symbols.push_back(interner::intern(symbol_name));
+        }
+
+        bool symbols_valid = true;
+        auto resolve = [&](interner::symbol_id& symbol) {
+            if (symbol == interner::no_symbol) {
+                return;
+            }
+            if (symbol.value >= symbols.size()) {
+                symbols_valid = false;
+                return;
+            }
+            symbol = symbols[symbol.value];
+        };
+
+        uint64_t function_count;
+        if (!input.value(function_count)) {
+            return false;
+        }
+        std::map<interner::symbol_id, std::pair<type_enum::types, std::map<int, type_enum::types>>> functions;
+        for (uint64_t i = 0; i < function_count; i++) {
+            interner::symbol_id function_name;
+            type_enum::types return_type;
+            uint64_t argument_count;
+            if (!input.value(function_name) || !input.value(return_type) || !input.value(argument_count)) {
+                return false;
+            }
+            resolve(function_name);
+
+            std::map<int, type_enum::types> arguments;
+            for (uint64_t argument = 0; argument < argument_count; argument++) {
+                signature_argument argument_type;
+                if (!input.value(argument_type)) {
+                    return false;
+                }
+                arguments[argument_type.number] = argument_type.type;
+            }
+            functions[function_name] = std::make_pair(return_type, std::move(arguments));
+        }
+
+        flat_ast::tree flat;
+        if (!transfer_tree(input, flat) || input.cursor != input.end) {
+            return false;
+        }
+        flat_ast::for_each_symbol(flat, resolve);
+        if (!symbols_valid) {
+            return false;
+        }
+
+        passes::purity_analysis purity; // read off the flat tree, before it is expanded
+        purity.run(flat);
+
+        ctx.library_and_include = std::move(includes);
+        sem_analysis_scope::defined_functions = std::move(functions);
+        ctx.pure_functions = purity.pure();
+        parser::current_location = header.end_location;
+        program = flat_ast::expand(flat);
+        return true;
+    }
+
+    /**
+     * @par Writes the entry for `ctx.cache_key` from a program that has just passed semantic analysis, along with the unit's includes and `sem_analysis_scope::defined_functions`. The entry is written to a temporary file and renamed into place, so a reader (another compile of the same file) sees either the whole entry or none of it. Failing to write is not an error; the next compile just misses.
+     * @code
+        flat_ast::tree flat;
+        flat_ast::flatten(flat, program);
+
+        std::vector<interner::symbol_id> names;
+        std::unordered_map<interner::symbol_id, uint32_t> numbering;
+        auto number = [&](interner::symbol_id& symbol) {
+            if (symbol == interner::no_symbol) {
+                return;
+            }
+            auto [position, inserted] = numbering.emplace(symbol, static_cast<uint32_t>(names.size()));
+            if (inserted) {
+                names.push_back(symbol);
+            }
+            symbol.value = position->second;
+        };
+        flat_ast::for_each_symbol(flat, number);
+
+        // header, includes, included module fingerprints, names, function signatures, then the tree
+        ...
+        std::filesystem::rename(temporary, entry_path(ctx.cache_key), error);
+     * @endcode
+     */
+    void store(const context::compilation_context& ctx, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        flat_ast::tree flat;
+        flat_ast::flatten(flat, program);
+
+        std::vector<interner::symbol_id> names;
+        std::unordered_map<interner::symbol_id, uint32_t> numbering;
+        auto number = [&](interner::symbol_id& symbol) {
+            if (symbol == interner::no_symbol) {
+                return;
+            }
+            auto [position, inserted] = numbering.emplace(symbol, static_cast<uint32_t>(names.size()));
+            if (inserted) {
+                names.push_back(symbol);
+            }
+            symbol.value = position->second;
+        };
+        flat_ast::for_each_symbol(flat, number);
+
+        std::vector<interner::symbol_id> function_names;
+        for (const auto& function : sem_analysis_scope::defined_functions) {
+            interner::symbol_id function_name = function.first;
+            number(function_name);
+            function_names.push_back(function_name);
+        }
+
+        writer output;
+        output.bytes.reserve(flat_ast::memory_bytes(flat) + flat.is_global.size() + flat.bools.size() + 4096); // bit vectors are written a byte per entry
+        entry_header header = {};
+        std::memcpy(header.magic, entry_magic, sizeof(entry_magic));
+        header.version = format_version;
+        header.identity = compiler_identity();
+        header.source_bytes = ctx.lexer.source.size();
+        header.end_location = parser::current_location;
+        output.value(header); // written again below, once the payload it hashes exists
+
+        output.value<uint64_t>(ctx.library_and_include.size());
+        for (std::string include_item : ctx.library_and_include) {
+            output.text(include_item);
+        }
+
+        output.value<uint64_t>(ctx.modules.size());
+        for (const module_interface::interface* module : ctx.modules) {
+            std::string module_path = module->source_path;
+            output.text(module_path);
+            output.value(module->fingerprint);
+        }
+
+        output.value<uint64_t>(names.size());
+        for (interner::symbol_id symbol : names) {
+            std::string symbol_name = interner::name(symbol);
+            output.text(symbol_name);
+        }
+
+        output.value<uint64_t>(sem_analysis_scope::defined_functions.size());
+        std::size_t function_position = 0;
+        for (const auto& function : sem_analysis_scope::defined_functions) {
+            output.value(function_names[function_position++]);
+            output.value(function.second.first);
+            output.value<uint64_t>(function.second.second.size());
+            for (const std::pair<const int, type_enum::types>& argument : function.second.second) {
+                output.value(signature_argument{argument.first, argument.second});
+            }
+        }
+
+        transfer_tree(output, flat);
+        header.payload_hash = hash_bytes(std::string_view(output.bytes).substr(sizeof(entry_header)));
+        std::memcpy(output.bytes.data(), &header, sizeof(entry_header));
+
+        std::error_code error;
+        std::filesystem::create_directories(cache_directory(), error);
+        if (error) {
+            return;
+        }
+
+        std::string temporary = entry_path(ctx.cache_key) + ".tmp." + std::to_string(getpid()) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file || !file.write(output.bytes.data(), output.bytes.size())) {
+                file.close();
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, entry_path(ctx.cache_key), error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+}
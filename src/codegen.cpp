@@ -11,18 +11,18 @@ If LICENSE.md is not included, this version of the source code is provided in br
 #include <iostream>
 
 namespace codegen {
-    std::unique_ptr<llvm::LLVMContext> LLVM_Context;
-    std::unique_ptr<llvm::Module> LLVM_Module;
-    std::unique_ptr<llvm::IRBuilder<>> IR_Builder;
-    llvm::BasicBlock* top_level_entry;
-    llvm::FunctionCallee print_f_function;
+    thread_local std::unique_ptr<llvm::LLVMContext> LLVM_Context;
+    thread_local std::unique_ptr<llvm::Module> LLVM_Module;
+    thread_local std::unique_ptr<llvm::IRBuilder<>> IR_Builder;
+    thread_local llvm::BasicBlock* top_level_entry;
+    thread_local llvm::FunctionCallee print_f_function;
 
     std::string get_llvm_type_as_string(llvm::Type* type) {
         if (type->isIntegerTy(32)) {
             return "int";
         }
         else {
-            utility::codegen_error("Unsupported llvm type to string conversion", parser::current_line);
+            utility::codegen_error("Unsupported llvm type to string conversion", parser::current_location);
         }
     }
 
@@ -109,7 +109,7 @@ namespace ast {
      * @code
      *  std::vector<llvm::Constant*> ascii_values;
 
-        for (int i = 0; i < held_value.size(); i++) {
+        for (std::size_t i = 0; i < held_value.size(); i++) {
             ascii_values.emplace_back(llvm::ConstantInt::get(codegen::IR_Builder->getInt8Ty(), held_value[i], true));
         }
      * @endcode
@@ -126,7 +126,7 @@ namespace ast {
     llvm::Value* ast::string_expression::codegen() {
         std::vector<llvm::Constant*> ascii_values;
 
-        for (int i = 0; i < held_value.size(); i++) {
+        for (std::size_t i = 0; i < held_value.size(); i++) {
             ascii_values.emplace_back(llvm::ConstantInt::get(codegen::IR_Builder->getInt8Ty(), held_value[i], true));
         }
 
@@ -150,41 +150,27 @@ namespace ast {
 
     /**
      * @fn ast::identifier_expr::codegen()
-     * @par Generates IR for primary identifier expressions. Grabs the actualy pointer to the allocation, and creates a load instruction based on the pointer to the stack allocation.
+     * @par Generates IR for primary identifier expressions. Grabs the pointer to the variable's storage from the slot semantic analysis resolved the identifier to, and creates a load instruction from it.
      *
-     * @par Handling of local variables.
      * @code
-     *  scope::llvm_var_info *var_alloca_type = scope::variable_lookup(identifier_name);
-
-        if (!var_alloca_type)
-        {
-            utility::codegen_error("Variable '" + identifier_name + "' not found in current or outer scopes.", parser::current_line);
-        }
-
-        if (var_alloca_and_type->is_init == false) {
-            utility::codegen_error("Variable '" + identifier_name + "' has not been initialized.", parser::current_line);
-        }
-
-        llvm::LoadInst* load = codegen::IR_Builder->CreateLoad(var_alloca_and_type->allocation->getType(), var_alloca_and_type->allocation, identifier_name);
-        if ( var_alloca_and_type->allocation->getType()->isIntegerTy(64)) {
-            load->setAlignment(llvm::Align(8));
+        llvm::Value* storage = scope::slot_storage(slot);
+        if (storage == nullptr) {
+            utility::codegen_error("Variable '" + interner::name(identifier_name) + "' not found in current or outer scopes.", parser::current_location);
         }
-
-        return load; 
      * @endcode
 
-       @par Handling of global variables.
+       @par Globals of this unit are always initialized, and those of included modules are initialized by their module.
        @code
-        llvm::GlobalVariable* current_global = codegen::LLVM_Module->getGlobalVariable(identifier_name);
-
-        if (!current_global->hasInitializer()) {
-            utility::codegen_error("Global variable (" + identifier_name + ") not initialized", parser::current_line);
+        if (get_is_global()) {
+            llvm::GlobalVariable* current_global = llvm::cast<llvm::GlobalVariable>(storage);
+            if (!current_global->hasInitializer() && !current_global->isExternallyInitialized()) {
+                utility::codegen_error("Global variable (" + interner::name(identifier_name) + ") not initialized", parser::current_location);
+            }
         }
-        
-        llvm::Type* global_type = current_global->getValueType();
-        llvm::LoadInst* load = codegen::IR_Builder->CreateLoad(global_type, current_global, identifier_name);
 
-        if (global_type->isIntegerTy(64)) {
+        llvm::Type* stored_type = scope::stored_type(storage);
+        llvm::LoadInst* load = codegen::IR_Builder->CreateLoad(stored_type, storage, interner::name(identifier_name));
+        if (stored_type->isIntegerTy(64)) {
             load->setAlignment(llvm::Align(8));
         }
 
@@ -192,112 +178,146 @@ namespace ast {
        @endcode
      */
     llvm::Value* ast::identifier_expr::codegen() {
-        if (!get_is_global()) {
-            scope::llvm_var_info* var_alloca_and_type = scope::variable_lookup(identifier_name);
-
-            if (var_alloca_and_type == nullptr) {
-                utility::codegen_error("Variable '" + identifier_name + "' not found in current or outer scopes.", parser::current_line);
-            }
-
-            if (var_alloca_and_type->is_init == false) {
-                utility::codegen_error("Variable '" + identifier_name + "' has not been initialized.", parser::current_line);
-            }
-
-            llvm::LoadInst* load = codegen::IR_Builder->CreateLoad(var_alloca_and_type->type, var_alloca_and_type->allocation, identifier_name);
-            if (var_alloca_and_type->type->isIntegerTy(64)) {
-                load->setAlignment(llvm::Align(8));
-            }
-
-            return load;  
+        llvm::Value* storage = scope::slot_storage(slot);
+        if (storage == nullptr) {
+            utility::codegen_error("Variable '" + interner::name(identifier_name) + "' not found in current or outer scopes.", parser::current_location);
         }
-        llvm::GlobalVariable* current_global = codegen::LLVM_Module->getGlobalVariable(identifier_name);
 
-        if (!current_global->hasInitializer()) {
-            utility::codegen_error("Global variable (" + identifier_name + ") not initialized", parser::current_line);
+        if (get_is_global()) {
+            llvm::GlobalVariable* current_global = llvm::cast<llvm::GlobalVariable>(storage);
+            if (!current_global->hasInitializer() && !current_global->isExternallyInitialized()) { // globals of included modules are initialized by the module
+                utility::codegen_error("Global variable (" + interner::name(identifier_name) + ") not initialized", parser::current_location);
+            }
         }
-        
-        llvm::Type* global_type = current_global->getValueType();
-        llvm::LoadInst* load = codegen::IR_Builder->CreateLoad(global_type, current_global, identifier_name);
 
-        if (global_type->isIntegerTy(64)) {
+        llvm::Type* stored_type = scope::stored_type(storage);
+        llvm::LoadInst* load = codegen::IR_Builder->CreateLoad(stored_type, storage, interner::name(identifier_name));
+        if (stored_type->isIntegerTy(64)) {
             load->setAlignment(llvm::Align(8));
         }
 
         return load;
+    }
+
+    namespace {
+
+        /**
+         * @par Generates the operation of a binary expression on its already generated operands, through the helpers below (which fold constant operands, as global initializers need).
+         * @code
+            switch (node.get_op_token()) {
+                case lexer::tok_plus:
+                    return codegen::binary_local_helper_plus(left_value, right_value, scope::is_llvm_scope_global(), node.get_expr_type());
+                ...
+                case lexer::tok_and: case lexer::tok_or:
+                    return codegen::binary_local_helper_logical(node.get_op_token(), left_value, right_value);
+                default:
+                    utility::codegen_error("Unsupported operator in global var init.", parser::current_location);
+            }
+         * @endcode
+         */
+        llvm::Value* generate_binary(ast::binary_expr& node, llvm::Value* left_value, llvm::Value* right_value) {
+            type_enum::types type = node.get_expr_type();
+            switch (node.get_op_token()) {
+                case lexer::tok_plus:
+                    return codegen::binary_local_helper_plus(left_value, right_value, scope::is_llvm_scope_global(), type);
+                case lexer::tok_minus:
+                    return codegen::binary_local_helper_minus(left_value, right_value, scope::is_llvm_scope_global(), type);
+                case lexer::tok_mult:
+                    return codegen::binary_local_helper_mult(left_value, right_value, scope::is_llvm_scope_global(), type);
+                case lexer::tok_div:
+                    return codegen::binary_local_helper_div(left_value, right_value, scope::is_llvm_scope_global(), type);
+                case lexer::tok_mod:
+                    return codegen::binary_local_helper_mod(left_value, right_value, type);
+                case lexer::tok_equal: case lexer::tok_not_equal: case lexer::tok_less: case lexer::tok_less_equal: case lexer::tok_greater: case lexer::tok_greater_equal:
+                    return codegen::binary_local_helper_compare(node.get_op_token(), left_value, right_value, node.get_left()->get_expr_type());
+                case lexer::tok_and: case lexer::tok_or:
+                    return codegen::binary_local_helper_logical(node.get_op_token(), left_value, right_value);
+                default:
+                    utility::codegen_error("Unsupported operator in global var init.", parser::current_location);
+            }
+            return nullptr;
+        }
 
+        /**
+         * @par Generates a prefix operator on its already generated operand. Like the binary helpers, constant operands are folded by the builder, so this also works in global initializers.
+         * @code
+            if (node.get_op_token() == lexer::tok_not) {
+                return codegen::IR_Builder->CreateNot(operand_value, "nottmp");
+            }
+            if (node.get_expr_type() == type_enum::float_type) {
+                return codegen::IR_Builder->CreateFNeg(operand_value, "negtmp");
+            }
+            return codegen::IR_Builder->CreateNeg(operand_value, "negtmp");
+         * @endcode
+         */
+        llvm::Value* generate_unary(ast::unary_expr& node, llvm::Value* operand_value) {
+            if (node.get_op_token() == lexer::tok_not) {
+                return codegen::IR_Builder->CreateNot(operand_value, "nottmp");
+            }
+            if (node.get_expr_type() == type_enum::float_type) {
+                return codegen::IR_Builder->CreateFNeg(operand_value, "negtmp");
+            }
+            return codegen::IR_Builder->CreateNeg(operand_value, "negtmp");
+        }
+
+        /**
+         * @par Values of the operands generated so far, shared by every expression generated on this thread. An expression generated while another is (a call argument) works above the other's values.
+         */
+        thread_local std::vector<llvm::Value*> operand_values;
+
+        /**
+         * @par Generates the operator tree under `root` bottom up with `ast::walk_operator_tree()`, so deeply nested expressions do not recurse: each operand that is not an operator is generated on its own and its value pushed, and each operator replaces the values of its operands with its own.
+         * @code
+            ast::walk_operator_tree(root,
+                [](ast::top_level_expr* operand) {
+                    operand_values.push_back(operand->codegen());
+                },
+                [](ast::top_level_expr* node) {
+                    if (node->get_kind() == ast::kind_binary) {
+                        llvm::Value* right_value = operand_values.back();
+                        operand_values.pop_back();
+                        operand_values.back() = generate_binary(*ast::cast<ast::binary_expr>(node), operand_values.back(), right_value);
+                    } else {
+                        operand_values.back() = generate_unary(*ast::cast<ast::unary_expr>(node), operand_values.back());
+                    }
+                });
+
+            llvm::Value* result = operand_values.back();
+            operand_values.pop_back();
+            return result;
+         * @endcode
+         */
+        llvm::Value* generate_operators(ast::top_level_expr* root) {
+            ast::walk_operator_tree(root,
+                [](ast::top_level_expr* operand) {
+                    llvm::Value* value = operand->codegen();
+                    operand_values.push_back(value);
+                },
+                [](ast::top_level_expr* node) {
+                    if (node->get_kind() == ast::kind_binary) {
+                        llvm::Value* right_value = operand_values.back();
+                        operand_values.pop_back();
+                        operand_values.back() = generate_binary(*ast::cast<ast::binary_expr>(node), operand_values.back(), right_value);
+                    } else {
+                        operand_values.back() = generate_unary(*ast::cast<ast::unary_expr>(node), operand_values.back());
+                    }
+                });
+
+            llvm::Value* result = operand_values.back();
+            operand_values.pop_back();
+            return result;
+        }
     }
 
     /**
      * @fn ast::binary_expr::codegen()
-     * @par Generates IR for binary expressions. As primary expressions are allocated during recursive calls of the codegen function, we just need to deal with the operator.
-     * 
-     * @par Handling of global binary exprressions.
-     * 
-     * @par Recursively grab constant expressions from the tree (not able to be non-constants as semantic analyzer throws an error).
-     * 
-     * @code
-     *  llvm::Constant* left_const = llvm::dyn_cast<llvm::Constant>(left->codegen());
-        llvm::Constant* right_const = llvm::dyn_cast<llvm::Constant>(right->codegen());
-     * @endcode
-
-       @par Do the operation specified to generate a new constant expression.
-       @code
-        switch (op) {
-            case lexer::tok_plus:
-                return llvm::ConstantExpr::getAdd(left_const, right_const);
-            case lexer::tok_minus:
-                return llvm::ConstantExpr::getSub(left_const, right_const);
-            case lexer::tok_mult:
-                return llvm::ConstantExpr::getMul(left_const, right_const);
-            case lexer::tok_div:
-                return llvm::ConstantExpr::getSDiv(left_const, right_const);
-            default:
-            utility::codegen_error("Unsupported operator in global var init.", parser::current_line);
-        }
-       @endcode
-     * 
-     * @par Handling of local binary expressions.
-     * 
-     * @par Recursively generate IR for the left and right subtree.
-     * 
+     * @par Generates IR for binary expressions. `generate_operators()` generates the operands of this operator and of every operator nested under it bottom up, without recursing, and `generate_binary()` then creates the instruction (or, in the global scope, the folded constant) for each operator.
      * @code
-     *  llvm::Value* left_value = left->codegen();
-        llvm::Value* right_value = right->codegen();
+        return generate_operators(this);
      * @endcode
-
-       @par Create an LLVM instruction corresponding to the binary operator.
-
-       @code
-        switch (op) {
-            case lexer::tok_plus:  
-                return codegen::IR_Builder->CreateAdd(left_value, right_value, "addtmp");
-            case lexer::tok_minus:  
-                return codegen::IR_Builder->CreateSub(left_value, right_value, "subtmp");
-            case lexer::tok_mult:  
-                return codegen::IR_Builder->CreateMul(left_value, right_value, "multmp");
-            case lexer::tok_div:  
-                return codegen::IR_Builder->CreateSDiv(left_value, right_value, "divtmp"); 
-            default:
-                return nullptr;
-        }
-       @endcode
      */
     llvm::Value* ast::binary_expr::codegen() {
-        llvm::Value* left_value = left->codegen();
-        llvm::Value* right_value = right->codegen();
-
-        switch (op) {
-            case lexer::tok_plus:
-                return codegen::binary_local_helper_plus(left_value, right_value, scope::is_llvm_scope_global(), type);
-            case lexer::tok_minus:
-                return codegen::binary_local_helper_minus(left_value, right_value, scope::is_llvm_scope_global(), type);
-            case lexer::tok_mult:
-                return codegen::binary_local_helper_mult(left_value, right_value, scope::is_llvm_scope_global(), type);
-            case lexer::tok_div:
-                return codegen::binary_local_helper_div(left_value, right_value, scope::is_llvm_scope_global(), type);
-            default:
-                utility::codegen_error("Unsupported operator in global var init.", parser::current_line);
-        }
+        return generate_operators(this);
 
 /*
         if (scope::is_llvm_scope_global()) {
@@ -314,7 +334,7 @@ namespace ast {
                 case lexer::tok_div:
                     return llvm::ConstantExpr::getSDiv(left_const, right_const);
                 default:
-                    utility::codegen_error("Unsupported operator in global var init.", parser::current_line);
+                    utility::codegen_error("Unsupported operator in global var init.", parser::current_location);
             }
         }
 
@@ -342,6 +362,17 @@ namespace ast {
         */
 
     }
+
+    /**
+     * @fn ast::unary_expr::codegen()
+     * @par Generates IR for a prefix operator (see `generate_unary()`), after its operand. Operators nested under this one are generated in the same non recursive walk.
+     * @code
+        return generate_operators(this);
+     * @endcode
+     */
+    llvm::Value* ast::unary_expr::codegen() {
+        return generate_operators(this);
+    }
 }
 
 namespace codegen {
@@ -356,7 +387,7 @@ namespace codegen {
                 case type_enum::float_type:
                     return llvm::BinaryOperator::CreateFAdd(llvm::dyn_cast<llvm::Constant>(left), llvm::dyn_cast<llvm::Constant>(right));
                 default:
-                    utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                    utility::codegen_error("Unsupported type in binary expression", parser::current_location);
             }
         }
 
@@ -366,7 +397,7 @@ namespace codegen {
             case type_enum::float_type:
                 return codegen::IR_Builder->CreateFAdd(left, right, "addtmp");
             default:
-                utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                utility::codegen_error("Unsupported type in binary expression", parser::current_location);
         }
     }
 
@@ -378,7 +409,7 @@ namespace codegen {
                 case type_enum::float_type:
                     return llvm::BinaryOperator::CreateFSub(llvm::dyn_cast<llvm::Constant>(left), llvm::dyn_cast<llvm::Constant>(right));
                 default:
-                    utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                    utility::codegen_error("Unsupported type in binary expression", parser::current_location);
             }
         }
 
@@ -388,7 +419,7 @@ namespace codegen {
             case type_enum::float_type:
                 return codegen::IR_Builder->CreateFSub(left, right, "subtmp");
             default:
-                utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                utility::codegen_error("Unsupported type in binary expression", parser::current_location);
         }
     }     
 
@@ -400,7 +431,7 @@ namespace codegen {
                 case type_enum::float_type:
                     return llvm::BinaryOperator::CreateFMul(llvm::dyn_cast<llvm::Constant>(left), llvm::dyn_cast<llvm::Constant>(right));
                 default:
-                    utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                    utility::codegen_error("Unsupported type in binary expression", parser::current_location);
             }
         }
 
@@ -410,10 +441,102 @@ namespace codegen {
             case type_enum::float_type:
                 return codegen::IR_Builder->CreateFMul(left, right, "multmp");
             default:
-                utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                utility::codegen_error("Unsupported type in binary expression", parser::current_location);
         }
     }    
 
+    /**
+     * @par Generates a signed integer or floating point remainder. Constant operands (global initializers) are folded by the builder.
+     * @code
+        switch (type) {
+            case type_enum::int_type:
+                return codegen::IR_Builder->CreateSRem(left, right, "modtmp");
+            case type_enum::float_type:
+                return codegen::IR_Builder->CreateFRem(left, right, "modtmp");
+            default:
+                utility::codegen_error("Unsupported type in binary expression", parser::current_location);
+        }
+     * @endcode
+     */
+    llvm::Value* binary_local_helper_mod(llvm::Value* left, llvm::Value* right, type_enum::types type) {
+        switch (type) {
+            case type_enum::int_type:
+                return codegen::IR_Builder->CreateSRem(left, right, "modtmp");
+            case type_enum::float_type:
+                return codegen::IR_Builder->CreateFRem(left, right, "modtmp");
+            default:
+                utility::codegen_error("Unsupported type in binary expression", parser::current_location);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @par Generates a comparison producing an i1. Floats use ordered predicates (false if either side is NaN), ints are compared as signed integers, and chars and bools as unsigned ones, so that `true > false` and chars order by their byte value.
+     * @code
+        bool is_float = operand_type == type_enum::float_type;
+        bool is_unsigned = operand_type == type_enum::char_type || operand_type == type_enum::bool_type;
+        switch (op) {
+            case lexer::tok_equal:
+                return is_float ? codegen::IR_Builder->CreateFCmpOEQ(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpEQ(left, right, "cmptmp");
+            ...
+            case lexer::tok_greater_equal:
+                if (is_float) {
+                    return codegen::IR_Builder->CreateFCmpOGE(left, right, "cmptmp");
+                }
+                return is_unsigned ? codegen::IR_Builder->CreateICmpUGE(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpSGE(left, right, "cmptmp");
+        }
+     * @endcode
+     */
+    llvm::Value* binary_local_helper_compare(lexer::Token_Type op, llvm::Value* left, llvm::Value* right, type_enum::types operand_type) {
+        bool is_float = operand_type == type_enum::float_type;
+        bool is_unsigned = operand_type == type_enum::char_type || operand_type == type_enum::bool_type;
+        switch (op) {
+            case lexer::tok_equal:
+                return is_float ? codegen::IR_Builder->CreateFCmpOEQ(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpEQ(left, right, "cmptmp");
+            case lexer::tok_not_equal:
+                return is_float ? codegen::IR_Builder->CreateFCmpONE(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpNE(left, right, "cmptmp");
+            case lexer::tok_less:
+                if (is_float) {
+                    return codegen::IR_Builder->CreateFCmpOLT(left, right, "cmptmp");
+                }
+                return is_unsigned ? codegen::IR_Builder->CreateICmpULT(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpSLT(left, right, "cmptmp");
+            case lexer::tok_less_equal:
+                if (is_float) {
+                    return codegen::IR_Builder->CreateFCmpOLE(left, right, "cmptmp");
+                }
+                return is_unsigned ? codegen::IR_Builder->CreateICmpULE(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpSLE(left, right, "cmptmp");
+            case lexer::tok_greater:
+                if (is_float) {
+                    return codegen::IR_Builder->CreateFCmpOGT(left, right, "cmptmp");
+                }
+                return is_unsigned ? codegen::IR_Builder->CreateICmpUGT(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpSGT(left, right, "cmptmp");
+            case lexer::tok_greater_equal:
+                if (is_float) {
+                    return codegen::IR_Builder->CreateFCmpOGE(left, right, "cmptmp");
+                }
+                return is_unsigned ? codegen::IR_Builder->CreateICmpUGE(left, right, "cmptmp") : codegen::IR_Builder->CreateICmpSGE(left, right, "cmptmp");
+            default:
+                utility::codegen_error("Unsupported comparison operator", parser::current_location);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @par Generates a logical and / or of two booleans. Both sides are always evaluated (there is no short circuiting), which keeps global initializers constant.
+     * @code
+        if (op == lexer::tok_and) {
+            return codegen::IR_Builder->CreateAnd(left, right, "andtmp");
+        }
+        return codegen::IR_Builder->CreateOr(left, right, "ortmp");
+     * @endcode
+     */
+    llvm::Value* binary_local_helper_logical(lexer::Token_Type op, llvm::Value* left, llvm::Value* right) {
+        if (op == lexer::tok_and) {
+            return codegen::IR_Builder->CreateAnd(left, right, "andtmp");
+        }
+        return codegen::IR_Builder->CreateOr(left, right, "ortmp");
+    }
+
     llvm::Value* binary_local_helper_div(llvm::Value* left, llvm::Value* right, bool is_global, type_enum::types type) {
         if (is_global) {
             switch (type) {
@@ -422,7 +545,7 @@ namespace codegen {
                 case type_enum::float_type:
                     return llvm::BinaryOperator::CreateFDiv(llvm::dyn_cast<llvm::Constant>(left), llvm::dyn_cast<llvm::Constant>(right));
                 default:
-                    utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                    utility::codegen_error("Unsupported type in binary expression", parser::current_location);
             }
         }
 
@@ -432,7 +555,7 @@ namespace codegen {
             case type_enum::float_type:
                 return codegen::IR_Builder->CreateFDiv(left, right, "divtmp"); 
             default:
-                utility::codegen_error("Unsupported type in binary expression", parser::current_line);
+                utility::codegen_error("Unsupported type in binary expression", parser::current_location);
         }
     } 
 }
@@ -442,22 +565,18 @@ namespace ast {
      * @fn ast::variable_assignment::codegen()
      * @par Generates IR for reassignment of variables.
      * 
-     * @par Validate that what we are reassigning even exists in the symbol table, then generate IR for the new value, and create a store instruction.
+     * @par Find the variable's storage through the slot semantic analysis resolved it to, then generate IR for the new value, and create a store instruction.
      * 
      * @code
-     * 
-        if (codegen::symbol_table.find(identifier_name) == codegen::symbol_table.end()) {
-            std::cout << "Identifier not found(" << identifier_name << ").\n"; // do proper error handling later
-            return nullptr;
+        llvm::Value* storage = scope::slot_storage(slot);
+        if (storage == nullptr) {
+            utility::codegen_error("Variable '" + interner::name(identifier_name) + "' not found in current or outer scopes.", parser::current_location);
         }
 
-        var_alloca_and_type->is_init = true;
-
         llvm::Value* expression_value = assigned_value->codegen();
+        llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, storage);
 
-        llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, codegen::symbol_table[identifier_name]);
-
-        if (var_alloca_and_type->allocation->getType()->isIntegerTy(64)) {
+        if (expression_value->getType()->isIntegerTy(64)) {
             store->setAlignment(llvm::Align(8));
         }
 
@@ -465,34 +584,18 @@ namespace ast {
      * @endcode
      */
     llvm::Value* ast::variable_assignment::codegen() {
-        if (!get_is_global()) {
-            scope::llvm_var_info* var_alloca_and_type = scope::variable_lookup(identifier_name);
-
-            if (var_alloca_and_type->allocation == nullptr) {
-                utility::codegen_error("Variable '" + identifier_name + "' not found in current or outer scopes.", parser::current_line);
-            }
-
-            var_alloca_and_type->is_init = true;
-
-            llvm::Value* expression_value = assigned_value->codegen();
-
-            llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, var_alloca_and_type->allocation);
-
-
-            if (expression_value->getType()->isIntegerTy(64)) {
-                store->setAlignment(llvm::Align(8));
-            }
-
-            return store;
+        llvm::Value* storage = scope::slot_storage(slot);
+        if (storage == nullptr) {
+            utility::codegen_error("Variable '" + interner::name(identifier_name) + "' not found in current or outer scopes.", parser::current_location);
         }
 
-        llvm::GlobalVariable* current_global = codegen::LLVM_Module->getGlobalVariable(identifier_name);
         llvm::Value* expression_value = assigned_value->codegen();
-        llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, current_global);
+        llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, storage);
 
         if (expression_value->getType()->isIntegerTy(64)) {
             store->setAlignment(llvm::Align(8));
         }
+
         return store;
     }
 
@@ -509,16 +612,11 @@ namespace ast {
             llvm::IRBuilder<> tempBuilder(&currentFunction->getEntryBlock(), currentFunction->getEntryBlock().begin());
      * @endcode
 
-       @par Create the variable allocation with a nullptr value, and insert it into the current scope, then return the allocation.
+       @par Create the variable allocation with a nullptr value, and store it in the variable's slot, then return the allocation.
 
        @code
-            llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(variable_type, nullptr, identifier_name);
-            
-            if (scope::variable_exists_in_current_scope(identifier_name)) {
-                utility::codegen_error("Variable '" + identifier_name + "' already declared in this scope", current_line);
-            }
-            
-            scope::add_var_to_current_scope(identifier_name, variable_allocation, variable_type, false);
+            llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(variable_type, nullptr, interner::name(identifier_name));
+            scope::bind_slot(slot, variable_allocation);
 
             return variable_allocation;    
         }
@@ -536,7 +634,7 @@ namespace ast {
         } else if (variable_type->isIntegerTy(8)) {
             initializer = llvm::ConstantInt::get(variable_type, 0);
         } else {
-            utility::codegen_error("String types not yet suported", parser::current_line);
+            utility::codegen_error("String types not yet suported", parser::current_location);
         }
 
 
@@ -546,8 +644,9 @@ namespace ast {
             false,
             llvm::GlobalValue::ExternalLinkage,
             initializer, 
-            identifier_name);
+            interner::name(identifier_name));
 
+        scope::bind_slot(slot, global_variable);
         return global_variable;
        @endcode
 
@@ -560,13 +659,8 @@ namespace ast {
             llvm::Function* currentFunction = codegen::IR_Builder->GetInsertBlock()->getParent();
 
             llvm::IRBuilder<> tempBuilder(&currentFunction->getEntryBlock(), currentFunction->getEntryBlock().begin());
-            llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(variable_type, nullptr, identifier_name);
-
-            if (scope::variable_exists_in_current_scope(identifier_name)) {
-                utility::codegen_error("Variable '" + identifier_name + "' already declared in this scope. Redeclaration", parser::current_line);
-            }
-
-            scope::add_var_to_current_scope(identifier_name, variable_allocation, variable_type, false);
+            llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(variable_type, nullptr, interner::name(identifier_name));
+            scope::bind_slot(slot, variable_allocation);
 
             return variable_allocation;    
         }
@@ -581,7 +675,7 @@ namespace ast {
         } else if (variable_type->isIntegerTy(8)) {
             initializer = llvm::ConstantInt::get(variable_type, 0);
         } else {
-            utility::codegen_error("String types not yet suported", parser::current_line);
+            utility::codegen_error("String types not yet suported", parser::current_location);
         }
 
 
@@ -591,8 +685,9 @@ namespace ast {
             false,
             llvm::GlobalValue::ExternalLinkage,
             initializer, 
-            identifier_name);
+            interner::name(identifier_name));
 
+        scope::bind_slot(slot, global_variable);
         return global_variable;
     }
 
@@ -610,19 +705,13 @@ namespace ast {
         llvm::IRBuilder<> tempBuilder(&currentFunction->getEntryBlock(), currentFunction->getEntryBlock().begin());
      * @endcode
      * 
-     * @par Allocate the variable on the stack, and then create a store instruction that places the assigned value into the variable allocation. Then add it to the symbol table.
+     * @par Allocate the variable on the stack, store it in the variable's slot, and then create a store instruction that places the assigned value into the variable allocation.
      * 
      * @code
-     *  llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(expression_value->getType(), nullptr, identifier_name);
-     * 
-     *  if (scope::variable_exists_in_current_scope(identifier_name)) {
-            utility::codegen_error("Variable '" + identifier_name + "' already declared in this scope. Redeclaration", parser::current_line);
-        }
+     *  llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(expression_value->getType(), nullptr, interner::name(identifier_name));
+        scope::bind_slot(slot, variable_allocation);
 
-        scope::add_var_to_current_scope(identifier_name, variable_allocation, variable_allocation->getAllocatedType()));
-     * 
-        llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, variable_allocation, true);
-        codegen::symbol_table.insert({identifier_name, variable_allocation});
+        llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, variable_allocation);
         return variable_allocation;
      * @endcode
 
@@ -636,8 +725,9 @@ namespace ast {
             false,
             llvm::GlobalValue::ExternalLinkage,
             llvm::dyn_cast<llvm::Constant>(expression_value), 
-            identifier_name);
+            interner::name(identifier_name));
 
+        scope::bind_slot(slot, global_variable);
         return global_variable;
        @endcode
      */
@@ -648,13 +738,8 @@ namespace ast {
             llvm::Function* currentFunction = codegen::IR_Builder->GetInsertBlock()->getParent();
 
             llvm::IRBuilder<> tempBuilder(&currentFunction->getEntryBlock(), currentFunction->getEntryBlock().begin());
-            llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(expression_value->getType(), nullptr, identifier_name);
-
-            if (scope::variable_exists_in_current_scope(identifier_name)) {
-                utility::codegen_error("Variable '" + identifier_name + "' already declared in this scope. Redeclaration", parser::current_line);
-            }
-
-            scope::add_var_to_current_scope(identifier_name, variable_allocation, variable_allocation->getAllocatedType(), true);
+            llvm::AllocaInst* variable_allocation = tempBuilder.CreateAlloca(expression_value->getType(), nullptr, interner::name(identifier_name));
+            scope::bind_slot(slot, variable_allocation);
 
             llvm::StoreInst* store = codegen::IR_Builder->CreateStore(expression_value, variable_allocation);
 
@@ -672,8 +757,9 @@ namespace ast {
             false,
             llvm::GlobalValue::ExternalLinkage,
             llvm::dyn_cast<llvm::Constant>(expression_value), 
-            identifier_name);
+            interner::name(identifier_name));
 
+        scope::bind_slot(slot, global_variable);
         return global_variable;
     }
 
@@ -699,6 +785,7 @@ namespace ast {
      * @par Grab the return type, as well as the types of all of the paramters.
      * @code
      * scope::create_scope();
+     * std::size_t enclosing_frame_start = scope::enter_function();
      * llvm::Type* func_return_type = codegen::get_llvm_type(return_type);
 
         std::vector<llvm::Type*> parameter_types;
@@ -712,23 +799,26 @@ namespace ast {
         llvm::FunctionType* func_type = llvm::FunctionType::get(func_return_type, parameter_types, false);
        @endcode
 
-       @par Create the function declaration in the current module. 
+       @par Create the function declaration in the current module, unless a call before the definition has declared it already (see `ast::func_call_expr::codegen()`).
        @code
-        llvm::Function* function_decl = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, func_name, *codegen::LLVM_Module);
+        llvm::Function* function_decl = codegen::LLVM_Module->getFunction(interner::name(func_name));
+        if (function_decl == nullptr) {
+            function_decl = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, interner::name(func_name), *codegen::LLVM_Module);
+        }
        @endcode
 
        @par Create a new basic block for the function, which is essentially just a control flow boundary for the function, and set the IR_Builder insertion point to it.
        @code
-        llvm::BasicBlock* function_block = llvm::BasicBlock::Create(*codegen::LLVM_Context, "entry_pt_" + func_name, function_decl);
+        llvm::BasicBlock* function_block = llvm::BasicBlock::Create(*codegen::LLVM_Context, "entry_pt_" + interner::name(func_name), function_decl);
         codegen::IR_Builder->SetInsertPoint(function_block);
        @endcode
 
-       @par We iterate over the parameters array in the AST Node, and set the name of the argument in the llvm::Function* to the values stored in the parameters vector.
+       @par We iterate over the parameters array in the AST Node, set the name of the argument in the llvm::Function* to the values stored in the parameters vector, and store each argument in its parameter's slot.
        @code
-        for (int i = 0; i < parameters.size(); i++) {
+        for (std::size_t i = 0; i < parameters.size(); i++) {
             llvm::Argument* argument = function_decl->getArg(i); 
-            argument->setName(parameters.at(i)->get_name());
-            scope::add_var_to_current_scope(argument->getName().str(), argument, argument->getType());
+            argument->setName(interner::name(parameters.at(i)->get_name()));
+            scope::bind_slot(ast::get_parameter_slot(parameters.at(i).get()), argument);
         }
        @endcode
        @par Then iterate over the array of expressions, and generate IR in the new control block. If it is a return type, we validate that the expression type matches, and break out of the loop to avoid parsing unreachable code.
@@ -737,11 +827,11 @@ namespace ast {
         for (auto const& expression : expressions) {
             llvm::Value* current_expr = expression->codegen();
 
-            if (expression->get_ast_class() == "return") {
+            if (ast::isa<ast::return_expr>(expression)) {
                 if (func_return_type->isVoidTy()) {
                     // ADD ERROR HANDLING HERE
                 } else if(func_return_type != codegen::get_llvm_type(expression->get_expr_type())) {
-                    utility::codegen_error("Invalid return type", parser::current_line);
+                    utility::codegen_error("Invalid return type", parser::current_location);
                 }
                 break;
             }
@@ -764,12 +854,14 @@ namespace ast {
        @par Reset the IR insertion point back to the global insertion point and return control back to the global block. Then return the llvm::Function*.
        @code
         codegen::IR_Builder->SetInsertPoint(codegen::top_level_entry);
+        scope::exit_function(enclosing_frame_start);
         scope::exit_scope();
         return function_decl;
        @endcode
      */
     llvm::Value* ast::func_defn::codegen() {
         scope::create_scope();
+        std::size_t enclosing_frame_start = scope::enter_function();
         llvm::Type* func_return_type = codegen::get_llvm_type(return_type);
         std::vector<llvm::Type*> parameter_types;
         for (auto const& parameter : parameters) {
@@ -778,26 +870,29 @@ namespace ast {
 
         llvm::FunctionType* func_type = llvm::FunctionType::get(func_return_type, parameter_types, false); // specifies return type and parameter types for the function
 
-        llvm::Function* function_decl = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, func_name, *codegen::LLVM_Module); // creates the function based on all of the above parameters, and set it to the module
+        llvm::Function* function_decl = codegen::LLVM_Module->getFunction(interner::name(func_name)); // called before its definition
+        if (function_decl == nullptr) {
+            function_decl = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, interner::name(func_name), *codegen::LLVM_Module); // creates the function based on all of the above parameters, and set it to the module
+        }
 
-        llvm::BasicBlock* function_block = llvm::BasicBlock::Create(*codegen::LLVM_Context, "entry_pt_" + func_name, function_decl);
+        llvm::BasicBlock* function_block = llvm::BasicBlock::Create(*codegen::LLVM_Context, "entry_pt_" + interner::name(func_name), function_decl);
         codegen::IR_Builder->SetInsertPoint(function_block);
 
     
-        for (int i = 0; i < parameters.size(); i++) {
+        for (std::size_t i = 0; i < parameters.size(); i++) {
             llvm::Argument* argument = function_decl->getArg(i); 
-            argument->setName(parameters.at(i)->get_name());
-            scope::add_var_to_current_scope(argument->getName().str(), argument, argument->getType());
+            argument->setName(interner::name(parameters.at(i)->get_name()));
+            scope::bind_slot(ast::get_parameter_slot(parameters.at(i).get()), argument);
         }
 
         for (auto const& expression : expressions) {
             llvm::Value* current_expr = expression->codegen();
 
-            if (expression->get_ast_class() == "return") {
+            if (ast::isa<ast::return_expr>(expression)) {
                 if (func_return_type->isVoidTy()) {
                     // ADD ERROR HANDLING HERE
                 } else if(func_return_type != current_expr->getType()) {
-                    utility::codegen_error("Invalid return type", parser::current_line);
+                    utility::codegen_error("Invalid return type", parser::current_location);
                 }
                 break;
             }
@@ -818,133 +913,147 @@ namespace ast {
 
         codegen::IR_Builder->SetInsertPoint(codegen::top_level_entry);
 
+        scope::exit_function(enclosing_frame_start);
         scope::exit_scope();
         return function_decl;
     }
 
-    /**
-     * @fn ast::if_expr::codegen()
-     * @par Code generation for if expressions.
-     * 
-     * @par Initialize a static local variable that serves as a the naming convention for LLVM labels
-     * @code
-        static int block_name_counter = -1;
-     * @endcode
-
-       @par Evaluate the condition to an LLVM Value*, and convert it tp am integer comparison.
-       @code
-        llvm::Value* condition_value = condition->codegen();
-        condition_value = codegen::IR_Builder->CreateICmpNE(condition_value, llvm::ConstantInt::get(*codegen::LLVM_Context, llvm::APInt(1, 0)), "__if_cond__");
-       @endcode
-
-       @par Grab the parent function, and create a then block (will contain expressions in the if block).
-       @code
-        llvm::BasicBlock* then_blk = llvm::BasicBlock::Create(*codegen::LLVM_Context, "__then__" + std::to_string(++block_name_counter) + "__", parent_function);
-       @endcode
-
-       @par If an else statement exists in our if expression, create a new llvm block for it, otherwise set it to nullptr.
-       @code
-        llvm::BasicBlock* else_blk = else_stmt ? llvm::BasicBlock::Create(*codegen::LLVM_Context, "__else__" + std::to_string(block_name_counter) + "__", parent_function) : nullptr;
-       @endcode
-
-       @par If the merge block of the if expression is not yet set (not an elif), create a new basic block, and assign it to the if expression.
-       @code
-        if (merge_block == nullptr) {
-            merge_block = llvm::BasicBlock::Create(*codegen::LLVM_Context, "__merge__" + std::to_string(block_name_counter) + "__", parent_function);
-        }
-       @endcode
+    namespace {
+
+        /**
+         * @struct open_branch
+         * @par The block of an if (or of the else after it) whose statements are being generated, the index of its next statement, and the basic blocks of its if statement.
+         */
+        struct open_branch {
+            ast::top_level_expr* node;
+            std::size_t next_statement;
+            llvm::Function* parent_function;
+            llvm::BasicBlock* then_blk;
+            llvm::BasicBlock* else_blk;
+            llvm::BasicBlock* merge_block;
+        };
+
+        /**
+         * @par Shared by every if statement generated on this thread, so generating one does not allocate. An if generated while another is (from a statement the walk hands off) works above the other's entries.
+         */
+        thread_local std::vector<open_branch> open_branches;
+
+        /**
+         * @par Starts generating an if: branches on its condition to a new then block, or else to its else block (if it has one) or the merge block, and opens the then block's scope.
+         * An else if is given the merge block of the if it belongs to, so the whole chain joins in one place.
+         */
+        void enter_if(ast::if_expr& node) {
+            thread_local int block_name_counter = -1;
+            llvm::Value* condition_value = node.get_condition()->codegen();
+            condition_value = codegen::IR_Builder->CreateICmpNE(condition_value, llvm::ConstantInt::get(*codegen::LLVM_Context, llvm::APInt(1, 0)), "__if_cond__");
+            llvm::Function* parent_function = codegen::IR_Builder->GetInsertBlock()->getParent();
+            llvm::BasicBlock* then_blk = llvm::BasicBlock::Create(*codegen::LLVM_Context, "__then__" + std::to_string(++block_name_counter) + "__", parent_function);
+            llvm::BasicBlock* else_blk = node.get_else() ? llvm::BasicBlock::Create(*codegen::LLVM_Context, "__else__" + std::to_string(block_name_counter) + "__", parent_function) : nullptr;
+            if (node.get_merge_block() == nullptr) {
+                node.set_merge_block(llvm::BasicBlock::Create(*codegen::LLVM_Context, "__merge__" + std::to_string(block_name_counter) + "__", parent_function));
+            }
 
-       @par Create a conditional branch based on the integer comparison condition to either the else block if the else block is non-null, or the merge block if it is.
-       @code
-        codegen::IR_Builder->CreateCondBr(condition_value, then_blk, else_blk ? else_blk : merge_block);
-       @endcode
+            codegen::IR_Builder->CreateCondBr(condition_value, then_blk, else_blk ? else_blk : node.get_merge_block());
 
-       @par Set the insertion point to the then block, create a scope, and generate IR for all of the contained expressions.
-       @par Then exit the scope, and create an unconditional branch to the merge point.
-       @code
-        codegen::IR_Builder->SetInsertPoint(then_blk);
-        scope::create_scope();
-        for (auto const& expression : expressions) {
-            expression->codegen();
+            codegen::IR_Builder->SetInsertPoint(then_blk);
+            scope::create_scope();
+            open_branches.push_back({&node, 0, parent_function, then_blk, else_blk, node.get_merge_block()});
         }
-        scope::exit_scope();
-        codegen::IR_Builder->CreateBr(merge_block);
-       @endcode
-
-       @par If the else statement is non-null, set the insertion point to the else block
-       @code
-        if (else_stmt != nullptr) {
-            codegen::IR_Builder->SetInsertPoint(else_blk);
-       @endcode
 
-       @par If the else statement is an elif, grab the if expression from the else block, and set its merge point to the common merge point, then call codegen on the nested if expr.
-       @code
-        if (else_stmt->is_elif()) {
-            auto elif_node = else_stmt->grab_else_if();
-            elif_node->set_merge_block(merge_block);
-            elif_node->codegen();
-        }
-       @endcode
+        /**
+         * @par Finishes a block whose statements have all been generated. The end of a then block branches to the merge block and moves on to the else: an else if is entered like any other if, and a plain else has its block's scope opened.
+         * Once the last block of the statement is done, it is placed before the merge block, and generation carries on from the merge block.
+         */
+        void leave_branch(const open_branch& finished) {
+            scope::exit_scope();
+            codegen::IR_Builder->CreateBr(finished.merge_block);
 
-       @par If the else statement is not a nested else if, and just a raw else, generate IR, and create an unconditional branch to the merge point.
-       @par Then place the else block before the merge block to avoid spagetti code.
-       @code
-        parent_function->getBasicBlockList().splice(std::next(else_blk->getIterator()), parent_function->getBasicBlockList(), merge_block->getIterator());
-       @endcode
+            if (finished.node->get_kind() == ast::kind_if) {
+                ast::top_level_expr* else_stmt = ast::cast<ast::if_expr>(finished.node)->get_else();
+                if (else_stmt == nullptr) {
+                    finished.parent_function->getBasicBlockList().splice(std::next(finished.then_blk->getIterator()), finished.parent_function->getBasicBlockList(), finished.merge_block->getIterator());
+                    codegen::IR_Builder->SetInsertPoint(finished.merge_block);
+                    return;
+                }
 
-       @par If thesres is no else statement to speak of, then place the then block before the merge block.
-       @code
-        else {
-            parent_function->getBasicBlockList().splice(std::next(then_blk->getIterator()), parent_function->getBasicBlockList(), merge_block->getIterator());
-        }
-       @endcode
+                codegen::IR_Builder->SetInsertPoint(finished.else_blk);
+                if (else_stmt->is_elif()) {
+                    ast::if_expr* elif_node = ast::cast<ast::if_expr>(ast::cast<ast::else_expr>(else_stmt)->get_body().front().get());
+                    elif_node->set_merge_block(finished.merge_block);
+                    enter_if(*elif_node);
+                    return;
+                }
 
-       @par Then set the insertion point to the merge block, and proceed with code generation
-       @code
-        codegen::IR_Builder->SetInsertPoint(merge_block);
-        return nullptr;
-       @endcode
+                scope::create_scope();
+                open_branches.push_back({else_stmt, 0, finished.parent_function, finished.then_blk, finished.else_blk, finished.merge_block});
+                return;
+            }
 
-     */
-    llvm::Value* ast::if_expr::codegen() {
-        static int block_name_counter = -1;
-        llvm::Value* condition_value = condition->codegen();
-        condition_value = codegen::IR_Builder->CreateICmpNE(condition_value, llvm::ConstantInt::get(*codegen::LLVM_Context, llvm::APInt(1, 0)), "__if_cond__");
-        llvm::Function* parent_function = codegen::IR_Builder->GetInsertBlock()->getParent();
-        llvm::BasicBlock* then_blk = llvm::BasicBlock::Create(*codegen::LLVM_Context, "__then__" + std::to_string(++block_name_counter) + "__", parent_function);
-        llvm::BasicBlock* else_blk = else_stmt ? llvm::BasicBlock::Create(*codegen::LLVM_Context, "__else__" + std::to_string(block_name_counter) + "__", parent_function) : nullptr;
-        if (merge_block == nullptr) {
-            merge_block = llvm::BasicBlock::Create(*codegen::LLVM_Context, "__merge__" + std::to_string(block_name_counter) + "__", parent_function);
-        }
+            finished.parent_function->getBasicBlockList().splice(std::next(finished.else_blk->getIterator()), finished.parent_function->getBasicBlockList(), finished.merge_block->getIterator());
+            codegen::IR_Builder->SetInsertPoint(finished.merge_block);
+        }
+
+        /**
+         * @par Generates an if statement, with its else if chain and every if nested in its blocks, keeping the blocks being generated on `open_branches` instead of recursing into them.
+         * @code
+            enter_if(root);
+            while (open_branches.size() > base) {
+                open_branch& top = open_branches.back();
+                const ast::node_list& body = (top.node->get_kind() == ast::kind_if) ? ast::cast<ast::if_expr>(top.node)->get_body() : ast::cast<ast::else_expr>(top.node)->get_body();
+
+                if (top.next_statement < body.size()) {
+                    ast::top_level_expr* statement = body[top.next_statement++].get();
+                    if (statement->get_kind() == ast::kind_if) {
+                        enter_if(*ast::cast<ast::if_expr>(statement));
+                    } else {
+                        statement->codegen();
+                    }
+                    continue;
+                }
 
-        codegen::IR_Builder->CreateCondBr(condition_value, then_blk, else_blk ? else_blk : merge_block);
+                open_branch finished = top;
+                open_branches.pop_back();
+                leave_branch(finished);
+            }
+            return nullptr;
+         * @endcode
+         */
+        llvm::Value* generate_conditionals(ast::if_expr& root) {
+            const std::size_t base = open_branches.size();
+            enter_if(root);
+
+            while (open_branches.size() > base) {
+                open_branch& top = open_branches.back();
+                const ast::node_list& body = (top.node->get_kind() == ast::kind_if) ? ast::cast<ast::if_expr>(top.node)->get_body() : ast::cast<ast::else_expr>(top.node)->get_body();
+
+                if (top.next_statement < body.size()) {
+                    ast::top_level_expr* statement = body[top.next_statement++].get();
+                    if (statement->get_kind() == ast::kind_if) {
+                        enter_if(*ast::cast<ast::if_expr>(statement));
+                    } else {
+                        statement->codegen();
+                    }
+                    continue;
+                }
 
-        codegen::IR_Builder->SetInsertPoint(then_blk);
-        scope::create_scope();
-        for (auto const& expression : expressions) {
-            expression->codegen();
-        }
-        scope::exit_scope();
-        codegen::IR_Builder->CreateBr(merge_block);
-
-        if (else_stmt != nullptr) {
-            codegen::IR_Builder->SetInsertPoint(else_blk);
-            if (else_stmt->is_elif()) {
-                auto elif_node = else_stmt->grab_else_if();
-                elif_node->set_merge_block(merge_block);
-                elif_node->codegen(); 
-            } else {
-                else_stmt->codegen();
-                codegen::IR_Builder->CreateBr(merge_block);          
-                parent_function->getBasicBlockList().splice(std::next(else_blk->getIterator()), parent_function->getBasicBlockList(), merge_block->getIterator());
+                open_branch finished = top;
+                open_branches.pop_back();
+                leave_branch(finished);
             }
-        } else {
-            parent_function->getBasicBlockList().splice(std::next(then_blk->getIterator()), parent_function->getBasicBlockList(), merge_block->getIterator());
+            return nullptr;
         }
-        
-        codegen::IR_Builder->SetInsertPoint(merge_block);
+    }
 
-        return nullptr;
+    /**
+     * @fn ast::if_expr::codegen()
+     * @par Code generation for if expressions. The condition branches to a then block, or to the else block (if there is one) or the merge block, and every block ends by branching to the merge block; an else if chain shares the merge block of its first if.
+     * Nested ifs and else if chains are generated by `generate_conditionals` from an explicit stack, so deeply nested or very long chains do not grow the call stack.
+     * @code
+        return generate_conditionals(*this);
+     * @endcode
+     */
+    llvm::Value* ast::if_expr::codegen() {
+        return generate_conditionals(*this);
     }
 
     /**
@@ -994,6 +1103,7 @@ namespace ast {
 
         return nullptr;
         */
+        return nullptr; // not generated yet
     }
 
     /**
@@ -1009,14 +1119,19 @@ namespace ast {
         }
      * @endcode
 
-     @par Grab a reference to the called function from the module, and then return a call to it.
+     @par Grab a reference to the called function from the module, and then return a call to it. A function defined further down the file is not in the module yet, so it is declared here, with the signature semantic analysis checked the call against, and its definition fills it in later.
      @code
-        llvm::Function* callee = codegen::LLVM_Module->getFunction(func_name);
+        llvm::Function* callee = codegen::LLVM_Module->getFunction(interner::name(func_name));
         if (callee == nullptr) {
-            utility::codegen_error("Undefined function: " + func_name, parser::current_line);
+            std::vector<llvm::Type*> parameter_types;
+            for (auto const& argument : arguments) {
+                parameter_types.emplace_back(codegen::get_llvm_type(argument->get_expr_type()));
+            }
+            llvm::FunctionType* callee_type = llvm::FunctionType::get(codegen::get_llvm_type(get_expr_type()), parameter_types, false);
+            callee = llvm::Function::Create(callee_type, llvm::Function::ExternalLinkage, interner::name(func_name), *codegen::LLVM_Module);
         }
 
-        return codegen::IR_Builder->CreateCall(callee, llvm_arguments, "__" + func_name + "_call__");
+        return codegen::IR_Builder->CreateCall(callee, llvm_arguments, "__" + interner::name(func_name) + "_call__");
      @endcode
      */
     llvm::Value* ast::func_call_expr::codegen() {
@@ -1026,12 +1141,17 @@ namespace ast {
             llvm_arguments.push_back(argument_value);
         }
 
-        llvm::Function* callee = codegen::LLVM_Module->getFunction(func_name);
-        if (callee == nullptr) {
-            utility::codegen_error("Undefined function: " + func_name, parser::current_line);
+        llvm::Function* callee = codegen::LLVM_Module->getFunction(interner::name(func_name));
+        if (callee == nullptr) { // defined further down the file
+            std::vector<llvm::Type*> parameter_types;
+            for (auto const& argument : arguments) {
+                parameter_types.emplace_back(codegen::get_llvm_type(argument->get_expr_type()));
+            }
+            llvm::FunctionType* callee_type = llvm::FunctionType::get(codegen::get_llvm_type(get_expr_type()), parameter_types, false);
+            callee = llvm::Function::Create(callee_type, llvm::Function::ExternalLinkage, interner::name(func_name), *codegen::LLVM_Module);
         }
 
-        return codegen::IR_Builder->CreateCall(callee, llvm_arguments, "__" + func_name + "_call__");
+        return codegen::IR_Builder->CreateCall(callee, llvm_arguments, "__" + interner::name(func_name) + "_call__");
     }
 
     /**
@@ -1041,7 +1161,7 @@ namespace ast {
         llvm::Value* expr_to_print = expression->codegen();
 
         if (!expr_to_print) {
-            utility::codegen_error("Failed to generate value for print expression", parser::current_line);
+            utility::codegen_error("Failed to generate value for print expression", parser::current_location);
         }
         
         llvm::Value* fmt_str;
@@ -1056,7 +1176,7 @@ namespace ast {
                 fmt_str = codegen::IR_Builder->CreateGlobalStringPtr("%c\n", "format_str", 0, codegen::LLVM_Module.get());
                 break;
             default:
-                utility::codegen_error("Printing requested on invalid type", parser::current_line);
+                utility::codegen_error("Printing requested on invalid type", parser::current_location);
         }
 
         std::vector<llvm::Value*> printfArgs = {fmt_str, expr_to_print};
@@ -1068,7 +1188,7 @@ namespace ast {
         llvm::Value* expr_to_print = expression->codegen();
 
         if (!expr_to_print) {
-            utility::codegen_error("Failed to generate value for print expression", parser::current_line);
+            utility::codegen_error("Failed to generate value for print expression", parser::current_location);
         }
         
         llvm::Value* fmt_str;
@@ -1088,7 +1208,7 @@ namespace ast {
                 fmt_str = codegen::IR_Builder->CreateGlobalStringPtr("%c\n", "format_str", 0, codegen::LLVM_Module.get());
                 break;
             default:
-                utility::codegen_error("Printing requested on invalid type", parser::current_line);
+                utility::codegen_error("Printing requested on invalid type", parser::current_location);
         }
 
         std::vector<llvm::Value*> printfArgs = {fmt_str, expr_to_print};
@@ -1115,7 +1235,7 @@ namespace ast {
                 constructor = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiEC2Ev");
                 break;
             case (type_enum::float_type):
-                constructor = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfEC2Ev");
+                constructor = codegen::LLVM_Module->getFunction("_ZN10slib_graphIdEC2Ev");
                 break;
             case (type_enum::char_type):
                 constructor = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcEC2Ev");
@@ -1124,16 +1244,15 @@ namespace ast {
                 constructor = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbEC2Ev");
                 break;
             default:
-                utility::codegen_error("Invalid type passed to list", parser::current_line);
+                utility::codegen_error("Invalid type passed to list", parser::current_location);
                 
         }
 
 
-        llvm::StructType* struct_slib_graph_type = llvm::StructType::getTypeByName(*codegen::LLVM_Context, "class.slib_graph");
-        llvm::PointerType* pointer_type = llvm::PointerType::get(struct_slib_graph_type, 0);
+        llvm::Type* struct_slib_graph_type = constructor->getFunctionType()->getParamType(0)->getPointerElementType(); // each instantiation has its own struct type
         llvm::AllocaInst* instantiated_object = codegen::IR_Builder->CreateAlloca(struct_slib_graph_type, nullptr, "slib_graph_obj");
         codegen::IR_Builder->CreateCall(constructor, {instantiated_object});
-        scope::add_var_to_current_scope(graph_name, instantiated_object, codegen::get_llvm_type(type), true);
+        scope::bind_slot(slot, instantiated_object);
 
         return instantiated_object;
         
@@ -1152,7 +1271,7 @@ namespace ast {
                 constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIiEC2Ev");
                 break;
             case (type_enum::float_type):
-                constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIfEC2Ev");
+                constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIdEC2Ev");
                 break;
             case (type_enum::char_type):
                 constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIcEC2Ev");
@@ -1161,14 +1280,13 @@ namespace ast {
                 constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIbEC2Ev");
                 break;
             default:
-                utility::codegen_error("Invalid type passed to list", parser::current_line);
+                utility::codegen_error("Invalid type passed to list", parser::current_location);
         }
      * @endcode
 
-       @par Grab the struct type from the llvm context, and grab a pointer type to an slib_list struct type.
+       @par Take the struct type from the constructor's `this` parameter, since each element type's instantiation has a struct type of its own (`class.slib_list`, `class.slib_list.0`, ...).
        @code 
-        llvm::StructType* struct_slib_list_type = llvm::StructType::getTypeByName(*codegen::LLVM_Context, "class.slib_list");
-        llvm::PointerType* pointer_type = llvm::PointerType::get(struct_slib_list_type, 0);
+        llvm::Type* struct_slib_list_type = constructor->getFunctionType()->getParamType(0)->getPointerElementType();
        @endcode
 
        @par Allocate memory for the new object and create a call to it's constructor
@@ -1177,9 +1295,9 @@ namespace ast {
         codegen::IR_Builder->CreateCall(constructor, {instantiated_object});
        @endcode
 
-       @par Add the variable to the current scope to be found later, and return a pointer to the instantiated object allocation.
+       @par Store the object in the list's slot to be found later, and return a pointer to the instantiated object allocation.
        @code
-        scope::add_var_to_current_scope(name, instantiated_object, codegen::get_llvm_type(type), true);
+        scope::bind_slot(slot, instantiated_object);
         return instantiated_object;
        @endcode
      */
@@ -1192,7 +1310,7 @@ namespace ast {
                 constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIiEC2Ev");
                 break;
             case (type_enum::float_type):
-                constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIfEC2Ev");
+                constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIdEC2Ev");
                 break;
             case (type_enum::char_type):
                 constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIcEC2Ev");
@@ -1201,15 +1319,14 @@ namespace ast {
                 constructor = codegen::LLVM_Module->getFunction("_ZN9slib_listIbEC2Ev");
                 break;
             default:
-                utility::codegen_error("Invalid type passed to list", parser::current_line);
+                utility::codegen_error("Invalid type passed to list", parser::current_location);
         }
 
-        llvm::StructType* struct_slib_list_type = llvm::StructType::getTypeByName(*codegen::LLVM_Context, "class.slib_list");
-        llvm::PointerType* pointer_type = llvm::PointerType::get(struct_slib_list_type, 0);
+        llvm::Type* struct_slib_list_type = constructor->getFunctionType()->getParamType(0)->getPointerElementType();
         llvm::AllocaInst* instantiated_object = codegen::IR_Builder->CreateAlloca(struct_slib_list_type, nullptr, "slib_list_obj");
         codegen::IR_Builder->CreateCall(constructor, {instantiated_object});
 
-        scope::add_var_to_current_scope(name, instantiated_object, codegen::get_llvm_type(type), true);
+        scope::bind_slot(slot, instantiated_object);
 
         return instantiated_object;
     }
@@ -1217,467 +1334,57 @@ namespace ast {
 
     /**
      * @fn ast::method_dot_call::codegen()
-     * @par Lookup the variable in the current scope, and retrieve its allcoation.
-     * @code
-     *  llvm::AllocaInst* object = llvm::dyn_cast<llvm::AllocaInst>(scope::variable_lookup(item_name)->allocation);
-     * @endcode
-     * 
-     * @par If the aggregate type is a list type, call the correct handler for that function, which deals with calling the correct function based on the type.
+     * @par Take the function semantic analysis resolved the method to. Trees read back from the AST cache were never analyzed, so those look the method up in the unit's methods instead.
      * @code
-        if (aggregate_type == "list") {
-            if (called == "at") {
-                return codegen::list_handlers::list_at_handler(type, item_name, args);
-            } else if (called == "add") {
-                return codegen::list_handlers::list_add_handler(type, item_name, args);
-            } else if (called == "remove") {
-                return codegen::list_handlers::list_remove_handler(type, item_name, args);
-            } else if (called == "size") {
-                return codegen::list_handlers::list_size_handler(type, item_name, args);
+     *  llvm::Function* function = callee;
+        if (function == nullptr) {
+            const sem_analysis_scope::dot_call_target* method = sem_analysis_scope::find_dot_call({aggregate_type, obj_type, called});
+            if (method != nullptr) {
+                function = method->function;
             }
         }
+        if (function == nullptr) {
+            utility::codegen_error("Method (" + interner::name(called) + ") not found in module", parser::current_location);
+        }
      * @endcode
+     *
+     * @par Call it with the object's allocation first and the arguments of the call after it. Methods that return nothing give back a nullptr.
+     * @code
+        std::vector<llvm::Value*> call_args;
+        call_args.reserve(args.size() + 1);
+        call_args.push_back(scope::slot_storage(slot));
+        for (auto const& argument : args) {
+            call_args.push_back(argument->codegen());
+        }
 
-       @par Return a nullptr if the object is not found to suppress warnings, but in reality, the semantic analyzer will catch this bug.
-       @code
-        return nullptr;
-       @endcode
+        llvm::CallInst* call = codegen::IR_Builder->CreateCall(function, call_args);
+        return call->getType()->isVoidTy() ? nullptr : call;
+     * @endcode
      */
     llvm::Value* ast::method_dot_call::codegen() {
-        llvm::AllocaInst* object = llvm::dyn_cast<llvm::AllocaInst>(scope::variable_lookup(item_name)->allocation);
-
-        // LISTS
-        if (aggregate_type == "list") {
-            if (called == "at") {
-                return codegen::list_handlers::list_at_handler(obj_type, item_name, args);
-            } else if (called == "add") {
-                return codegen::list_handlers::list_add_handler(obj_type, item_name, args);
-            } else if (called == "remove") {
-                return codegen::list_handlers::list_remove_handler(obj_type, item_name, args);
-            } else if (called == "size") {
-                return codegen::list_handlers::list_size_handler(obj_type, item_name, args);
-            }
-        } else if (aggregate_type == "graph") {
-            if (called == "addNode") {
-                return codegen::graph_handlers::graph_add_node_handler(obj_type, item_name, args);
-            } else if (called == "containsNode") {
-                return codegen::graph_handlers::graph_contains_node_handler(obj_type, item_name, args);
-            } else if (called == "removeNode") {
-                return codegen::graph_handlers::graph_remove_node_handler(obj_type, item_name, args);
-            } else if (called == "size") {
-                return codegen::graph_handlers::graph_size_handler(obj_type, item_name, args);
-            } else if (called == "addEdge") {
-                return codegen::graph_handlers::graph_add_edge_handler(obj_type, item_name, args);
-            } else if (called  == "removeEdge") {
-                return codegen::graph_handlers::graph_remove_edge_handler(obj_type, item_name, args);
-            } else if (called  == "numEdges") {
-                return codegen::graph_handlers::graph_num_edge_handler(obj_type, item_name, args);
-            } else if (called == "printBFS") {
-                return codegen::graph_handlers::graph_BFS_printer_handler(obj_type, item_name, args);
-            } else if (called == "printDFS") {
-                return codegen::graph_handlers::graph_DFS_printer_handler(obj_type, item_name, args);
+        llvm::Function* function = callee;
+        if (function == nullptr) {
+            const sem_analysis_scope::dot_call_target* method = sem_analysis_scope::find_dot_call({aggregate_type, obj_type, called});
+            if (method != nullptr) {
+                function = method->function;
             }
         }
-        
-        return nullptr;
-
-    }
-}
-    
-namespace codegen {
-    namespace graph_handlers {
-        llvm::Value* graph_add_node_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* add_node_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    add_node_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE6insertEi");
-                    break;
-                case (type_enum::float_type):
-                    add_node_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE6insertEf");
-                    break;
-                case (type_enum::char_type):
-                    add_node_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE6insertEc");
-                    break;
-                case (type_enum::bool_type):
-                    add_node_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE6insertEb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!add_node_function) {
-                utility::codegen_error("Add node function not found in module", parser::current_line);
-            }
-
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* new_node = args.at(0)->codegen(); 
-
-            codegen::IR_Builder->CreateCall(add_node_function, {slib_obj, new_node});  
-            return nullptr;
-        }
-
-        llvm::Value* graph_contains_node_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE13contains_nodeEi");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE13contains_nodeEf");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE13contains_nodeEc");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE13contains_nodeEb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("Contains node function not found in module", parser::current_line);
-            }
-
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* checked_node = args.at(0)->codegen(); 
-
-            return codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj, checked_node});  
-        }
-
-        llvm::Value* graph_remove_node_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE6removeEi");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE6removeEf");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE6removeEc");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE6removeEb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("Remove node function not found in module", parser::current_line);
-            }
-
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* node_to_remove = args.at(0)->codegen(); 
-
-            codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj, node_to_remove});  
-
-            return nullptr;
-        }
-
-        llvm::Value* graph_size_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE4sizeEv");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE4sizeEv");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE4sizeEv");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE4sizeEv");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("Size (graph) function not found in module", parser::current_line);
-            }
-
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-
-            return codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj});            
-        }
-
-        llvm::Value* graph_add_edge_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE8add_edgeEii");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE8add_edgeEff");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE8add_edgeEcc");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE8add_edgeEbb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("Add edge function not found in module", parser::current_line);
-            }
-
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* from_node = args.at(0)->codegen(); 
-            llvm::Value* to_node = args.at(1)->codegen(); 
-
-            codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj, from_node, to_node});  
-
-            return nullptr;                 
+        if (function == nullptr) {
+            utility::codegen_error("Method (" + interner::name(called) + ") not found in module", parser::current_location);
         }
 
-        llvm::Value* graph_remove_edge_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE11remove_edgeEii");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE11remove_edgeEff");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE11remove_edgeEcc");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE11remove_edgeEbb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("Remove edge function not found in module", parser::current_line);
-            }
-
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* from_node = args.at(0)->codegen(); 
-            llvm::Value* to_node = args.at(1)->codegen(); 
-
-            codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj, from_node, to_node});  
-
-            return nullptr;            
+        std::vector<llvm::Value*> call_args;
+        call_args.reserve(args.size() + 1);
+        call_args.push_back(scope::slot_storage(slot));
+        for (auto const& argument : args) {
+            call_args.push_back(argument->codegen());
         }
 
-        llvm::Value* graph_num_edge_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE9num_edgesEv");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE9num_edgesEv");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE9num_edgesEv");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE9num_edgesEv");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("Number of edges function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-
-            return codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj});                              
-        }
-
-        llvm::Value* graph_BFS_printer_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE9print_BFSEi");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE9print_BFSEf");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE9print_BFSEc");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE9print_BFSEb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("PrintBFS function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* start_node = args.at(0)->codegen(); 
-            codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj, start_node});  
-
-            return nullptr;     
-        }
-
-        llvm::Value* graph_DFS_printer_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* graph_related_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIiE9print_DFSEi");
-                    break;
-                case (type_enum::float_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIfE9print_DFSEf");
-                    break;
-                case (type_enum::char_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIcE9print_DFSEc");
-                    break;
-                case (type_enum::bool_type):
-                    graph_related_function = codegen::LLVM_Module->getFunction("_ZN10slib_graphIbE9print_DFSEb");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to graph", parser::current_line);
-                    
-            }   
-            if (!graph_related_function) {
-                utility::codegen_error("PrintBFS function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* start_node = args.at(0)->codegen(); 
-            codegen::IR_Builder->CreateCall(graph_related_function, {slib_obj, start_node});  
-
-            return nullptr;  
-        }
-    }
-    namespace list_handlers {
-        llvm::Value* list_at_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* at_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    at_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIiE2atEi");
-                    break;
-                case (type_enum::float_type):
-                    at_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIfE2atEi");
-                    break;
-                case (type_enum::char_type):
-                    at_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIcE2atEi");
-                    break;
-                case (type_enum::bool_type):
-                    at_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIbE2atEi");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to list", parser::current_line);
-                    
-            }   
-            if (!at_function) {
-                utility::codegen_error("Insert function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* index = args.at(0)->codegen(); 
-
-            return codegen::IR_Builder->CreateCall(at_function, {slib_obj, index});   
-        }
-
-        llvm::Value* list_add_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* insert_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    insert_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIiE6insertEii");
-                    break;
-                case (type_enum::float_type):
-                    insert_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIfE6insertEfi");
-                    break;
-                case (type_enum::char_type):
-                    insert_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIcE6insertEci");
-                    break;
-                case (type_enum::bool_type):
-                    insert_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIbE6insertEbi");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to list", parser::current_line);
-            }   
-
-            if (!insert_function) {
-                utility::codegen_error("Insert function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* element = args.at(0)->codegen();
-            llvm::Value* index = args.at(1)->codegen();      
-
-            codegen::IR_Builder->CreateCall(insert_function, {slib_obj, element, index});   
-            return nullptr; 
-        }
-
-        llvm::Value* list_remove_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* rm_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    rm_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIiE6removeEi");
-                    break;
-                case (type_enum::float_type):
-                    rm_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIfE6removeEi");
-                    break;
-                case (type_enum::char_type):
-                    rm_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIcE6removeEi");
-                    break;
-                case (type_enum::bool_type):
-                    rm_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIbE6removeEi");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to list", parser::current_line);
-            }   
-            if (!rm_function) {
-                utility::codegen_error("Remove function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-            llvm::Value* index = args.at(0)->codegen(); 
-
-            return codegen::IR_Builder->CreateCall(rm_function, {slib_obj, index});  
-        }
-
-        llvm::Value* list_size_handler(type_enum::types obj_type, const std::string& item_name, std::vector<std::unique_ptr<ast::top_level_expr>>& args) {
-            llvm::Function* size_function = nullptr;
-            switch (obj_type) {
-                case (type_enum::int_type):
-                    size_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIiE4sizeEv");
-                    break;
-                case (type_enum::float_type):
-                    size_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIfE4sizeEv");
-                    break;
-                case (type_enum::char_type):
-                    size_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIcE4sizeEv");
-                    break;
-                case (type_enum::bool_type):
-                    size_function = codegen::LLVM_Module->getFunction("_ZN9slib_listIbE4sizeEv");
-                    break;
-                default:
-                    utility::codegen_error("Invalid type passed to list", parser::current_line);
-            } 
-            if (!size_function) {
-                utility::codegen_error("Size function not found in module", parser::current_line);
-            }
-
-            llvm::Value* slib_obj = scope::variable_lookup(item_name)->allocation;
-
-            return codegen::IR_Builder->CreateCall(size_function, {slib_obj}); 
-        }
+        llvm::CallInst* call = codegen::IR_Builder->CreateCall(function, call_args);
+        return call->getType()->isVoidTy() ? nullptr : call;
     }
 }
+
 namespace ast {
     /**
      * TODO: docs
@@ -12,6 +12,9 @@ If LICENSE.md is not included, this version of the source code is provided in br
 #include "../include/parser/parser.h"
 #include "../include/type_checker/type_checker.h"
 #include "../include/utility/utility.h"
+#include "../include/context/context.h"
+#include "../include/thread_pool/thread_pool.h"
+#include "../include/module_interface/module_interface.h"
 
 
 #include "llvm/Support/raw_ostream.h"
@@ -21,6 +24,10 @@ If LICENSE.md is not included, this version of the source code is provided in br
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <filesystem>
+#include <set>
+#include <sys/stat.h>
 
 #define DEBUG 0
 
@@ -28,30 +35,36 @@ int main(int argc, char** argv) {
 
     //std::cout << "My LLVM Driver is Working\n";
 
-    if (argc != 2) {
+    if (argc < 2) {
         utility::driver_args_error(argc);
     }
 
-    std::fstream file;
-    std::string file_name = argv[1];
-    
-    if (file_name.find(".pyrx") == std::string::npos) {
-        utility::driver_extension_error("Incorrect file extension on ", file_name);
-    }
-    
-    if (argc > 1) {
-        file.open(argv[1]);
-        if (!file) {
-            fprintf(stderr, "File not found.\n");
-            return 0;
+    std::vector<context::compilation_context> units(argc - 1); // one per .pyrx file, compiled in parallel
+
+    for (int i = 0; i < argc - 1; i++) {
+        context::compilation_context& unit = units[i];
+        unit.file_name = argv[i + 1];
+
+        if (unit.file_name.find(".pyrx") == std::string::npos) {
+            utility::driver_extension_error("Incorrect file extension on ", unit.file_name);
         }
-        lexer::input = &file;
-    } else {
-        fprintf(stderr, ">> "); // prime the inital token
-        lexer::input = &std::cin;
-    }
 
-    lexer::tokenize_file();
+        struct stat file_status;
+        bool is_regular_file = (stat(unit.file_name.c_str(), &file_status) == 0) && S_ISREG(file_status.st_mode);
+
+        if (is_regular_file && lexer::map_source_file(unit.lexer, unit.file_name)) {
+            // regular files are memory mapped, and tokens are views into the mapping
+        } else {
+            std::fstream file(unit.file_name);
+            if (!file) {
+                fprintf(stderr, "File not found.\n");
+                return 0;
+            }
+            unit.lexer.input = &file;
+            lexer::load_source_from_stream(unit.lexer);
+            unit.lexer.input = nullptr;
+        }
+    }
 
     utility::initialize_operator_precendence();
 
@@ -59,23 +72,47 @@ int main(int argc, char** argv) {
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
 
-    utility::init_llvm_mods();
-
-    utility::init_parser();
-
-    utility::primary_driver_loop();
+    thread_pool::parallel_for(units.size(), [&](std::size_t unit_index) {
+        utility::compile_translation_unit(units[unit_index]);
+    });
 
-    if (llvm::verifyModule(*codegen::LLVM_Module, &llvm::errs())) {
-        llvm::errs() << "Error: Module verification failed.\n";
-        exit(1);
+    for (context::compilation_context& unit : units) {
+        if (llvm::verifyModule(*unit.LLVM_Module, &llvm::errs())) {
+            llvm::errs() << "Error: Module verification failed.\n";
+            exit(1);
+        }
     }
 
     auto JIT = llvm::orc::LLJITBuilder().create();
     auto& jit = *JIT;
 
-    codegen::LLVM_Module->setDataLayout(jit->getDataLayout());
+    for (context::compilation_context& unit : units) {
+        unit.LLVM_Module->setDataLayout(jit->getDataLayout());
+        if (llvm::Error error = jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(unit.LLVM_Module), std::move(unit.LLVM_Context)))) {
+            llvm::errs() << "Error: " << unit.file_name << ": " << llvm::toString(std::move(error)) << "\n"; // e.g. a symbol defined by two files
+            exit(1);
+        }
+    }
+
+    std::set<std::string> unit_paths; // a module also named on the command line is already in the JIT as a unit
+    for (context::compilation_context& unit : units) {
+        std::error_code error;
+        unit_paths.insert(std::filesystem::weakly_canonical(unit.file_name, error).string());
+    }
+
+    for (const module_interface::interface* module : module_interface::required_modules()) { // each included module once, however many files include it
+        if (unit_paths.count(module->source_path) != 0) {
+            continue;
+        }
+        auto module_context = std::make_unique<llvm::LLVMContext>();
+        std::unique_ptr<llvm::Module> module_ir = module_interface::load_bitcode(*module, *module_context);
+        module_ir->setDataLayout(jit->getDataLayout());
+        if (llvm::Error error = jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module_ir), std::move(module_context)))) {
+            llvm::errs() << "Error: " << module->source_path << ": " << llvm::toString(std::move(error)) << "\n";
+            exit(1);
+        }
+    }
 
-    auto added_ir_module = jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(codegen::LLVM_Module), std::move(codegen::LLVM_Context)));
     JIT->get()->getMainJITDylib().addGenerator(llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(JIT->get()->getDataLayout().getGlobalPrefix())));
     auto main_symbol = jit->lookup("main");
     if(!main_symbol) {
@@ -86,8 +123,5 @@ int main(int argc, char** argv) {
     auto main_function_entry_pt = (int (*)())(main_symbol->getValue());
     main_function_entry_pt();
 
-
-    file.close();
-
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,510 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/flat_ast/flat_ast.h"
+
+namespace flat_ast {
+
+    namespace {
+
+        /**
+         * @par Appends the per node entries of `node` (its record slot is filled in by the caller).
+         */
+        node_index add_node(tree& flat, const ast::top_level_expr* node) {
+            node_index index = static_cast<node_index>(flat.kinds.size());
+            flat.kinds.push_back(node->get_kind());
+            flat.slots.push_back(0);
+            flat.types.push_back(static_cast<int8_t>(node->get_expr_type()));
+            flat.locations.push_back(node->get_location());
+            flat.is_global.push_back(false);
+            flat.variable_slots.push_back(ast::no_slot);
+            return index;
+        }
+
+        /**
+         * @struct pending_child
+         * @par A node waiting to be flattened, and where its index goes once it has one: field `field` of the record of `parent`, or (with no parent) entry `field` of `tree::children`. A root has neither.
+         */
+        struct pending_child {
+            ast::top_level_expr* node;
+            node_index parent;
+            uint32_t field;
+        };
+
+        /**
+         * @par Writes `child` into field `field` of the record of `parent`. Records with two or three single children number them in source order (a binary's left and right, an if's condition and else, a for's definition, condition and modification).
+         */
+        void set_child(tree& flat, node_index parent, uint32_t field, node_index child) {
+            uint32_t slot = flat.slots[parent];
+            switch (flat.kinds[parent]) {
+                case ast::kind_binary:
+                    (field == 0 ? flat.binaries[slot].left : flat.binaries[slot].right) = child;
+                    break;
+                case ast::kind_unary:
+                    flat.unaries[slot].operand = child;
+                    break;
+                case ast::kind_var_defn:
+                    flat.definitions[slot].value = child;
+                    break;
+                case ast::kind_var_assign:
+                    flat.assignments[slot].value = child;
+                    break;
+                case ast::kind_return:
+                    flat.returns[slot] = child;
+                    break;
+                case ast::kind_if:
+                    (field == 0 ? flat.ifs[slot].condition : flat.ifs[slot].else_branch) = child;
+                    break;
+                case ast::kind_for:
+                    (field == 0 ? flat.fors[slot].variable_defn : (field == 1 ? flat.fors[slot].condition : flat.fors[slot].var_modification)) = child;
+                    break;
+                case ast::kind_print:
+                    flat.prints[slot] = child;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        /**
+         * @par Queues a single child (if there is one) to be written into field `field` of `parent`.
+         */
+        void push_child(std::vector<pending_child>& pending, ast::top_level_expr* child, node_index parent, uint32_t field) {
+            if (child != nullptr) {
+                pending.push_back({child, parent, field});
+            }
+        }
+
+        /**
+         * @par Reserves a contiguous range of `tree::children` for a list of `count` children, filled in as they are flattened.
+         */
+        child_range reserve_list(tree& flat, std::size_t count) {
+            child_range range = {static_cast<uint32_t>(flat.children.size()), static_cast<uint32_t>(count)};
+            flat.children.resize(flat.children.size() + count, no_node);
+            return range;
+        }
+
+        /**
+         * @par Queues a child list into its reserved range, last child first, so that the children come off the stack in source order.
+         */
+        void push_list(std::vector<pending_child>& pending, const ast::node_list& list, child_range range) {
+            for (std::size_t child = list.size(); child-- > 0; ) {
+                pending.push_back({list[child].get(), no_node, static_cast<uint32_t>(range.first + child)});
+            }
+        }
+
+        /**
+         * @par Appends the record of one node and queues its children. Children are pushed last to first, so the walk stays in pre-order and a node keeps a smaller index than any of its descendants.
+         */
+        node_index flatten_one(tree& flat, ast::top_level_expr* node, std::vector<pending_child>& pending) {
+            node_index index = add_node(flat, node);
+            uint32_t slot = 0;
+
+            switch (node->get_kind()) {
+                case ast::kind_binary: {
+                    ast::binary_expr* binary = ast::cast<ast::binary_expr>(node);
+                    slot = flat.binaries.size();
+                    flat.binaries.push_back({binary->get_op_token(), no_node, no_node});
+                    push_child(pending, binary->get_right(), index, 1);
+                    push_child(pending, binary->get_left(), index, 0);
+                    break;
+                }
+                case ast::kind_unary: {
+                    ast::unary_expr* unary = ast::cast<ast::unary_expr>(node);
+                    slot = flat.unaries.size();
+                    flat.unaries.push_back({unary->get_op_token(), no_node});
+                    push_child(pending, unary->get_operand(), index, 0);
+                    break;
+                }
+                case ast::kind_identifier:
+                    slot = flat.identifiers.size();
+                    flat.identifiers.push_back(node->get_name());
+                    flat.is_global[index] = ast::cast<ast::identifier_expr>(node)->get_is_global();
+                    flat.variable_slots[index] = ast::cast<ast::identifier_expr>(node)->get_slot();
+                    break;
+                case ast::kind_int:
+                    slot = flat.ints.size();
+                    flat.ints.push_back(ast::cast<ast::integer_expression>(node)->get_value());
+                    break;
+                case ast::kind_float:
+                    slot = flat.floats.size();
+                    flat.floats.push_back(ast::cast<ast::float_expression>(node)->get_value());
+                    break;
+                case ast::kind_char:
+                    slot = flat.chars.size();
+                    flat.chars.push_back(ast::cast<ast::char_expression>(node)->get_value());
+                    break;
+                case ast::kind_string: {
+                    std::string_view text = ast::cast<ast::string_expression>(node)->get_value();
+                    slot = flat.strings.size();
+                    flat.strings.push_back({static_cast<uint32_t>(flat.string_pool.size()), static_cast<uint32_t>(text.size())});
+                    flat.string_pool.append(text);
+                    break;
+                }
+                case ast::kind_bool:
+                    slot = flat.bools.size();
+                    flat.bools.push_back(ast::cast<ast::bool_expression>(node)->get_value());
+                    break;
+                case ast::kind_var_decl:
+                    flat.is_global[index] = ast::cast<ast::variable_declaration>(node)->get_is_global();
+                    flat.variable_slots[index] = ast::cast<ast::variable_declaration>(node)->get_slot();
+                    [[fallthrough]];
+                case ast::kind_graph_decl: case ast::kind_list_decl:
+                    if (node->get_kind() == ast::kind_graph_decl) {
+                        flat.variable_slots[index] = ast::cast<ast::graph_decl_expr>(node)->get_slot();
+                    } else if (node->get_kind() == ast::kind_list_decl) {
+                        flat.variable_slots[index] = ast::cast<ast::list_decl>(node)->get_slot();
+                    }
+                    slot = flat.declarations.size();
+                    flat.declarations.push_back({node->get_name(), node->get_expr_type()});
+                    break;
+                case ast::kind_var_defn: {
+                    ast::variable_definition* definition = ast::cast<ast::variable_definition>(node);
+                    slot = flat.definitions.size();
+                    flat.definitions.push_back({definition->get_name(), definition->get_expr_type(), no_node});
+                    flat.is_global[index] = definition->get_is_global();
+                    flat.variable_slots[index] = definition->get_slot();
+                    push_child(pending, definition->get_assigned_value(), index, 0);
+                    break;
+                }
+                case ast::kind_var_assign: {
+                    ast::variable_assignment* assignment = ast::cast<ast::variable_assignment>(node);
+                    slot = flat.assignments.size();
+                    flat.assignments.push_back({assignment->get_name(), no_node});
+                    flat.is_global[index] = assignment->get_is_global();
+                    flat.variable_slots[index] = assignment->get_slot();
+                    push_child(pending, assignment->get_assigned_value(), index, 0);
+                    break;
+                }
+                case ast::kind_return:
+                    slot = flat.returns.size();
+                    flat.returns.push_back(no_node);
+                    push_child(pending, ast::cast<ast::return_expr>(node)->get_returned_value(), index, 0);
+                    break;
+                case ast::kind_if: {
+                    ast::if_expr* if_node = ast::cast<ast::if_expr>(node);
+                    slot = flat.ifs.size();
+                    flat.ifs.push_back({no_node, reserve_list(flat, if_node->get_body().size()), no_node});
+                    push_child(pending, if_node->get_else(), index, 1);
+                    push_list(pending, if_node->get_body(), flat.ifs[slot].body);
+                    push_child(pending, if_node->get_condition(), index, 0);
+                    break;
+                }
+                case ast::kind_else: {
+                    ast::else_expr* else_node = ast::cast<ast::else_expr>(node);
+                    slot = flat.elses.size();
+                    flat.elses.push_back({reserve_list(flat, else_node->get_body().size()), else_node->is_elif()});
+                    push_list(pending, else_node->get_body(), flat.elses[slot].body);
+                    break;
+                }
+                case ast::kind_for: {
+                    ast::for_expr* for_node = ast::cast<ast::for_expr>(node);
+                    slot = flat.fors.size();
+                    flat.fors.push_back({no_node, no_node, no_node, reserve_list(flat, for_node->get_body().size())});
+                    push_list(pending, for_node->get_body(), flat.fors[slot].body);
+                    push_child(pending, for_node->get_var_modification(), index, 2);
+                    push_child(pending, for_node->get_condition(), index, 1);
+                    push_child(pending, for_node->get_variable_defn(), index, 0);
+                    break;
+                }
+                case ast::kind_func_call: {
+                    ast::func_call_expr* call = ast::cast<ast::func_call_expr>(node);
+                    slot = flat.calls.size();
+                    flat.calls.push_back({call->get_name(), reserve_list(flat, call->get_arguments().size())});
+                    push_list(pending, call->get_arguments(), flat.calls[slot].arguments);
+                    break;
+                }
+                case ast::kind_print:
+                    slot = flat.prints.size();
+                    flat.prints.push_back(no_node);
+                    push_child(pending, ast::cast<ast::print_expr>(node)->get_expression(), index, 0);
+                    break;
+                case ast::kind_method_dot_call: {
+                    ast::method_dot_call* call = ast::cast<ast::method_dot_call>(node);
+                    slot = flat.method_calls.size();
+                    flat.method_calls.push_back({call->get_item_name(), call->get_called(), reserve_list(flat, call->get_arguments().size()), call->get_obj_type(), call->get_ag_type()});
+                    flat.variable_slots[index] = call->get_slot();
+                    push_list(pending, call->get_arguments(), flat.method_calls[slot].arguments);
+                    break;
+                }
+                case ast::kind_dot_call_var: {
+                    ast::dot_call_var* member = ast::cast<ast::dot_call_var>(node);
+                    slot = flat.members.size();
+                    flat.members.push_back({member->get_item_name(), member->get_called()});
+                    break;
+                }
+            }
+
+            flat.slots[index] = slot;
+            return index;
+        }
+
+        /**
+         * @par Flattens every queued node (and what it queues in turn), writing each index to where its parent asked for it. Returns the index of the last root popped, if any.
+         * @code
+            node_index root = no_node;
+            while (!pending.empty()) {
+                pending_child next = pending.back();
+                pending.pop_back();
+
+                node_index index = flatten_one(flat, next.node, pending);
+                if (next.parent != no_node) {
+                    set_child(flat, next.parent, next.field, index);
+                } else if (next.field != no_node) {
+                    flat.children[next.field] = index;
+                } else {
+                    root = index;
+                }
+            }
+            return root;
+         * @endcode
+         */
+        node_index flatten_pending(tree& flat, std::vector<pending_child>& pending) {
+            node_index root = no_node;
+            while (!pending.empty()) {
+                pending_child next = pending.back();
+                pending.pop_back();
+
+                node_index index = flatten_one(flat, next.node, pending);
+                if (next.parent != no_node) {
+                    set_child(flat, next.parent, next.field, index);
+                } else if (next.field != no_node) {
+                    flat.children[next.field] = index;
+                } else {
+                    root = index;
+                }
+            }
+            return root;
+        }
+
+        /**
+         * @par Takes the already rebuilt node at `index` out of `built` (nothing for `no_node`).
+         */
+        ast::node_ptr<ast::top_level_expr> take_node(std::vector<ast::node_ptr<ast::top_level_expr>>& built, node_index index) {
+            return (index == no_node) ? nullptr : std::move(built[index]);
+        }
+
+        ast::node_list take_list(const tree& flat, std::vector<ast::node_ptr<ast::top_level_expr>>& built, child_range range) {
+            ast::node_list list;
+            list.reserve(range.count);
+            for (const node_index* child = range_begin(flat, range); child != range_end(flat, range); ++child) {
+                list.push_back(std::move(built[*child]));
+            }
+            return list;
+        }
+
+        /**
+         * @par Rebuilds one node from its children, which `expand` has already rebuilt (every child has a larger index than its parent), restoring the type and location it was flattened with, along with what semantic analysis resolved on it (whether a name is global, and the receiver of a method call).
+         */
+        ast::node_ptr<ast::top_level_expr> expand_one(const tree& flat, node_index index, std::vector<ast::node_ptr<ast::top_level_expr>>& built) {
+            uint32_t slot = flat.slots[index];
+            ast::node_ptr<ast::top_level_expr> node;
+
+            switch (flat.kinds[index]) {
+                case ast::kind_binary: {
+                    const binary_node& binary = flat.binaries[slot];
+                    ast::node_ptr<ast::top_level_expr> left = take_node(built, binary.left);
+                    node = ast::make_node<ast::binary_expr>(binary.op, std::move(left), take_node(built, binary.right));
+                    break;
+                }
+                case ast::kind_unary:
+                    node = ast::make_node<ast::unary_expr>(flat.unaries[slot].op, take_node(built, flat.unaries[slot].operand));
+                    break;
+                case ast::kind_identifier: {
+                    auto identifier = ast::make_node<ast::identifier_expr>(flat.identifiers[slot]);
+                    identifier->set_is_global(flat.is_global[index]);
+                    identifier->set_slot(flat.variable_slots[index]);
+                    node = std::move(identifier);
+                    break;
+                }
+                case ast::kind_int:
+                    node = ast::make_node<ast::integer_expression>(flat.ints[slot]);
+                    break;
+                case ast::kind_float:
+                    node = ast::make_node<ast::float_expression>(flat.floats[slot]);
+                    break;
+                case ast::kind_char:
+                    node = ast::make_node<ast::char_expression>(flat.chars[slot]);
+                    break;
+                case ast::kind_string:
+                    node = ast::make_node<ast::string_expression>(string_value(flat, index));
+                    break;
+                case ast::kind_bool:
+                    node = ast::make_node<ast::bool_expression>(flat.bools[slot]);
+                    break;
+                case ast::kind_var_decl: {
+                    auto declaration = ast::make_node<ast::variable_declaration>(flat.declarations[slot].type, flat.declarations[slot].name);
+                    declaration->set_is_global(flat.is_global[index]);
+                    declaration->set_slot(flat.variable_slots[index]);
+                    node = std::move(declaration);
+                    break;
+                }
+                case ast::kind_graph_decl: {
+                    auto graph = ast::make_node<ast::graph_decl_expr>(flat.declarations[slot].type, flat.declarations[slot].name);
+                    graph->set_slot(flat.variable_slots[index]);
+                    node = std::move(graph);
+                    break;
+                }
+                case ast::kind_list_decl: {
+                    auto list = ast::make_node<ast::list_decl>(flat.declarations[slot].type, flat.declarations[slot].name);
+                    list->set_slot(flat.variable_slots[index]);
+                    node = std::move(list);
+                    break;
+                }
+                case ast::kind_var_defn: {
+                    const definition_node& definition = flat.definitions[slot];
+                    auto expanded = ast::make_node<ast::variable_definition>(definition.type, definition.name, take_node(built, definition.value));
+                    expanded->set_is_global(flat.is_global[index]);
+                    expanded->set_slot(flat.variable_slots[index]);
+                    node = std::move(expanded);
+                    break;
+                }
+                case ast::kind_var_assign: {
+                    auto assignment = ast::make_node<ast::variable_assignment>(flat.assignments[slot].name, take_node(built, flat.assignments[slot].value));
+                    assignment->set_is_global(flat.is_global[index]);
+                    assignment->set_slot(flat.variable_slots[index]);
+                    node = std::move(assignment);
+                    break;
+                }
+                case ast::kind_return:
+                    node = ast::make_node<ast::return_expr>(take_node(built, flat.returns[slot]));
+                    break;
+                case ast::kind_if: {
+                    const if_node& if_record = flat.ifs[slot];
+                    ast::node_ptr<ast::top_level_expr> condition = take_node(built, if_record.condition);
+                    ast::node_list body = take_list(flat, built, if_record.body);
+                    node = ast::make_node<ast::if_expr>(std::move(condition), std::move(body), take_node(built, if_record.else_branch));
+                    break;
+                }
+                case ast::kind_else:
+                    node = ast::make_node<ast::else_expr>(take_list(flat, built, flat.elses[slot].body), flat.elses[slot].is_else_if);
+                    break;
+                case ast::kind_for: {
+                    const for_node& for_record = flat.fors[slot];
+                    ast::node_list body = take_list(flat, built, for_record.body);
+                    ast::node_ptr<ast::top_level_expr> variable_defn = take_node(built, for_record.variable_defn);
+                    ast::node_ptr<ast::top_level_expr> condition = take_node(built, for_record.condition);
+                    node = ast::make_node<ast::for_expr>(std::move(body), std::move(variable_defn), std::move(condition), take_node(built, for_record.var_modification));
+                    break;
+                }
+                case ast::kind_func_call:
+                    node = ast::make_node<ast::func_call_expr>(flat.calls[slot].name, take_list(flat, built, flat.calls[slot].arguments));
+                    break;
+                case ast::kind_print:
+                    node = ast::make_node<ast::print_expr>(take_node(built, flat.prints[slot]));
+                    break;
+                case ast::kind_method_dot_call: {
+                    const method_call_node& call = flat.method_calls[slot];
+                    auto expanded = ast::make_node<ast::method_dot_call>(call.item_name, call.called, take_list(flat, built, call.arguments));
+                    expanded->set_obj_type(call.obj_type);
+                    expanded->set_aggregate_type(call.aggregate_type);
+                    expanded->set_slot(flat.variable_slots[index]);
+                    node = std::move(expanded);
+                    break;
+                }
+                case ast::kind_dot_call_var:
+                    node = ast::make_node<ast::dot_call_var>(flat.members[slot].item_name, flat.members[slot].called);
+                    break;
+            }
+
+            node->set_expr_type(static_cast<type_enum::types>(flat.types[index]));
+            node->set_location(flat.locations[index]);
+            return node;
+        }
+
+        template <typename T>
+        std::size_t vector_bytes(const std::vector<T>& items) {
+            return items.capacity() * sizeof(T);
+        }
+    }
+
+    /**
+     * @par Appends a parsed program to `flat`, in source order. Nodes are flattened from an explicit stack, so arbitrarily deep expressions and blocks do not grow the call stack.
+     * @code
+        std::vector<pending_child> pending;
+        for (const auto& item : program) {
+            if (item.index() == 0) {
+                pending.push_back({std::get<0>(item).get(), no_node, no_node});
+                flat.roots.push_back({false, flatten_pending(flat, pending)});
+                continue;
+            }
+
+            ast::func_defn& function = *std::get<1>(item);
+            uint32_t slot = flat.functions.size();
+            child_range parameters = reserve_list(flat, function.get_parameters().size());
+            child_range body = reserve_list(flat, function.get_body().size());
+            flat.functions.push_back({function.get_return_type(), function.get_name(), parameters, body, function.get_location()});
+            push_list(pending, function.get_body(), body);
+            push_list(pending, function.get_parameters(), parameters);
+            flatten_pending(flat, pending);
+            flat.roots.push_back({true, slot});
+        }
+     * @endcode
+     */
+    void flatten(tree& flat, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        std::vector<pending_child> pending;
+        for (const auto& item : program) {
+            if (item.index() == 0) {
+                pending.push_back({std::get<0>(item).get(), no_node, no_node});
+                flat.roots.push_back({false, flatten_pending(flat, pending)});
+                continue;
+            }
+
+            ast::func_defn& function = *std::get<1>(item);
+            uint32_t slot = flat.functions.size();
+            child_range parameters = reserve_list(flat, function.get_parameters().size());
+            child_range body = reserve_list(flat, function.get_body().size());
+            flat.functions.push_back({function.get_return_type(), function.get_name(), parameters, body, function.get_location()});
+            push_list(pending, function.get_body(), body);
+            push_list(pending, function.get_parameters(), parameters);
+            flatten_pending(flat, pending);
+            flat.roots.push_back({true, slot});
+        }
+    }
+
+    /**
+     * @par Rebuilds the program a tree was flattened from as AST nodes in the active arena, which semantic analysis and codegen then run on exactly as they would on freshly parsed nodes.
+     * Nodes are rebuilt from the last index to the first, so every node's children are ready before it is, and no call recurses into a subtree.
+     */
+    std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> expand(const tree& flat) {
+        std::vector<ast::node_ptr<ast::top_level_expr>> built(flat.kinds.size());
+        for (node_index index = static_cast<node_index>(flat.kinds.size()); index-- > 0; ) {
+            built[index] = expand_one(flat, index, built);
+        }
+
+        std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> program;
+        program.reserve(flat.roots.size());
+
+        for (const top_level_item& root : flat.roots) {
+            if (!root.is_function) {
+                program.emplace_back(std::move(built[root.index]));
+                continue;
+            }
+
+            const function_node& function = flat.functions[root.index];
+            ast::node_list body = take_list(flat, built, function.body);
+            auto expanded = ast::make_node<ast::func_defn>(function.return_type, function.name, std::move(body), take_list(flat, built, function.parameters));
+            expanded->set_location(function.location);
+            program.emplace_back(std::move(expanded));
+        }
+        return program;
+    }
+
+    /**
+     * @par Returns how many bytes the tree's arrays have reserved.
+     */
+    std::size_t memory_bytes(const tree& flat) {
+        return vector_bytes(flat.kinds) + vector_bytes(flat.slots) + vector_bytes(flat.types) + vector_bytes(flat.locations) + flat.is_global.capacity() / 8 + vector_bytes(flat.variable_slots)
+            + vector_bytes(flat.binaries) + vector_bytes(flat.unaries) + vector_bytes(flat.identifiers) + vector_bytes(flat.ints)
+            + vector_bytes(flat.floats) + vector_bytes(flat.chars) + vector_bytes(flat.strings) + flat.bools.capacity() / 8
+            + vector_bytes(flat.declarations) + vector_bytes(flat.definitions) + vector_bytes(flat.assignments) + vector_bytes(flat.returns)
+            + vector_bytes(flat.ifs) + vector_bytes(flat.elses) + vector_bytes(flat.fors) + vector_bytes(flat.calls)
+            + vector_bytes(flat.prints) + vector_bytes(flat.method_calls) + vector_bytes(flat.members) + vector_bytes(flat.functions)
+            + vector_bytes(flat.children) + flat.string_pool.capacity() + vector_bytes(flat.roots);
+    }
+}
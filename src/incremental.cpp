@@ -0,0 +1,344 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/incremental/incremental.h"
+#include "../include/parser/parser.h"
+#include "../include/utility/utility.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace incremental {
+
+    namespace {
+
+        /**
+         * @par Makes token `index` the current token of the parser (re-pointing it at the document's lexer, which may have moved along with the document since it was parsed).
+         * @code
+            doc.unit.parser.source = &doc.unit.lexer;
+            doc.unit.parser.token_index_max = doc.unit.lexer.token_stream.size();
+            doc.unit.parser.current_token_index = index;
+            parser::get_next_token(doc.unit);
+         * @endcode
+         */
+        void seek(document& doc, std::size_t index) {
+            doc.unit.parser.source = &doc.unit.lexer;
+            doc.unit.parser.token_index_max = doc.unit.lexer.token_stream.size();
+            doc.unit.parser.current_token_index = index;
+            parser::get_next_token(doc.unit);
+        }
+
+        /**
+         * @par Returns the index of the parser's current token.
+         */
+        inline std::size_t current_position(const document& doc) {
+            return doc.unit.parser.current_token_index - 1;
+        }
+
+        /**
+         * @par Moves the source location of every node of a kept statement by `offset_shift`, the change in length of the text before it. The nodes are walked from `pending`, an explicit stack shared by every statement an edit keeps, so deep statements do not grow the call stack and the walk does not allocate per statement.
+         */
+        void shift_locations(parsed_statement& statement, std::ptrdiff_t offset_shift, std::vector<ast::top_level_expr*>& pending) {
+            if (statement.node.index() == 0) {
+                pending.push_back(std::get<0>(statement.node).get());
+            } else {
+                ast::func_defn& function = *std::get<1>(statement.node);
+                function.set_location(function.get_location() + offset_shift);
+                for (const ast::node_ptr<ast::top_level_expr>& parameter : function.get_parameters()) {
+                    pending.push_back(parameter.get());
+                }
+                for (const ast::node_ptr<ast::top_level_expr>& expression : function.get_body()) {
+                    pending.push_back(expression.get());
+                }
+            }
+
+            while (!pending.empty()) {
+                ast::top_level_expr* node = pending.back();
+                pending.pop_back();
+                if (node->get_location() != lexer::no_location) {
+                    node->set_location(node->get_location() + offset_shift);
+                }
+                ast::for_each_child(node, [&](ast::top_level_expr* child) {
+                    pending.push_back(child);
+                });
+            }
+        }
+
+        /**
+         * @par Parses one top level statement at the current token into `output`, recording where it started. Returns false at EOF.
+         * @code
+            std::size_t first_token = current_position(doc);
+            scratch.clear();
+            if (!utility::parse_top_level_statement(doc.unit, scratch)) {
+                return false;
+            }
+            if (!scratch.empty()) {
+                output.push_back({first_token, std::move(scratch.back())});
+            }
+            return true;
+         * @endcode
+         */
+        bool parse_statement(document& doc, std::vector<parsed_statement>& output, std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& scratch) {
+            std::size_t first_token = current_position(doc);
+            scratch.clear();
+            if (!utility::parse_top_level_statement(doc.unit, scratch)) {
+                return false;
+            }
+            if (!scratch.empty()) {
+                output.push_back({first_token, std::move(scratch.back())});
+            }
+            return true;
+        }
+
+        /**
+         * @par Parses the whole token stream, the same way `utility::primary_driver_loop()` does, minus building and linking the included libraries.
+         * @code
+            doc.unit.library_and_include.clear();
+            doc.statements.clear();
+            doc.unit.ast_arena.release();
+            arena::arena_scope ast_scope(doc.unit.ast_arena);
+
+            utility::init_parser(doc.unit);
+            parser::get_next_token(doc.unit);
+            while (doc.unit.parser.current_token == lexer::tok_include) {
+                doc.unit.library_and_include.insert(parser::parse_include(doc.unit));
+            }
+            doc.body_start = current_position(doc);
+
+            std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> scratch;
+            while (parse_statement(doc, doc.statements, scratch)) {}
+            doc.parsed_arena_bytes = doc.unit.ast_arena.bytes_used();
+         * @endcode
+         */
+        void parse_document(document& doc) {
+            doc.unit.library_and_include.clear();
+            doc.statements.clear();
+            doc.unit.ast_arena.release();
+            arena::arena_scope ast_scope(doc.unit.ast_arena);
+
+            utility::init_parser(doc.unit);
+            parser::get_next_token(doc.unit);
+            while (doc.unit.parser.current_token == lexer::tok_include) {
+                doc.unit.library_and_include.insert(parser::parse_include(doc.unit));
+            }
+            doc.body_start = current_position(doc);
+
+            std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> scratch;
+            while (parse_statement(doc, doc.statements, scratch)) {}
+            doc.parsed_arena_bytes = doc.unit.ast_arena.bytes_used();
+        }
+
+        /**
+         * <h4> Brings the statements of a document up to date with an edit whose tokens `lexer::relex_edit()` has just replaced (`damage`), reparsing only the top level statements that could have changed. Every other statement keeps its existing subtree. </h4>
+         *
+         * @par Finding the Damaged Statements
+         * A statement is parsed from its own tokens, the token after it (where the parser stops), and at most one token of lookahead past that. So the first statement that must be reparsed is the last one whose next neighbour starts no earlier than one token before the damage.
+         * Edits that reach the include statements change what the whole file includes, so the document is parsed again from the start. So is a document whose arena has grown to hold more replaced statements than live ones, which frees them:
+         * @code
+         * if (damage.first <= doc.body_start || doc.unit.ast_arena.bytes_used() > 2 * doc.parsed_arena_bytes + arena::bump_arena::first_block_size) {
+         *     doc.last_edit.full_reparse = true;
+         *     parse_document(doc);
+         *     return;
+         * }
+         *
+         * auto next = std::partition_point(statements.begin(), statements.end(), [&](const parsed_statement& statement) {
+         *     return statement.first_token + 1 < damage.first;
+         * });
+         * std::size_t first_damaged = (next == statements.begin()) ? 0 : (next - statements.begin()) - 1;
+         * std::size_t start = (first_damaged == 0) ? doc.body_start : statements[first_damaged].first_token;
+         * @endcode
+         *
+         * @par Resynchronizing
+         * Statements are reparsed until the parser stops, past the damaged tokens, on the (shifted) first token of an old statement. Parsing from there would retrace exactly what the old parse did, so that statement and every one after it are kept, with their token indices and source locations shifted past the edit:
+         * @code
+         * std::size_t position = current_position(doc);
+         * if (position >= damage_end) {
+         *     std::size_t old_position = position - token_shift;
+         *     while (reuse < statements.size() && statements[reuse].first_token < old_position) {
+         *         reuse++;
+         *     }
+         *     if (reuse < statements.size() && statements[reuse].first_token == old_position) {
+         *         break;
+         *     }
+         * }
+         * @endcode
+         *
+         * @param doc The document to update.
+         * @param edit The change to its text.
+         * @param damage The tokens the edit replaced.
+         */
+        void reparse_edit(document& doc, const text_edit& edit, const lexer::token_damage& damage) {
+            doc.last_edit = {damage.inserted, doc.unit.lexer.token_stream.size() - damage.inserted, 0, 0, false};
+
+            if (damage.first <= doc.body_start || doc.unit.ast_arena.bytes_used() > 2 * doc.parsed_arena_bytes + arena::bump_arena::first_block_size) {
+                doc.last_edit.full_reparse = true; // the old tree is dropped before the new one is parsed
+                parse_document(doc);
+                doc.last_edit.statements_reparsed = doc.statements.size();
+                return;
+            }
+
+            std::vector<parsed_statement>& statements = doc.statements;
+            std::ptrdiff_t token_shift = static_cast<std::ptrdiff_t>(damage.inserted) - static_cast<std::ptrdiff_t>(damage.removed);
+            std::ptrdiff_t offset_shift = static_cast<std::ptrdiff_t>(edit.inserted_text.size()) - static_cast<std::ptrdiff_t>(edit.removed_length);
+            std::size_t damage_end = damage.first + damage.inserted;
+
+            auto next = std::partition_point(statements.begin(), statements.end(), [&](const parsed_statement& statement) {
+                return statement.first_token + 1 < damage.first;
+            });
+            std::size_t first_damaged = (next == statements.begin()) ? 0 : (next - statements.begin()) - 1;
+            std::size_t start = (first_damaged == 0) ? doc.body_start : statements[first_damaged].first_token;
+
+            seek(doc, start);
+
+            arena::arena_scope ast_scope(doc.unit.ast_arena); // replaced statements stay in the arena until the next full parse
+            std::vector<parsed_statement> reparsed;
+            std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> scratch;
+            std::size_t reuse = first_damaged;
+
+            while (true) {
+                std::size_t position = current_position(doc);
+                if (position >= damage_end) {
+                    std::size_t old_position = position - token_shift;
+                    while (reuse < statements.size() && statements[reuse].first_token < old_position) {
+                        reuse++;
+                    }
+                    if (reuse < statements.size() && statements[reuse].first_token == old_position) {
+                        break;
+                    }
+                }
+
+                if (!parse_statement(doc, reparsed, scratch)) {
+                    reuse = statements.size();
+                    break;
+                }
+            }
+
+            auto erased = statements.erase(statements.begin() + first_damaged, statements.begin() + reuse);
+            auto kept = statements.insert(erased, std::make_move_iterator(reparsed.begin()), std::make_move_iterator(reparsed.end())) + reparsed.size();
+            std::vector<ast::top_level_expr*> pending;
+            for (; kept != statements.end(); ++kept) {
+                kept->first_token += token_shift;
+                if (offset_shift != 0) {
+                    shift_locations(*kept, offset_shift, pending);
+                }
+            }
+
+            doc.last_edit.statements_reparsed = reparsed.size();
+            doc.last_edit.statements_reused = statements.size() - reparsed.size();
+        }
+    }
+
+    /**
+     * @par Loads `text` into the document, and lexes and parses all of it.
+     * @code
+        lexer::lexer_state& lexer = doc.unit.lexer;
+        lexer::release_source(lexer);
+        lexer.stream_buffer = std::move(text);
+        lexer.source = lexer.stream_buffer;
+        lexer.source_loaded = true;
+
+        lexer::reset_lexer(lexer);
+        lexer::tokenize_file(lexer);
+        parse_document(doc);
+     * @endcode
+     */
+    void open_document(document& doc, std::string text) {
+        lexer::lexer_state& lexer = doc.unit.lexer;
+        lexer::release_source(lexer);
+        lexer.stream_buffer = std::move(text);
+        if (lexer.stream_buffer.size() > UINT32_MAX) {
+            utility::lexer_error("Source file too large to be addressed by 32 bit source spans", lexer::no_location);
+        }
+        lexer.source = lexer.stream_buffer;
+        lexer.source_loaded = true;
+
+        lexer::reset_lexer(lexer);
+        lexer::tokenize_file(lexer);
+        parse_document(doc);
+
+        doc.last_edit = {lexer.token_stream.size(), 0, doc.statements.size(), 0, true};
+    }
+
+    /**
+     * <h4> Applies an edit to the document, rescanning only the damaged tokens and reparsing only the top level statements that could have changed (see `reparse_edit()`). </h4>
+     *
+     * @par The text is edited in place, and `lexer::relex_edit()` replaces just the tokens the edit touched. Lexer and parser errors are deferred rather than reported while the edit is applied:
+     * @code
+        text.replace(edit.offset, edit.removed_length, edit.inserted_text);
+        lexer.source = text;
+        lexer::token_damage damage = lexer::relex_edit(lexer, edit.offset, edit.removed_length, edit.inserted_text.size());
+        relexed = true;
+        reparse_edit(doc, edit, damage);
+     * @endcode
+     *
+     * @par An edit that leaves the text with an error (half typed code, usually) is rejected rather than ending the process. Its error goes in `doc.last_error`, and the edit is undone: the old text is put back and relexed, and the old statements are kept as they were, or parsed again if the edit had already dropped them for a full reparse. Returns whether the edit was applied.
+     * @code
+        text.replace(edit.offset, edit.inserted_text.size(), removed_text);
+        lexer.source = text;
+        if (relexed) {
+            lexer::relex_edit(lexer, edit.offset, edit.inserted_text.size(), removed_text.size());
+            if (doc.last_edit.full_reparse) {
+                parse_document(doc);
+            }
+        }
+        doc.last_edit = previous_edit;
+        return false;
+     * @endcode
+     *
+     * @param doc The document to update.
+     * @param edit The change to its text.
+     */
+    bool apply_edit(document& doc, const text_edit& edit) {
+        lexer::lexer_state& lexer = doc.unit.lexer;
+        std::string& text = lexer.stream_buffer;
+
+        if (text.size() - edit.removed_length + edit.inserted_text.size() > UINT32_MAX) {
+            doc.last_error = {"Lexer error: Source file too large to be addressed by 32 bit source spans", lexer::no_location};
+            return false;
+        }
+
+        std::string removed_text = text.substr(edit.offset, edit.removed_length);
+        edit_stats previous_edit = doc.last_edit;
+        bool relexed = false;
+        doc.last_error = {"", lexer::no_location};
+
+        text.replace(edit.offset, edit.removed_length, edit.inserted_text);
+        lexer.source = text;
+
+        utility::defer_lexer_errors = true;
+        utility::defer_parser_errors = true;
+        try {
+            lexer::token_damage damage = lexer::relex_edit(lexer, edit.offset, edit.removed_length, edit.inserted_text.size());
+            relexed = true;
+            reparse_edit(doc, edit, damage);
+        } catch (const utility::deferred_lexer_error& error) {
+            doc.last_error = {"Lexer error: " + error.message, error.location};
+        } catch (const utility::deferred_parser_error& error) {
+            doc.last_error = {"Parser error: " + error.message, error.location};
+        } catch (const std::out_of_range&) { // the parser ran off the end of the tokens
+            doc.last_error = {"Parser error: Unexpected end of file", static_cast<lexer::source_location>(text.size())};
+        }
+        utility::defer_lexer_errors = false;
+        utility::defer_parser_errors = false;
+
+        if (doc.last_error.message.empty()) {
+            return true;
+        }
+
+        text.replace(edit.offset, edit.inserted_text.size(), removed_text);
+        lexer.source = text;
+        if (relexed) {
+            lexer::relex_edit(lexer, edit.offset, edit.inserted_text.size(), removed_text.size());
+            if (doc.last_edit.full_reparse) {
+                parse_document(doc);
+            }
+        }
+        doc.last_edit = previous_edit;
+        return false;
+    }
+}
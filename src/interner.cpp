@@ -0,0 +1,144 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/interner/interner.h"
+#include "../include/utility/utility.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace interner {
+
+    namespace {
+
+        /**
+         * @par Names are stored in blocks that double in size (64, 128, 256, ...), so a stored name never moves and ids can be resolved without taking the lock.
+         */
+        constexpr std::size_t first_block_size = 64;
+        constexpr std::size_t block_count = 27; // enough blocks to cover every 32 bit id
+
+        /**
+         * @par Returns the block holding `id`, and the id's position within it.
+         * @code
+            std::size_t block = 31 - __builtin_clz(static_cast<uint32_t>(id / first_block_size + 1));
+            offset = id - first_block_size * ((std::size_t(1) << block) - 1);
+            return block;
+         * @endcode
+         */
+        inline std::size_t locate(uint32_t id, std::size_t& offset) {
+            std::size_t block = 31 - __builtin_clz(static_cast<uint32_t>(id / first_block_size + 1));
+            offset = id - first_block_size * ((std::size_t(1) << block) - 1);
+            return block;
+        }
+
+        /**
+         * @struct name_table
+         * @par The process wide interner. It is never destroyed, so that a thread still interning while another calls `exit()` (as the error reporters do) cannot touch a destroyed table.
+         *
+         * @var name_table::ids
+         * Maps each name to its id. The keys view the strings held in `blocks`.
+         *
+         * @var name_table::blocks
+         * The stored names, indexed through `locate()`. Block pointers are published with release stores so `name()` can read them without the lock.
+         */
+        struct name_table {
+            std::mutex table_mutex;
+            std::unordered_map<std::string_view, symbol_id> ids;
+            uint32_t next_id = 0;
+            std::atomic<std::string*> blocks[block_count] = {};
+        };
+
+        name_table& table() {
+            static name_table* instance = new name_table();
+            return *instance;
+        }
+
+        /**
+         * @par Each thread remembers the names it has already resolved, so that repeated identifiers (the common case) are looked up without taking the lock.
+         */
+        thread_local std::unordered_map<std::string_view, symbol_id> thread_cache;
+    }
+
+    /**
+     * @par Returns the id of `text`, checking this thread's cache before the shared table.
+     * @code
+        auto cached = thread_cache.find(text);
+        if (cached != thread_cache.end()) {
+            return cached->second;
+        }
+
+        name_table& names = table();
+        std::lock_guard<std::mutex> lock(names.table_mutex);
+
+        auto found = names.ids.find(text);
+        if (found == names.ids.end()) {
+            std::size_t offset;
+            std::size_t block = locate(names.next_id, offset);
+            std::string* storage = names.blocks[block].load(std::memory_order_relaxed);
+            if (storage == nullptr) {
+                storage = new std::string[first_block_size << block];
+                names.blocks[block].store(storage, std::memory_order_release);
+            }
+            storage[offset].assign(text);
+            found = names.ids.emplace(storage[offset], symbol_id{names.next_id++}).first;
+        }
+
+        thread_cache.emplace(found->first, found->second);
+        return found->second;
+     * @endcode
+     */
+    symbol_id intern(std::string_view text) {
+        auto cached = thread_cache.find(text);
+        if (cached != thread_cache.end()) {
+            return cached->second;
+        }
+
+        name_table& names = table();
+        std::lock_guard<std::mutex> lock(names.table_mutex);
+
+        auto found = names.ids.find(text);
+        if (found == names.ids.end()) {
+            if (names.next_id == UINT32_MAX) {
+                utility::lexer_error("Too many distinct identifiers", lexer::no_location);
+            }
+
+            std::size_t offset;
+            std::size_t block = locate(names.next_id, offset);
+            std::string* storage = names.blocks[block].load(std::memory_order_relaxed);
+            if (storage == nullptr) {
+                storage = new std::string[first_block_size << block];
+                names.blocks[block].store(storage, std::memory_order_release);
+            }
+            storage[offset].assign(text);
+            found = names.ids.emplace(storage[offset], symbol_id{names.next_id++}).first;
+        }
+
+        thread_cache.emplace(found->first, found->second);
+        return found->second;
+    }
+
+    /**
+     * @par Resolves an id back to its text without locking. An id can only reach another thread after `intern()` stored its name, so the name is always visible.
+     * @code
+        std::size_t offset;
+        std::size_t block = locate(symbol.value, offset);
+        return table().blocks[block].load(std::memory_order_acquire)[offset];
+     * @endcode
+     */
+    const std::string& name(symbol_id symbol) {
+        std::size_t offset;
+        std::size_t block = locate(symbol.value, offset);
+        return table().blocks[block].load(std::memory_order_acquire)[offset];
+    }
+
+    std::size_t symbol_count() {
+        name_table& names = table();
+        std::lock_guard<std::mutex> lock(names.table_mutex);
+        return names.next_id;
+    }
+}
@@ -8,762 +8,1459 @@ If LICENSE.md is not included, this version of the source code is provided in br
 
 #include "../include/lexer/lexer.h"
 #include "../include/utility/utility.h"
+#include "../include/scan_kernels/scan_kernels.h"
+#include "../include/thread_pool/thread_pool.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iterator>
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <algorithm>
 
 namespace lexer {
 
-    int line_count = 1; 
+    namespace {
+        /**
+         * @struct scanner_state
+         * @par Everything a single scan over a source buffer reads and writes. `get_token()` and the sequential lexer use one per call, and the parallel lexer gives one to each chunk so that chunks can be scanned at the same time.
+         *
+         * @var scanner_state::source
+         * The source buffer being scanned, copied from the owning `lexer_state`.
+         *
+         * @var scanner_state::read_offset
+         * Offset of the next unread character, so the character most recently returned by `next_char()` lives at `read_offset - 1`.
+         *
+         * @var scanner_state::limit
+         * No token may start at or after this offset. Scanning stops there with `reached_limit` set (whitespace and comments may run past it).
+         *
+         * @var scanner_state::previous_character
+         * The character the scanner is currently looking at, which has already been consumed from the source buffer.
+         *
+         * @var scanner_state::token_offset
+         * Offset of the first character of the token most recently returned by `scan_token()`.
+         *
+         * @var scanner_state::speculative
+         * Whether errors are recorded in `error_message` (and `error_location`) instead of being reported, because a chunk that started in the middle of a literal or comment can hit errors the sequential lexer never would.
+         */
+        struct scanner_state {
+            std::string_view source;
+            std::size_t read_offset = 0;
+            std::size_t limit = SIZE_MAX;
+            int previous_character = ' ';
+            uint32_t token_offset = 0;
+
+            bool speculative = false;
+            bool reached_limit = false;
+            const char* error_message = nullptr;
+            source_location error_location = no_location;
+
+            source_span identifier;
+            int integer_value;
+            float float_value;
+            bool bool_value;
+            char char_value;
+            source_span string_value;
+
+            /**
+             * @par Returns the next character of the source buffer, or EOF once the buffer is exhausted (without advancing past the end).
+             * @code
+                if (read_offset < source.size()) {
+                    return static_cast<unsigned char>(source[read_offset++]);
+                }
+                return EOF;
+             * @endcode
+             */
+            inline int next_char() {
+                if (read_offset < source.size()) {
+                    return static_cast<unsigned char>(source[read_offset++]);
+                }
+                return EOF;
+            }
 
-    std::vector<Token_Type> token_stream;
-    std::vector<std::optional<lexer_stored_values>> stored_values;
-    std::vector<int> line_count_vec;
+            /**
+             * @par Returns the offset of the lookahead character held by the scanner (the end of the buffer if it is EOF).
+             */
+            inline uint32_t lookahead_offset() const {
+                return static_cast<uint32_t>(previous_character == EOF ? source.size() : read_offset - 1);
+            }
 
-    std::string identifier; 
-    int integer_value; 
-    float float_value; 
-    bool bool_value; 
-    char char_value; 
-    std::string string_value; 
-    std::istream* input; 
+            /**
+             * @par Positions the scanner on the character at `offset`, as if everything before it had already been tokenized.
+             */
+            void start_at(std::size_t offset) {
+                read_offset = offset;
+                previous_character = next_char();
+            }
+        };
+    }
 
     /**
-     * <h4> This function reads characters from the input stream and categorizes them into tokens, and updates the relevant associated value, which can be `std::nullopt` if not applicable. </h4>
-     * 
-     * @par Handling Whitespaces
-     * Iterates over all whitespace and ignores it by incrementing the `previous_character`:
-     * @code
-     * while (isspace(previous_character)) {  
-     *     if (previous_character == '\n') line_count++; 
-     *     previous_character = input->get(); 
-     * }
-     * @endcode
-     * 
-     * @par Single Character Tokens
-     * Tokenizes all single character tokens, such as `(`, `{`, `+`, `EOF`, and others:
+     * @par Memory maps a regular file read-only and points `state.source` at the mapping. Returns false if the file cannot be mapped, so the caller can fall back to stream input.
+     * @param state The lexer state to load the source into.
+     * @param file_name The path to the .pyrx file.
+     *
      * @code
-     * if (previous_character == ';') {
-     *     previous_character = input->get();
-     *     return tok_semicolon;
-     * }
-     * if (previous_character == '=') {
-     *     previous_character = input->get();
-     *     return tok_assignment;
-     * }
-     * if (previous_character == '(') { 
-     *     previous_character = input->get();
-     *     return tok_open_paren;
-     * }
-     * if (previous_character == ')') {
-     *     previous_character = input->get();
-     *     return tok_close_paren;
-     * }
-     * if (previous_character == '{') {
-     *     previous_character = input->get();
-     *     return tok_open_brack;
-     * }
-     * if (previous_character == '}') {
-     *     previous_character = input->get();
-     *     return tok_close_brack;
-     * }
-     * if (previous_character == '[') {
-     *     previous_character = input->get();
-     *     return tok_open_arr;
-     * }
-     * if (previous_character == ']') {
-     *     previous_character = input->get();
-     *     return tok_close_arr;
-     * }
-     * if (previous_character == '.') {
-     *     previous_character = input->get();
-     *     return tok_dot;
-     * }
-     * if (previous_character == ',') {
-     *     previous_character = input->get();
-     *     return tok_comma;
-     * } 
-     * if (previous_character == EOF) { 
-     *     return tok_eof; 
-     * }
-        if (previous_character == '+') {
-            previous_character = input->get();
-            if (previous_character == '+') {
-                previous_character = input->get();
-                return tok_increment;
-            }
-            return tok_plus;
+        int file_descriptor = open(file_name.c_str(), O_RDONLY);
+        if (file_descriptor < 0) {
+            return false;
         }
 
-        if (previous_character == '-') {
-            previous_character = input->get();
-            if (previous_character == '-') {
-                previous_character = input->get();
-                return tok_decrement;
-            }
-            return tok_minus;
+        struct stat file_status;
+        if (fstat(file_descriptor, &file_status) != 0 || !S_ISREG(file_status.st_mode)) {
+            close(file_descriptor);
+            return false;
         }
-     * if (previous_character == '*') {
-     *     previous_character = input->get();
-     *     return tok_mult;
-     * }
-     * @endcode
-     * 
-     * @par Comments and Division
-     * Deals with character consumption when handling comments (inline and multiline), as well as the division operator:
-     * @code
-     * if (previous_character == '/') { 
-     *     previous_character = input->get(); 
-     *     if (isspace(previous_character)) {
-     *         previous_character = input->get();
-     *         return tok_div;
-     *     }
-     * 
-     *     if (previous_character == '/') { 
-     *         do { 
-     *             previous_character = input->get(); 
-     *         } while (previous_character != '\n' && previous_character != EOF);
-     *     }
-     * 
-     *     if (previous_character == '*') {  
-     *         previous_character = input->get(); 
-     * 
-     *         while (true) { 
-     *             if (previous_character == '*') { 
-     *                 previous_character = input->get(); 
-     *                 if (previous_character == '/') { 
-     *                     previous_character = input->get(); 
-     *                     return get_token(); 
-     *                 }
-     *             } else if (previous_character == '\n') { 
-     *                 line_count++;
-     *             } else if (previous_character == EOF) { 
-     *                 utility::lexer_error("Unterminated multiline comment", line_count);
-     *             }
-     *             previous_character = input->get(); 
-     *         }
-     *     }
-     * 
-     *     if (previous_character == EOF) {
-     *         return tok_eof;
-     *     }
-     * 
-     *     if (previous_character == '\n') {
-     *         line_count++;
-     *     }
-     * 
-     *     previous_character = input->get(); 
-     *     return get_token(); 
-     * }
-     * @endcode
-     * 
-     * @par Keywords and Identifiers
-     * Handles parsing alphanumeric input into keyword and identifier tokens:
-     * @code
-     * if (isalpha(previous_character) || previous_character == '_') { 
-     *     identifier = previous_character; 
-     *     while (isalnum(previous_character = input->get()) || (previous_character == '_')) { 
-     *         identifier += previous_character; 
-     *     }
-     * 
-     *     if (identifier == "print") {
-     *         return tok_print;
-     *     }
-     * 
-     *     if (identifier == "int") {
-     *         return tok_int;
-     *     }
-     *     
-     *     if (identifier == "float") {
-     *         return tok_float;
-     *     }
-     * 
-     *     if (identifier == "bool") {
-     *         return tok_bool;
-     *     }
-     *     
-     *     if (identifier == "char") {
-     *         return tok_char;
-     *     }
-     * 
-     *     if (identifier == "string") {
-     *         return tok_string;
-     *     }
-     * 
-     *     if (identifier == "void") {
-     *         return tok_void;
-     *     }
-     * 
-     *     if (identifier == "if") {
-     *         return tok_if;
-     *     }
-     * 
-     *     if (identifier == "else") {
-     *         return tok_else;
-     *     }
-     * 
-     *     if (identifier == "for") {
-     *         return tok_for;
-     *     }
-     * 
-     *     if (identifier == "while") {
-     *         return tok_while;
-     *     }
-     * 
-     *     if (identifier == "true") {
-     *         return tok_true;
-     *     }
-     * 
-     *     if (identifier == "false") {
-     *         return tok_false;
-     *     }
-     * 
-     *     if (identifier == "class") {
-     *         return tok_class;
-     *     }
-     * 
-     *     if (identifier == "graph") {
-     *         return tok_graph;
-     *     }
-     * 
-     *     if (identifier == "return") {
-     *         return tok_return;
-     *     }
-     * 
-     *     if (identifier == "def") {
-     *         return tok_def;
-     *     }
-     * 
-     *      if (identifier == "include") {
-                return tok_include;
-            }
 
-            if (identifier == "list") {
-                return tok_list;
-            }
+        if (static_cast<uint64_t>(file_status.st_size) > UINT32_MAX) {
+            close(file_descriptor);
+            utility::lexer_error("Source file too large to be addressed by 32 bit source spans", no_location);
+        }
 
-            if (identifier == "for") {
-                return tok_for;
-            }
+        release_source(state);
 
-            if (identifier == "while") {
-                return tok_while;
-            }
+        if (file_status.st_size == 0) {
+            close(file_descriptor);
+            state.source = std::string_view();
+            state.source_loaded = true;
+            return true;
+        }
 
-     * 
-     *     return tok_identifier;
-     * }
-     * @endcode
-     * 
-     * @par Integers and Floats
-     * Deals with integer and floating point literals:
-     * @code
-     * if (isdigit(previous_character)) { 
-     *     std::string temp_num; 
-     *     bool is_float = false; 
-     * 
-     *     do {
-     *         temp_num += previous_character; 
-     * 
-     *         if (previous_character == '.' && is_float == true) { 
-     *             utility::lexer_error("Too many decimal points passed to FP number", line_count); 
-     *         } else if (previous_character == '.') { 
-     *             is_float = true; 
-     *         }
-     * 
-     *         previous_character = input->get(); 
-     *     
-     *         if (previous_character == EOF) { 
-     *             utility::lexer_error("Unexpected end of input while reading a number", line_count);
-     *         }
-     * 
-     *     }  while(isdigit(previous_character) || previous_character == '.'); 
-     * 
-     *     if (is_float == true) { 
-     *         float_value = strtod(temp_num.c_str(), nullptr); 
-     *         return tok_float_val;
-     *     }
-     * 
-     *     integer_value = std::stoi(temp_num); 
-     *     return tok_int_val;
-     * }
-     * @endcode
-     * 
-     * @par String Literals
-     * Deals with tokenization of string literals:
-     * 
-     * @code
-     *  if (previous_character == '"') { 
-     *      string_value = ""; 
-     *      while (true) { 
-     *          previous_character = input->get(); 
-     * 
-     *           if (previous_character == '"') { 
-     *               previous_character = input->get();
-     *               return tok_string_val;
-     *           }
-     * 
-     *           if (previous_character == EOF || previous_character == ';') { 
-     *               utility::lexer_error("Unterminated string", line_count);
-     *               break;
-     *           }
-     * 
-     *           string_value += previous_character; 
-     *      }
-     *  }
-     * 
-     * @endcode
-     * 
-     * @par Character Literals
-     * Deals with tokenization of character literals:
-     * @code
-     * 
-     * if (previous_character == '\'') { 
-     *     previous_character = input->get(); 
-     * 
-     *     if (previous_character == EOF) { 
-     *         utility::lexer_error("Unterminated character", line_count);
-     *     }
-     * 
-     *     if (previous_character == '\'') { 
-     *          utility::lexer_error("No character provided", line_count);
-     *     }
-     * 
-     *     char_value = previous_character; 
-     * 
-     *     previous_character = input->get(); 
-     * 
-     *     if (previous_character == EOF) { 
-     *         utility::lexer_error("Unterminated character", line_count);
-     *     } else if (previous_character != '\'') { 
-     *         utility::lexer_error("Unterminated character", line_count);
-     *     }
-     * 
-     *     previous_character = input->get(); 
-     *     return tok_char_val; 
-     * }
-     * 
-     * int current_character = previous_character; 
+        void* address = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        close(file_descriptor);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        madvise(address, file_status.st_size, MADV_SEQUENTIAL);
+
+        state.mapped_address = address;
+        state.mapped_length = file_status.st_size;
+        state.source = std::string_view(static_cast<const char*>(address), state.mapped_length);
+        state.source_loaded = true;
+        return true;
      * @endcode
      */
-    Token_Type get_token() {
+    bool map_source_file(lexer_state& state, const std::string& file_name) {
+        int file_descriptor = open(file_name.c_str(), O_RDONLY);
+        if (file_descriptor < 0) {
+            return false;
+        }
 
-        static int previous_character = ' ';  
+        struct stat file_status;
+        if (fstat(file_descriptor, &file_status) != 0 || !S_ISREG(file_status.st_mode)) {
+            close(file_descriptor);
+            return false;
+        }
 
-        while (isspace(previous_character)) {  
-            if (previous_character == '\n') line_count++; 
-            previous_character = input->get(); 
+        if (static_cast<uint64_t>(file_status.st_size) > UINT32_MAX) {
+            close(file_descriptor);
+            utility::lexer_error("Source file too large to be addressed by 32 bit source spans", no_location);
         }
 
-        if (previous_character == ';') {
-            previous_character = input->get();
-            return tok_semicolon;
+        release_source(state);
+
+        if (file_status.st_size == 0) { // mmap rejects zero length mappings, so an empty file is just an empty source
+            close(file_descriptor);
+            state.source = std::string_view();
+            state.source_loaded = true;
+            return true;
         }
 
-        if (previous_character == '=') {
-            previous_character = input->get();
-            return tok_assignment;
+        void* address = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        close(file_descriptor); // the mapping stays valid after the descriptor is closed
+        if (address == MAP_FAILED) {
+            return false;
         }
+        madvise(address, file_status.st_size, MADV_SEQUENTIAL);
+
+        state.mapped_address = address;
+        state.mapped_length = file_status.st_size;
+        state.source = std::string_view(static_cast<const char*>(address), state.mapped_length);
+        state.source_loaded = true;
+        return true;
+    }
 
-        if (previous_character == '(') { 
-            previous_character = input->get();
-            return tok_open_paren;
+    /**
+     * @par Reads the whole of `state.input` into an owned buffer, used for pipes, terminals and anything else that cannot be mapped.
+     * @code
+        release_source(state);
+        state.stream_buffer.assign(std::istreambuf_iterator<char>(*state.input), std::istreambuf_iterator<char>());
+        state.source = state.stream_buffer;
+     * @endcode
+     */
+    void load_source_from_stream(lexer_state& state) {
+        release_source(state);
+        state.stream_buffer.assign(std::istreambuf_iterator<char>(*state.input), std::istreambuf_iterator<char>());
+        if (state.stream_buffer.size() > UINT32_MAX) {
+            utility::lexer_error("Source file too large to be addressed by 32 bit source spans", no_location);
         }
+        state.source = state.stream_buffer;
+        state.source_loaded = true;
+    }
 
-        if (previous_character == ')') {
-            previous_character = input->get();
-            return tok_close_paren;
+    /**
+     * @par Unmaps (or frees) the current source buffer. Every `source_span` handed out by the lexer is invalid afterwards.
+     * @code
+        if (state.mapped_address != nullptr) {
+            munmap(state.mapped_address, state.mapped_length);
+            state.mapped_address = nullptr;
+            state.mapped_length = 0;
+        }
+        state.stream_buffer.clear();
+        state.stream_buffer.shrink_to_fit();
+        state.source = std::string_view();
+        state.source_loaded = false;
+        state.read_offset = 0;
+        state.previous_character = ' ';
+        state.line_starts.clear();
+     * @endcode
+     */
+    void release_source(lexer_state& state) {
+        if (state.mapped_address != nullptr) {
+            munmap(state.mapped_address, state.mapped_length);
+            state.mapped_address = nullptr;
+            state.mapped_length = 0;
         }
+        state.stream_buffer.clear();
+        state.stream_buffer.shrink_to_fit();
+        state.source = std::string_view();
+        state.source_loaded = false;
+        state.read_offset = 0;
+        state.previous_character = ' ';
+        state.line_starts.clear();
+    }
 
-        if (previous_character == '{') {
-            previous_character = input->get();
-            return tok_open_brack;
+    namespace {
+        /**
+         * @par The classes of characters the scanner dispatches on. Every byte of input (and EOF) maps to exactly one class.
+         */
+        enum char_class : uint8_t {
+            cc_invalid,      ///< Not valid anywhere outside of literals and comments
+            cc_whitespace,   ///< Spaces, tabs, carriage returns, etc...
+            cc_newline,      ///< '\n'
+            cc_ident_start,  ///< Letters and '_'
+            cc_digit,        ///< '0' through '9'
+            cc_single,       ///< Single character tokens, looked up in `single_char_tokens`
+            cc_plus,         ///< '+' or '++'
+            cc_minus,        ///< '-' or '--'
+            cc_slash,        ///< '/', or the start of a comment
+            cc_compound,     ///< Operators that may be followed by a second character, looked up in `compound_tokens`
+            cc_double_quote, ///< Start of a string literal
+            cc_single_quote, ///< Start of a character literal
+            cc_eof           ///< End of the source buffer
+        };
+
+        /**
+         * @par Builds the character class table at compile time. It is indexed by `character + 1`, so that EOF (-1) occupies slot 0.
+         */
+        constexpr std::array<char_class, 257> build_char_classes() {
+            std::array<char_class, 257> classes{};
+
+            classes[0] = cc_eof;
+            for (int character : {' ', '\t', '\r', '\v', '\f'}) classes[character + 1] = cc_whitespace;
+            classes['\n' + 1] = cc_newline;
+
+            for (int character = 'a'; character <= 'z'; character++) classes[character + 1] = cc_ident_start;
+            for (int character = 'A'; character <= 'Z'; character++) classes[character + 1] = cc_ident_start;
+            classes['_' + 1] = cc_ident_start;
+            for (int character = '0'; character <= '9'; character++) classes[character + 1] = cc_digit;
+
+            for (int character : {';', '(', ')', '{', '}', '[', ']', '.', ',', '*', '%'}) classes[character + 1] = cc_single;
+            for (int character : {'=', '<', '>', '!', '&', '|'}) classes[character + 1] = cc_compound;
+            classes['+' + 1] = cc_plus;
+            classes['-' + 1] = cc_minus;
+            classes['/' + 1] = cc_slash;
+            classes['"' + 1] = cc_double_quote;
+            classes['\'' + 1] = cc_single_quote;
+
+            return classes;
         }
 
-        if (previous_character == '}') {
-            previous_character = input->get();
-            return tok_close_brack;
+        constexpr std::array<char_class, 257> char_classes = build_char_classes();
+
+        /**
+         * @par Maps each `cc_single` character to the token it produces.
+         */
+        constexpr std::array<Token_Type, 256> build_single_char_tokens() {
+            std::array<Token_Type, 256> tokens{};
+
+            tokens[';'] = tok_semicolon;
+            tokens['='] = tok_assignment;
+            tokens['('] = tok_open_paren;
+            tokens[')'] = tok_close_paren;
+            tokens['{'] = tok_open_brack;
+            tokens['}'] = tok_close_brack;
+            tokens['['] = tok_open_arr;
+            tokens[']'] = tok_close_arr;
+            tokens['.'] = tok_dot;
+            tokens[','] = tok_comma;
+            tokens['*'] = tok_mult;
+            tokens['%'] = tok_mod;
+
+            return tokens;
         }
 
-        if (previous_character == '[') {
-            previous_character = input->get();
-            return tok_open_arr;
+        constexpr std::array<Token_Type, 256> single_char_tokens = build_single_char_tokens();
+
+        /**
+         * @struct compound_token
+         * @par What a `cc_compound` character lexes to: `paired` if it is followed by `second`, and `alone` otherwise (`tok_eof` when it is not valid on its own).
+         */
+        struct compound_token {
+            Token_Type alone;
+            char second;
+            Token_Type paired;
+        };
+
+        /**
+         * @par Maps each `cc_compound` character to its one and two character forms.
+         */
+        constexpr std::array<compound_token, 256> build_compound_tokens() {
+            std::array<compound_token, 256> tokens{};
+
+            tokens['='] = {tok_assignment, '=', tok_equal};
+            tokens['<'] = {tok_less, '=', tok_less_equal};
+            tokens['>'] = {tok_greater, '=', tok_greater_equal};
+            tokens['!'] = {tok_not, '=', tok_not_equal};
+            tokens['&'] = {tok_eof, '&', tok_and};
+            tokens['|'] = {tok_eof, '|', tok_or};
+
+            return tokens;
         }
 
-        if (previous_character == ']') {
-            previous_character = input->get();
-            return tok_close_arr;
+        constexpr std::array<compound_token, 256> compound_tokens = build_compound_tokens();
+
+        inline char_class classify(int character) {
+            return char_classes[character + 1];
         }
 
-        if (previous_character == '.') {
-            previous_character = input->get();
-            return tok_dot;
+        /**
+         * @struct keyword_entry
+         * @par Pairs a reserved word with the token it lexes to.
+         */
+        struct keyword_entry {
+            std::string_view text;
+            Token_Type token;
+        };
+
+        constexpr keyword_entry keywords[] = {
+            {"print", tok_print}, {"int", tok_int}, {"float", tok_float}, {"void", tok_void}, {"if", tok_if},
+            {"else", tok_else}, {"bool", tok_bool}, {"char", tok_char}, {"string", tok_string}, {"for", tok_for},
+            {"while", tok_while}, {"true", tok_true}, {"false", tok_false}, {"class", tok_class}, {"graph", tok_graph},
+            {"return", tok_return}, {"def", tok_def}, {"include", tok_include}, {"list", tok_list}
+        };
+
+        constexpr std::size_t keyword_table_size = 32;
+
+        /**
+         * @par Hashes an identifier by its length, first, and last character. The multipliers were chosen so every keyword lands in its own slot.
+         * @code
+            return (2 * text.size() + 5 * static_cast<unsigned char>(text.front()) + 4 * static_cast<unsigned char>(text.back())) & (keyword_table_size - 1);
+         * @endcode
+         */
+        constexpr std::size_t keyword_hash(std::string_view text) {
+            return (2 * text.size() + 5 * static_cast<unsigned char>(text.front()) + 4 * static_cast<unsigned char>(text.back())) & (keyword_table_size - 1);
         }
 
-        if (previous_character == ',') {
-            previous_character = input->get();
-            return tok_comma;
-        } 
+        /**
+         * @par Places each keyword in its hash slot, returning false if two keywords collide.
+         */
+        constexpr bool build_keyword_table(std::array<keyword_entry, keyword_table_size>& table) {
+            for (const keyword_entry& keyword : keywords) {
+                keyword_entry& slot = table[keyword_hash(keyword.text)];
+                if (!slot.text.empty()) {
+                    return false;
+                }
+                slot = keyword;
+            }
+            return true;
+        }
 
-        if (previous_character == EOF) { 
-            return tok_eof; 
+        constexpr std::array<keyword_entry, keyword_table_size> make_keyword_table() {
+            std::array<keyword_entry, keyword_table_size> table{};
+            build_keyword_table(table);
+            return table;
         }
 
-        if (previous_character == '+') {
-            previous_character = input->get();
-            if (previous_character == '+') {
-                previous_character = input->get();
-                return tok_increment;
-            }
-            return tok_plus;
+        constexpr bool keyword_hash_is_perfect() {
+            std::array<keyword_entry, keyword_table_size> table{};
+            return build_keyword_table(table);
         }
 
-        if (previous_character == '-') {
-            previous_character = input->get();
-            if (previous_character == '-') {
-                previous_character = input->get();
-                return tok_decrement;
-            }
-            return tok_minus;
+        static_assert(keyword_hash_is_perfect(), "Keyword hash collision, pick new multipliers in keyword_hash()");
+
+        constexpr std::array<keyword_entry, keyword_table_size> keyword_table = make_keyword_table();
+
+        /**
+         * @par Resolves an identifier to its keyword token with a single hash probe and compare, or `tok_identifier` if it is not reserved.
+         * @code
+            const keyword_entry& slot = keyword_table[keyword_hash(text)];
+            return (slot.text == text) ? slot.token : tok_identifier;
+         * @endcode
+         */
+        inline Token_Type lookup_keyword(std::string_view text) {
+            const keyword_entry& slot = keyword_table[keyword_hash(text)];
+            return (slot.text == text) ? slot.token : tok_identifier;
         }
 
-        if (previous_character == '*') {
-            previous_character = input->get();
-            return tok_mult;
+        /**
+         * @par Converts the digits of a floating point literal into `float_value` without copying them, returning false if it is out of range. Standard libraries that lack floating point `std::from_chars` fall back to `strtof` on a terminated copy.
+         * @code
+            auto [number_end, error] = std::from_chars(first, last, state.float_value);
+            return error != std::errc::result_out_of_range;
+         * @endcode
+         */
+        inline bool parse_float_literal(scanner_state& state, const char* first, const char* last) {
+        #if defined(__cpp_lib_to_chars)
+            auto [number_end, error] = std::from_chars(first, last, state.float_value);
+            return error != std::errc::result_out_of_range;
+        #else
+            state.float_value = std::strtof(std::string(first, last).c_str(), nullptr);
+            return true;
+        #endif
         }
 
-        if (previous_character == '/') { 
-            previous_character = input->get(); 
-            if (isspace(previous_character)) {
-                previous_character = input->get();
-                return tok_div;
+        /**
+         * @par Reports a lexing error. Speculative scanners only record it (and stop), since the error may not exist once the chunk is stitched in place.
+         * @code
+            if (!state.speculative) {
+                utility::lexer_error(message, state.token_offset);
             }
-
-            if (previous_character == '/') { 
-                do { 
-                    previous_character = input->get(); 
-                } while (previous_character != '\n' && previous_character != EOF);
+            state.error_message = message;
+            state.error_location = state.token_offset;
+            return tok_eof;
+         * @endcode
+         */
+        Token_Type fail(scanner_state& state, const char* message) {
+            if (!state.speculative) {
+                utility::lexer_error(message, state.token_offset);
             }
+            state.error_message = message;
+            state.error_location = state.token_offset;
+            return tok_eof;
+        }
+
+        /**
+         * @struct token_chunk
+         * @par Tokens and side tables produced by scanning one range of the state.source. Payload indices are local to the chunk until it is stitched into the token stream.
+         */
+        struct token_chunk {
+            std::vector<token> tokens;
+            std::vector<source_span> spans;
+            std::vector<int> ints;
+            std::vector<float> floats;
+        };
+
+        /**
+         * @par Sources smaller than this are always lexed sequentially, since chunking them costs more than it saves.
+         */
+        constexpr std::size_t parallel_lex_threshold = std::size_t(4) << 20;
+
+        /**
+         * @par The smallest chunk handed to a worker.
+         */
+        constexpr std::size_t minimum_chunk_size = std::size_t(1) << 20;
+
+        /**
+         * <h4> This function reads characters from the source buffer and categorizes them into tokens, and updates the relevant associated value in the scanner state if applicable. Each character is classified with a single lookup in the `char_classes` table, and the scanner switches on that class. </h4>
+         *
+         * @par Chunk Limits
+         * Before starting each token the scanner records where it starts, and checks whether it has reached the end of the range it was given:
+         * @code
+         * state.token_offset = state.lookahead_offset();
+         * if (state.token_offset >= state.limit) {
+         *     state.reached_limit = true;
+         *     return tok_eof;
+         * }
+         * @endcode
+         * 
+         * @par Handling Whitespaces
+         * Skips the whole whitespace run with the vectorized kernel. Newlines are not counted here, since tokens only record where they start and lines are recovered from offsets when a diagnostic needs one (see `locate()`):
+         * @code
+         * case cc_newline:
+         * case cc_whitespace:
+         *     state.read_offset = kernels.skip_whitespace(state.source.data(), state.read_offset, state.source.size());
+         *     state.previous_character = state.next_char();
+         *     continue;
+         * @endcode
+         * 
+         * @par Single Character Tokens
+         * Tokenizes all single character tokens, such as `(`, `{`, `*`, and others, as well as EOF, and the operators that may be doubled:
+         * @code
+         * case cc_eof:
+         *     return tok_eof;
+         *
+         * case cc_single: {
+         *     Token_Type token = single_char_tokens[state.previous_character];
+         *     state.previous_character = state.next_char();
+         *     return token;
+         * }
+         *
+         * case cc_plus:
+         *     state.previous_character = state.next_char();
+         *     if (state.previous_character == '+') {
+         *         state.previous_character = state.next_char();
+         *         return tok_increment;
+         *     }
+         *     return tok_plus;
+         *
+         * case cc_minus:
+         *     state.previous_character = state.next_char();
+         *     if (state.previous_character == '-') {
+         *         state.previous_character = state.next_char();
+         *         return tok_decrement;
+         *     }
+         *     return tok_minus;
+         *
+         * case cc_compound: {
+         *     const compound_token& compound = compound_tokens[state.previous_character];
+         *     state.previous_character = state.next_char();
+         *     if (state.previous_character == compound.second) {
+         *         state.previous_character = state.next_char();
+         *         return compound.paired;
+         *     }
+         *     if (compound.alone == tok_eof) {
+         *         return fail(state, "Unrecognized character");
+         *     }
+         *     return compound.alone;
+         * }
+         * @endcode
+         * 
+         * @par Comments and Division
+         * Skips inline and multiline comments by searching for their terminators with the vectorized kernels, and resumes scanning after them, otherwise the slash is the division operator:
+         * @code
+         * case cc_slash:
+         *     state.previous_character = state.next_char();
+         *
+         *     if (state.previous_character == '/') {
+         *         state.read_offset = kernels.find_newline(state.source.data(), state.read_offset, state.source.size());
+         *         state.previous_character = state.next_char();
+         *         continue;
+         *     }
+         *
+         *     if (state.previous_character == '*') {
+         *         std::size_t comment_end = kernels.find_comment_end(state.source.data(), state.read_offset, state.source.size());
+         *         if (comment_end == state.source.size()) {
+         *             return fail(state, "Unterminated multiline comment");
+         *         }
+         *         state.read_offset = comment_end + 2;
+         *         state.previous_character = state.next_char();
+         *         continue;
+         *     }
+         *
+         *     return tok_div;
+         * @endcode
+         * 
+         * @par Keywords and Identifiers
+         * Handles parsing alphanumeric input into keyword and identifier tokens. The identifier run is measured with the vectorized kernel and recorded as a span of the source buffer rather than copied, and keywords are resolved with one probe of the compile-time perfect hash table:
+         * @code
+         * case cc_ident_start: {
+         *     uint32_t identifier_start = state.lookahead_offset();
+         *     state.read_offset = kernels.skip_identifier(state.source.data(), state.read_offset, state.source.size());
+         *     state.identifier = {identifier_start, static_cast<uint32_t>(state.read_offset) - identifier_start};
+         *     state.previous_character = state.next_char();
+         *
+         *     Token_Type keyword = lookup_keyword(state.source.substr(state.identifier.offset, state.identifier.length));
+         *     if (keyword == tok_true || keyword == tok_false) {
+         *         state.bool_value = (keyword == tok_true);
+         *     }
+         *     return keyword;
+         * }
+         * @endcode
+         * 
+         * @par Integers and Floats
+         * Deals with integer and floating point literals, converting the digits in place in the source buffer with `std::from_chars`:
+         * @code
+         * case cc_digit: {
+         *     uint32_t number_start = state.lookahead_offset();
+         *     bool is_float = false;
+         *
+         *     do {
+         *         if (state.previous_character == '.' && is_float == true) {
+         *             return fail(state, "Too many decimal points passed to FP number");
+         *         } else if (state.previous_character == '.') {
+         *             is_float = true;
+         *         }
+         *
+         *         state.previous_character = state.next_char();
+         *
+         *         if (state.previous_character == EOF) {
+         *             return fail(state, "Unexpected end of input while reading a number");
+         *         }
+         *     } while (classify(state.previous_character) == cc_digit || state.previous_character == '.');
+         *
+         *     const char* number_first = state.source.data() + number_start;
+         *     const char* number_last = state.source.data() + state.lookahead_offset();
+         *
+         *     if (is_float == true) {
+         *         if (!parse_float_literal(state, number_first, number_last)) {
+         *             return fail(state, "Float literal out of range");
+         *         }
+         *         return tok_float_val;
+         *     }
+         *
+         *     auto [number_end, error] = std::from_chars(number_first, number_last, state.integer_value);
+         *     if (error == std::errc::result_out_of_range) {
+         *         return fail(state, "Integer literal out of range");
+         *     }
+         *     return tok_int_val;
+         * }
+         * @endcode
+         * 
+         * @par String Literals
+         * Deals with tokenization of string literals, storing the contents between the quotes as a span of the source buffer:
+         * @code
+         * case cc_double_quote: {
+         *     uint32_t string_start = static_cast<uint32_t>(state.read_offset);
+         *     while (true) {
+         *         state.previous_character = state.next_char();
+         *
+         *         if (state.previous_character == '"') {
+         *             state.string_value = {string_start, static_cast<uint32_t>(state.read_offset - 1) - string_start};
+         *             state.previous_character = state.next_char();
+         *             return tok_string_val;
+         *         }
+         *
+         *         if (state.previous_character == EOF || state.previous_character == ';') {
+         *             return fail(state, "Unterminated string");
+         *         }
+         *     }
+         * }
+         * @endcode
+         * 
+         * @par Character Literals
+         * Deals with tokenization of character literals:
+         * @code
+         * case cc_single_quote:
+         *     state.previous_character = state.next_char();
+         *
+         *     if (state.previous_character == EOF) {
+         *         return fail(state, "Unterminated character");
+         *     }
+         *
+         *     if (state.previous_character == '\'') {
+         *         return fail(state, "No character provided");
+         *     }
+         *
+         *     state.char_value = state.previous_character;
+         *     state.previous_character = state.next_char();
+         *
+         *     if (state.previous_character != '\'') {
+         *         return fail(state, "Unterminated character");
+         *     }
+         *
+         *     state.previous_character = state.next_char();
+         *     return tok_char_val;
+         * @endcode
+         *
+         * @par Anything else is not part of the language:
+         * @code
+         * default:
+         *     return fail(state, "Unrecognized character");
+         * @endcode
+         */
+        Token_Type scan_token(scanner_state& state) {
+
+            const scan_kernels::kernel_table& kernels = scan_kernels::kernels();
+
+            while (true) {
+                state.token_offset = state.lookahead_offset();
+                if (state.token_offset >= state.limit) {
+                    state.reached_limit = true;
+                    return tok_eof;
+                }
+
+                switch (classify(state.previous_character)) {
+                    case cc_newline:
+                    case cc_whitespace:
+                        state.read_offset = kernels.skip_whitespace(state.source.data(), state.read_offset, state.source.size());
+                        state.previous_character = state.next_char();
+                        continue;
+
+                    case cc_eof:
+                        return tok_eof;
 
-            if (previous_character == '*') {  
-                previous_character = input->get(); 
-                while (true) { 
-                    if (previous_character == '*') { 
-                        previous_character = input->get(); 
-                        if (previous_character == '/') { 
-                            previous_character = input->get(); 
-                            return get_token(); 
+                    case cc_single: {
+                        Token_Type token = single_char_tokens[state.previous_character];
+                        state.previous_character = state.next_char();
+                        return token;
+                    }
+
+                    case cc_plus:
+                        state.previous_character = state.next_char();
+                        if (state.previous_character == '+') {
+                            state.previous_character = state.next_char();
+                            return tok_increment;
+                        }
+                        return tok_plus;
+
+                    case cc_minus:
+                        state.previous_character = state.next_char();
+                        if (state.previous_character == '-') {
+                            state.previous_character = state.next_char();
+                            return tok_decrement;
+                        }
+                        return tok_minus;
+
+                    case cc_compound: {
+                        const compound_token& compound = compound_tokens[state.previous_character];
+                        state.previous_character = state.next_char();
+                        if (state.previous_character == compound.second) {
+                            state.previous_character = state.next_char();
+                            return compound.paired;
+                        }
+                        if (compound.alone == tok_eof) { // a lone '&' or '|'
+                            return fail(state, "Unrecognized character");
                         }
-                    } else if (previous_character == '\n') { 
-                        line_count++;
-                    } else if (previous_character == EOF) { 
-                        utility::lexer_error("Unterminated multiline comment", line_count);
+                        return compound.alone;
                     }
-                    previous_character = input->get(); 
-                }
-            }
 
-            if (previous_character == EOF) {
-                return tok_eof;
-            }
+                    case cc_slash:
+                        state.previous_character = state.next_char();
 
-            if (previous_character == '\n') {
-                line_count++;
-            }
+                        if (state.previous_character == '/') {
+                            state.read_offset = kernels.find_newline(state.source.data(), state.read_offset, state.source.size());
+                            state.previous_character = state.next_char();
+                            continue;
+                        }
 
-            previous_character = input->get(); 
-            return get_token(); 
-        }
+                        if (state.previous_character == '*') {
+                            std::size_t comment_end = kernels.find_comment_end(state.source.data(), state.read_offset, state.source.size());
+                            if (comment_end == state.source.size()) {
+                                return fail(state, "Unterminated multiline comment");
+                            }
+                            state.read_offset = comment_end + 2;
+                            state.previous_character = state.next_char();
+                            continue;
+                        }
 
-        if (isalpha(previous_character) || previous_character == '_') { 
-            identifier = previous_character; 
-            while (isalnum(previous_character = input->get()) || (previous_character == '_')) { 
-                identifier += previous_character; 
-            }
-            
-            if (identifier == "print") {
-               return tok_print;
-            }
+                        return tok_div;
 
-            if (identifier == "int") {
-                return tok_int;
-            }
-            
-            if (identifier == "float") {
-                return tok_float;
-            }
+                    case cc_ident_start: {
+                        uint32_t identifier_start = state.lookahead_offset();
+                        state.read_offset = kernels.skip_identifier(state.source.data(), state.read_offset, state.source.size());
+                        state.identifier = {identifier_start, static_cast<uint32_t>(state.read_offset) - identifier_start};
+                        state.previous_character = state.next_char();
 
-            if (identifier == "void") {
-                return tok_void;
-            }
+                        Token_Type keyword = lookup_keyword(state.source.substr(state.identifier.offset, state.identifier.length));
+                        if (keyword == tok_true || keyword == tok_false) {
+                            state.bool_value = (keyword == tok_true);
+                        }
+                        return keyword;
+                    }
 
-            if (identifier == "if") {
-                return tok_if;
-            }
-        
-            if (identifier == "else") {
-                return tok_else;
-            }
+                    case cc_digit: {
+                        uint32_t number_start = state.lookahead_offset();
+                        bool is_float = false;
 
-            if (identifier == "bool") {
-                return tok_bool;
-            }
-            
-            if (identifier == "char") {
-                return tok_char;
-            }
+                        do {
+                            if (state.previous_character == '.' && is_float == true) {
+                                return fail(state, "Too many decimal points passed to FP number");
+                            } else if (state.previous_character == '.') {
+                                is_float = true;
+                            }
 
-            if (identifier == "string") {
-                return tok_string;
-            }
+                            state.previous_character = state.next_char();
 
-            if (identifier == "for") {
-                return tok_for;
-            }
+                            if (state.previous_character == EOF) {
+                                return fail(state, "Unexpected end of input while reading a number");
+                            }
+                        } while (classify(state.previous_character) == cc_digit || state.previous_character == '.');
 
-            if (identifier == "while") {
-                return tok_while;
-            }
+                        const char* number_first = state.source.data() + number_start;
+                        const char* number_last = state.source.data() + state.lookahead_offset();
 
-            if (identifier == "true") {
-                bool_value = true;
-                return tok_true;
-            }
+                        if (is_float == true) {
+                            if (!parse_float_literal(state, number_first, number_last)) {
+                                return fail(state, "Float literal out of range");
+                            }
+                            return tok_float_val;
+                        }
 
-            if (identifier == "false") {
-                bool_value = false;
-                return tok_false;
-            }
+                        auto [number_end, error] = std::from_chars(number_first, number_last, state.integer_value);
+                        if (error == std::errc::result_out_of_range) {
+                            return fail(state, "Integer literal out of range");
+                        }
+                        return tok_int_val;
+                    }
 
-            if (identifier == "class") {
-                return tok_class;
-            }
+                    case cc_double_quote: {
+                        uint32_t string_start = static_cast<uint32_t>(state.read_offset);
+                        while (true) {
+                            state.previous_character = state.next_char();
 
-            if (identifier == "graph") {
-                return tok_graph;
-            }
+                            if (state.previous_character == '"') {
+                                state.string_value = {string_start, static_cast<uint32_t>(state.read_offset - 1) - string_start};
+                                state.previous_character = state.next_char();
+                                return tok_string_val;
+                            }
 
-            if (identifier == "return") {
-                return tok_return;
-            }
+                            if (state.previous_character == EOF || state.previous_character == ';') {
+                                return fail(state, "Unterminated string");
+                            }
+                        }
+                    }
 
-            if (identifier == "def") {
-                return tok_def;
-            }
+                    case cc_single_quote:
+                        state.previous_character = state.next_char();
 
-            if (identifier == "include") {
-                return tok_include;
-            }
+                        if (state.previous_character == EOF) {
+                            return fail(state, "Unterminated character");
+                        }
 
-            if (identifier == "list") {
-                return tok_list;
-            }
+                        if (state.previous_character == '\'') {
+                            return fail(state, "No character provided");
+                        }
 
-            if (identifier == "for") {
-                return tok_for;
-            }
+                        state.char_value = state.previous_character;
+                        state.previous_character = state.next_char();
 
-            if (identifier == "while") {
-                return tok_while;
+                        if (state.previous_character != '\'') {
+                            return fail(state, "Unterminated character");
+                        }
+
+                        state.previous_character = state.next_char();
+                        return tok_char_val;
+
+                    default:
+                        return fail(state, "Unrecognized character");
+                }
             }
-        
-            return tok_identifier;
         }
 
-        if (isdigit(previous_character)) { 
-            std::string temp_num; 
-            bool is_float = false; 
+        /**
+         * @par Appends the token the scanner just produced to `output`. Depending on the token type, the payload either holds the interned id (identifiers), indexes into a side table (strings, integers, floats), 
+         * holds the value directly (characters, booleans), or is `no_payload`:
+         * @code
+         * uint32_t payload = no_payload;
+         * switch (token) {
+         *     case tok_identifier:
+         *         payload = interner::intern(state.source.substr(state.identifier.offset, state.identifier.length)).value;
+         *         break;
+         *     case tok_string_val:
+         *         payload = output.spans.size();
+         *         output.spans.emplace_back(state.string_value);
+         *         break;
+         *     case tok_int_val:
+         *         payload = output.ints.size();
+         *         output.ints.emplace_back(state.integer_value);
+         *         break;
+         *     case tok_float_val:
+         *         payload = output.floats.size();
+         *         output.floats.emplace_back(state.float_value);
+         *         break;
+         *     case tok_char_val:
+         *         payload = static_cast<unsigned char>(state.char_value);
+         *         break;
+         *     case tok_true: case tok_false:
+         *         payload = state.bool_value;
+         *         break;
+         *     default:
+         *         break;
+         * }
+         *
+         * output.tokens.push_back({token, payload, state.token_offset});
+         * @endcode
+         */
+        inline void append_token(const scanner_state& state, Token_Type token, token_chunk& output) {
+            uint32_t payload = no_payload;
 
-            do {
-                temp_num += previous_character; 
+            switch (token) {
+                case tok_identifier:
+                    payload = interner::intern(state.source.substr(state.identifier.offset, state.identifier.length)).value;
+                    break;
+                case tok_string_val:
+                    payload = output.spans.size();
+                    output.spans.emplace_back(state.string_value);
+                    break;
+                case tok_int_val:
+                    payload = output.ints.size();
+                    output.ints.emplace_back(state.integer_value);
+                    break;
+                case tok_float_val:
+                    payload = output.floats.size();
+                    output.floats.emplace_back(state.float_value);
+                    break;
+                case tok_char_val:
+                    payload = static_cast<unsigned char>(state.char_value);
+                    break;
+                case tok_true: case tok_false:
+                    payload = state.bool_value;
+                    break;
+                default:
+                    break;
+            }
 
-                if (previous_character == '.' && is_float == true) { 
-                    utility::lexer_error("Too many decimal points passed to FP number", line_count); 
-                } else if (previous_character == '.') { 
-                    is_float = true; 
-                }
+            output.tokens.push_back({token, payload, state.token_offset});
+        }
 
-                previous_character = input->get(); 
-            
-                if (previous_character == EOF) { 
-                    utility::lexer_error("Unexpected end of input while reading a number", line_count);
+        /**
+         * <h4> Scans tokens into `output` until EOF, the scanner's limit, or an error. </h4>
+         * @code
+         * while (true) {
+         *     Token_Type token = scan_token(state);
+         *     if (state.reached_limit || state.error_message != nullptr) {
+         *         break;
+         *     }
+         *
+         *     append_token(state, token, output);
+         *
+         *     if (token == tok_eof) {
+         *         break;
+         *     }
+         * }
+         * @endcode
+         */
+        void scan_range(scanner_state& state, token_chunk& output) {
+            while (true) {
+
+                Token_Type token = scan_token(state);
+                if (state.reached_limit || state.error_message != nullptr) {
+                    break;
                 }
 
-            }  while(isdigit(previous_character) || previous_character == '.'); 
+                append_token(state, token, output);
 
-            if (is_float == true) { 
-                float_value = strtod(temp_num.c_str(), nullptr); 
-                return tok_float_val;
+                if (token == tok_eof) {
+                    break;
+                }
             }
+        }
 
-            integer_value = std::stoi(temp_num); 
-            return tok_int_val;
+        /**
+         * @par Builds a scanner that picks up where the previous `get_token()` call on `state` left off.
+         * @code
+            scanner_state scanner;
+            scanner.source = state.source;
+            scanner.read_offset = state.read_offset;
+            scanner.previous_character = state.previous_character;
+            return scanner;
+         * @endcode
+         */
+        scanner_state resume_scanner(const lexer_state& state) {
+            scanner_state scanner;
+            scanner.source = state.source;
+            scanner.read_offset = state.read_offset;
+            scanner.previous_character = state.previous_character;
+            return scanner;
         }
 
-        if (previous_character == '"') { 
-            string_value = ""; 
-            while (true) { 
-                previous_character = input->get(); 
+        /**
+         * @par Stores the scanner's position, and the value of the token it last produced, back into `state`.
+         */
+        void save_scanner(const scanner_state& scanner, lexer_state& state) {
+            state.read_offset = scanner.read_offset;
+            state.previous_character = scanner.previous_character;
+            state.identifier = scanner.identifier;
+            state.integer_value = scanner.integer_value;
+            state.float_value = scanner.float_value;
+            state.bool_value = scanner.bool_value;
+            state.char_value = scanner.char_value;
+            state.string_value = scanner.string_value;
+        }
 
-                if (previous_character == '"') { 
-                    previous_character = input->get();
-                    return tok_string_val;
+        /**
+         * @par Appends a chunk to the token stream of `state`, rebasing its side table indices. Identifier ids are already global, and token locations are absolute source offsets, so both are copied as is.
+         * @code
+            std::size_t span_base = state.span_table.size();
+            std::size_t int_base = state.int_table.size();
+            std::size_t float_base = state.float_table.size();
+
+            for (token current_token : chunk.tokens) {
+                switch (current_token.kind) {
+                    case tok_string_val:
+                        current_token.payload += span_base;
+                        break;
+                    case tok_int_val:
+                        current_token.payload += int_base;
+                        break;
+                    case tok_float_val:
+                        current_token.payload += float_base;
+                        break;
+                    default:
+                        break;
                 }
+                state.token_stream.push_back(current_token);
+            }
 
-                if (previous_character == EOF || previous_character == ';') { 
-                    utility::lexer_error("Unterminated string", line_count);
-                    break;
+            state.span_table.insert(state.span_table.end(), chunk.spans.begin(), chunk.spans.end());
+            state.int_table.insert(state.int_table.end(), chunk.ints.begin(), chunk.ints.end());
+            state.float_table.insert(state.float_table.end(), chunk.floats.begin(), chunk.floats.end());
+         * @endcode
+         */
+        void append_chunk(lexer_state& state, const token_chunk& chunk) {
+            std::size_t span_base = state.span_table.size();
+            std::size_t int_base = state.int_table.size();
+            std::size_t float_base = state.float_table.size();
+
+            for (token current_token : chunk.tokens) {
+                switch (current_token.kind) {
+                    case tok_string_val:
+                        current_token.payload += span_base;
+                        break;
+                    case tok_int_val:
+                        current_token.payload += int_base;
+                        break;
+                    case tok_float_val:
+                        current_token.payload += float_base;
+                        break;
+                    default:
+                        break;
                 }
-
-                string_value += previous_character; 
+                state.token_stream.push_back(current_token);
             }
+
+            state.span_table.insert(state.span_table.end(), chunk.spans.begin(), chunk.spans.end());
+            state.int_table.insert(state.int_table.end(), chunk.ints.begin(), chunk.ints.end());
+            state.float_table.insert(state.float_table.end(), chunk.floats.begin(), chunk.floats.end());
         }
 
-        if (previous_character == '\'') { 
-            previous_character = input->get(); 
+        /**
+         * @par Replaces `removed` elements of `target` starting at `position` with the contents of `replacement`.
+         */
+        template <typename T>
+        void splice(std::vector<T>& target, std::size_t position, std::size_t removed, const std::vector<T>& replacement) {
+            auto at = target.erase(target.begin() + position, target.begin() + position + removed);
+            target.insert(at, replacement.begin(), replacement.end());
+        }
+    }
 
-            if (previous_character == EOF) { 
-                utility::lexer_error("Unterminated character", line_count);
-            }
+    /**
+     * @par Clears the token stream and side tables and rewinds the scanner to the start of the source buffer, so that it can be tokenized again.
+     * @code
+        state.token_stream.clear();
+        state.span_table.clear();
+        state.int_table.clear();
+        state.float_table.clear();
+        state.line_starts.clear();
+        state.read_offset = 0;
+        state.previous_character = ' ';
+     * @endcode
+     */
+    void reset_lexer(lexer_state& state) {
+        state.token_stream.clear();
+        state.span_table.clear();
+        state.int_table.clear();
+        state.float_table.clear();
+        state.line_starts.clear();
+        state.read_offset = 0;
+        state.previous_character = ' ';
+    }
 
-            if (previous_character == '\'') { 
-                 utility::lexer_error("No character provided", line_count);
-            }
+    /**
+     * @par Scans the next token of `state`, and publishes its value through the per-token fields (`identifier`, `integer_value`, etc...).
+     * @code
+        scanner_state scanner = resume_scanner(state);
+        Token_Type token = scan_token(scanner);
+        save_scanner(scanner, state);
+        return token;
+     * @endcode
+     */
+    Token_Type get_token(lexer_state& state) {
+        scanner_state scanner = resume_scanner(state);
+        Token_Type token = scan_token(scanner);
+        save_scanner(scanner, state);
+        return token;
+    }
+
+    /**
+     * 
+     * <h4> This function reads through the entire source buffer, populating `token_stream` with packed token records, and the side tables with their associated values. </h4>
+     *
+     * @par Source Loading
+     * If the driver did not memory map the file, the input stream is read into a buffer first:
+     * @code
+     * if (!state.source_loaded) {
+     *     load_source_from_stream(state);
+     * }
+     * @endcode
+     *
+     * @par Large sources are split into chunks and lexed in parallel (see `tokenize_file_parallel()`), everything else is scanned in one pass:
+     * @code
+     * bool at_start = state.read_offset == 0 && state.token_stream.empty();
+     * if (at_start && state.source.size() >= parallel_lex_threshold && thread_pool::worker_count() > 1) {
+     *     tokenize_file_parallel(state, thread_pool::worker_count());
+     *     return;
+     * }
+     *
+     * scanner_state scanner = resume_scanner(state);
+     * token_chunk output{std::move(state.token_stream), std::move(state.span_table), std::move(state.int_table), std::move(state.float_table)};
+     * scan_range(scanner, output);
+     * save_scanner(scanner, state);
+     * @endcode
+     *
+     * @param state The lexer state holding the source, which receives the tokens.
+     */
+    void tokenize_file(lexer_state& state) {
+        if (!state.source_loaded) { // nothing was mapped, so fall back to reading the input stream
+            load_source_from_stream(state);
+        }
+        utility::diagnostic_source = &state;
+
+        bool at_start = state.read_offset == 0 && state.token_stream.empty();
+        if (at_start && state.source.size() >= parallel_lex_threshold && thread_pool::worker_count() > 1) {
+            tokenize_file_parallel(state, thread_pool::worker_count());
+            return;
+        }
+
+        scanner_state scanner = resume_scanner(state);
+        token_chunk output{std::move(state.token_stream), std::move(state.span_table), std::move(state.int_table), std::move(state.float_table)};
+        scan_range(scanner, output);
+        save_scanner(scanner, state);
+
+        state.token_stream = std::move(output.tokens);
+        state.span_table = std::move(output.spans);
+        state.int_table = std::move(output.ints);
+        state.float_table = std::move(output.floats);
+    }
+
+    /**
+     * <h4> Tokenizes the whole source buffer on the thread pool, producing exactly the same tokens, values, and locations as the sequential lexer. </h4>
+     *
+     * @par Splitting
+     * The source is cut just after newlines near evenly spaced offsets. Where a cut actually lands inside a string, character literal, or block comment cannot be known without scanning everything before it,
+     * so every chunk is scanned speculatively, as if its first character began a line of code, with errors recorded rather than reported:
+     * @code
+     * thread_pool::parallel_for(chunk_count, [&](std::size_t chunk_index) {
+     *     scanner_state& scanner = scanners[chunk_index];
+     *     scanner.source = state.source;
+     *     scanner.speculative = true;
+     *     scanner.limit = (chunk_index + 1 < chunk_count) ? boundaries[chunk_index + 1] : SIZE_MAX;
+     *     scanner.start_at(boundaries[chunk_index]);
+     *     scan_range(scanner, chunks[chunk_index]);
+     * });
+     * @endcode
+     *
+     * @par Stitching
+     * Each chunk stops on the first token boundary at or past the next cut. The following chunk's speculation was correct exactly when nothing but whitespace lies between the cut and that stopping point,
+     * since the sequential scanner would then be skipping whitespace when it crossed the cut as well. Otherwise the chunk is rescanned (non speculatively) from where its predecessor stopped:
+     * @code
+     * std::size_t stop_offset = scanners[chunk_index - 1].lookahead_offset();
+     * bool speculation_valid = kernels.skip_whitespace(state.source.data(), boundaries[chunk_index], stop_offset) == stop_offset;
+     *
+     * if (!speculation_valid) {
+     *     ...
+     *     scanner.start_at(stop_offset);
+     *     scan_range(scanner, chunks[chunk_index]);
+     * }
+     * @endcode
+     *
+     * @par Errors are reported in source order, so the first one is the same error the sequential lexer would have stopped at.
+     *
+     * @param state The lexer state holding the source, which receives the tokens.
+     * @param thread_count The number of chunks to aim for (more are made when the source allows, for load balancing).
+     */
+    void tokenize_file_parallel(lexer_state& state, unsigned thread_count) {
+        if (!state.source_loaded) {
+            load_source_from_stream(state);
+        }
+        utility::diagnostic_source = &state;
 
-            char_value = previous_character; 
+        const scan_kernels::kernel_table& kernels = scan_kernels::kernels();
 
-            previous_character = input->get(); 
+        std::size_t wanted_chunks = std::max<std::size_t>(1, std::min<std::size_t>(std::size_t(thread_count) * 4, state.source.size() / minimum_chunk_size));
+        std::vector<std::size_t> boundaries = {0};
+        for (std::size_t i = 1; i < wanted_chunks; i++) {
+            std::size_t target = std::max(state.source.size() / wanted_chunks * i, boundaries.back() + 1);
+            std::size_t newline = kernels.find_newline(state.source.data(), std::min(target, state.source.size()), state.source.size());
+            if (newline + 1 >= state.source.size()) {
+                break;
+            }
+            boundaries.push_back(newline + 1);
+        }
 
-            if (previous_character == EOF) { 
-                utility::lexer_error("Unterminated character", line_count);
-            } else if (previous_character != '\'') { 
-                utility::lexer_error("Unterminated character", line_count);
+        std::size_t chunk_count = boundaries.size();
+        std::vector<scanner_state> scanners(chunk_count);
+        std::vector<token_chunk> chunks(chunk_count);
+
+        thread_pool::parallel_for(chunk_count, [&](std::size_t chunk_index) {
+            scanner_state& scanner = scanners[chunk_index];
+            scanner.source = state.source;
+            scanner.speculative = true;
+            scanner.limit = (chunk_index + 1 < chunk_count) ? boundaries[chunk_index + 1] : SIZE_MAX;
+            scanner.start_at(boundaries[chunk_index]);
+            scan_range(scanner, chunks[chunk_index]);
+        });
+
+        state.token_stream.clear();
+        state.span_table.clear();
+        state.int_table.clear();
+        state.float_table.clear();
+        state.line_starts.clear();
+
+        for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+            scanner_state& scanner = scanners[chunk_index];
+
+            if (chunk_index > 0) {
+                std::size_t stop_offset = scanners[chunk_index - 1].lookahead_offset();
+                bool speculation_valid = kernels.skip_whitespace(state.source.data(), boundaries[chunk_index], stop_offset) == stop_offset;
+
+                if (!speculation_valid) {
+                    std::size_t limit = scanner.limit;
+                    scanner = scanner_state();
+                    scanner.source = state.source;
+                    scanner.limit = limit;
+                    scanner.start_at(stop_offset);
+
+                    chunks[chunk_index] = token_chunk();
+                    scan_range(scanner, chunks[chunk_index]);
+                }
             }
 
-            previous_character = input->get(); 
-            return tok_char_val; 
+            if (scanner.error_message != nullptr) {
+                utility::lexer_error(scanner.error_message, scanner.error_location);
+            }
+
+            append_chunk(state, chunks[chunk_index]);
         }
 
-        int current_character = previous_character; 
+        save_scanner(scanners.back(), state);
     }
 
     /**
-     * 
-     * <h4> This function reads through the entire input stream and calls `get_token()` 
-     *  to retrieve tokens and their associated values. It continuously populates the 
-     * `token_stream` with the tokens and `stored_values` with their corresponding values. </h4>
+     * <h4> Brings the token stream of `state` up to date after an edit to its source, rescanning only the tokens the edit could have changed. The result is identical to tokenizing the edited source from scratch. </h4>
      *
-     * @par Token Storage
-     * Stores tokens in the `token_stream` vector:
+     * @par `state.source` must already hold the edited text, while the token stream still describes the text before the edit, in which `removed_length` characters at `edit_offset` were replaced by `inserted_length` new ones.
+     *
+     * @par Restarting
+     * A token only reads up to the first character after it, so every token ending before the edit is unaffected. Scanning restarts a couple of tokens before the first one at or past the edit:
      * @code
-     * Token_Type token = get_token();
-     * if (token == tok_eof) {
-     *     token_stream.emplace_back(token);
-     *      stored_values.emplace_back(std::nullopt);
-     *     break;
-     * }
-     * token_stream.emplace_back(token);
-     *  line_count_vec.emplace_back(line_count);
+     * auto at_edit = std::lower_bound(tokens.begin(), tokens.end(), edit_offset, [](const token& tok, std::size_t offset) {
+     *     return tok.location < offset;
+     * });
+     * std::size_t first = at_edit - tokens.begin();
+     * first = (first > 2) ? first - 2 : 0;
      * @endcode
      *
-     * @par Associated Value Storage
-     * Stores values associated with the adjacent token in the `stored_values` vector. Depending on the token type, 
-     * it stores various types of values such as identifiers, integers, floats, characters, strings, or booleans:
+     * @par Resynchronizing
+     * Once a token starts past the inserted text at the (shifted) offset of an old token, the scanner is exactly where it was when it scanned that old token, so it and every token after it are kept:
      * @code
-     * switch (token) {
-     *     case tok_identifier:
-     *         stored_values.emplace_back(identifier);
-     *         break;
-     *     case tok_int_val:
-     *         stored_values.emplace_back(integer_value);
-     *         break;
-     *     case tok_float_val:
-     *         stored_values.emplace_back(float_value);
-     *         break;
-     *     case tok_char_val:
-     *         stored_values.emplace_back(char_value);
-     *         break;
-     *     case tok_string_val:
-     *         stored_values.emplace_back(string_value);
-     *         break;
-     *     case tok_true: case tok_false:
-     *         stored_values.emplace_back(bool_value);
-     *         break;
-     *     default:
-     *         stored_values.emplace_back(std::nullopt);
+     * if (scanner.token_offset >= edit_end) {
+     *     std::ptrdiff_t old_offset = static_cast<std::ptrdiff_t>(scanner.token_offset) - offset_delta;
+     *     while (resume < old_count && tokens[resume].location < old_offset) {
+     *         resume++;
+     *     }
+     *     if (resume < old_count && tokens[resume].location == old_offset) {
      *         break;
+     *     }
      * }
      * @endcode
+     *
+     * @par Splicing
+     * Side table entries are stored in token order, so the entries of the replaced tokens are one contiguous range of each table. The new entries take their place, and the kept tokens after the edit have their payloads and locations shifted. The line table no longer matches the text, so it is dropped and rebuilt the next time a location is resolved.
+     *
+     * @return Which range of the token stream was replaced, so the parser can tell which top level statements need to be parsed again.
      */
-    void tokenize_file() {
+    token_damage relex_edit(lexer_state& state, std::size_t edit_offset, std::size_t removed_length, std::size_t inserted_length) {
+        std::vector<token>& tokens = state.token_stream;
+        std::size_t old_count = tokens.size();
+        std::ptrdiff_t offset_delta = static_cast<std::ptrdiff_t>(inserted_length) - static_cast<std::ptrdiff_t>(removed_length);
+        utility::diagnostic_source = &state;
+        state.line_starts.clear();
+
+        auto at_edit = std::lower_bound(tokens.begin(), tokens.end(), edit_offset, [](const token& tok, std::size_t offset) {
+            return tok.location < offset;
+        });
+        std::size_t first = at_edit - tokens.begin();
+        first = (first > 2) ? first - 2 : 0;
+
+        scanner_state scanner;
+        scanner.source = state.source;
+        scanner.start_at((first == 0) ? 0 : tokens[first].location);
+
+        token_chunk chunk;
+        std::size_t resume = first;
+        std::size_t edit_end = edit_offset + inserted_length;
+
         while (true) {
+            Token_Type token = scan_token(scanner);
+
+            if (scanner.token_offset >= edit_end) {
+                std::ptrdiff_t old_offset = static_cast<std::ptrdiff_t>(scanner.token_offset) - offset_delta;
+                while (resume < old_count && tokens[resume].location < old_offset) {
+                    resume++;
+                }
+                if (resume < old_count && tokens[resume].location == old_offset) {
+                    break;
+                }
+            }
+
+            append_token(scanner, token, chunk);
 
-            Token_Type token = get_token();
             if (token == tok_eof) {
-                token_stream.emplace_back(token);
-                stored_values.emplace_back(std::nullopt);
-                line_count_vec.emplace_back(line_count);
+                resume = old_count;
                 break;
             }
-            token_stream.emplace_back(token);
-            line_count_vec.emplace_back(line_count);
+        }
 
-            switch (token) {
-                case tok_identifier:
-                    stored_values.emplace_back(identifier);
+        std::size_t span_first = state.span_table.size(), int_first = state.int_table.size(), float_first = state.float_table.size();
+        std::size_t span_removed = 0, int_removed = 0, float_removed = 0;
+
+        for (std::size_t i = first; i < resume; i++) {
+            const token& old_token = tokens[i];
+            switch (old_token.kind) {
+                case tok_string_val:
+                    span_first = (span_removed++ == 0) ? old_token.payload : span_first;
                     break;
                 case tok_int_val:
-                    stored_values.emplace_back(integer_value);
+                    int_first = (int_removed++ == 0) ? old_token.payload : int_first;
                     break;
                 case tok_float_val:
-                    stored_values.emplace_back(float_value);
+                    float_first = (float_removed++ == 0) ? old_token.payload : float_first;
                     break;
-                case tok_char_val:
-                    stored_values.emplace_back(char_value);
+                default:
                     break;
+            }
+        }
+
+        std::ptrdiff_t span_shift = static_cast<std::ptrdiff_t>(chunk.spans.size()) - static_cast<std::ptrdiff_t>(span_removed);
+        std::ptrdiff_t int_shift = static_cast<std::ptrdiff_t>(chunk.ints.size()) - static_cast<std::ptrdiff_t>(int_removed);
+        std::ptrdiff_t float_shift = static_cast<std::ptrdiff_t>(chunk.floats.size()) - static_cast<std::ptrdiff_t>(float_removed);
+        bool span_found = span_removed > 0, int_found = int_removed > 0, float_found = float_removed > 0;
+
+        for (std::size_t i = resume; i < old_count; i++) {
+            token& kept_token = tokens[i];
+            switch (kept_token.kind) {
                 case tok_string_val:
-                    stored_values.emplace_back(string_value);
+                    span_first = span_found ? span_first : kept_token.payload;
+                    span_found = true;
+                    state.span_table[kept_token.payload].offset += offset_delta;
+                    kept_token.payload += span_shift;
                     break;
-                case tok_true: case tok_false:
-                    stored_values.emplace_back(bool_value);
+                case tok_int_val:
+                    int_first = int_found ? int_first : kept_token.payload;
+                    int_found = true;
+                    kept_token.payload += int_shift;
+                    break;
+                case tok_float_val:
+                    float_first = float_found ? float_first : kept_token.payload;
+                    float_found = true;
+                    kept_token.payload += float_shift;
                     break;
                 default:
-                    stored_values.emplace_back(std::nullopt);
                     break;
             }
+            kept_token.location += offset_delta;
         }
 
+        for (token& new_token : chunk.tokens) {
+            switch (new_token.kind) {
+                case tok_string_val:
+                    new_token.payload += span_first;
+                    break;
+                case tok_int_val:
+                    new_token.payload += int_first;
+                    break;
+                case tok_float_val:
+                    new_token.payload += float_first;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        splice(tokens, first, resume - first, chunk.tokens);
+        splice(state.span_table, span_first, span_removed, chunk.spans);
+        splice(state.int_table, int_first, int_removed, chunk.ints);
+        splice(state.float_table, float_first, float_removed, chunk.floats);
+
+        return {first, resume - first, chunk.tokens.size()};
+    }
+
+    /**
+     * @par Fills `state.line_starts` with the offset every line of the source starts at. Nothing on the lexing path needs lines, so this only runs the first time a location has to be shown to the user.
+     * @code
+        const scan_kernels::kernel_table& kernels = scan_kernels::kernels();
+        const char* data = state.source.data();
+        std::size_t size = state.source.size();
+
+        state.line_starts.clear();
+        state.line_starts.reserve(kernels.count_newlines(data, 0, size) + 1);
+        state.line_starts.push_back(0);
+        for (std::size_t newline = kernels.find_newline(data, 0, size); newline < size; newline = kernels.find_newline(data, newline + 1, size)) {
+            state.line_starts.push_back(static_cast<uint32_t>(newline + 1));
+        }
+     * @endcode
+     */
+    void build_line_table(lexer_state& state) {
+        const scan_kernels::kernel_table& kernels = scan_kernels::kernels();
+        const char* data = state.source.data();
+        std::size_t size = state.source.size();
+
+        state.line_starts.clear();
+        state.line_starts.reserve(kernels.count_newlines(data, 0, size) + 1);
+        state.line_starts.push_back(0);
+        for (std::size_t newline = kernels.find_newline(data, 0, size); newline < size; newline = kernels.find_newline(data, newline + 1, size)) {
+            state.line_starts.push_back(static_cast<uint32_t>(newline + 1));
+        }
+    }
+
+    /**
+     * @par Turns a source location into the (1 based) line and column it points at, building the line table first if needed. The line is found with a binary search for the last line starting at or before the location.
+     * @code
+        if (state.line_starts.empty()) {
+            build_line_table(state);
+        }
+        auto line = std::upper_bound(state.line_starts.begin(), state.line_starts.end(), location) - 1;
+        return {static_cast<uint32_t>(line - state.line_starts.begin()) + 1, location - *line + 1};
+     * @endcode
+     */
+    source_position locate(lexer_state& state, source_location location) {
+        if (state.line_starts.empty()) {
+            build_line_table(state);
+        }
+        auto line = std::upper_bound(state.line_starts.begin(), state.line_starts.end(), location) - 1;
+        return {static_cast<uint32_t>(line - state.line_starts.begin()) + 1, location - *line + 1};
     }
 
     /**
      * @par Allows the user to grab a token based on the index of the desired token in the token stream.
      * @param token_number The desired index in the token stream.
      * @code
-     *  if (token_stream.empty()) {
-            utility::lexer_error("Token stream not yet initialized", parser::current_line);
+     *  if (state.token_stream.empty()) {
+            utility::lexer_error("Token stream not yet initialized", parser::current_location);
         } 
-        if (token_number >= token_stream.size()) {
-            utility::lexer_error("Number greater than token stream size", parser::current_line);
+        if (token_number < 0 || static_cast<std::size_t>(token_number) >= state.token_stream.size()) {
+            utility::lexer_error("Number greater than token stream size", parser::current_location);
         }
-        return token_stream.at(token_number);
+        return state.token_stream.at(token_number).kind;
      * @endcode
      */
-    Token_Type peek_token(int token_number) {
-        if (token_stream.empty()) {
-            utility::lexer_error("Token stream not yet initialized", parser::current_line);
+    Token_Type peek_token(const lexer_state& state, int token_number) {
+        if (state.token_stream.empty()) {
+            utility::lexer_error("Token stream not yet initialized", parser::current_location);
         } 
-        if (token_number >= token_stream.size()) {
-            utility::lexer_error("Number greater than token stream size", parser::current_line);
+        if (token_number < 0 || static_cast<std::size_t>(token_number) >= state.token_stream.size()) {
+            utility::lexer_error("Number greater than token stream size", parser::current_location);
         }
-        return token_stream.at(token_number);
+        return state.token_stream.at(token_number).kind;
     }
 
     /**
-     * @par Simply returns whether a token is an operator.
+     * @par Simply returns whether a token is an infix operator (arithmetic, comparison, or logical).
      * @param token The token in question
      * @code
-     * return (token == tok_plus || token == tok_minus || token == tok_mult || token == tok_div);
+        switch (token) {
+            case tok_plus: case tok_minus: case tok_mult: case tok_div: case tok_mod:
+            case tok_equal: case tok_not_equal: case tok_less: case tok_less_equal: case tok_greater: case tok_greater_equal:
+            case tok_and: case tok_or:
+                return true;
+            default:
+                return false;
+        }
      * @endcode
      */
     bool is_operator(Token_Type token) {
-        return (token == tok_plus || token == tok_minus || token == tok_mult || token == tok_div);
+        switch (token) {
+            case tok_plus: case tok_minus: case tok_mult: case tok_div: case tok_mod:
+            case tok_equal: case tok_not_equal: case tok_less: case tok_less_equal: case tok_greater: case tok_greater_equal:
+            case tok_and: case tok_or:
+                return true;
+            default:
+                return false;
+        }
     }
 
 }
\ No newline at end of file
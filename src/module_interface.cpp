@@ -0,0 +1,666 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/module_interface/module_interface.h"
+#include "../include/ast_cache/ast_cache.h"
+#include "../include/codegen/codegen.h"
+#include "../include/scoping/scoping.h"
+#include "../include/thread_pool/thread_pool.h"
+#include "../include/utility/utility.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace module_interface {
+
+    namespace {
+
+        /**
+         * @struct registered_module
+         * @par A module this process has asked for. While `ready` is false it is still being loaded or built, and `waiting_for` names the module its build is currently blocked on (if any), which is how include cycles are found.
+         */
+        struct registered_module {
+            bool ready = false;
+            std::string waiting_for;
+            interface module;
+        };
+
+        /**
+         * @par Every module required so far, by canonical path. Each one is loaded or built once per process, however many files include it. Entries are never removed, so references handed out stay valid.
+         */
+        std::mutex registry_mutex;
+        std::condition_variable registry_changed;
+        std::map<std::string, std::unique_ptr<registered_module>> registry;
+
+        /**
+         * @par Writes the exports (and dependencies) one per line. The same text is hashed into the fingerprint and written to the interface file, so what is read back hashes the same.
+         * @code
+            std::ostringstream text;
+            for (const exported_function& function : module.functions) {
+                text << "function " << interner::name(function.name) << " " << static_cast<int>(function.return_type) << " " << function.parameters.size();
+                for (type_enum::types parameter : function.parameters) {
+                    text << " " << static_cast<int>(parameter);
+                }
+                text << "\n";
+            }
+            for (const exported_global& global : module.globals) {
+                text << "global " << interner::name(global.name) << " " << static_cast<int>(global.type) << "\n";
+            }
+            return text.str();
+         * @endcode
+         */
+        std::string render_exports(const interface& module) {
+            std::ostringstream text;
+            for (const exported_function& function : module.functions) {
+                text << "function " << interner::name(function.name) << " " << static_cast<int>(function.return_type) << " " << function.parameters.size();
+                for (type_enum::types parameter : function.parameters) {
+                    text << " " << static_cast<int>(parameter);
+                }
+                text << "\n";
+            }
+            for (const exported_global& global : module.globals) {
+                text << "global " << interner::name(global.name) << " " << static_cast<int>(global.type) << "\n";
+            }
+            return text.str();
+        }
+
+        uint64_t fingerprint_of(const interface& module) {
+            return std::hash<std::string>()(render_exports(module));
+        }
+
+        /**
+         * @par Returns where the interface or bitcode of the module whose source hashes to `key` lives.
+         */
+        std::string cached_path(const std::string& key, const char* extension) {
+            return ast_cache::cache_directory() + "/" + key + extension;
+        }
+
+        /**
+         * @par Writes `bytes` to `path` through a temporary file, so a reader sees either the whole file or none of it. Failing to write is not an error; the next compile just rebuilds the module.
+         */
+        bool write_file(const std::string& path, const std::string& bytes) {
+            std::error_code error;
+            std::string temporary = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                if (!file || !file.write(bytes.data(), bytes.size())) {
+                    file.close();
+                    std::filesystem::remove(temporary, error);
+                    return false;
+                }
+            }
+            std::filesystem::rename(temporary, path, error);
+            if (error) {
+                std::filesystem::remove(temporary, error);
+                return false;
+            }
+            return true;
+        }
+
+        bool read_file(const std::string& path, std::string& bytes) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                return false;
+            }
+            bytes.assign(static_cast<std::size_t>(file.tellg()), '\0');
+            file.seekg(0);
+            return static_cast<bool>(file.read(bytes.data(), bytes.size()));
+        }
+
+        /**
+         * @par Reads back the interface written for the source hashing to `key`, and its bitcode. It is only used if it describes the same module (`path`, `source_bytes`), its bitcode is intact, and every module it was checked against still has the interface it had then; those are required on the way, so they are loaded (or rebuilt) first.
+         */
+        bool read_interface(const std::string& key, const std::string& path, std::size_t source_bytes, const std::vector<std::string>& include_chain, interface& module) {
+            std::string bytes;
+            if (!read_file(cached_path(key, interface_extension), bytes)) {
+                return false;
+            }
+            std::istringstream lines(bytes);
+
+            std::string line;
+            std::string keyword;
+            uint32_t version = 0;
+            uint64_t recorded_source_bytes = 0;
+            uint64_t bitcode_bytes = 0;
+            if (!std::getline(lines, line) || !(std::istringstream(line) >> keyword >> version) || keyword != "pyroxene-module" || version != format_version) {
+                return false;
+            }
+
+            std::vector<std::string> chain = include_chain;
+            chain.push_back(path);
+            while (std::getline(lines, line)) {
+                std::istringstream fields(line);
+                fields >> keyword;
+                if (keyword == "source") {
+                    if (line.substr(keyword.size() + 1) != path) {
+                        return false;
+                    }
+                } else if (keyword == "source_bytes") {
+                    fields >> recorded_source_bytes;
+                } else if (keyword == "bitcode_bytes") {
+                    fields >> bitcode_bytes;
+                } else if (keyword == "depends") {
+                    uint64_t fingerprint = 0;
+                    fields >> fingerprint;
+                    std::string dependency_path;
+                    std::getline(fields >> std::ws, dependency_path);
+                    if (require(dependency_path, chain).fingerprint != fingerprint) {
+                        return false;
+                    }
+                    module.dependencies.push_back({dependency_path, fingerprint});
+                } else if (keyword == "function") {
+                    std::string name;
+                    int return_type = 0;
+                    std::size_t parameter_count = 0;
+                    fields >> name >> return_type >> parameter_count;
+                    exported_function function = {interner::intern(name), static_cast<type_enum::types>(return_type), {}};
+                    for (std::size_t parameter = 0; parameter < parameter_count; parameter++) {
+                        int parameter_type = 0;
+                        fields >> parameter_type;
+                        function.parameters.push_back(static_cast<type_enum::types>(parameter_type));
+                    }
+                    module.functions.push_back(std::move(function));
+                } else if (keyword == "global") {
+                    std::string name;
+                    int type = 0;
+                    fields >> name >> type;
+                    module.globals.push_back({interner::intern(name), static_cast<type_enum::types>(type)});
+                } else {
+                    return false;
+                }
+                if (fields.fail()) {
+                    return false;
+                }
+            }
+
+            if (recorded_source_bytes != source_bytes || !read_file(cached_path(key, bitcode_extension), module.bitcode) || module.bitcode.size() != bitcode_bytes) {
+                return false;
+            }
+            module.source_path = path;
+            module.fingerprint = fingerprint_of(module);
+            return true;
+        }
+
+        /**
+         * @par Writes a freshly built module's bitcode and interface. The bitcode goes first, so an interface on disk always has its bitcode next to it.
+         * @code
+            std::error_code error;
+            std::filesystem::create_directories(ast_cache::cache_directory(), error);
+            if (error || !write_file(cached_path(key, bitcode_extension), module.bitcode)) {
+                return;
+            }
+
+            std::ostringstream text;
+            text << "pyroxene-module " << format_version << "\n";
+            text << "source " << module.source_path << "\n";
+            text << "source_bytes " << source_bytes << "\n";
+            text << "bitcode_bytes " << module.bitcode.size() << "\n";
+            for (const dependency& included : module.dependencies) {
+                text << "depends " << included.fingerprint << " " << included.path << "\n";
+            }
+            text << render_exports(module);
+            write_file(cached_path(key, interface_extension), text.str());
+         * @endcode
+         */
+        void write_interface(const std::string& key, std::size_t source_bytes, const interface& module) {
+            std::error_code error;
+            std::filesystem::create_directories(ast_cache::cache_directory(), error);
+            if (error || !write_file(cached_path(key, bitcode_extension), module.bitcode)) {
+                return;
+            }
+
+            std::ostringstream text;
+            text << "pyroxene-module " << format_version << "\n";
+            text << "source " << module.source_path << "\n";
+            text << "source_bytes " << source_bytes << "\n";
+            text << "bitcode_bytes " << module.bitcode.size() << "\n";
+            for (const dependency& included : module.dependencies) {
+                text << "depends " << included.fingerprint << " " << included.path << "\n";
+            }
+            text << render_exports(module);
+            write_file(cached_path(key, interface_extension), text.str());
+        }
+
+        /**
+         * @par Compiles a module like any other file, on a thread of its own: codegen and semantic analysis state is thread local, and the file that included the module is still in the middle of using it. That thread stays part of the including file's pool task, so the module's own parallel lexing and analysis run inline rather than as a second pool job.
+         * The exports are collected by the driver loop once the module has been analyzed (see `collect_exports()`), and its finished LLVM module is verified and written out as bitcode.
+         * @code
+            module.source_path = unit.file_name;
+            unit.module_chain = include_chain;
+            unit.exports = &module;
+            thread_pool::run_on_new_thread([&unit]() { utility::compile_translation_unit(unit); });
+
+            if (llvm::verifyModule(*unit.LLVM_Module, &llvm::errs())) {
+                utility::module_error("Module verification failed for ", unit.file_name);
+            }
+
+            llvm::raw_string_ostream bitcode(module.bitcode);
+            llvm::WriteBitcodeToFile(*unit.LLVM_Module, bitcode);
+            bitcode.flush();
+         * @endcode
+         */
+        void build_module(context::compilation_context& unit, const std::vector<std::string>& include_chain, interface& module) {
+            module.source_path = unit.file_name;
+            unit.module_chain = include_chain;
+            unit.exports = &module;
+            thread_pool::run_on_new_thread([&unit]() { utility::compile_translation_unit(unit); });
+
+            if (llvm::verifyModule(*unit.LLVM_Module, &llvm::errs())) {
+                utility::module_error("Module verification failed for ", unit.file_name);
+            }
+
+            llvm::raw_string_ostream bitcode(module.bitcode);
+            llvm::WriteBitcodeToFile(*unit.LLVM_Module, bitcode);
+            bitcode.flush();
+        }
+
+        /**
+         * @par Loads the interface of the module at `path` if one was written for its current source (and is still valid), and builds the module otherwise. Only the source is read to find the interface, so an unchanged module is never lexed or parsed.
+         * @code
+            context::compilation_context unit;
+            unit.file_name = path;
+            if (!lexer::map_source_file(unit.lexer, path)) {
+                std::ifstream file(path);
+                if (!file) {
+                    utility::module_error("Included module not found: ", path);
+                }
+                unit.lexer.input = &file;
+                lexer::load_source_from_stream(unit.lexer);
+                unit.lexer.input = nullptr;
+            }
+
+            std::string key = ast_cache::cache_key(unit.lexer.source, path);
+            std::size_t source_bytes = unit.lexer.source.size();
+            interface module;
+            if (!key.empty() && read_interface(key, path, source_bytes, include_chain, module)) {
+                lexer::release_source(unit.lexer);
+                return module;
+            }
+
+            module = interface();
+            std::vector<std::string> chain = include_chain;
+            chain.push_back(path);
+            build_module(unit, chain, module);
+            if (!key.empty()) {
+                write_interface(key, source_bytes, module);
+            }
+            return module;
+         * @endcode
+         */
+        interface load_or_build(const std::string& path, const std::vector<std::string>& include_chain) {
+            context::compilation_context unit;
+            unit.file_name = path;
+            if (!lexer::map_source_file(unit.lexer, path)) {
+                std::ifstream file(path);
+                if (!file) {
+                    utility::module_error("Included module not found: ", path);
+                }
+                unit.lexer.input = &file;
+                lexer::load_source_from_stream(unit.lexer);
+                unit.lexer.input = nullptr;
+            }
+
+            std::string key = ast_cache::cache_key(unit.lexer.source, path);
+            std::size_t source_bytes = unit.lexer.source.size();
+            interface module;
+            if (!key.empty() && read_interface(key, path, source_bytes, include_chain, module)) {
+                lexer::release_source(unit.lexer);
+                return module;
+            }
+
+            module = interface(); // whatever a stale interface left behind
+            std::vector<std::string> chain = include_chain;
+            chain.push_back(path);
+            build_module(unit, chain, module);
+            if (!key.empty()) {
+                write_interface(key, source_bytes, module);
+            }
+            return module;
+        }
+
+        /**
+         * @par Returns whether `path` (being loaded or built) is, through the modules each build is waiting on, waiting on `requester`, in which case `requester` waiting on `path` would never finish. Called with `registry_mutex` held.
+         */
+        bool waits_on(const std::string& path, const std::string& requester) {
+            std::set<std::string> visited;
+            for (std::string current = path; !current.empty() && visited.insert(current).second; ) {
+                if (current == requester) {
+                    return true;
+                }
+                auto entry = registry.find(current);
+                if (entry == registry.end() || entry->second->ready) {
+                    return false;
+                }
+                current = entry->second->waiting_for;
+            }
+            return false;
+        }
+    }
+
+    /**
+     * @par Returns whether an include names a .pyrx module rather than a standard library.
+     */
+    bool is_module_include(const std::string& item) {
+        return item.size() > 5 && item.compare(item.size() - 5, 5, ".pyrx") == 0;
+    }
+
+    /**
+     * @par Resolves an included module's path, as written, against the directory of the file including it. The result is canonical, so one module reached through different spellings is still loaded once.
+     */
+    std::string resolve_path(const std::string& including_file, const std::string& item) {
+        std::filesystem::path module_path(item);
+        if (module_path.is_relative()) {
+            module_path = std::filesystem::path(including_file).parent_path() / module_path;
+        }
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(module_path, error);
+        return (error ? module_path.lexically_normal() : canonical).string();
+    }
+
+    /**
+     * @par Returns the interface of the module at `path` (canonical, see `resolve_path()`), loading or building it the first time any file of this process asks for it. `include_chain` lists the modules being built that led here.
+     * A file asking for a module another thread is still working on waits for it, unless that thread is (through the modules it is waiting on) waiting on the asking module, which means the modules include each other; that is an error rather than a deadlock.
+     * @code
+            std::unique_lock<std::mutex> lock(registry_mutex);
+            const std::string* requester = include_chain.empty() ? nullptr : &include_chain.back();
+            if (requester != nullptr && waits_on(path, *requester)) {
+                utility::module_error("Modules include each other: ", path);
+            }
+
+            auto [position, inserted] = registry.try_emplace(path);
+            if (inserted) {
+                position->second = std::make_unique<registered_module>();
+            }
+            registered_module& entry = *position->second;
+            registered_module* waiting = nullptr;
+            if (requester != nullptr) {
+                if (auto requesting = registry.find(*requester); requesting != registry.end()) {
+                    waiting = requesting->second.get();
+                    waiting->waiting_for = path;
+                }
+            }
+
+            if (inserted) {
+                lock.unlock();
+                interface module = load_or_build(path, include_chain);
+                lock.lock();
+                entry.module = std::move(module);
+                entry.ready = true;
+                registry_changed.notify_all();
+            } else {
+                registry_changed.wait(lock, [&entry]() { return entry.ready; });
+            }
+
+            if (waiting != nullptr) {
+                waiting->waiting_for.clear();
+            }
+            return entry.module;
+     * @endcode
+     */
+    const interface& require(const std::string& path, const std::vector<std::string>& include_chain) {
+        std::unique_lock<std::mutex> lock(registry_mutex);
+        const std::string* requester = include_chain.empty() ? nullptr : &include_chain.back();
+        if (requester != nullptr && waits_on(path, *requester)) {
+            utility::module_error("Modules include each other: ", path);
+        }
+
+        auto [position, inserted] = registry.try_emplace(path);
+        if (inserted) {
+            position->second = std::make_unique<registered_module>();
+        }
+        registered_module& entry = *position->second;
+        registered_module* waiting = nullptr;
+        if (requester != nullptr) {
+            if (auto requesting = registry.find(*requester); requesting != registry.end()) {
+                waiting = requesting->second.get();
+                waiting->waiting_for = path;
+            }
+        }
+
+        if (inserted) {
+            lock.unlock();
+            interface module = load_or_build(path, include_chain);
+            lock.lock();
+            entry.module = std::move(module);
+            entry.ready = true;
+            registry_changed.notify_all();
+        } else {
+            registry_changed.wait(lock, [&entry]() { return entry.ready; });
+        }
+
+        if (waiting != nullptr) {
+            waiting->waiting_for.clear();
+        }
+        return entry.module;
+    }
+
+    /**
+     * @par Records what a module being compiled exports, once its program has been analyzed: every top level function except `main`, and every global variable. Does nothing for a file that is not being compiled as a module.
+     * @code
+        if (ctx.exports == nullptr) {
+            return;
+        }
+        interface& module = *ctx.exports;
+
+        for (const auto& item : program) {
+            if (item.index() == 1) {
+                ast::func_defn& function = *std::get<1>(item);
+                if (interner::name(function.get_name()) == "main") {
+                    continue;
+                }
+                exported_function exported = {function.get_name(), function.get_return_type(), {}};
+                for (const ast::node_ptr<ast::top_level_expr>& parameter : function.get_parameters()) {
+                    exported.parameters.push_back(parameter->get_expr_type());
+                }
+                module.functions.push_back(std::move(exported));
+                continue;
+            }
+
+            ast::top_level_expr* statement = std::get<0>(item).get();
+            if (ast::variable_declaration* declaration = ast::dyn_cast<ast::variable_declaration>(statement); declaration != nullptr && declaration->get_is_global()) {
+                module.globals.push_back({declaration->get_name(), declaration->get_expr_type()});
+            } else if (ast::variable_definition* definition = ast::dyn_cast<ast::variable_definition>(statement); definition != nullptr && definition->get_is_global()) {
+                module.globals.push_back({definition->get_name(), definition->get_expr_type()});
+            }
+        }
+
+        for (const interface* included : ctx.modules) {
+            module.dependencies.push_back({included->source_path, included->fingerprint});
+        }
+        module.fingerprint = fingerprint_of(module);
+     * @endcode
+     */
+    void collect_exports(context::compilation_context& ctx, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        if (ctx.exports == nullptr) {
+            return;
+        }
+        interface& module = *ctx.exports;
+
+        for (const auto& item : program) {
+            if (item.index() == 1) {
+                ast::func_defn& function = *std::get<1>(item);
+                if (interner::name(function.get_name()) == "main") {
+                    continue;
+                }
+                exported_function exported = {function.get_name(), function.get_return_type(), {}};
+                for (const ast::node_ptr<ast::top_level_expr>& parameter : function.get_parameters()) {
+                    exported.parameters.push_back(parameter->get_expr_type());
+                }
+                module.functions.push_back(std::move(exported));
+                continue;
+            }
+
+            ast::top_level_expr* statement = std::get<0>(item).get();
+            if (ast::variable_declaration* declaration = ast::dyn_cast<ast::variable_declaration>(statement); declaration != nullptr && declaration->get_is_global()) {
+                module.globals.push_back({declaration->get_name(), declaration->get_expr_type()});
+            } else if (ast::variable_definition* definition = ast::dyn_cast<ast::variable_definition>(statement); definition != nullptr && definition->get_is_global()) {
+                module.globals.push_back({definition->get_name(), definition->get_expr_type()});
+            }
+        }
+
+        for (const interface* included : ctx.modules) {
+            module.dependencies.push_back({included->source_path, included->fingerprint});
+        }
+        module.fingerprint = fingerprint_of(module);
+    }
+
+    /**
+     * @par Makes a module's exports known to semantic analysis of the including file: its functions as defined functions, and its globals as initialized variables of the global scope (which must already be open).
+     * @code
+        for (const exported_function& function : module.functions) {
+            if (sem_analysis_scope::global_contains_func_defn(function.name)) {
+                utility::sem_analysis_error("Function '" + interner::name(function.name) + "' is defined by more than one included module", lexer::no_location);
+            }
+            sem_analysis_scope::add_function_defn(function.name, function.return_type, function.parameters);
+        }
+        for (const exported_global& global : module.globals) {
+            if (sem_analysis_scope::variable_exists_in_current_scope(global.name)) {
+                utility::sem_analysis_error("Global variable '" + interner::name(global.name) + "' is defined by more than one included module", lexer::no_location);
+            }
+            sem_analysis_scope::add_var_to_current_scope(global.name, global.type, true, interner::intern("base_literal"));
+        }
+     * @endcode
+     */
+    void import_semantics(const interface& module) {
+        for (const exported_function& function : module.functions) {
+            if (sem_analysis_scope::global_contains_func_defn(function.name)) {
+                utility::sem_analysis_error("Function '" + interner::name(function.name) + "' is defined by more than one included module", lexer::no_location);
+            }
+            sem_analysis_scope::add_function_defn(function.name, function.return_type, function.parameters);
+        }
+        for (const exported_global& global : module.globals) {
+            if (sem_analysis_scope::variable_exists_in_current_scope(global.name)) {
+                utility::sem_analysis_error("Global variable '" + interner::name(global.name) + "' is defined by more than one included module", lexer::no_location);
+            }
+            sem_analysis_scope::add_var_to_current_scope(global.name, global.type, true, interner::intern("base_literal"));
+        }
+    }
+
+    /**
+     * @par Declares a module's exports in the module being generated, so calls and global accesses resolve to them; the definitions come from the module's bitcode, which the driver hands to the JIT.
+     * Imported globals have no initializer here, and are marked as initialized elsewhere instead. They take the next global slots in the order `import_semantics()` numbered them, since the modules of a unit are declared in the order they were imported, before any global of the unit itself.
+     * @code
+        for (const exported_function& function : module.functions) {
+            if (codegen::LLVM_Module->getFunction(interner::name(function.name)) != nullptr) {
+                continue;
+            }
+            std::vector<llvm::Type*> parameter_types;
+            for (type_enum::types parameter : function.parameters) {
+                parameter_types.push_back(codegen::get_llvm_type(parameter));
+            }
+            llvm::FunctionType* function_type = llvm::FunctionType::get(codegen::get_llvm_type(function.return_type), parameter_types, false);
+            llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, interner::name(function.name), *codegen::LLVM_Module);
+        }
+        for (const exported_global& global : module.globals) {
+            llvm::GlobalVariable* declaration = codegen::LLVM_Module->getGlobalVariable(interner::name(global.name));
+            if (declaration == nullptr) {
+                declaration = new llvm::GlobalVariable(*codegen::LLVM_Module, codegen::get_llvm_type(global.type), false, llvm::GlobalValue::ExternalLinkage, nullptr, interner::name(global.name));
+                declaration->setExternallyInitialized(true);
+            }
+            scope::bind_slot(ast::global_slot | static_cast<ast::variable_slot>(scope::global_slots.size()), declaration);
+        }
+     * @endcode
+     */
+    void declare_exports(const interface& module) {
+        for (const exported_function& function : module.functions) {
+            if (codegen::LLVM_Module->getFunction(interner::name(function.name)) != nullptr) {
+                continue;
+            }
+            std::vector<llvm::Type*> parameter_types;
+            for (type_enum::types parameter : function.parameters) {
+                parameter_types.push_back(codegen::get_llvm_type(parameter));
+            }
+            llvm::FunctionType* function_type = llvm::FunctionType::get(codegen::get_llvm_type(function.return_type), parameter_types, false);
+            llvm::Function::Create(function_type, llvm::Function::ExternalLinkage, interner::name(function.name), *codegen::LLVM_Module);
+        }
+        for (const exported_global& global : module.globals) {
+            llvm::GlobalVariable* declaration = codegen::LLVM_Module->getGlobalVariable(interner::name(global.name));
+            if (declaration == nullptr) {
+                declaration = new llvm::GlobalVariable(*codegen::LLVM_Module, codegen::get_llvm_type(global.type), false, llvm::GlobalValue::ExternalLinkage, nullptr, interner::name(global.name));
+                declaration->setExternallyInitialized(true);
+            }
+            scope::bind_slot(ast::global_slot | static_cast<ast::variable_slot>(scope::global_slots.size()), declaration);
+        }
+    }
+
+    /**
+     * @par Returns every module required by this process so far (ordered by path), each of which the driver adds to the JIT once.
+     */
+    std::vector<const interface*> required_modules() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        std::vector<const interface*> modules;
+        for (const auto& entry : registry) {
+            if (entry.second->ready) {
+                modules.push_back(&entry.second->module);
+            }
+        }
+        return modules;
+    }
+
+    /**
+     * @par Reads a module's bitcode into `llvm_context`. Definitions other than the exports (the standard library copies linked into the module) are made weak, as `weaken_duplicate_library()` does for the files of one compile, so they merge with the copies any other file links in.
+     * @code
+        std::unique_ptr<llvm::MemoryBuffer> buffer = llvm::MemoryBuffer::getMemBuffer(module.bitcode, module.source_path, false);
+        llvm::Expected<std::unique_ptr<llvm::Module>> parsed = llvm::parseBitcodeFile(buffer->getMemBufferRef(), llvm_context);
+        if (!parsed) {
+            utility::module_error("Unreadable bitcode (" + llvm::toString(parsed.takeError()) + ") for ", module.source_path);
+        }
+        std::unique_ptr<llvm::Module> loaded = std::move(*parsed);
+
+        std::set<std::string> exported;
+        ...
+        for (llvm::Function& function : *loaded) {
+            if (!function.isDeclaration() && !function.hasLocalLinkage() && exported.count(function.getName().str()) == 0) {
+                function.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+            }
+        }
+        ...
+        return loaded;
+     * @endcode
+     */
+    std::unique_ptr<llvm::Module> load_bitcode(const interface& module, llvm::LLVMContext& llvm_context) {
+        std::unique_ptr<llvm::MemoryBuffer> buffer = llvm::MemoryBuffer::getMemBuffer(module.bitcode, module.source_path, false);
+        llvm::Expected<std::unique_ptr<llvm::Module>> parsed = llvm::parseBitcodeFile(buffer->getMemBufferRef(), llvm_context);
+        if (!parsed) {
+            utility::module_error("Unreadable bitcode (" + llvm::toString(parsed.takeError()) + ") for ", module.source_path);
+        }
+        std::unique_ptr<llvm::Module> loaded = std::move(*parsed);
+
+        std::set<std::string> exported;
+        for (const exported_function& function : module.functions) {
+            exported.insert(interner::name(function.name));
+        }
+        for (const exported_global& global : module.globals) {
+            exported.insert(interner::name(global.name));
+        }
+
+        for (llvm::Function& function : *loaded) {
+            if (!function.isDeclaration() && !function.hasLocalLinkage() && exported.count(function.getName().str()) == 0) {
+                function.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+            }
+        }
+        for (llvm::GlobalVariable& global : loaded->globals()) {
+            if (!global.isDeclaration() && !global.hasLocalLinkage() && exported.count(global.getName().str()) == 0) {
+                global.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+            }
+        }
+        return loaded;
+    }
+}
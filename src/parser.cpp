@@ -7,265 +7,281 @@ If LICENSE.md is not included, this version of the source code is provided in br
 */
 
 #include "../include/parser/parser.h"
+#include "../include/module_interface/module_interface.h"
 #include "../debug_test_suite/parser_tests/parser_tests.cpp"
 namespace parser {
-    int current_token;
+    thread_local lexer::source_location current_location = lexer::no_location;
 
-    lexer::Token_Type current_token_as_token;
-
-    std::map<lexer::Token_Type, int> operator_precedence;
-
-    int current_token_index = 0;
-    int current_line;
-    int token_index_max = lexer::token_stream.size();
-
-    std::optional<lexer::lexer_stored_values> current_value;
+    std::array<uint8_t, operator_precedence_size> operator_precedence = {};
 
     /**
-     * @par Grabs the next token from input, increments the index, and casts it to an int.
+     * @par Grabs the next token from input by reference, and increments the index.
      * 
      * @code
-        if (current_token_index >= lexer::token_stream.size()) {
+        if (ctx.parser.current_token_index >= ctx.parser.token_index_max) {
             throw std::out_of_range("Token Stream Access OUT OF RANGE");
         }
-        current_token = lexer::token_stream.at(current_token_index);
+        ctx.parser.current_token_record = ctx.parser.source->token_stream.data() + ctx.parser.current_token_index;
 
-        if (current_token_index >= lexer::stored_values.size()) {
-            throw std::out_of_range("Value Stream Access OUT OF RANGE");
-        }   
-        current_value = lexer::stored_values.at(current_token_index);     
-        
-        if (current_token_index >= lexer::line_count_vec.size()) {
-            throw std::out_of_range("Line Count Vector Access OUT OF RANGE");
-        } 
-        current_line = lexer::line_count_vec.at(current_token_index);
+        ctx.parser.current_token_as_token = ctx.parser.current_token_record->kind;
+        ctx.parser.current_token = ctx.parser.current_token_as_token;
+        current_location = ctx.parser.current_token_record->location;
 
-        current_token_index++;
-        current_token_as_token = static_cast<lexer::Token_Type>(current_token);
+        ctx.parser.current_token_index++;
 
-        return current_token;
+        return ctx.parser.current_token;
      * @endcode
      */
-    int get_next_token() {
-        if (current_token_index >= lexer::token_stream.size()) {
+    int get_next_token(context::compilation_context& ctx) {
+        if (ctx.parser.current_token_index >= ctx.parser.token_index_max) {
             throw std::out_of_range("Token Stream Access OUT OF RANGE");
         }
-        current_token = lexer::token_stream.at(current_token_index);
+        ctx.parser.current_token_record = ctx.parser.source->token_stream.data() + ctx.parser.current_token_index;
 
-        if (current_token_index >= lexer::stored_values.size()) {
-            throw std::out_of_range("Value Stream Access OUT OF RANGE");
-        }
-        current_value = lexer::stored_values.at(current_token_index);
-
-        if (current_token_index >= lexer::line_count_vec.size()) {
-            throw std::out_of_range("Line Count Vector Access OUT OF RANGE");
-        } 
-        current_line = lexer::line_count_vec.at(current_token_index);
+        ctx.parser.current_token_as_token = ctx.parser.current_token_record->kind;
+        ctx.parser.current_token = ctx.parser.current_token_as_token;
+        current_location = ctx.parser.current_token_record->location;
 
-        current_token_index++;
-        current_token_as_token = static_cast<lexer::Token_Type>(current_token);
+        ctx.parser.current_token_index++;
 
-        return current_token;
+        return ctx.parser.current_token;
     }
 
 
    /**
-    * @par When called, figures out whether we are dealing with a unary, or binary expression, and calls the respective function.
-    * 
-    * @par Initialize all intermediary storage units.
+    * @par Parses a full expression, which ends at a semicolon, comma, or the closing parenthesis of whatever it is nested in.
     * @code
-    *   std::vector<lexer::Token_Type> single_nested_expr_tokens; 
-        std::vector<std::optional<lexer::lexer_stored_values>> single_nested_expr_values; 
-        std::vector<std::unique_ptr<ast::top_level_expr>> parsed_expressions; 
-        std::vector<lexer::Token_Type> operators; 
-
-        int paren_count = 0;
-        std::unique_ptr<ast::top_level_expr> current_expr = nullptr;
-    * @endcode
+        if (ctx.parser.current_token_as_token == lexer::tok_semicolon || ctx.parser.current_token_as_token == lexer::tok_close_paren) {
+            utility::parser_error("Expected an expression", current_location);
+        }
 
-    @par Iterate over the token stream until we encounter a semicolon, or a closing parenthesis, and the number of nested parenthesis is 0.
-    Functionally, we then parse each individual primary expression in the binary expression, and store operators in an adjacent vector. We build the tree up from there.
-    @code 
-        while ((current_token_as_token != lexer::tok_semicolon) && (current_token_as_token != lexer::tok_close_paren || paren_count > 0)) { // while it is an expression.. 
+        ast::node_ptr<ast::top_level_expr> expression = parse_expression_with_precedence(ctx, 0);
 
-            current_expr = parse_primary_expression(current_token_as_token, current_value.value());
+        if (ctx.parser.current_token_as_token != lexer::tok_semicolon && ctx.parser.current_token_as_token != lexer::tok_close_paren && ctx.parser.current_token_as_token != lexer::tok_comma) {
+            utility::parser_error("Expected infix operator in expression", current_location);
+        }
 
-            if (current_expr == nullptr) {
-                utility::parser_error("Parsed expression is null", current_line);
-            }
+        return expression;
+    * @endcode
+    */
+    ast::node_ptr<ast::top_level_expr> parse_expression(context::compilation_context& ctx) {
+        if (ctx.parser.current_token_as_token == lexer::tok_semicolon || ctx.parser.current_token_as_token == lexer::tok_close_paren) {
+            utility::parser_error("Expected an expression", current_location);
+        }
 
-            parsed_expressions.push_back(std::move(current_expr));
+        ast::node_ptr<ast::top_level_expr> expression = parse_expression_with_precedence(ctx, 0);
 
-            if ((current_token_as_token == lexer::tok_semicolon) || (current_token_as_token == lexer::tok_close_paren && paren_count <= 0) || (current_token_as_token == lexer::tok_comma)) break;
+        if (ctx.parser.current_token_as_token != lexer::tok_semicolon && ctx.parser.current_token_as_token != lexer::tok_close_paren && ctx.parser.current_token_as_token != lexer::tok_comma) {
+            utility::parser_error("Expected infix operator in expression", current_location);
+        }
 
-            if (!lexer::is_operator(current_token_as_token)) {
-                utility::parser_error("Expected infix operator in expression", current_line);
-            }
+        return expression;
+    }
 
-            operators.push_back(current_token_as_token);
+    namespace {
 
-            get_next_token(); 
-        }
-    @endcode
+        /**
+         * @par What an expression is still waiting on while its operand is parsed: a prefix operator to apply to it, an open parenthesis to close after it, or an infix operator whose left operand is `left`. `location` is where the operator is, which the node it becomes is located at.
+         */
+        struct pending_operator {
+            enum { prefix, paren, infix } role;
+            lexer::Token_Type op;
+            int precedence;
+            ast::node_ptr<ast::top_level_expr> left;
+            lexer::source_location location;
+        };
 
-    @par Keep building up binary expression until the number of operators in the operator vector is 0. Then return the singular expression stored in the vecotr (allowed to be primary or unary).
-    @code
-        int index_of_highest_prec_op = -1;
-        int highest_prec = -1;
-        lexer::Token_Type current_op;
-        while (operators.size() != 0) {
+        /**
+         * @par Shared by every expression parsed on this thread, so parsing one does not allocate. An expression nested in another (a call argument) works above the entries of the one it is nested in.
+         */
+        thread_local std::vector<pending_operator> operator_stack;
 
-            for (int i = 0; i < operators.size(); i++) {
-                current_op = operators.at(i);
-                if (operator_precedence.find(current_op) != operator_precedence.end()) {
-                    if (operator_precedence[current_op] > highest_prec) {
-                        highest_prec = operator_precedence[current_op];
-                        index_of_highest_prec_op = i;
+        /**
+         * @par Trims one of this thread's parser stacks back to the size it had when the guard was made. A parser error thrown while errors are deferred (an edit being checked, a function parsed ahead on a pool thread) unwinds past the code that pops what was pushed, and the entries left behind hold nodes and lists in an arena that is freed long before the thread exits.
+         */
+        template <typename stack_type>
+        class stack_depth_guard {
+            private:
+                stack_type& entries;
+                std::size_t depth;
+
+            public:
+                explicit stack_depth_guard(stack_type& entries) : entries(entries), depth(entries.size()) {}
+                ~stack_depth_guard() {
+                    if (entries.size() > depth) {
+                        entries.erase(entries.begin() + depth, entries.end());
                     }
                 }
-            }
+                stack_depth_guard(const stack_depth_guard&) = delete;
+                stack_depth_guard& operator=(const stack_depth_guard&) = delete;
+        };
+    }
 
-            if (index_of_highest_prec_op == -1) {
-                utility::parser_error("Operator not found in operator map", current_line);
+    /**
+     * <h4> Parses an expression by precedence climbing (a Pratt parser), in a single pass over its tokens. </h4>
+     *
+     * @par Parse one operand, then keep folding infix operators into the tree for as long as they bind tighter than the operator waiting on it (or `minimum_precedence`).
+     * The right hand side of each operator stops at the next operator of the same level, which makes operators left associative.
+     * Instead of recursing for every prefix operator, parenthesis, and tighter binding operator, what is still waiting on an operand is kept on an explicit stack, so machine generated expressions nested hundreds of thousands deep parse in linear time without growing the call stack.
+     * @par Parse an operand: push every prefix operator and '(' in front of it, then parse the primary expression.
+     * @code
+        while (true) {
+            if (ctx.parser.current_token_as_token == lexer::tok_minus || ctx.parser.current_token_as_token == lexer::tok_not) {
+                waiting.push_back({pending_operator::prefix, ctx.parser.current_token_as_token, 0, nullptr, ctx.parser.current_token_record->location});
+                get_next_token(ctx); // consume the operator
+            } else if (ctx.parser.current_token_as_token == lexer::tok_open_paren) {
+                waiting.push_back({pending_operator::paren, lexer::tok_open_paren, 0, nullptr, ctx.parser.current_token_record->location});
+                get_next_token(ctx); // consume the '('
+            } else {
+                break;
             }
-
-            current_op = current_op = operators.at(index_of_highest_prec_op);
-            operators.erase(operators.begin() + index_of_highest_prec_op);
-
-            auto left_expr = std::move(parsed_expressions.at(index_of_highest_prec_op));
-            auto right_expr = std::move(parsed_expressions.at(index_of_highest_prec_op + 1));
-
-            parsed_expressions.at(index_of_highest_prec_op) = parse_binary_expr(std::move(left_expr), std::move(right_expr), current_op);
-            parsed_expressions.erase(parsed_expressions.begin() + index_of_highest_prec_op + 1);
-
-            index_of_highest_prec_op = -1;
-            highest_prec = -1;
+        }
+        lexer::source_location operand_location = ctx.parser.current_token_record->location;
+        ast::node_ptr<ast::top_level_expr> operand = parse_primary_expression(ctx, *ctx.parser.current_token_record);
+        operand->set_location(operand_location);
+     * @endcode
+     *
+     * @par Then fold the operand into what is waiting on it, from the top of the stack down, until an operator binds it tighter (start on its right hand side) or nothing is left (it is the whole expression). Operator nodes are located at their operator.
+     * @code
+        if (top.role == pending_operator::prefix) {
+            operand = ast::make_node<ast::unary_expr>(top.op, std::move(operand));
+            operand->set_location(top.location);
+            continue;
         }
 
-        return std::move(parsed_expressions.at(0));
-    @endcode
-    */
-    std::unique_ptr<ast::top_level_expr> parse_expression() {
-
-        std::vector<lexer::Token_Type> single_nested_expr_tokens; // stores the sub token stream
-        std::vector<std::optional<lexer::lexer_stored_values>> single_nested_expr_values; // stores the values adjacent to the token stream (can be a nullopt)
-        std::vector<std::unique_ptr<ast::top_level_expr>> parsed_expressions; // stores the parsed expressions, eventually should be a single value that we extract and return
-        std::vector<lexer::Token_Type> operators; // the intermediary operators
-
-        int paren_count = 0;
-        std::unique_ptr<ast::top_level_expr> current_expr = nullptr;
-        
-        while ((current_token_as_token != lexer::tok_semicolon) && (current_token_as_token != lexer::tok_close_paren || paren_count > 0)) { // while it is an expression.. 
-            // need to aggregate tokens until we find an operator
-
-            current_expr = parse_primary_expression(current_token_as_token, current_value.value());
+        int floor = (waiting.size() == base) ? minimum_precedence : (top.role == pending_operator::infix ? top.precedence : 0);
+        if (get_precedence(op) > floor) {
+            waiting.push_back({pending_operator::infix, op, get_precedence(op), std::move(operand), ctx.parser.current_token_record->location});
+            get_next_token(ctx); // consume the operator
+            break;
+        }
+        if (waiting.size() == base) {
+            return operand;
+        }
 
-            if (current_expr == nullptr) {
-                utility::parser_error("Parsed expression is null", current_line);
+        if (top.role == pending_operator::infix) {
+            operand = parse_binary_expr(ctx, std::move(top.left), std::move(operand), top.op);
+            operand->set_location(top.location);
+        } else { // a '(' closes around everything above it
+            if (ctx.parser.current_token_as_token != lexer::tok_close_paren) {
+                utility::parser_error("Number of parenthesis do not match", current_location);
             }
+            get_next_token(ctx); // consume the ')'
+        }
+     * @endcode
+     *
+     * @param minimum_precedence Operators at or below this level are left for the caller.
+     */
+    ast::node_ptr<ast::top_level_expr> parse_expression_with_precedence(context::compilation_context& ctx, int minimum_precedence) {
+        std::vector<pending_operator>& waiting = operator_stack;
+        const std::size_t base = waiting.size();
+        stack_depth_guard<std::vector<pending_operator>> trim_on_error(waiting);
 
-            parsed_expressions.push_back(std::move(current_expr));
-
-            if ((current_token_as_token == lexer::tok_semicolon) || (current_token_as_token == lexer::tok_close_paren && paren_count <= 0) || (current_token_as_token == lexer::tok_comma)) break;
+        while (true) {
+            while (true) {
+                if (ctx.parser.current_token_as_token == lexer::tok_minus || ctx.parser.current_token_as_token == lexer::tok_not) {
+                    waiting.push_back({pending_operator::prefix, ctx.parser.current_token_as_token, 0, nullptr, ctx.parser.current_token_record->location});
+                    get_next_token(ctx); // consume the operator
+                } else if (ctx.parser.current_token_as_token == lexer::tok_open_paren) {
+                    waiting.push_back({pending_operator::paren, lexer::tok_open_paren, 0, nullptr, ctx.parser.current_token_record->location});
+                    get_next_token(ctx); // consume the '('
+                } else {
+                    break;
+                }
+            }
 
-            if (!lexer::is_operator(current_token_as_token)) {
-                utility::parser_error("Expected infix operator in expression", current_line);
+            lexer::source_location operand_location = ctx.parser.current_token_record->location;
+            ast::node_ptr<ast::top_level_expr> operand = parse_primary_expression(ctx, *ctx.parser.current_token_record);
+            if (operand == nullptr) {
+                utility::parser_error("Parsed expression is null", current_location);
             }
+            operand->set_location(operand_location);
 
+            while (true) {
+                if (waiting.size() > base && waiting.back().role == pending_operator::prefix) {
+                    auto ast_node = ast::make_node<ast::unary_expr>(waiting.back().op, std::move(operand));
+                    ast_node->set_location(waiting.back().location);
 
-            operators.push_back(current_token_as_token);
+                    #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+                        ast_node->debug_output();
+                    #endif
 
-            get_next_token(); // consume the operator
-        }
+                    operand = std::move(ast_node);
+                    waiting.pop_back();
+                    continue;
+                }
 
-        if (paren_count != 0) {
-            utility::parser_error("Number of parenthesis do not match", current_line);
-        }
+                lexer::Token_Type op = ctx.parser.current_token_as_token;
+                int precedence = get_precedence(op);
+                int floor = minimum_precedence;
+                if (waiting.size() > base) {
+                    floor = (waiting.back().role == pending_operator::infix) ? waiting.back().precedence : 0;
+                }
 
-        if (operators.size() != parsed_expressions.size() - 1) {
-            utility::parser_error("Number of infix operators does not match number of expressions", current_line);
-        }
+                if (precedence > floor) { // binds tighter than whatever is waiting, so the operand is its left hand side
+                    waiting.push_back({pending_operator::infix, op, precedence, std::move(operand), ctx.parser.current_token_record->location});
+                    get_next_token(ctx); // consume the operator
+                    break;
+                }
 
-        int index_of_highest_prec_op = -1;
-        int highest_prec = -1;
-        lexer::Token_Type current_op;
-        while (operators.size() != 0) {
+                if (waiting.size() == base) {
+                    return operand;
+                }
 
-            for (int i = 0; i < operators.size(); i++) {
-                current_op = operators.at(i);
-                if (operator_precedence.find(current_op) != operator_precedence.end()) {
-                    if (operator_precedence[current_op] > highest_prec) {
-                        highest_prec = operator_precedence[current_op];
-                        index_of_highest_prec_op = i;
+                if (waiting.back().role == pending_operator::infix) {
+                    operand = parse_binary_expr(ctx, std::move(waiting.back().left), std::move(operand), waiting.back().op);
+                    operand->set_location(waiting.back().location);
+                } else {
+                    if (ctx.parser.current_token_as_token != lexer::tok_close_paren) {
+                        utility::parser_error("Number of parenthesis do not match", current_location);
                     }
+                    get_next_token(ctx); // consume the ')'
                 }
+                waiting.pop_back();
             }
-
-            if (index_of_highest_prec_op == -1) {
-                utility::parser_error("Operator not found in operator map", current_line);
-            }
-
-            // highest prec => if is 0, then between 0 and 1, if 1, then between 1 and 2
-            current_op = current_op = operators.at(index_of_highest_prec_op);
-            operators.erase(operators.begin() + index_of_highest_prec_op);
-
-            // overwrite the value with a parsed binary expression at index of highest prec op
-            // delete the expression at index of highest prec op + 1
-            auto left_expr = std::move(parsed_expressions.at(index_of_highest_prec_op));
-            auto right_expr = std::move(parsed_expressions.at(index_of_highest_prec_op + 1));
-
-            parsed_expressions.at(index_of_highest_prec_op) = parse_binary_expr(std::move(left_expr), std::move(right_expr), current_op);
-            parsed_expressions.erase(parsed_expressions.begin() + index_of_highest_prec_op + 1);
-
-            index_of_highest_prec_op = -1;
-            highest_prec = -1;
         }
-
-        return std::move(parsed_expressions.at(0));
     }
     
     /**
      * @par When called, parses tokens into leaf nodes of our AST.
      * 
-     * @param prev_tok The token being parsed as a primary expression,
-     * @param top_level This indicates whether or not the expression is or isn't nested within a binary expression. (true = not in binary_expr)
-     * @param value A paramter that passes the value associated with the primary expression, whether it be a float, boolean, string, etc...
+     * @param tok The packed token being parsed as a primary expression, whose payload holds the associated float, boolean, string, etc...
      * @code
-        if (prev_tok == lexer::tok_int_val) return std::move(parse_int_expr(value));
-        if (prev_tok == lexer::tok_float_val) return std::move(parse_float_expr(value));
-        if (prev_tok == lexer::tok_char_val) return std::move(parse_char_expr(value));
-        if (prev_tok == lexer::tok_string_val) return std::move(parse_string_expr(value));
-        if (prev_tok == lexer::tok_true) return std::move(parse_bool_expr(value));
-        if (prev_tok == lexer::tok_false) return std::move(parse_bool_expr(value));
-        if (prev_tok == lexer::tok_identifier) {
-            if (current_token_as_token == lexer::tok_open_paren) {
-                return std::move(parse_func_call(std::get<std::string>(value)));
+        if (tok.kind == lexer::tok_int_val) return std::move(parse_int_expr(ctx, tok));
+        if (tok.kind == lexer::tok_float_val) return std::move(parse_float_expr(ctx, tok));
+        if (tok.kind == lexer::tok_char_val) return std::move(parse_char_expr(ctx, tok));
+        if (tok.kind == lexer::tok_string_val) return std::move(parse_string_expr(ctx, tok));
+        if (tok.kind == lexer::tok_true) return std::move(parse_bool_expr(ctx, tok));
+        if (tok.kind == lexer::tok_false) return std::move(parse_bool_expr(ctx, tok));
+        if (tok.kind == lexer::tok_identifier) {
+            if (ctx.parser.current_token_as_token == lexer::tok_open_paren) {
+                return std::move(parse_func_call(ctx, tok));
             }
-            return std::move(parse_identifier_expr(value)); 
+            return std::move(parse_identifier_expr(ctx, tok)); 
         }
      * @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_primary_expression(lexer::Token_Type prev_tok, lexer::lexer_stored_values value) {
-        if (prev_tok == lexer::tok_int_val) return std::move(parse_int_expr(value));
-        if (prev_tok == lexer::tok_float_val) return std::move(parse_float_expr(value));
-        if (prev_tok == lexer::tok_char_val) return std::move(parse_char_expr(value));
-        if (prev_tok == lexer::tok_string_val) return std::move(parse_string_expr(value));
-        if (prev_tok == lexer::tok_true) return std::move(parse_bool_expr(value));
-        if (prev_tok == lexer::tok_false) return std::move(parse_bool_expr(value));
-
-        if (prev_tok == lexer::tok_identifier) {
-            if (lexer::peek_token(current_token_index) == lexer::tok_open_paren) {
-                return std::move(parse_func_call(std::get<std::string>(value)));
+    ast::node_ptr<ast::top_level_expr> parse_primary_expression(context::compilation_context& ctx, const lexer::token& tok) {
+        if (tok.kind == lexer::tok_int_val) return std::move(parse_int_expr(ctx, tok));
+        if (tok.kind == lexer::tok_float_val) return std::move(parse_float_expr(ctx, tok));
+        if (tok.kind == lexer::tok_char_val) return std::move(parse_char_expr(ctx, tok));
+        if (tok.kind == lexer::tok_string_val) return std::move(parse_string_expr(ctx, tok));
+        if (tok.kind == lexer::tok_true) return std::move(parse_bool_expr(ctx, tok));
+        if (tok.kind == lexer::tok_false) return std::move(parse_bool_expr(ctx, tok));
+
+        if (tok.kind == lexer::tok_identifier) {
+            if (peek_next_token(ctx) == lexer::tok_open_paren) {
+                return std::move(parse_func_call(ctx, tok));
             }
-            if (lexer::peek_token(current_token_index) == lexer::tok_dot) {
-                return std::move(parse_method_dot_call());
+            if (peek_next_token(ctx) == lexer::tok_dot) {
+                return std::move(parse_method_dot_call(ctx));
             }
 
-            return std::move(parse_identifier_expr(value)); 
+            return std::move(parse_identifier_expr(ctx, tok)); 
         }
         
 
-        utility::parser_error("Primary expression not recognized", current_line);
+        utility::parser_error("Primary expression not recognized", current_location);
         return nullptr;
     }
 
@@ -275,12 +291,12 @@ namespace parser {
      * @param right The right expression.
      * @param operand The infix operator.
      * @code
-     * auto ast_node = std::make_unique<ast::binary_expr>(operator, std::move(left), std::move(right));
+     * auto ast_node = ast::make_node<ast::binary_expr>(operator, std::move(left), std::move(right));
        return std::move(ast_node); 
      * @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_binary_expr(std::unique_ptr<ast::top_level_expr> left, std::unique_ptr<ast::top_level_expr> right, lexer::Token_Type operand) {
-        auto ast_node = std::make_unique<ast::binary_expr>(operand, std::move(left), std::move(right));
+    ast::node_ptr<ast::top_level_expr> parse_binary_expr(context::compilation_context&, ast::node_ptr<ast::top_level_expr> left, ast::node_ptr<ast::top_level_expr> right, lexer::Token_Type operand) {
+        auto ast_node = ast::make_node<ast::binary_expr>(operand, std::move(left), std::move(right));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -294,65 +310,65 @@ namespace parser {
     * 
     * @par First we check the type
     * @code
-    *   type_enum::types type = parse_type();
-        std::string identifier;
+    *   type_enum::types type = parse_type(ctx);
+        interner::symbol_id identifier = interner::no_symbol;
 
-        get_next_token();
+        get_next_token(ctx);
     * @endcode
 
       @par We then store the identifier, and put it in the type map.
       
       @code
-        std::optional<lexer::lexer_stored_values> value = current_value;;
+        const lexer::token& tok = *ctx.parser.current_token_record;
 
-        if (value.has_value()) {
-            if (std::holds_alternative<std::string>(value.value())) {
-                identifier = std::get<std::string>(value.value());
+        if (tok.payload != lexer::no_payload) {
+            if (lexer::has_text(tok)) {
+                identifier = lexer::token_symbol(*ctx.parser.source, tok);
             } 
             else {
-                utility::parser_error("Expected identifier", current_line);
+                utility::parser_error("Expected identifier", current_location);
             }
         }
 
-        get_next_token();
+        get_next_token(ctx);
 
       @endcode
 
       @par We then check whether the next token is an '=', or a ';', ',', or an ')' and call the respective declaration, or definition token.
 
       @code
-        if (current_token == lexer::tok_assignment) {
-            return std::move(parse_var_defn(type, identifier));
-        } else if (current_token == lexer::tok_semicolon || current_token == lexer::tok_comma || current_token == lexer::tok_close_paren) {
-            return std::move(parse_var_decl(type, identifier));
+        if (ctx.parser.current_token == lexer::tok_assignment) {
+            return std::move(parse_var_defn(ctx, type, identifier));
+        } else if (ctx.parser.current_token == lexer::tok_semicolon || ctx.parser.current_token == lexer::tok_comma || ctx.parser.current_token == lexer::tok_close_paren) {
+            return std::move(parse_var_decl(ctx, type, identifier));
         
-        utility::parser_error("Expected variable definition or declaration", current_line);
+        utility::parser_error("Expected variable definition or declaration", current_location);
 
       @endcode
     */
-    std::unique_ptr<ast::top_level_expr> parse_var_decl_defn() {
-        type_enum::types type = parse_type();
-        std::string identifier;
-        get_next_token(); // consume the type
+    ast::node_ptr<ast::top_level_expr> parse_var_decl_defn(context::compilation_context& ctx) {
+        type_enum::types type = parse_type(ctx);
+        interner::symbol_id identifier = interner::no_symbol;
+        get_next_token(ctx); // consume the type
 
-        std::optional<lexer::lexer_stored_values> value = current_value;
+        const lexer::token& tok = *ctx.parser.current_token_record;
 
-        if (value.has_value()) {
-            if (std::holds_alternative<std::string>(value.value())) {
-                identifier = std::get<std::string>(value.value());
+        if (tok.payload != lexer::no_payload) {
+            if (lexer::has_text(tok)) {
+                identifier = lexer::token_symbol(*ctx.parser.source, tok);
             } 
             else {
-                utility::parser_error("Expected identifier", current_line);
+                utility::parser_error("Expected identifier", current_location);
             }
         }
-        get_next_token(); // consume the identifier
+        get_next_token(ctx); // consume the identifier
 
-        if (current_token == lexer::tok_assignment) {
-            return std::move(parse_var_defn(type, identifier));
-        } else if (current_token == lexer::tok_semicolon || current_token == lexer::tok_comma || current_token == lexer::tok_close_paren) {
-            return std::move(parse_var_decl(type, identifier));
+        if (ctx.parser.current_token == lexer::tok_assignment) {
+            return std::move(parse_var_defn(ctx, type, identifier));
+        } else if (ctx.parser.current_token == lexer::tok_semicolon || ctx.parser.current_token == lexer::tok_comma || ctx.parser.current_token == lexer::tok_close_paren) {
+            return std::move(parse_var_decl(ctx, type, identifier));
         } 
-        utility::parser_error("Expected variable definition or declaration", current_line);
+        utility::parser_error("Expected variable definition or declaration", current_location);
         return nullptr;
 
     }
@@ -361,7 +377,7 @@ namespace parser {
      * @par This function simply needs to create an AST node for a variable declaration based on the values passed to it
      * 
      * @code
-        auto ast_node = std::make_unique<ast::variable_declaration>(type, identifier);
+        auto ast_node = ast::make_node<ast::variable_declaration>(type, identifier);
 
         #if (DEBUG_MODE == 1)
             ast_node->debug_output();
@@ -370,9 +386,9 @@ namespace parser {
         return std::move(ast_node);
      * @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_var_decl(type_enum::types type, std::string identifier) {
+    ast::node_ptr<ast::top_level_expr> parse_var_decl(context::compilation_context&, type_enum::types type, interner::symbol_id identifier) {
 
-        auto ast_node = std::make_unique<ast::variable_declaration>(type, identifier);
+        auto ast_node = ast::make_node<ast::variable_declaration>(type, identifier);
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -386,24 +402,24 @@ namespace parser {
      * @par Parses a variable definition, and returns an AST node.
      * 
      * @code
-        get_next_token(); // consume the '='
-        auto assigned_expr = parse_expression();
+        get_next_token(ctx); // consume the '='
+        auto assigned_expr = parse_expression(ctx);
 
         if (assigned_expr->get_expr_type() != type) {
-            utility::parser_error("Defining a variable with incorrect type", current_line);
+            utility::parser_error("Defining a variable with incorrect type", current_location);
         }
         
-        auto ast_node = std::make_unique<ast::variable_definition>(type, identifier, std::move(assigned_expr));
+        auto ast_node = ast::make_node<ast::variable_definition>(type, identifier, std::move(assigned_expr));
         return std::move(ast_node);
      * @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_var_defn(type_enum::types type, std::string identifier) {
+    ast::node_ptr<ast::top_level_expr> parse_var_defn(context::compilation_context& ctx, type_enum::types type, interner::symbol_id identifier) {
 
-        get_next_token(); // consume the '='
+        get_next_token(ctx); // consume the '='
 
-        auto assigned_expr = parse_expression();
+        auto assigned_expr = parse_expression(ctx);
         
-        auto ast_node = std::make_unique<ast::variable_definition>(type, identifier, std::move(assigned_expr));
+        auto ast_node = ast::make_node<ast::variable_definition>(type, identifier, std::move(assigned_expr));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -418,58 +434,58 @@ namespace parser {
      * @par Validate that the identifier has been declared.
      * 
      * @code
-     *  std::string identifier;
-        std::optional<lexer::lexer_stored_values> value = current_value;
+     *  interner::symbol_id identifier = interner::no_symbol;
+        const lexer::token& tok = *ctx.parser.current_token_record;
         
-        if (value.has_value()) {
-            if (std::holds_alternative<std::string>(value.value())) {
-                identifier = std::get<std::string>(value.value());
+        if (tok.payload != lexer::no_payload) {
+            if (lexer::has_text(tok)) {
+                identifier = lexer::token_symbol(*ctx.parser.source, tok);
             } 
             else {
-                utility::parser_error("Expected identifier", current_line);
+                utility::parser_error("Expected identifier", current_location);
             }
         }
 
-        get_next_token(); 
+        get_next_token(ctx); 
      * @endcode
 
        @par Parse the new expression assigned, and validate its type.
 
        @code
-        auto assigned_expr = parse_expression();
+        auto assigned_expr = parse_expression(ctx);
 
-        auto ast_node = std::make_unique<ast::variable_assignment>(identifier, std::move(assigned_expr));
+        auto ast_node = ast::make_node<ast::variable_assignment>(identifier, std::move(assigned_expr));
 
         return std::move(ast_node);
        @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_var_assign() {
-        std::string identifier;
-        std::optional<lexer::lexer_stored_values> value = current_value;
+    ast::node_ptr<ast::top_level_expr> parse_var_assign(context::compilation_context& ctx) {
+        interner::symbol_id identifier = interner::no_symbol;
+        const lexer::token& tok = *ctx.parser.current_token_record;
         
-        if (value.has_value()) {
-            if (std::holds_alternative<std::string>(value.value())) {
-                identifier = std::get<std::string>(value.value());
+        if (tok.payload != lexer::no_payload) {
+            if (lexer::has_text(tok)) {
+                identifier = lexer::token_symbol(*ctx.parser.source, tok);
             } 
             else {
-                utility::parser_error("Expected identifier", current_line);
+                utility::parser_error("Expected identifier", current_location);
             }
         }
 
-        get_next_token(); // consumes the identifier
+        get_next_token(ctx); // consumes the identifier
 
 
-        if (current_token != lexer::tok_assignment) {
-            utility::parser_error("Expected an assignment", current_line);
+        if (ctx.parser.current_token != lexer::tok_assignment) {
+            utility::parser_error("Expected an assignment", current_location);
         }
         
 
-        get_next_token(); // consume the '='
+        get_next_token(ctx); // consume the '='
 
 
-        auto assigned_expr = parse_expression();
+        auto assigned_expr = parse_expression(ctx);
 
-        auto ast_node = std::make_unique<ast::variable_assignment>(identifier, std::move(assigned_expr));
+        auto ast_node = ast::make_node<ast::variable_assignment>(identifier, std::move(assigned_expr));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -480,85 +496,85 @@ namespace parser {
 
     /**
      * @par Parse function calls.
-     * @param value The value corresponding to the identifier.
+     * @param tok The identifier token naming the function.
      * 
      * @par Grab the name, and consume the opening '('.
      * @code
-     *  std::string func_name = std::get<std::string>(value);
+     *  interner::symbol_id func_name = lexer::token_symbol(*ctx.parser.source, tok);
 
-        get_next_token(); 
+        get_next_token(ctx); 
 
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Expected '(' before function arguments", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_paren) {
+            utility::parser_error("Expected '(' before function arguments", current_location);
         }
 
-        get_next_token(); 
+        get_next_token(ctx); 
      * @endcode
 
        @par Iterate over arguments until a ')' is reached, and parse them each as an expression.
        @code
-        std::vector<std::unique_ptr<ast::top_level_expr>> arguments;
+        ast::node_list arguments;
 
-        while(current_token != lexer::tok_close_paren) {
+        while(ctx.parser.current_token != lexer::tok_close_paren) {
 
-            auto current_expression = parse_expression();
+            auto current_expression = parse_expression(ctx);
             arguments.emplace_back(std::move(current_expression));
 
-            if (current_token != lexer::tok_comma && current_token != lexer::tok_close_paren) {
-                utility::parser_error("Expected ',' delimiter between arguments, or a closing ')'", current_line);
+            if (ctx.parser.current_token != lexer::tok_comma && ctx.parser.current_token != lexer::tok_close_paren) {
+                utility::parser_error("Expected ',' delimiter between arguments, or a closing ')'", current_location);
             }
 
-            if (current_token == lexer::tok_comma) {
-                get_next_token();
+            if (ctx.parser.current_token == lexer::tok_comma) {
+                get_next_token(ctx);
             }
         }
        @endcode
 
        @par Consume the closing ')', create the ASt node, and return it.
        @code
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')' after function arguments", current_line);
+        if (ctx.parser.current_token != lexer::tok_close_paren) {
+            utility::parser_error("Expected ')' after function arguments", current_location);
         }
-        get_next_token(); // consume the ')'
+        get_next_token(ctx); // consume the ')'
 
-        auto ast_node = std::make_unique<ast::func_call_expr>(func_name, std::move(arguments));
+        auto ast_node = ast::make_node<ast::func_call_expr>(func_name, std::move(arguments));
 
         return std::move(ast_node);
        @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_func_call(lexer::lexer_stored_values value) {
-        std::string func_name = std::get<std::string>(value);
+    ast::node_ptr<ast::top_level_expr> parse_func_call(context::compilation_context& ctx, const lexer::token& tok) {
+        interner::symbol_id func_name = lexer::token_symbol(*ctx.parser.source, tok);
 
-        get_next_token(); // consume the function call name
+        get_next_token(ctx); // consume the function call name
 
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Expected '(' before function arguments", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_paren) {
+            utility::parser_error("Expected '(' before function arguments", current_location);
         }
 
-        get_next_token(); // consume the '('
+        get_next_token(ctx); // consume the '('
 
-        std::vector<std::unique_ptr<ast::top_level_expr>> arguments;
+        ast::node_list arguments;
 
-        while(current_token != lexer::tok_close_paren) {
+        while(ctx.parser.current_token != lexer::tok_close_paren) {
 
-            auto current_expression = parse_expression();
+            auto current_expression = parse_expression(ctx);
             arguments.emplace_back(std::move(current_expression));
 
-            if (current_token != lexer::tok_comma && current_token != lexer::tok_close_paren) {
-                utility::parser_error("Expected ',' delimiter between arguments, or a closing ')'", current_line);
+            if (ctx.parser.current_token != lexer::tok_comma && ctx.parser.current_token != lexer::tok_close_paren) {
+                utility::parser_error("Expected ',' delimiter between arguments, or a closing ')'", current_location);
             }
 
-            if (current_token == lexer::tok_comma) {
-                get_next_token();
+            if (ctx.parser.current_token == lexer::tok_comma) {
+                get_next_token(ctx);
             }
         }
 
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')' after function arguments", current_line);
+        if (ctx.parser.current_token != lexer::tok_close_paren) {
+            utility::parser_error("Expected ')' after function arguments", current_location);
         }
-        get_next_token(); // consume the ')'
+        get_next_token(ctx); // consume the ')'
 
-        auto ast_node = std::make_unique<ast::func_call_expr>(func_name, std::move(arguments));
+        auto ast_node = ast::make_node<ast::func_call_expr>(func_name, std::move(arguments));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -572,111 +588,111 @@ namespace parser {
      * @par This parses primary identifiers, and validates that they have been pre-defined
      * 
      * @param top_level Indicates whether this expresion is part of a binary subexpression.
-     * @param value Stores the actual associated identifier name.
+     * @param tok The token whose payload stores the associated identifier name.
      * 
      * @code
-        std::string identifier = std::get<std::string>(value);
+        interner::symbol_id identifier = lexer::token_symbol(*ctx.parser.source, tok);
 
-        auto ast_node = std::make_unique<ast::identifier_expr>(identifier);
+        auto ast_node = ast::make_node<ast::identifier_expr>(identifier);
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
         #endif
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
      * @endcode.
      */
-    std::unique_ptr<ast::top_level_expr> parse_identifier_expr(lexer::lexer_stored_values value) {
+    ast::node_ptr<ast::top_level_expr> parse_identifier_expr(context::compilation_context& ctx, const lexer::token& tok) {
 
-        std::string identifier = std::get<std::string>(value);
+        interner::symbol_id identifier = lexer::token_symbol(*ctx.parser.source, tok);
 
-        auto ast_node = std::make_unique<ast::identifier_expr>(identifier);
+        auto ast_node = ast::make_node<ast::identifier_expr>(identifier);
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
         #endif
         
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
     }
 
     /**
      * @par This parses integer literals.
-     * @param value Stores the actual associated integer value.
+     * @param tok The token whose payload stores the associated integer value.
      * 
      * @code
-     * auto ast_node = std::make_unique<ast::integer_expression>(lexer::integer_value);
+     * auto ast_node = ast::make_node<ast::integer_expression>(lexer::integer_value);
      *  if (top_level) {
-            get_next_token();
+            get_next_token(ctx);
         }
 
-         get_next_token();
+         get_next_token(ctx);
 
         return std::move(ast_node);
         @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_int_expr(lexer::lexer_stored_values value) {
-        auto ast_node = std::make_unique<ast::integer_expression>(std::get<int>(value));
+    ast::node_ptr<ast::top_level_expr> parse_int_expr(context::compilation_context& ctx, const lexer::token& tok) {
+        auto ast_node = ast::make_node<ast::integer_expression>(lexer::token_int(*ctx.parser.source, tok));
         
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
         #endif
 
-        get_next_token();
+        get_next_token(ctx);
         return std::move(ast_node);
     }
 
     /**
      * @par This parses float literals.
-     * @param value Stores the actual associated float value.
+     * @param tok The token whose payload stores the associated float value.
      * 
      * @code
-        auto ast_node = std::make_unique<ast::float_expression>(lexer::float_value);
+        auto ast_node = ast::make_node<ast::float_expression>(lexer::float_value);
 
         if (top_level) {
-            get_next_token();
+            get_next_token(ctx);
         }
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
         @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_float_expr(lexer::lexer_stored_values value) {
-        auto ast_node = std::make_unique<ast::float_expression>(std::get<float>(value));
+    ast::node_ptr<ast::top_level_expr> parse_float_expr(context::compilation_context& ctx, const lexer::token& tok) {
+        auto ast_node = ast::make_node<ast::float_expression>(lexer::token_float(*ctx.parser.source, tok));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
         #endif
 
-        get_next_token();
+        get_next_token(ctx);
         return std::move(ast_node);
     }
 
     /**
      * @par This parses char literals.
-     * @param value Stores the actual associated character value.
+     * @param tok The token whose payload stores the associated character value.
      * 
      * @code
-        std::unique_ptr<ast::top_level_expr> parse_char_expr(bool top_level) {
-            auto ast_node = std::make_unique<ast::char_expression>(lexer::char_value);
+        ast::node_ptr<ast::top_level_expr> parse_char_expr(context::compilation_context& ctx, bool top_level) {
+            auto ast_node = ast::make_node<ast::char_expression>(lexer::char_value);
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
         @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_char_expr(lexer::lexer_stored_values value) {
-        auto ast_node = std::make_unique<ast::char_expression>(std::get<char>(value));
+    ast::node_ptr<ast::top_level_expr> parse_char_expr(context::compilation_context& ctx, const lexer::token& tok) {
+        auto ast_node = ast::make_node<ast::char_expression>(lexer::token_char(tok));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
         #endif
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
     }
@@ -684,56 +700,56 @@ namespace parser {
 
     /**
      * @par This parses string literals.
-     * @param value Stores the actual associated string value.
+     * @param tok The token whose payload stores the associated string value.
      * 
      * @code
-        auto ast_node = std::make_unique<ast::string_expression>(lexer::string_value);
+        auto ast_node = ast::make_node<ast::string_expression>(lexer::string_value);
 
         if (top_level) {
-            get_next_token();
+            get_next_token(ctx);
         }
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
         @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_string_expr(lexer::lexer_stored_values value) {
-        auto ast_node = std::make_unique<ast::string_expression>(std::get<std::string>(value));
+    ast::node_ptr<ast::top_level_expr> parse_string_expr(context::compilation_context& ctx, const lexer::token& tok) {
+        auto ast_node = ast::make_node<ast::string_expression>(lexer::token_text(*ctx.parser.source, tok));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
         #endif
 
-        get_next_token();
+        get_next_token(ctx);
         
         return std::move(ast_node);
     }
 
     /**
      * @par This parses boolean literals.
-     * @param value Stores the actual associated boolean value.
+     * @param tok The token whose payload stores the associated boolean value.
      * 
      * @code
-        auto ast_node = std::make_unique<ast::bool_expression>(lexer::bool_value);
+        auto ast_node = ast::make_node<ast::bool_expression>(lexer::bool_value);
 
         if (top_level) {
-            get_next_token();
+            get_next_token(ctx);
         }
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
         @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_bool_expr(lexer::lexer_stored_values value) {
-        auto ast_node = std::make_unique<ast::bool_expression>(std::get<bool>(value));
+    ast::node_ptr<ast::top_level_expr> parse_bool_expr(context::compilation_context& ctx, const lexer::token& tok) {
+        auto ast_node = ast::make_node<ast::bool_expression>(lexer::token_bool(tok));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1) 
             ast_node->debug_output();
         #endif
 
-        get_next_token();
+        get_next_token(ctx);
 
         return std::move(ast_node);
     }
@@ -752,64 +768,68 @@ namespace parser {
      * 
      * @par Consume 'def', the return type, and the name (also storing them in the process)
      * @code
-     *   get_next_token();
+     *   lexer::source_location function_location = ctx.parser.current_token_record->location;
+        get_next_token(ctx);
 
-        type_enum::types ret_type = parse_type();
-        get_next_token(); 
+        type_enum::types ret_type = parse_type(ctx);
+        get_next_token(ctx); 
 
-        std::string func_name = std::get<std::string>(lexer::stored_values.at(current_token_index - 1).value()); // grab the function name
+        interner::symbol_id func_name = lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record); // grab the function name
         
-        get_next_token(); 
+        get_next_token(ctx); 
      * @endcode
 
        @par Consume the opening parenthesis, then consume and store as many variable declarations as there are, and then consume the ')', and '{'.
        @code
-        get_next_token();
+        get_next_token(ctx);
 
-        std::vector<std::unique_ptr<ast::top_level_expr>> parameters;
+        ast::node_list parameters;
 
         while (true) {
-            if (current_token == lexer::tok_close_paren) {
-                get_next_token(); 
+            if (ctx.parser.current_token == lexer::tok_close_paren) {
+                get_next_token(ctx); 
                 break;
             }
 
-            auto current_decl = parse_var_decl_defn();
+            lexer::source_location parameter_location = ctx.parser.current_token_record->location;
+            auto current_decl = parse_var_decl_defn(ctx);
+            current_decl->set_location(parameter_location);
             parameters.emplace_back(std::move(current_decl));
 
             
-            if (current_token == lexer::tok_comma) {
-                get_next_token();
-            } else if (current_token == lexer::tok_close_paren) {
-                get_next_token();
+            if (ctx.parser.current_token == lexer::tok_comma) {
+                get_next_token(ctx);
+            } else if (ctx.parser.current_token == lexer::tok_close_paren) {
+                get_next_token(ctx);
                 break;
             } else {
-                utility::parser_error("Expected ',' or ')'", current_line);
+                utility::parser_error("Expected ',' or ')'", current_location);
             }
             
         }
 
-        if (current_token != lexer::tok_open_brack) {
-            utility::parser_error("Expected opening bracket", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_brack) {
+            utility::parser_error("Expected opening bracket", current_location);
         }
 
-        get_next_token();
+        get_next_token(ctx);
        @endcode
 
        @par Parse expressions and store them in a vector until we reach a closing bracket.
        @code
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
+        ast::node_list expressions = parse_block(ctx);
 
-        get_next_token(); 
+        get_next_token(ctx); 
        @endcode
 
        @par Construct the function definition node, and return it.
        @code
-        auto func_definition = std::make_unique<ast::func_defn>(ret_type, func_name, std::move(expressions), std::move(parameters));
+        auto func_definition = ast::make_node<ast::func_defn>(ret_type, func_name, std::move(expressions), std::move(parameters));
+        func_definition->set_location(function_location);
         return func_definition;
        @endcode
      */
-    std::unique_ptr<ast::func_defn> parse_function() {
+    ast::node_ptr<ast::func_defn> parse_function(context::compilation_context& ctx) {
         // need to eat "def"
         // need to get type, store it, and then eat it
         // grab the name, store it, and then eat it
@@ -824,56 +844,60 @@ namespace parser {
         
         // hold a boolean flag that indicates whether a return statement exists for functions...
 
-        get_next_token(); // eat def
+        lexer::source_location function_location = ctx.parser.current_token_record->location;
+        get_next_token(ctx); // eat def
 
-        type_enum::types ret_type = parse_type();
+        type_enum::types ret_type = parse_type(ctx);
 
-        get_next_token(); // consume the type
+        get_next_token(ctx); // consume the type
 
-        std::string func_name = std::get<std::string>(current_value.value()); // grab the function name
+        interner::symbol_id func_name = lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record); // grab the function name
 
-        get_next_token(); // consume the name
+        get_next_token(ctx); // consume the name
 
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Expected '('", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_paren) {
+            utility::parser_error("Expected '('", current_location);
         }
 
-        get_next_token();
+        get_next_token(ctx);
 
-        std::vector<std::unique_ptr<ast::top_level_expr>> parameters;
+        ast::node_list parameters;
 
         while (true) {
-            if (current_token == lexer::tok_close_paren) {
-                get_next_token(); 
+            if (ctx.parser.current_token == lexer::tok_close_paren) {
+                get_next_token(ctx); 
                 break;
             }
 
-            auto current_decl = parse_var_decl_defn();
+            lexer::source_location parameter_location = ctx.parser.current_token_record->location;
+            auto current_decl = parse_var_decl_defn(ctx);
+            current_decl->set_location(parameter_location);
             parameters.emplace_back(std::move(current_decl));
 
             
-            if (current_token == lexer::tok_comma) {
-                get_next_token();
-            } else if (current_token == lexer::tok_close_paren) {
-                get_next_token();
+            if (ctx.parser.current_token == lexer::tok_comma) {
+                get_next_token(ctx);
+            } else if (ctx.parser.current_token == lexer::tok_close_paren) {
+                get_next_token(ctx);
                 break;
             } else {
-                utility::parser_error("Expected ',' or ')'", current_line);
+                utility::parser_error("Expected ',' or ')'", current_location);
             }
             
         }
 
-        if (current_token != lexer::tok_open_brack) {
-            utility::parser_error("Expected opening bracket", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_brack) {
+            utility::parser_error("Expected opening bracket", current_location);
         }
-        get_next_token(); // consume the bracket
+        get_next_token(ctx); // consume the bracket
 
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
+        ast::node_list expressions = parse_block(ctx);
 
-        get_next_token(); // consume the '}'
+        get_next_token(ctx); // consume the '}'
 
         // instantiate the ast node and return it
-        auto func_definition = std::make_unique<ast::func_defn>(ret_type, func_name, std::move(expressions), std::move(parameters));
+        auto func_definition = ast::make_node<ast::func_defn>(ret_type, func_name, std::move(expressions), std::move(parameters));
+        func_definition->set_location(function_location);
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             func_definition->debug_output();
@@ -888,28 +912,28 @@ namespace parser {
      * "return (expr);"
      * 
      * @code
-     *  get_next_token();
-     *  if (current_token == lexer::tok_semicolon) {
-            return(std::move(std::make_unique<ast::return_expr>(nullptr)));
+     *  get_next_token(ctx);
+     *  if (ctx.parser.current_token == lexer::tok_semicolon) {
+            return(std::move(ast::make_node<ast::return_expr>(nullptr)));
         }
-        auto expr_node = parse_expression();
+        auto expr_node = parse_expression(ctx);
 
         if (auto* binary_expr_node = dynamic_cast<ast::binary_expr*>(expr_node.get())) {
-            get_next_token();
+            get_next_token(ctx);
         }
 
-        auto ast_node = std::make_unique<ast::return_expr>(std::move(expr_node));
+        auto ast_node = ast::make_node<ast::return_expr>(std::move(expr_node));
         return std::move(ast_node);
      * @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_return() {
-        get_next_token();
-        if (current_token == lexer::tok_semicolon) { // deal with void return types
-            return(std::move(std::make_unique<ast::return_expr>(nullptr)));
+    ast::node_ptr<ast::top_level_expr> parse_return(context::compilation_context& ctx) {
+        get_next_token(ctx);
+        if (ctx.parser.current_token == lexer::tok_semicolon) { // deal with void return types
+            return(std::move(ast::make_node<ast::return_expr>(nullptr)));
         }
-        auto expr_node = parse_expression();
+        auto expr_node = parse_expression(ctx);
 
-        auto ast_node = std::make_unique<ast::return_expr>(std::move(expr_node));
+        auto ast_node = ast::make_node<ast::return_expr>(std::move(expr_node));
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -926,103 +950,19 @@ namespace parser {
      *      expr2;
      *      ...
      *      exprn;
+     * } (OPTIONAL) else if (condition) {
+     *      ...
      * } (OPTIONAL) else {
      *      ...
      * }
      * 
-     * @par Consumes header components of if block and storces the condition "if (cond) {"
+     * @par The whole statement, including every block nested in it and every else if after it, is parsed by `parse_block_statement()` on an explicit stack rather than by recursing, so generated code with very deep nesting or very long else if chains cannot overflow the call stack.
      * @code
-     *  get_next_token();
-
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Exprected '('", current_line);
-        }
-
-        get_next_token();
-
-        auto condition = parse_expression(); 
-
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')'", current_line);
-        }
-
-        get_next_token();
-
-        if (current_token != lexer::tok_open_brack) {
-            utility::parser_error("Exprected '{'", current_line);
-        }
-
-        get_next_token(); 
+        return parse_block_statement(ctx);
      * @endcode
-
-       @par Parse through all expressions contained within the if block, and store them.
-       @code
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
-
-        if (current_token != lexer::tok_close_brack) {
-            utility::parser_error("Expected closing bracket for if expression", current_line);
-        }
-
-        get_next_token(); 
-       @endcode
-
-       @par Check if an else statement comes after the if block, and if so parse it. Otherwise just store it as a nullptr. Then return the if node.
-       @code
-        std::unique_ptr<ast::top_level_expr> else_stmt = nullptr;
-
-        if (current_token == lexer::tok_else) {
-            else_stmt = parse_else(); 
-        }
-
-        auto if_node = std::make_unique<ast::if_expr>(std::move(condition), std::move(expressions), std::move(else_stmt));
-        return std::move(if_node);
-       @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_if() {
-        get_next_token(); // consume the if
-
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Exprected '('", current_line);
-        }
-
-        get_next_token(); // consume the (
-
-        auto condition = parse_expression(); 
-
-        
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')'", current_line);
-        }
-
-        get_next_token(); // consume the )
-
-        if (current_token != lexer::tok_open_brack) {
-            utility::parser_error("Expected '{'", current_line);
-        }
-
-        get_next_token(); // consume the {
-
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
-
-        if (current_token != lexer::tok_close_brack) {
-            utility::parser_error("Expected closing bracket for if expression", current_line);
-        }
-
-        get_next_token(); // consume the '}'
-
-        std::unique_ptr<ast::top_level_expr> else_stmt = nullptr;
-
-        if (current_token == lexer::tok_else) {
-            else_stmt = parse_else(); 
-        }
-
-        auto if_node = std::make_unique<ast::if_expr>(std::move(condition), std::move(expressions), std::move(else_stmt));
-
-        #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
-            if_node->debug_output();
-        #endif
-
-        return std::move(if_node);
+    ast::node_ptr<ast::top_level_expr> parse_if(context::compilation_context& ctx) {
+        return parse_block_statement(ctx);
     }
     
     /**
@@ -1030,10 +970,10 @@ namespace parser {
      * 
      * @par Handle else if statements.
      * @code
-     *  if (current_token == lexer::tok_if) {
-            std::vector<std::unique_ptr<ast::top_level_expr>> if_expression;
-            if_expression.emplace_back(parse_if());
-            return std::make_unique<ast::else_expr>(std::move(if_expression), true);
+     *  if (ctx.parser.current_token == lexer::tok_if) {
+            ast::node_list if_expression;
+            if_expression.emplace_back(parse_if(ctx));
+            return ast::make_node<ast::else_expr>(std::move(if_expression), true);
         }
      * @endcode
 
@@ -1041,40 +981,40 @@ namespace parser {
 
        @par Parse expressions until we encounter a closing bracket.
        @code
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
+        ast::node_list expressions = parse_block(ctx);
        @endcode
 
        @par Generate an else expression AST node.
        @code
-        return std::make_unique<ast::else_expr>(std::move(expressions), false);
+        return ast::make_node<ast::else_expr>(std::move(expressions), false);
        @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_else() {
-        if (current_token != lexer::tok_else) {
-            utility::parser_error("Exprected else keyword in else expression", current_line);
+    ast::node_ptr<ast::top_level_expr> parse_else(context::compilation_context& ctx) {
+        if (ctx.parser.current_token != lexer::tok_else) {
+            utility::parser_error("Exprected else keyword in else expression", current_location);
         }
-        get_next_token(); // consume the else
+        get_next_token(ctx); // consume the else
 
-        if (current_token == lexer::tok_if) {
-            std::vector<std::unique_ptr<ast::top_level_expr>> if_expression;
-            if_expression.emplace_back(parse_if());
-            return std::make_unique<ast::else_expr>(std::move(if_expression), true);
+        if (ctx.parser.current_token == lexer::tok_if) {
+            ast::node_list if_expression;
+            if_expression.emplace_back(parse_if(ctx));
+            return ast::make_node<ast::else_expr>(std::move(if_expression), true);
         }
 
-        if (current_token != lexer::tok_open_brack) {
-            utility::parser_error("Expected opening bracket for else expression", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_brack) {
+            utility::parser_error("Expected opening bracket for else expression", current_location);
         }
 
-        get_next_token(); // consume the '{'
+        get_next_token(ctx); // consume the '{'
 
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
+        ast::node_list expressions = parse_block(ctx);
 
-        if (current_token != lexer::tok_close_brack) {
-            utility::parser_error("Expected closing bracket", current_line);
+        if (ctx.parser.current_token != lexer::tok_close_brack) {
+            utility::parser_error("Expected closing bracket", current_location);
         }
-        get_next_token(); // consume the closing bracket
+        get_next_token(ctx); // consume the closing bracket
 
-        auto ast_node = std::make_unique<ast::else_expr>(std::move(expressions), false);
+        auto ast_node = ast::make_node<ast::else_expr>(std::move(expressions), false);
        
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -1084,117 +1024,64 @@ namespace parser {
     }
 
     /**
-     * TODO: docs
+     * @par Parses a for loop, "for (defn; condition; modification) { ... }". Like `parse_if()`, the loop and everything nested in its body is parsed by `parse_block_statement()`.
+     * @code
+        return parse_block_statement(ctx);
+     * @endcode
      */
-    std::unique_ptr<ast::top_level_expr> parse_for() {
-        if (current_token != lexer::tok_for) {
-            utility::parser_error("Expected for keyword", current_line);
-        }
-
-        get_next_token(); // consume the for keyword
-
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Expected '(' at beginning of for loop declaration", current_line);
-        }
-
-        get_next_token(); // consume the '('
-
-        std::unique_ptr<ast::top_level_expr> defn = parse_var_decl_defn();
-
-        if (current_token != lexer::tok_semicolon) {
-            utility::parser_error("Expected ';' after definition in for loop", current_line);
-        }
-
-        get_next_token(); // consume the ';'
-
-        std::unique_ptr<ast::top_level_expr> condition = parse_expression();
-
-        if (current_token != lexer::tok_semicolon) {
-            utility::parser_error("Expected ';' after condition in for loop", current_line);
-        }
-
-        get_next_token(); // consume the ';'
-
-        std::unique_ptr<ast::top_level_expr> modification = parse_expression();
-
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')' at end of for loop declaration", current_line);
-        }
-
-        get_next_token(); // consume the ')'
-
-        if (current_token != lexer::tok_open_brack) {
-            utility::parser_error("Expected '{' at beginning of for loop block", current_line);
-        }
-
-        get_next_token(); // consume the '{'
-
-        std::vector<std::unique_ptr<ast::top_level_expr>> expressions = parse_block();
-
-        if (current_token != lexer::tok_close_brack) {
-            utility::parser_error("Expected '}' at end of for loop block", current_line);
-        }
-
-        get_next_token(); // consume the '}'
-
-        auto ast_node = std::make_unique<ast::for_expr>(std::move(expressions), std::move(defn), std::move(condition), std::move(modification));
-       
-        #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
-            ast_node->debug_output();
-        #endif
-
-        return std::move(ast_node);
+    ast::node_ptr<ast::top_level_expr> parse_for(context::compilation_context& ctx) {
+        return parse_block_statement(ctx);
     }
 
     /**
      * TODO: docs
      */
-    std::unique_ptr<ast::top_level_expr> parse_while() {
+    ast::node_ptr<ast::top_level_expr> parse_while(context::compilation_context&) {
         return nullptr;
     }
 
     /**
      * @par Handle print expressions by parsing an internal expression to the print statement.
      * @code
-        if (current_token != lexer::tok_print) {
-            utility::parser_error("Expected print keyword", current_line);
+        if (ctx.parser.current_token != lexer::tok_print) {
+            utility::parser_error("Expected print keyword", current_location);
         }
-        get_next_token(); 
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Expected '('", current_line);
+        get_next_token(ctx); 
+        if (ctx.parser.current_token != lexer::tok_open_paren) {
+            utility::parser_error("Expected '('", current_location);
         }
-        get_next_token(); 
-        auto expression = parse_expression();
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')'", current_line);
+        get_next_token(ctx); 
+        auto expression = parse_expression(ctx);
+        if (ctx.parser.current_token != lexer::tok_close_paren) {
+            utility::parser_error("Expected ')'", current_location);
         }
-        get_next_token(); 
-        return std::make_unique<ast::print_expr>(std::move(expression));
+        get_next_token(ctx); 
+        return ast::make_node<ast::print_expr>(std::move(expression));
      * @endcode
      * 
      */
-    std::unique_ptr<ast::top_level_expr> parse_print() {
-        if (current_token != lexer::tok_print) {
-            utility::parser_error("Expected print keyword", current_line);
+    ast::node_ptr<ast::top_level_expr> parse_print(context::compilation_context& ctx) {
+        if (ctx.parser.current_token != lexer::tok_print) {
+            utility::parser_error("Expected print keyword", current_location);
         }
 
-        get_next_token(); // consume the print keyword
+        get_next_token(ctx); // consume the print keyword
 
-        if (current_token != lexer::tok_open_paren) {
-            utility::parser_error("Expected '('", current_line);
+        if (ctx.parser.current_token != lexer::tok_open_paren) {
+            utility::parser_error("Expected '('", current_location);
         }
 
-        get_next_token(); // consume the '('
+        get_next_token(ctx); // consume the '('
 
-        auto expression = parse_expression();
+        auto expression = parse_expression(ctx);
 
-        if (current_token != lexer::tok_close_paren) {
-            utility::parser_error("Expected ')'", current_line);
+        if (ctx.parser.current_token != lexer::tok_close_paren) {
+            utility::parser_error("Expected ')'", current_location);
         }
 
-        get_next_token(); // consume the closing ')'
+        get_next_token(ctx); // consume the closing ')'
 
-        return std::make_unique<ast::print_expr>(std::move(expression));
+        return ast::make_node<ast::print_expr>(std::move(expression));
     }
     
     /**
@@ -1207,40 +1094,40 @@ namespace parser {
 
      @par Grab the name.
      @code
-        std::string graph_name = std::get<std::string>(current_value.value());
+        interner::symbol_id graph_name = lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record);
      @endcode
 
      @par Create the AST Node and return it.
      @code
-        auto ast_node = std::make_unique<ast::graph_decl_expr>(type, graph_name);
+        auto ast_node = ast::make_node<ast::graph_decl_expr>(type, graph_name);
         return ast_node;
      @endcode
 
      */
-    std::unique_ptr<ast::top_level_expr> parse_graph_decl() {
-        if (utility::library_and_include.find("graph") == utility::library_and_include.end()) {
-            utility::parser_error("Attempting to use graph without include directive (graph)", current_line);
+    ast::node_ptr<ast::top_level_expr> parse_graph_decl(context::compilation_context& ctx) {
+        if (ctx.library_and_include.find("graph") == ctx.library_and_include.end()) {
+            utility::parser_error("Attempting to use graph without include directive (graph)", current_location);
         }
         
-        if (utility::library_and_include.find("list") == utility::library_and_include.end()) {
-            utility::parser_error("Attempting to use graph without include directive (list)", current_line);
+        if (ctx.library_and_include.find("list") == ctx.library_and_include.end()) {
+            utility::parser_error("Attempting to use graph without include directive (list)", current_location);
         }
 
-        if (current_token != lexer::tok_graph) {
-            utility::parser_error("Expected token graph", current_line);
+        if (ctx.parser.current_token != lexer::tok_graph) {
+            utility::parser_error("Expected token graph", current_location);
         }
 
-        get_next_token(); // consume the 'graph' keyword
+        get_next_token(ctx); // consume the 'graph' keyword
         
-        type_enum::types type = parse_type();
+        type_enum::types type = parse_type(ctx);
 
-        get_next_token(); // consume the type
+        get_next_token(ctx); // consume the type
 
-        std::string graph_name = std::get<std::string>(current_value.value()); // grab the name
+        interner::symbol_id graph_name = lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record); // grab the name
 
-        get_next_token(); // consume the name
+        get_next_token(ctx); // consume the name
 
-        auto ast_node = std::make_unique<ast::graph_decl_expr>(type, graph_name);
+        auto ast_node = ast::make_node<ast::graph_decl_expr>(type, graph_name);
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -1252,26 +1139,26 @@ namespace parser {
     /**
      * TODO: docs
      */
-    std::unique_ptr<ast::top_level_expr> parse_list_decl() {
-        if (utility::library_and_include.find("list") == utility::library_and_include.end()) {
-            utility::parser_error("Attempting to use list without include directive", current_line);
+    ast::node_ptr<ast::top_level_expr> parse_list_decl(context::compilation_context& ctx) {
+        if (ctx.library_and_include.find("list") == ctx.library_and_include.end()) {
+            utility::parser_error("Attempting to use list without include directive", current_location);
         }
 
-        if (current_token != lexer::tok_list) {
-            utility::parser_error("Expected list keyword", current_line);
+        if (ctx.parser.current_token != lexer::tok_list) {
+            utility::parser_error("Expected list keyword", current_location);
         }
 
-        get_next_token(); // consume the list keyword
+        get_next_token(ctx); // consume the list keyword
 
-        type_enum::types type = parse_type();
+        type_enum::types type = parse_type(ctx);
 
-        get_next_token(); // consume the type
+        get_next_token(ctx); // consume the type
 
-        std::string list_name = std::get<std::string>(current_value.value());
+        interner::symbol_id list_name = lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record);
 
-        get_next_token(); // consume the name
+        get_next_token(ctx); // consume the name
 
-        auto ast_node = std::make_unique<ast::list_decl>(type, list_name);
+        auto ast_node = ast::make_node<ast::list_decl>(type, list_name);
 
         #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
             ast_node->debug_output();
@@ -1280,78 +1167,86 @@ namespace parser {
         return ast_node;
     }
 
-    std::unique_ptr<ast::top_level_expr> parse_method_dot_call() {
+    ast::node_ptr<ast::top_level_expr> parse_method_dot_call(context::compilation_context& ctx) {
 
-        std::string item_name = std::get<std::string>(current_value.value());
-        get_next_token(); 
+        interner::symbol_id item_name = lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record);
+        get_next_token(ctx); 
 
-        if (current_token != lexer::tok_dot) {
-            utility::parser_error("Expected a dot call", current_line);
+        if (ctx.parser.current_token != lexer::tok_dot) {
+            utility::parser_error("Expected a dot call", current_location);
         }
 
-        get_next_token(); // consume the dot
+        get_next_token(ctx); // consume the dot
 
 
-        std::string called = dot_call_method_helper();
+        interner::symbol_id called = dot_call_method_helper(ctx);
 
-        get_next_token();
+        get_next_token(ctx);
 
-        if (current_token == lexer::tok_semicolon) {
-            auto ast_node = std::make_unique<ast::dot_call_var>(item_name, called);   
+        if (ctx.parser.current_token == lexer::tok_semicolon) {
+            auto ast_node = ast::make_node<ast::dot_call_var>(item_name, called);   
             
             #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
                 ast_node->debug_output();
             #endif
 
             return ast_node;
-        } else if (current_token == lexer::tok_open_paren) {
-            get_next_token(); // consume the opening parenthesis
+        } else if (ctx.parser.current_token == lexer::tok_open_paren) {
+            get_next_token(ctx); // consume the opening parenthesis
 
-            std::vector<std::unique_ptr<ast::top_level_expr>> arguments;      
+            ast::node_list arguments;      
 
-            while (current_token != lexer::tok_close_paren) {
-                auto current_expr = parse_expression();
+            while (ctx.parser.current_token != lexer::tok_close_paren) {
+                auto current_expr = parse_expression(ctx);
                 arguments.emplace_back(std::move(current_expr));
 
-                if (current_token == lexer::tok_comma) {
-                    get_next_token();
-                } else if (current_token == lexer::tok_close_paren) {
+                if (ctx.parser.current_token == lexer::tok_comma) {
+                    get_next_token(ctx);
+                } else if (ctx.parser.current_token == lexer::tok_close_paren) {
                     break;
                 } else {
-                    utility::parser_error("Expected ',' or ')'", current_line);
+                    utility::parser_error("Expected ',' or ')'", current_location);
                 }
             }
 
-            get_next_token(); // consume the closing parenthesis
-            auto ast_node = std::make_unique<ast::method_dot_call>(item_name, called, std::move(arguments));  
+            get_next_token(ctx); // consume the closing parenthesis
+            auto ast_node = ast::make_node<ast::method_dot_call>(item_name, called, std::move(arguments));  
             #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
                 ast_node->debug_output();
             #endif
 
             return ast_node;
         } else {
-            utility::parser_error("Expected ; or '(' on dot call", current_line);
+            utility::parser_error("Expected ; or '(' on dot call", current_location);
         }
     }
 
     /**
-     * TODO: docs
+     * @par Parses an include directive: a standard library name (`include list`, `include graph`), or the path of a .pyrx module as a string literal (`include "shapes.pyrx"`), which is resolved against the including file's directory later on.
      */
-    std::string parse_include() {
-        if (current_token != lexer::tok_include) {
-            utility::parser_error("Expected include directive", current_line);
+    std::string parse_include(context::compilation_context& ctx) {
+        if (ctx.parser.current_token != lexer::tok_include) {
+            utility::parser_error("Expected include directive", current_location);
         }
-        get_next_token(); // consume the include directive
-        switch (current_token) {
+        get_next_token(ctx); // consume the include directive
+        switch (ctx.parser.current_token) {
             case (lexer::tok_list):
-                get_next_token();
+                get_next_token(ctx);
                 return "list";
             case (lexer::tok_graph): {
-                get_next_token();
+                get_next_token(ctx);
                 return "graph";
             }
+            case (lexer::tok_string_val): {
+                std::string module_path(lexer::token_text(*ctx.parser.source, *ctx.parser.current_token_record));
+                if (!module_interface::is_module_include(module_path)) {
+                    utility::parser_error("Included modules must be .pyrx files", current_location);
+                }
+                get_next_token(ctx);
+                return module_path;
+            }
             default:
-                utility::parser_error("Invalid item included", current_line);
+                utility::parser_error("Invalid item included", current_location);
         }
     }
 
@@ -1361,130 +1256,431 @@ namespace parser {
         /**
          * TODO: docs
          */
-        std::string dot_call_method_helper() {
-            if (current_value.has_value() && std::holds_alternative<std::string>(current_value.value())) {
-                return std::get<std::string>(current_value.value());
+        interner::symbol_id dot_call_method_helper(context::compilation_context& ctx) {
+            if (lexer::has_text(*ctx.parser.current_token_record)) {
+                return lexer::token_symbol(*ctx.parser.source, *ctx.parser.current_token_record);
             } else {
-                utility::parser_error("Expected identifiable dot call", current_line);
+                utility::parser_error("Expected identifiable dot call", current_location);
             }
         }
 
         /**
-         * @par Parses a block within a scope that exists above the global scope (different from the utility level parsing dispatcher).
+         * @struct open_block
+         * @par A block whose statements are still being parsed, along with what its construct needs once the block closes. `outer` is the block `parse_block()` was called for, which its caller closes.
+         *
+         * @var open_block::first_branch
+         * For the blocks of an if statement, where its finished branches start in `block_stack::branches`.
+         *
+         * @var open_block::condition
+         * The condition of an if branch or of a for loop.
+         *
+         * @var open_block::location
+         * Where the keyword that opened the block (`if`, `else` or `for`) is, which the node built for it is located at.
+         */
+        struct open_block {
+            enum { outer, if_body, else_body, for_body } owner;
+            ast::node_list statements;
+            std::size_t first_branch = 0;
+            ast::node_ptr<ast::top_level_expr> condition;
+            ast::node_ptr<ast::top_level_expr> variable_defn;
+            ast::node_ptr<ast::top_level_expr> var_modification;
+            lexer::source_location location = lexer::no_location;
+        };
+
+        /**
+         * @par A branch of an if statement whose block has closed, kept until the whole else if chain is parsed.
+         */
+        struct finished_branch {
+            ast::node_ptr<ast::top_level_expr> condition;
+            ast::node_list body;
+            lexer::source_location location;
+        };
+
+        /**
+         * @par The blocks being parsed on this thread, innermost last, and the finished branches of the if statements among them. Kept between calls so that parsing a block does not allocate.
+         */
+        struct block_stack {
+            std::vector<open_block> blocks;
+            std::vector<finished_branch> branches;
+        };
+
+        thread_local block_stack open_blocks;
+
+        /**
+         * @par Consumes "if (condition) {" and opens the branch's block. `first_branch` is where the branches of this if statement start (the current end of `branches` for a new if statement, or the start of the chain for an else if).
          * @code
-            std::unique_ptr<ast::top_level_expr> current_expr;
-            std::vector<std::unique_ptr<ast::top_level_expr>> expressions;
-            while (current_token != lexer::tok_close_brack) {
-                switch (current_token) {
-                    case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool: 
-                        current_expr = parse_var_decl_defn();
-                        break;
-                    case lexer::tok_return: // validate we are in a function here
-                        current_expr = parse_return();
-                        break;
-                    case lexer::tok_identifier:
-                        if (lexer::peek_token(current_token_index) == lexer::tok_assignment) {
-                            current_expr = parse_var_assign();
-                            break;
-                        } else {
-                            current_expr = parse_expression();
-                            break;
-                        }
-                    case lexer::tok_semicolon:
-                        get_next_token();
-                        current_expr = nullptr;
-                        break;
-                    case lexer::tok_if:
-                        current_expr = parse_if();
-                        break;
-                    case lexer::tok_for:
-                        current_expr = parse_for();
-                        break;
-                    case lexer::tok_while:
-                        current_expr = parse_while();
-                        break;
-                    case lexer::tok_list:
-                        current_expr = parse_list_decl();
-                        break;
-                    case lexer::tok_graph:
-                        current_expr = parse_graph_decl();
-                        break;
-                    case lexer::tok_print:
-                        current_expr = parse_print();
-                        break;
-                    default:
-                        current_expr = parse_expression();
+            lexer::source_location if_location = ctx.parser.current_token_record->location;
+            get_next_token(ctx); // consume the if
+            if (ctx.parser.current_token != lexer::tok_open_paren) {
+                utility::parser_error("Exprected '('", current_location);
+            }
+            get_next_token(ctx); // consume the (
+            auto condition = parse_expression(ctx);
+            if (ctx.parser.current_token != lexer::tok_close_paren) {
+                utility::parser_error("Expected ')'", current_location);
+            }
+            get_next_token(ctx); // consume the )
+            if (ctx.parser.current_token != lexer::tok_open_brack) {
+                utility::parser_error("Expected '{'", current_location);
+            }
+            get_next_token(ctx); // consume the {
+
+            open_blocks.blocks.push_back({open_block::if_body, {}, first_branch, std::move(condition), nullptr, nullptr, if_location});
+         * @endcode
+         */
+        void open_if(context::compilation_context& ctx, std::size_t first_branch) {
+            lexer::source_location if_location = ctx.parser.current_token_record->location;
+            get_next_token(ctx); // consume the if
+
+            if (ctx.parser.current_token != lexer::tok_open_paren) {
+                utility::parser_error("Exprected '('", current_location);
+            }
+
+            get_next_token(ctx); // consume the (
+
+            auto condition = parse_expression(ctx);
+
+            if (ctx.parser.current_token != lexer::tok_close_paren) {
+                utility::parser_error("Expected ')'", current_location);
+            }
+
+            get_next_token(ctx); // consume the )
+
+            if (ctx.parser.current_token != lexer::tok_open_brack) {
+                utility::parser_error("Expected '{'", current_location);
+            }
+
+            get_next_token(ctx); // consume the {
+
+            open_blocks.blocks.push_back({open_block::if_body, {}, first_branch, std::move(condition), nullptr, nullptr, if_location});
+        }
+
+        /**
+         * @par Consumes "for (defn; condition; modification) {" and opens the loop's block.
+         */
+        void open_for(context::compilation_context& ctx) {
+            if (ctx.parser.current_token != lexer::tok_for) {
+                utility::parser_error("Expected for keyword", current_location);
+            }
+
+            lexer::source_location for_location = ctx.parser.current_token_record->location;
+
+            get_next_token(ctx); // consume the for keyword
+
+            if (ctx.parser.current_token != lexer::tok_open_paren) {
+                utility::parser_error("Expected '(' at beginning of for loop declaration", current_location);
+            }
+
+            get_next_token(ctx); // consume the '('
+
+            lexer::source_location defn_location = ctx.parser.current_token_record->location;
+            ast::node_ptr<ast::top_level_expr> defn = parse_var_decl_defn(ctx);
+            defn->set_location(defn_location);
+
+            if (ctx.parser.current_token != lexer::tok_semicolon) {
+                utility::parser_error("Expected ';' after definition in for loop", current_location);
+            }
+
+            get_next_token(ctx); // consume the ';'
+
+            ast::node_ptr<ast::top_level_expr> condition = parse_expression(ctx);
+
+            if (ctx.parser.current_token != lexer::tok_semicolon) {
+                utility::parser_error("Expected ';' after condition in for loop", current_location);
+            }
+
+            get_next_token(ctx); // consume the ';'
+
+            ast::node_ptr<ast::top_level_expr> modification = parse_expression(ctx);
+
+            if (ctx.parser.current_token != lexer::tok_close_paren) {
+                utility::parser_error("Expected ')' at end of for loop declaration", current_location);
+            }
+
+            get_next_token(ctx); // consume the ')'
+
+            if (ctx.parser.current_token != lexer::tok_open_brack) {
+                utility::parser_error("Expected '{' at beginning of for loop block", current_location);
+            }
+
+            get_next_token(ctx); // consume the '{'
+
+            open_blocks.blocks.push_back({open_block::for_body, {}, 0, std::move(condition), std::move(defn), std::move(modification), for_location});
+        }
+
+        /**
+         * @par Builds an if statement out of its finished branches, from the last one back: every branch but the first becomes the if of an else if (`else_expr` holding just that if), and `tail` is the final else (or nullptr).
+         * @code
+            ast::node_ptr<ast::top_level_expr> if_node = nullptr;
+            for (std::size_t branch = open_blocks.branches.size(); branch-- > first_branch;) {
+                if (if_node != nullptr) {
+                    lexer::source_location else_if_location = if_node->get_location();
+                    ast::node_list else_if;
+                    else_if.emplace_back(std::move(if_node));
+                    tail = ast::make_node<ast::else_expr>(std::move(else_if), true);
+                    tail->set_location(else_if_location);
                 }
+                finished_branch& finished = open_blocks.branches[branch];
+                if_node = ast::make_node<ast::if_expr>(std::move(finished.condition), std::move(finished.body), std::move(tail));
+                if_node->set_location(finished.location);
+            }
+            open_blocks.branches.erase(open_blocks.branches.begin() + first_branch, open_blocks.branches.end());
+            return if_node;
+         * @endcode
+         */
+        ast::node_ptr<ast::top_level_expr> finish_if(std::size_t first_branch, ast::node_ptr<ast::top_level_expr> tail) {
+            ast::node_ptr<ast::top_level_expr> if_node = nullptr;
+            for (std::size_t branch = open_blocks.branches.size(); branch-- > first_branch;) {
+                if (if_node != nullptr) {
+                    lexer::source_location else_if_location = if_node->get_location();
+                    ast::node_list else_if;
+                    else_if.emplace_back(std::move(if_node));
+                    tail = ast::make_node<ast::else_expr>(std::move(else_if), true);
+                    tail->set_location(else_if_location);
+                }
+
+                finished_branch& finished = open_blocks.branches[branch];
+                auto node = ast::make_node<ast::if_expr>(std::move(finished.condition), std::move(finished.body), std::move(tail));
+                node->set_location(finished.location);
+
+                #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+                    node->debug_output();
+                #endif
+
+                if_node = std::move(node);
+            }
+
+            open_blocks.branches.erase(open_blocks.branches.begin() + first_branch, open_blocks.branches.end());
+            return if_node;
+        }
 
-                if (current_expr != nullptr) {
-                    expressions.push_back(std::move(current_expr));
+        /**
+         * @par Closes the innermost block at its '}'. A closed if branch is followed by an else if (another branch is opened), an else (its block is opened), or neither, in which case the whole if statement is built; a closed else or for loop body completes its statement. A completed statement is added to the block around it.
+         */
+        void close_block(context::compilation_context& ctx) {
+            get_next_token(ctx); // consume the '}'
+
+            open_block block = std::move(open_blocks.blocks.back());
+            open_blocks.blocks.pop_back();
+
+            switch (block.owner) {
+                case open_block::if_body: {
+                    open_blocks.branches.push_back({std::move(block.condition), std::move(block.statements), block.location});
+                    if (ctx.parser.current_token != lexer::tok_else) {
+                        open_blocks.blocks.back().statements.push_back(finish_if(block.first_branch, nullptr));
+                        return;
+                    }
+
+                    lexer::source_location else_location = ctx.parser.current_token_record->location;
+                    get_next_token(ctx); // consume the else
+
+                    if (ctx.parser.current_token == lexer::tok_if) {
+                        open_if(ctx, block.first_branch);
+                        return;
+                    }
+
+                    if (ctx.parser.current_token != lexer::tok_open_brack) {
+                        utility::parser_error("Expected opening bracket for else expression", current_location);
+                    }
+
+                    get_next_token(ctx); // consume the '{'
+
+                    open_blocks.blocks.push_back({open_block::else_body, {}, block.first_branch, nullptr, nullptr, nullptr, else_location});
+                    return;
                 }
+                case open_block::else_body: {
+                    auto else_node = ast::make_node<ast::else_expr>(std::move(block.statements), false);
+                    else_node->set_location(block.location);
+
+                    #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+                        else_node->debug_output();
+                    #endif
+
+                    open_blocks.blocks.back().statements.push_back(finish_if(block.first_branch, std::move(else_node)));
+                    return;
+                }
+                case open_block::for_body: {
+                    auto for_node = ast::make_node<ast::for_expr>(std::move(block.statements), std::move(block.variable_defn), std::move(block.condition), std::move(block.var_modification));
+                    for_node->set_location(block.location);
+
+                    #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+                        for_node->debug_output();
+                    #endif
+
+                    open_blocks.blocks.back().statements.push_back(std::move(for_node));
+                    return;
+                }
+                default:
+                    return;
+            }
+        }
+
+        /**
+         * @par Parses one statement of the innermost block into it, located where the statement starts. An if or for statement only has its header parsed here, and its block is opened on the stack.
+         * @code
+            ast::node_ptr<ast::top_level_expr> current_expr;
+            lexer::source_location statement_location = ctx.parser.current_token_record->location;
+            switch (ctx.parser.current_token) {
+                case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool:
+                    current_expr = parse_var_decl_defn(ctx);
+                    break;
+                ...
+                case lexer::tok_if:
+                    open_if(ctx, open_blocks.branches.size());
+                    return;
+                case lexer::tok_for:
+                    open_for(ctx);
+                    return;
+                ...
+                default:
+                    current_expr = parse_expression(ctx);
             }
 
-            return std::move(expressions);
+            if (current_expr != nullptr) {
+                current_expr->set_location(statement_location);
+                open_blocks.blocks.back().statements.push_back(std::move(current_expr));
+            }
          * @endcode
          */
-        std::vector<std::unique_ptr<ast::top_level_expr>> parse_block() {
-            std::unique_ptr<ast::top_level_expr> current_expr;
-            std::vector<std::unique_ptr<ast::top_level_expr>> expressions;
-            while (current_token != lexer::tok_close_brack) {
-                switch (current_token) {
-                    case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool: 
-                        current_expr = parse_var_decl_defn();
-                        break;
-                    case lexer::tok_return: // validate we are in a function here
-                        current_expr = parse_return();
-                        break;
-                    case lexer::tok_identifier:
-                        if (lexer::peek_token(current_token_index) == lexer::tok_assignment) {
-                            current_expr = parse_var_assign();
-                            break;
-                        } else if (lexer::peek_token(current_token_index) == lexer::tok_dot) {
-                            current_expr = parse_method_dot_call();
-                            break;
-                        } else {
-                            current_expr = parse_expression();
-                            break;
-                        }
-                    case lexer::tok_semicolon:
-                        get_next_token();
-                        current_expr = nullptr;
-                        break;
-                    case lexer::tok_if:
-                        current_expr = parse_if();
-                        break;
-                    case lexer::tok_for:
-                        current_expr = parse_for();
-                        break;
-                    case lexer::tok_while:
-                        current_expr = parse_while();
-                        break;
-                    case lexer::tok_graph:
-                        current_expr = parse_graph_decl();
+        void parse_statement(context::compilation_context& ctx) {
+            ast::node_ptr<ast::top_level_expr> current_expr;
+            lexer::source_location statement_location = ctx.parser.current_token_record->location;
+            switch (ctx.parser.current_token) {
+                case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool:
+                    current_expr = parse_var_decl_defn(ctx);
+                    break;
+                case lexer::tok_return: // validate we are in a function here
+                    current_expr = parse_return(ctx);
+                    break;
+                case lexer::tok_identifier:
+                    if (peek_next_token(ctx) == lexer::tok_assignment) {
+                        current_expr = parse_var_assign(ctx);
                         break;
-                    case lexer::tok_list:
-                        current_expr = parse_list_decl();
+                    } else if (peek_next_token(ctx) == lexer::tok_dot) {
+                        current_expr = parse_method_dot_call(ctx);
                         break;
-                    case lexer::tok_print:
-                        current_expr = parse_print();
+                    } else {
+                        current_expr = parse_expression(ctx);
                         break;
-                    default:
-                        current_expr = parse_expression();
-                }
+                    }
+                case lexer::tok_semicolon:
+                    get_next_token(ctx);
+                    current_expr = nullptr;
+                    break;
+                case lexer::tok_if:
+                    open_if(ctx, open_blocks.branches.size());
+                    return;
+                case lexer::tok_for:
+                    open_for(ctx);
+                    return;
+                case lexer::tok_while:
+                    current_expr = parse_while(ctx);
+                    break;
+                case lexer::tok_graph:
+                    current_expr = parse_graph_decl(ctx);
+                    break;
+                case lexer::tok_list:
+                    current_expr = parse_list_decl(ctx);
+                    break;
+                case lexer::tok_print:
+                    current_expr = parse_print(ctx);
+                    break;
+                default:
+                    current_expr = parse_expression(ctx);
+            }
 
-                if (current_expr != nullptr) {
-                    expressions.push_back(std::move(current_expr));
+            if (current_expr != nullptr) {
+                current_expr->set_location(statement_location);
+                open_blocks.blocks.back().statements.push_back(std::move(current_expr));
+            }
+        }
+
+        /**
+         * @par Parses statements and closes blocks until only `depth` blocks are left open, or the block `parse_block()` was called for reaches its '}'.
+         * @code
+            while (open_blocks.blocks.size() > depth) {
+                if (ctx.parser.current_token != lexer::tok_close_brack) {
+                    parse_statement(ctx);
+                } else if (open_blocks.blocks.back().owner == open_block::outer) {
+                    return;
+                } else {
+                    close_block(ctx);
                 }
             }
+         * @endcode
+         */
+        void parse_open_blocks(context::compilation_context& ctx, std::size_t depth) {
+            while (open_blocks.blocks.size() > depth) {
+                if (ctx.parser.current_token != lexer::tok_close_brack) {
+                    parse_statement(ctx);
+                } else if (open_blocks.blocks.back().owner == open_block::outer) {
+                    return;
+                } else {
+                    close_block(ctx);
+                }
+            }
+        }
+
+        /**
+         * @par Parses a block within a scope that exists above the global scope (different from the utility level parsing dispatcher), up to but not including its closing bracket.
+         * Nested if and for statements are parsed on `open_blocks` rather than by recursing, so blocks can be nested arbitrarily deep.
+         * @code
+            stack_depth_guard<std::vector<open_block>> trim_blocks(open_blocks.blocks);
+            stack_depth_guard<std::vector<finished_branch>> trim_branches(open_blocks.branches);
+            std::size_t depth = open_blocks.blocks.size();
+            open_blocks.blocks.push_back({open_block::outer, {}, 0, nullptr, nullptr, nullptr});
+            parse_open_blocks(ctx, depth);
+
+            ast::node_list expressions = std::move(open_blocks.blocks.back().statements);
+            open_blocks.blocks.pop_back();
+            return expressions;
+         * @endcode
+         */
+        ast::node_list parse_block(context::compilation_context& ctx) {
+            stack_depth_guard<std::vector<open_block>> trim_blocks(open_blocks.blocks);
+            stack_depth_guard<std::vector<finished_branch>> trim_branches(open_blocks.branches);
+            std::size_t depth = open_blocks.blocks.size();
+            open_blocks.blocks.push_back({open_block::outer, {}, 0, nullptr, nullptr, nullptr});
+            parse_open_blocks(ctx, depth);
+
+            ast::node_list expressions = std::move(open_blocks.blocks.back().statements);
+            open_blocks.blocks.pop_back();
+            return expressions;
+        }
+
+        /**
+         * @par Parses an if or for statement starting at the current token, with everything nested in it, and returns it.
+         * @code
+            stack_depth_guard<std::vector<open_block>> trim_blocks(open_blocks.blocks);
+            stack_depth_guard<std::vector<finished_branch>> trim_branches(open_blocks.branches);
+            std::size_t depth = open_blocks.blocks.size();
+            open_blocks.blocks.push_back({open_block::outer, {}, 0, nullptr, nullptr, nullptr});
+            parse_statement(ctx);
+            parse_open_blocks(ctx, depth + 1);
+
+            ast::node_ptr<ast::top_level_expr> statement = std::move(open_blocks.blocks.back().statements.front());
+            open_blocks.blocks.pop_back();
+            return statement;
+         * @endcode
+         */
+        ast::node_ptr<ast::top_level_expr> parse_block_statement(context::compilation_context& ctx) {
+            stack_depth_guard<std::vector<open_block>> trim_blocks(open_blocks.blocks);
+            stack_depth_guard<std::vector<finished_branch>> trim_branches(open_blocks.branches);
+            std::size_t depth = open_blocks.blocks.size();
+            open_blocks.blocks.push_back({open_block::outer, {}, 0, nullptr, nullptr, nullptr});
+            parse_statement(ctx);
+            parse_open_blocks(ctx, depth + 1);
 
-            return std::move(expressions);
+            ast::node_ptr<ast::top_level_expr> statement = std::move(open_blocks.blocks.back().statements.front());
+            open_blocks.blocks.pop_back();
+            return statement;
         }
 
         /**
          * @par Dispatched when we expect to extract a type from a particular token keyword.
          * @code
             type_enum::types type;
-            switch (current_token) {
+            switch (ctx.parser.current_token) {
                 case lexer::tok_int:
                     type = type_enum::int_type;
                     break;
@@ -1501,15 +1697,15 @@ namespace parser {
                     type = type_enum::bool_type;
                     break;
                 default:
-                    utility::parser_error("Unsupported type for graphs", current_line);
+                    utility::parser_error("Unsupported type for graphs", current_location);
             }
 
             return type;
          * @endcode
          */
-        type_enum::types parse_type() {
+        type_enum::types parse_type(context::compilation_context& ctx) {
             type_enum::types type;
-            switch (current_token) {
+            switch (ctx.parser.current_token) {
                 case lexer::tok_int:
                     type = type_enum::int_type;
                     break;
@@ -1526,7 +1722,7 @@ namespace parser {
                     type = type_enum::bool_type;
                     break;
                 default:
-                    utility::parser_error("Unsupported type for graphs", current_line);
+                    utility::parser_error("Unsupported type for graphs", current_location);
             }
 
             return type;
@@ -0,0 +1,760 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/passes/passes.h"
+#include <cmath>
+#include <cstring>
+#include <optional>
+
+namespace passes {
+
+    /**
+     * @par Starts gathering the effects and callees of the function `name`. A later definition under the same name replaces an earlier one, as it does in codegen.
+     */
+    void purity_analysis::begin_function(interner::symbol_id name) {
+        current = &functions[name];
+        *current = function_facts();
+    }
+
+    /**
+     * @par Works out which functions of a flat tree are pure, reading each node's kind, global flag and callee straight from the tree's arrays. Gives the same answer as walking the expanded tree with a `pass_manager`.
+     * @code
+        flat_ast::walk(flat, [&](const flat_ast::top_level_item& root) { ... }, [&](flat_ast::node_index node) {
+            switch (flat.kinds[node]) {
+                case ast::kind_identifier: case ast::kind_var_decl: case ast::kind_var_defn: case ast::kind_var_assign:
+                    if (flat.is_global[node]) {
+                        mark_effect();
+                    }
+                    break;
+                case ast::kind_func_call:
+                    ...
+            }
+        });
+        finish();
+     * @endcode
+     */
+    void purity_analysis::run(const flat_ast::tree& flat) {
+        functions.clear();
+        current = nullptr;
+        flat_ast::walk(flat, [&](const flat_ast::top_level_item& root) {
+            if (root.is_function) {
+                begin_function(flat.functions[root.index].name);
+            } else {
+                current = nullptr;
+            }
+        }, [&](flat_ast::node_index node) {
+            switch (flat.kinds[node]) {
+                case ast::kind_identifier: case ast::kind_var_decl: case ast::kind_var_defn: case ast::kind_var_assign:
+                    if (flat.is_global[node]) {
+                        mark_effect();
+                    }
+                    break;
+                case ast::kind_print: case ast::kind_graph_decl: case ast::kind_list_decl: case ast::kind_method_dot_call: case ast::kind_dot_call_var:
+                    mark_effect();
+                    break;
+                case ast::kind_func_call:
+                    if (current != nullptr) {
+                        current->callees.push_back(flat.calls[flat.slots[node]].name);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        });
+        finish();
+    }
+
+    /**
+     * @par Starts from every function with no effects of its own, then drops those that call a function not in the set until nothing more is dropped.
+     * @code
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto candidate = pure_functions.begin(); candidate != pure_functions.end();) {
+                ...
+                if (calls_impure) {
+                    candidate = pure_functions.erase(candidate);
+                    changed = true;
+                } else {
+                    candidate++;
+                }
+            }
+        }
+     * @endcode
+     */
+    void purity_analysis::finish() {
+        pure_functions.clear();
+        for (const auto& [function, facts] : functions) {
+            if (!facts.has_effects) {
+                pure_functions.insert(function);
+            }
+        }
+
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto candidate = pure_functions.begin(); candidate != pure_functions.end();) {
+                const function_facts& facts = functions[*candidate];
+                bool calls_impure = false;
+                for (interner::symbol_id callee : facts.callees) {
+                    if (pure_functions.count(callee) == 0) {
+                        calls_impure = true;
+                        break;
+                    }
+                }
+                if (calls_impure) {
+                    candidate = pure_functions.erase(candidate);
+                    changed = true;
+                } else {
+                    candidate++;
+                }
+            }
+        }
+    }
+
+    namespace {
+
+        int64_t wrap_int(int64_t value) {
+            return static_cast<int32_t>(static_cast<uint32_t>(value));
+        }
+
+        bool same_value(const constant_value& left, const constant_value& right) {
+            return left.type == right.type && left.integer == right.integer && std::memcmp(&left.floating, &right.floating, sizeof(double)) == 0;
+        }
+
+        /**
+         * @par Returns the value of a literal, or nothing if `node` is not one (strings are never folded, so they count as not being one).
+         */
+        std::optional<constant_value> literal_value(ast::top_level_expr* node) {
+            switch (node->get_kind()) {
+                case ast::kind_int:
+                    return constant_value{type_enum::int_type, ast::cast<ast::integer_expression>(node)->get_value(), 0.0};
+                case ast::kind_float:
+                    return constant_value{type_enum::float_type, 0, ast::cast<ast::float_expression>(node)->get_value()};
+                case ast::kind_char:
+                    return constant_value{type_enum::char_type, static_cast<uint8_t>(ast::cast<ast::char_expression>(node)->get_value()), 0.0};
+                case ast::kind_bool:
+                    return constant_value{type_enum::bool_type, ast::cast<ast::bool_expression>(node)->get_value() ? 1 : 0, 0.0};
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        ast::node_ptr<ast::top_level_expr> make_literal(const constant_value& value, lexer::source_location location) {
+            ast::node_ptr<ast::top_level_expr> literal;
+            switch (value.type) {
+                case type_enum::int_type:
+                    literal = ast::make_node<ast::integer_expression>(static_cast<int>(value.integer));
+                    break;
+                case type_enum::float_type:
+                    literal = ast::make_node<ast::float_expression>(value.floating);
+                    break;
+                case type_enum::char_type:
+                    literal = ast::make_node<ast::char_expression>(static_cast<char>(value.integer));
+                    break;
+                default:
+                    literal = ast::make_node<ast::bool_expression>(value.integer != 0);
+                    break;
+            }
+            literal->set_location(location);
+            return literal;
+        }
+
+        /**
+         * @par Compares two operands like codegen's comparisons do. Not equal is written as less or greater so that, like the ordered float predicates, it is false when either side is NaN.
+         */
+        template <typename T>
+        bool compare(lexer::Token_Type op, T left, T right) {
+            switch (op) {
+                case lexer::tok_equal: return left == right;
+                case lexer::tok_not_equal: return left < right || left > right;
+                case lexer::tok_less: return left < right;
+                case lexer::tok_less_equal: return left <= right;
+                case lexer::tok_greater: return left > right;
+                default: return left >= right;
+            }
+        }
+
+        /**
+         * @par Computes a binary operation on constant operands, or returns nothing when it has to be left to codegen: arithmetic on anything but ints and floats (which semantic analysis has already rejected), and int division or remainder by zero or of the smallest int by -1.
+         * @code
+            if (node.is_logical()) {
+                int64_t result = (op == lexer::tok_and) ? (left.integer & right.integer) : (left.integer | right.integer);
+                return constant_value{type_enum::bool_type, result, 0.0};
+            }
+            if (node.is_comparison()) {
+                bool result = (left.type == type_enum::float_type) ? compare(op, left.floating, right.floating) : compare(op, left.integer, right.integer);
+                return constant_value{type_enum::bool_type, result ? 1 : 0, 0.0};
+            }
+            ...
+         * @endcode
+         */
+        std::optional<constant_value> evaluate_binary(ast::binary_expr& node, const constant_value& left, const constant_value& right) {
+            lexer::Token_Type op = node.get_op_token();
+            if (node.is_logical()) {
+                int64_t result = (op == lexer::tok_and) ? (left.integer & right.integer) : (left.integer | right.integer);
+                return constant_value{type_enum::bool_type, result, 0.0};
+            }
+            if (node.is_comparison()) {
+                bool result = (left.type == type_enum::float_type) ? compare(op, left.floating, right.floating) : compare(op, left.integer, right.integer);
+                return constant_value{type_enum::bool_type, result ? 1 : 0, 0.0};
+            }
+
+            if (left.type == type_enum::int_type) {
+                switch (op) {
+                    case lexer::tok_plus: return constant_value{type_enum::int_type, wrap_int(left.integer + right.integer), 0.0};
+                    case lexer::tok_minus: return constant_value{type_enum::int_type, wrap_int(left.integer - right.integer), 0.0};
+                    case lexer::tok_mult: return constant_value{type_enum::int_type, wrap_int(left.integer * right.integer), 0.0};
+                    case lexer::tok_div: case lexer::tok_mod:
+                        if (right.integer == 0 || (left.integer == INT32_MIN && right.integer == -1)) {
+                            return std::nullopt;
+                        }
+                        return constant_value{type_enum::int_type, (op == lexer::tok_div) ? left.integer / right.integer : left.integer % right.integer, 0.0};
+                    default: return std::nullopt;
+                }
+            }
+            if (left.type == type_enum::float_type) {
+                switch (op) {
+                    case lexer::tok_plus: return constant_value{type_enum::float_type, 0, left.floating + right.floating};
+                    case lexer::tok_minus: return constant_value{type_enum::float_type, 0, left.floating - right.floating};
+                    case lexer::tok_mult: return constant_value{type_enum::float_type, 0, left.floating * right.floating};
+                    case lexer::tok_div: return constant_value{type_enum::float_type, 0, left.floating / right.floating};
+                    case lexer::tok_mod: return constant_value{type_enum::float_type, 0, std::fmod(left.floating, right.floating)};
+                    default: return std::nullopt;
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::optional<constant_value> evaluate_unary(ast::unary_expr& node, const constant_value& operand) {
+            if (node.get_op_token() == lexer::tok_not) {
+                return constant_value{type_enum::bool_type, operand.integer == 0 ? 1 : 0, 0.0};
+            }
+            if (operand.type == type_enum::int_type) {
+                return constant_value{type_enum::int_type, wrap_int(-operand.integer), 0.0};
+            }
+            if (operand.type == type_enum::float_type) {
+                return constant_value{type_enum::float_type, 0, -operand.floating};
+            }
+            return std::nullopt;
+        }
+
+
+        /**
+         * @par Returns whether `node` is an `if` whose condition is a literal, so that the branch it takes can stand in for it.
+         */
+        bool is_constant_if(ast::top_level_expr* node) {
+            ast::if_expr* if_node = ast::dyn_cast<ast::if_expr>(node);
+            return if_node != nullptr && literal_value(if_node->get_condition()).has_value();
+        }
+
+        /**
+         * @par Appends `statement` to `output`, or, if it is an `if` with a constant condition, the statements of the branch it takes (an else if taken this way is checked again in turn). Returns how many `if`s were replaced.
+         * @code
+            while (is_constant_if(statement.get())) {
+                ast::if_expr* node = ast::cast<ast::if_expr>(statement);
+                replaced++;
+                if (literal_value(node->get_condition())->integer != 0) {
+                    taken = &node->get_body();
+                } else if (node->get_else() != nullptr && node->get_else()->is_elif()) {
+                    statement = node->get_else()->grab_else_if();
+                    continue;
+                } else if (node->get_else() != nullptr) {
+                    taken = &ast::cast<ast::else_expr>(node->get_else())->get_body();
+                }
+                ...
+            }
+            output.push_back(std::move(statement));
+         * @endcode
+         */
+        std::size_t append_taken(ast::node_list& output, ast::node_ptr<ast::top_level_expr> statement) {
+            std::size_t replaced = 0;
+            while (is_constant_if(statement.get())) {
+                ast::if_expr* node = ast::cast<ast::if_expr>(statement);
+                replaced++;
+                ast::node_list* taken = nullptr;
+                if (literal_value(node->get_condition())->integer != 0) {
+                    taken = &node->get_body();
+                } else if (node->get_else() != nullptr && node->get_else()->is_elif()) {
+                    statement = node->get_else()->grab_else_if();
+                    continue;
+                } else if (node->get_else() != nullptr) {
+                    taken = &ast::cast<ast::else_expr>(node->get_else())->get_body();
+                }
+                if (taken != nullptr) { // its own constant ifs were left for whichever block takes it in
+                    for (ast::node_ptr<ast::top_level_expr>& taken_statement : *taken) {
+                        replaced += append_taken(output, std::move(taken_statement));
+                    }
+                }
+                return replaced;
+            }
+            output.push_back(std::move(statement));
+            return replaced;
+        }
+    }
+
+    /**
+     * @par Returns the literal to replace `node` with, or nullptr if it is not constant or is a literal already.
+     */
+    ast::node_ptr<ast::top_level_expr> constant_folding::literal_for(ast::top_level_expr* node, const std::optional<constant_value>& value) {
+        if (!value || ast::is_literal(node)) {
+            return nullptr;
+        }
+        rewrites++;
+        return make_literal(*value, node->get_location());
+    }
+
+    /**
+     * @par Records that `slot` now holds `value` (or nothing known), logging what it held before if that changes anything.
+     */
+    void constant_folding::set_known(ast::variable_slot slot, const std::optional<constant_value>& value) {
+        auto found = known.find(slot);
+        if (found == known.end()) {
+            if (value) {
+                undo_log.push_back({slot, std::nullopt});
+                known.emplace(slot, *value);
+            }
+            return;
+        }
+        if (value && same_value(found->second, *value)) {
+            return;
+        }
+        undo_log.push_back({slot, found->second});
+        if (value) {
+            found->second = *value;
+        } else {
+            known.erase(found);
+        }
+    }
+
+    std::optional<constant_value> constant_folding::known_value(ast::variable_slot slot) const {
+        auto found = known.find(slot);
+        return found != known.end() ? std::optional<constant_value>(found->second) : std::nullopt;
+    }
+
+    /**
+     * @par Puts the top level locals aside while a function is folded, since its locals are numbered apart from them, and opens a block for its parameters.
+     */
+    void constant_folding::enter_function(ast::func_defn&) {
+        top_level = std::move(known);
+        known = known_locals();
+        blocks.push_back({false, false, values.size(), undo_log.size()});
+    }
+
+    void constant_folding::leave_function(ast::func_defn&) {
+        values.resize(blocks.back().first_statement); // the parameters' entries
+        undo_log.resize(blocks.back().first_change);
+        blocks.pop_back();
+        known = std::move(top_level);
+    }
+
+    /**
+     * @par Marks where the entries of `node`'s children start. Everything under a `for` is skipped, since its body may run any number of times, apart from noting which locals it assigns.
+     * @code
+        if (node.get_kind() == ast::kind_for) {
+            if (loop_depth++ == 0) {
+                first_child.push_back(values.size());
+                loop_assigns_unknown = false;
+                loop_assigned.clear();
+            }
+            return;
+        }
+        if (loop_depth > 0) {
+            ... // record the slot of every definition and assignment
+            return;
+        }
+        first_child.push_back(values.size());
+     * @endcode
+     */
+    void constant_folding::enter_node(ast::top_level_expr& node) {
+        if (node.get_kind() == ast::kind_for) {
+            if (loop_depth++ == 0) {
+                first_child.push_back(values.size());
+                loop_assigns_unknown = false;
+                loop_assigned.clear();
+            }
+            return;
+        }
+        if (loop_depth > 0) {
+            ast::variable_slot slot = ast::no_slot;
+            if (ast::variable_definition* definition = ast::dyn_cast<ast::variable_definition>(&node)) {
+                slot = definition->get_slot();
+            } else if (ast::variable_assignment* assignment = ast::dyn_cast<ast::variable_assignment>(&node)) {
+                slot = assignment->get_slot();
+            } else {
+                return;
+            }
+            if (slot == ast::no_slot) { // for loop bodies are not analyzed yet, so this could be any local
+                loop_assigns_unknown = true;
+            } else {
+                loop_assigned.push_back(slot);
+            }
+            return;
+        }
+        if (!ast::is_literal(&node) && node.get_kind() != ast::kind_identifier) { // leaves have no children's entries to mark
+            first_child.push_back(values.size());
+        }
+    }
+
+    /**
+     * @par Works out the value of `node` from its children's entries, replaces the constant ones with literals where it has to be kept, applies what it does to the known locals, and leaves its own entry in place of its children's.
+     * @code
+        switch (node.get_kind()) {
+            case ast::kind_binary: {
+                ast::binary_expr& binary = *ast::cast<ast::binary_expr>(&node);
+                const std::optional<constant_value>& left = values[from].value;
+                const std::optional<constant_value>& right = values[from + 1].value;
+                if (left && right) {
+                    result.value = evaluate_binary(binary, *left, *right);
+                }
+                if (!result.value) {
+                    replace(binary.get_left(), left, [&](auto literal) { binary.set_left(std::move(literal)); });
+                    replace(binary.get_right(), right, [&](auto literal) { binary.set_right(std::move(literal)); });
+                }
+                break;
+            }
+            ...
+        }
+        values.resize(from + 1);
+        values[from] = result;
+     * @endcode
+     */
+    void constant_folding::leave_node(ast::top_level_expr& node) {
+        if (node.get_kind() == ast::kind_for) {
+            if (--loop_depth > 0) {
+                return;
+            }
+            if (loop_assigns_unknown) {
+                loop_assigned.clear();
+                for (const auto& [slot, value] : known) {
+                    loop_assigned.push_back(slot);
+                }
+            }
+            for (ast::variable_slot slot : loop_assigned) {
+                set_known(slot, std::nullopt);
+            }
+        } else if (loop_depth > 0) {
+            return;
+        }
+
+        if (ast::is_literal(&node)) {
+            values.push_back({literal_value(&node), false});
+            return;
+        }
+        if (ast::identifier_expr* identifier = ast::dyn_cast<ast::identifier_expr>(&node)) {
+            values.push_back({identifier->get_is_global() ? std::nullopt : known_value(identifier->get_slot()), false});
+            return;
+        }
+
+        std::size_t from = first_child.back();
+        first_child.pop_back();
+        folded_value result = {std::nullopt, false};
+        auto replace = [&](ast::top_level_expr* child, const std::optional<constant_value>& value, auto&& set) {
+            if (ast::node_ptr<ast::top_level_expr> literal = literal_for(child, value)) {
+                set(std::move(literal));
+            }
+        };
+        auto replace_arguments = [&](ast::node_list& arguments) {
+            for (std::size_t index = 0; index < arguments.size(); index++) {
+                replace(arguments[index].get(), values[from + index].value, [&](auto literal) { arguments[index] = std::move(literal); });
+            }
+        };
+
+        switch (node.get_kind()) {
+            case ast::kind_binary: {
+                ast::binary_expr& binary = *ast::cast<ast::binary_expr>(&node);
+                const std::optional<constant_value>& left = values[from].value;
+                const std::optional<constant_value>& right = values[from + 1].value;
+                if (left && right) {
+                    result.value = evaluate_binary(binary, *left, *right);
+                }
+                if (!result.value) {
+                    replace(binary.get_left(), left, [&](auto literal) { binary.set_left(std::move(literal)); });
+                    replace(binary.get_right(), right, [&](auto literal) { binary.set_right(std::move(literal)); });
+                }
+                break;
+            }
+            case ast::kind_unary: {
+                ast::unary_expr& unary = *ast::cast<ast::unary_expr>(&node);
+                const std::optional<constant_value>& operand = values[from].value;
+                if (operand) {
+                    result.value = evaluate_unary(unary, *operand);
+                }
+                if (!result.value) {
+                    replace(unary.get_operand(), operand, [&](auto literal) { unary.set_operand(std::move(literal)); });
+                }
+                break;
+            }
+            case ast::kind_func_call:
+                replace_arguments(ast::cast<ast::func_call_expr>(&node)->get_arguments());
+                break;
+            case ast::kind_method_dot_call:
+                replace_arguments(ast::cast<ast::method_dot_call>(&node)->get_arguments());
+                break;
+            case ast::kind_var_defn: {
+                ast::variable_definition& definition = *ast::cast<ast::variable_definition>(&node);
+                replace(definition.get_assigned_value(), values[from].value, [&](auto literal) { definition.set_assigned_value(std::move(literal)); });
+                if (!definition.get_is_global()) {
+                    set_known(definition.get_slot(), literal_value(definition.get_assigned_value()));
+                }
+                break;
+            }
+            case ast::kind_var_assign: {
+                ast::variable_assignment& assignment = *ast::cast<ast::variable_assignment>(&node);
+                replace(assignment.get_assigned_value(), values[from].value, [&](auto literal) { assignment.set_assigned_value(std::move(literal)); });
+                if (!assignment.get_is_global()) {
+                    set_known(assignment.get_slot(), literal_value(assignment.get_assigned_value()));
+                }
+                break;
+            }
+            case ast::kind_var_decl: {
+                ast::variable_declaration& declaration = *ast::cast<ast::variable_declaration>(&node);
+                if (!declaration.get_is_global()) {
+                    set_known(declaration.get_slot(), std::nullopt);
+                }
+                break;
+            }
+            case ast::kind_return: {
+                ast::return_expr& return_node = *ast::cast<ast::return_expr>(&node);
+                if (return_node.get_returned_value() != nullptr) {
+                    replace(return_node.get_returned_value(), values[from].value, [&](auto literal) { return_node.set_returned_value(std::move(literal)); });
+                }
+                result.returns = true; // the rest of the block is unreachable
+                blocks.back().returned = true;
+                break;
+            }
+            case ast::kind_print: {
+                ast::print_expr& print = *ast::cast<ast::print_expr>(&node);
+                replace(print.get_expression(), values[from].value, [&](auto literal) { print.set_expression(std::move(literal)); });
+                break;
+            }
+            case ast::kind_if:
+                result.returns = leave_if(*ast::cast<ast::if_expr>(&node), values[from]);
+                break;
+            default:
+                break;
+        }
+
+        values.resize(from + 1);
+        values[from] = result;
+    }
+
+    /**
+     * @par Replaces a constant condition with a literal and works out what is known after the `if` from the changes its bodies left on `branch_changes` (both have been taken back by now): with a constant condition, those of the branch it takes (the `if` is swapped for that branch when its block is rebuilt), and otherwise whatever both ways through it agree on, or, if one of them returned, what the other one knows. Returns whether control cannot get past it.
+     * @code
+        if (then_result.returned != else_result.returned) {
+            apply(then_result.returned ? else_changes : then_changes);
+            return false;
+        }
+        // both sorted by slot, so they are read side by side, with a slot only one of them changed keeping its value from before the if on the other side
+        set_known(slot, (then_value && else_value && same_value(*then_value, *else_value)) ? then_value : std::nullopt);
+     * @endcode
+     */
+    bool constant_folding::leave_if(ast::if_expr& node, const folded_value& condition) {
+        if (ast::node_ptr<ast::top_level_expr> literal = literal_for(node.get_condition(), condition.value)) {
+            node.set_condition(std::move(literal));
+        }
+
+        bool has_else = node.get_else() != nullptr;
+        branch_result else_result = {branch_changes.size(), false}; // no else body changes nothing
+        if (has_else) {
+            else_result = branches.back();
+            branches.pop_back();
+        }
+        branch_result then_result = branches.back();
+        branches.pop_back();
+
+        typedef std::pair<ast::variable_slot, std::optional<constant_value>> final_value;
+        final_value* then_begin = branch_changes.data() + then_result.first_change;
+        final_value* else_begin = branch_changes.data() + else_result.first_change;
+        final_value* else_end = branch_changes.data() + branch_changes.size();
+        auto apply = [&](final_value* begin, final_value* end, bool returned) {
+            for (final_value* change = begin; change != end; change++) {
+                set_known(change->first, change->second);
+            }
+            blocks.back().returned = blocks.back().returned || returned;
+            return returned;
+        };
+
+        bool returns = false;
+        std::optional<constant_value> constant = literal_value(node.get_condition());
+        if (constant && constant->integer != 0) {
+            returns = apply(then_begin, else_begin, then_result.returned);
+        } else if (constant) {
+            returns = has_else && apply(else_begin, else_end, else_result.returned);
+        } else if (then_result.returned != else_result.returned) {
+            simplify_else_ifs(node);
+            if (then_result.returned) {
+                apply(else_begin, else_end, false);
+            } else {
+                apply(then_begin, else_begin, false);
+            }
+        } else {
+            simplify_else_ifs(node);
+            auto by_slot = [](const final_value& first, const final_value& second) { return first.first < second.first; };
+            auto same_slot = [](const final_value& first, const final_value& second) { return first.first == second.first; };
+            std::sort(then_begin, else_begin, by_slot); // a slot changed more than once has its final value every time
+            std::sort(else_begin, else_end, by_slot);
+            final_value* then_last = std::unique(then_begin, else_begin, same_slot);
+            final_value* else_last = std::unique(else_begin, else_end, same_slot);
+
+            final_value* then_change = then_begin;
+            final_value* else_change = else_begin;
+            while (then_change != then_last || else_change != else_last) {
+                ast::variable_slot slot;
+                std::optional<constant_value> then_value;
+                std::optional<constant_value> else_value;
+                if (else_change == else_last || (then_change != then_last && then_change->first < else_change->first)) {
+                    slot = then_change->first;
+                    then_value = (then_change++)->second;
+                    else_value = known_value(slot);
+                } else if (then_change == then_last || else_change->first < then_change->first) {
+                    slot = else_change->first;
+                    then_value = known_value(slot);
+                    else_value = (else_change++)->second;
+                } else {
+                    slot = then_change->first;
+                    then_value = (then_change++)->second;
+                    else_value = (else_change++)->second;
+                }
+                set_known(slot, (then_value && else_value && same_value(*then_value, *else_value)) ? then_value : std::nullopt);
+            }
+        }
+        branch_changes.resize(then_result.first_change);
+        return returns;
+    }
+
+    /**
+     * @par Removes the else ifs after `node` whose condition is constant: one that is true becomes the plain else of `node` (with the constant ifs its body kept opened), and one that is false is replaced by its own else. Their conditions were folded when they were left, and the rest of the chain is left as it is.
+     */
+    void constant_folding::simplify_else_ifs(ast::if_expr& node) {
+        while (node.get_else() != nullptr && node.get_else()->is_elif()) {
+            ast::if_expr* else_if = ast::cast<ast::if_expr>(ast::cast<ast::else_expr>(node.get_else())->get_body().front().get());
+            std::optional<constant_value> condition = literal_value(else_if->get_condition());
+            if (!condition) {
+                return;
+            }
+            rewrites++;
+            if (condition->integer != 0) {
+                ast::node_list body;
+                for (ast::node_ptr<ast::top_level_expr>& statement : else_if->get_body()) {
+                    rewrites += append_taken(body, std::move(statement));
+                }
+                ast::node_ptr<ast::top_level_expr> taken = ast::make_node<ast::else_expr>(std::move(body), false);
+                taken->set_location(node.get_else()->get_location());
+                node.set_else(std::move(taken));
+            } else {
+                node.set_else(else_if->take_else());
+            }
+        }
+    }
+
+    /**
+     * @par Opens a block, marking where its statements' entries and its changes to the known locals start, and whether it is the branch a constant `if` does not take, which is then skipped. The top level locals stay known from one top level statement (a block of its own) to the next.
+     */
+    void constant_folding::enter_block(ast::top_level_expr* owner, ast::node_list&) {
+        if (loop_depth > 0) {
+            return;
+        }
+        std::optional<constant_value> condition;
+        if (owner != nullptr) { // the owning if's condition was the first of its children to finish
+            condition = values[first_child[first_child.size() - (owner->get_kind() == ast::kind_else ? 2 : 1)]].value;
+        }
+        bool dead = condition && (owner->get_kind() == ast::kind_else) == (condition->integer != 0);
+        blocks.push_back({false, dead, values.size(), undo_log.size()});
+    }
+
+    /**
+     * @par Rebuilds the statements of a block that has been left: constant expressions used as statements are dropped, constant `if`s are replaced by the branch they take, and nothing after a statement control cannot get past is kept. The body of an else if is left alone, since it has to stay a single `if`; the `if` owning it simplifies the chain instead. A branch of a constant `if` only has its statements dropped in place, and the constant `if`s in it are opened by the block it is opened into, so nested constant `if`s are flattened once rather than once per level. The changes a then or else body made to the known locals are taken back and handed to the `if` owning it.
+     * @code
+        for (std::size_t index = 0; index < block.size(); index++) {
+            const folded_value& statement = values[state.first_statement + index];
+            if (statement.value && !ast::is_literal(block[index].get())) {
+                rewrites++;
+                continue;
+            }
+            rewrites += append_taken(rebuilt, std::move(block[index]));
+            if (statement.returns) {
+                rewrites += block.size() - index - 1;
+                break;
+            }
+        }
+        block = std::move(rebuilt);
+     * @endcode
+     */
+    void constant_folding::leave_block(ast::top_level_expr* owner, ast::node_list& block) {
+        if (loop_depth > 0) {
+            return;
+        }
+        block_state state = std::move(blocks.back());
+        blocks.pop_back();
+
+        bool left_alone = state.dead || (owner != nullptr && owner->get_kind() == ast::kind_else && owner->is_elif());
+        if (owner != nullptr && !left_alone) {
+            std::size_t owning_if = first_child[first_child.size() - (owner->get_kind() == ast::kind_else ? 2 : 1)];
+            if (values[owning_if].value) { // a branch of a constant if, compacted in place; its constant ifs are opened by the block that takes it in
+                std::size_t kept = 0;
+                for (std::size_t index = 0; index < block.size(); index++) {
+                    const folded_value& statement = values[state.first_statement + index];
+                    if (statement.value && !ast::is_literal(block[index].get())) {
+                        rewrites++;
+                        continue;
+                    }
+                    block[kept++] = std::move(block[index]);
+                    if (statement.returns) {
+                        rewrites += block.size() - index - 1;
+                        break;
+                    }
+                }
+                block.resize(kept);
+                left_alone = true;
+            }
+        }
+        bool changed = false;
+        for (std::size_t index = 0; index < block.size() && !left_alone && !changed; index++) {
+            const folded_value& statement = values[state.first_statement + index];
+            changed = (statement.value && !ast::is_literal(block[index].get())) || is_constant_if(block[index].get()) || (statement.returns && index + 1 < block.size());
+        }
+
+        if (changed) {
+            ast::node_list rebuilt;
+            for (std::size_t index = 0; index < block.size(); index++) {
+                const folded_value& statement = values[state.first_statement + index];
+                if (statement.value && !ast::is_literal(block[index].get())) { // it was constant, so there is nothing to run
+                    rewrites++;
+                    continue;
+                }
+                rewrites += append_taken(rebuilt, std::move(block[index]));
+                if (statement.returns) {
+                    rewrites += block.size() - index - 1;
+                    break;
+                }
+            }
+            block = std::move(rebuilt);
+        }
+        values.resize(state.first_statement);
+
+        if (owner == nullptr) { // a function body or top level statement, whose changes stay
+            undo_log.resize(state.first_change);
+            return;
+        }
+        branches.push_back({branch_changes.size(), state.returned});
+        for (std::size_t index = state.first_change; index < undo_log.size(); index++) {
+            branch_changes.push_back({undo_log[index].slot, known_value(undo_log[index].slot)});
+        }
+        while (undo_log.size() > state.first_change) {
+            const known_change& change = undo_log.back();
+            if (change.previous) {
+                known[change.slot] = *change.previous;
+            } else {
+                known.erase(change.slot);
+            }
+            undo_log.pop_back();
+        }
+    }
+}
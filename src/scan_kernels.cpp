@@ -0,0 +1,359 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/scan_kernels/scan_kernels.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define SCAN_KERNELS_X86 1
+    #include <immintrin.h>
+#else
+    #define SCAN_KERNELS_X86 0
+#endif
+
+namespace scan_kernels {
+
+    std::atomic<const kernel_table*> active{nullptr};
+
+    namespace {
+
+        inline bool is_whitespace(unsigned char character) {
+            return character == ' ' || (unsigned char)(character - '\t') <= ('\r' - '\t');
+        }
+
+        inline bool is_identifier_char(unsigned char character) {
+            return (unsigned char)((character | 0x20) - 'a') <= 25 || (unsigned char)(character - '0') <= 9 || character == '_';
+        }
+
+        /**
+         * @par The portable kernels, which also finish off the tails the vector kernels leave behind.
+         */
+        std::size_t scalar_skip_whitespace(const char* data, std::size_t position, std::size_t end) {
+            while (position < end && is_whitespace(data[position])) {
+                position++;
+            }
+            return position;
+        }
+
+        std::size_t scalar_skip_identifier(const char* data, std::size_t position, std::size_t end) {
+            while (position < end && is_identifier_char(data[position])) {
+                position++;
+            }
+            return position;
+        }
+
+        std::size_t scalar_find_newline(const char* data, std::size_t position, std::size_t end) {
+            while (position < end && data[position] != '\n') {
+                position++;
+            }
+            return position;
+        }
+
+        std::size_t scalar_find_comment_end(const char* data, std::size_t position, std::size_t end) {
+            while (position + 1 < end && !(data[position] == '*' && data[position + 1] == '/')) {
+                position++;
+            }
+            if (position + 1 >= end) {
+                return end;
+            }
+            return position;
+        }
+
+        std::size_t scalar_count_newlines(const char* data, std::size_t position, std::size_t end) {
+            std::size_t count = 0;
+            for (; position < end; position++) {
+                count += (data[position] == '\n');
+            }
+            return count;
+        }
+
+        const kernel_table scalar_kernels = {
+            scalar_skip_whitespace,
+            scalar_skip_identifier,
+            scalar_find_newline,
+            scalar_find_comment_end,
+            scalar_count_newlines
+        };
+
+    #if SCAN_KERNELS_X86
+
+        /**
+         * @par SSE2 kernels. Each 16 byte block is classified with byte compares, reduced to a bit mask with `movemask`, and the answer is the first set (or unset) bit.
+         * Whitespace is ' ' or '\t' through '\r', which is tested as an unsigned range with the `min_epu8` trick since SSE2 has no unsigned compare.
+         */
+        inline __m128i sse2_in_range(__m128i bytes, char low, unsigned char width) {
+            __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8(low));
+            return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8((char)width)), shifted);
+        }
+
+        inline unsigned sse2_whitespace_mask(__m128i bytes) {
+            __m128i whitespace = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), sse2_in_range(bytes, '\t', '\r' - '\t'));
+            return (unsigned)_mm_movemask_epi8(whitespace);
+        }
+
+        inline unsigned sse2_byte_mask(__m128i bytes, char value) {
+            return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value)));
+        }
+
+        std::size_t sse2_skip_whitespace(const char* data, std::size_t position, std::size_t end) {
+            while (position + 16 <= end) {
+                unsigned stop_mask = ~sse2_whitespace_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position))) & 0xFFFF;
+                if (stop_mask != 0) {
+                    return position + __builtin_ctz(stop_mask);
+                }
+                position += 16;
+            }
+            return scalar_skip_whitespace(data, position, end);
+        }
+
+        std::size_t sse2_skip_identifier(const char* data, std::size_t position, std::size_t end) {
+            while (position + 16 <= end) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                __m128i letters = sse2_in_range(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 25);
+                __m128i digits = sse2_in_range(bytes, '0', 9);
+                __m128i underscores = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_'));
+                unsigned stop_mask = ~(unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscores)) & 0xFFFF;
+
+                if (stop_mask != 0) {
+                    return position + __builtin_ctz(stop_mask);
+                }
+                position += 16;
+            }
+            return scalar_skip_identifier(data, position, end);
+        }
+
+        std::size_t sse2_find_newline(const char* data, std::size_t position, std::size_t end) {
+            while (position + 16 <= end) {
+                unsigned newline_mask = sse2_byte_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position)), '\n');
+                if (newline_mask != 0) {
+                    return position + __builtin_ctz(newline_mask);
+                }
+                position += 16;
+            }
+            return scalar_find_newline(data, position, end);
+        }
+
+        std::size_t sse2_find_comment_end(const char* data, std::size_t position, std::size_t end) {
+            while (position + 17 <= end) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                __m128i next_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + 1));
+                unsigned close_mask = sse2_byte_mask(bytes, '*') & sse2_byte_mask(next_bytes, '/');
+
+                if (close_mask != 0) {
+                    return position + __builtin_ctz(close_mask);
+                }
+                position += 16;
+            }
+            return scalar_find_comment_end(data, position, end);
+        }
+
+        std::size_t sse2_count_newlines(const char* data, std::size_t position, std::size_t end) {
+            std::size_t count = 0;
+            while (position + 16 <= end) {
+                count += __builtin_popcount(sse2_byte_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position)), '\n'));
+                position += 16;
+            }
+            return count + scalar_count_newlines(data, position, end);
+        }
+
+        const kernel_table sse2_kernels = {
+            sse2_skip_whitespace,
+            sse2_skip_identifier,
+            sse2_find_newline,
+            sse2_find_comment_end,
+            sse2_count_newlines
+        };
+
+        /**
+         * @par AVX2 kernels, the same algorithms as SSE2 over 32 byte blocks. They are compiled for AVX2 individually, so the rest of the compiler does not require it.
+         */
+        #define AVX2_KERNEL __attribute__((target("avx2,popcnt,bmi")))
+
+        AVX2_KERNEL inline __m256i avx2_in_range(__m256i bytes, char low, unsigned char width) {
+            __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8(low));
+            return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8((char)width)), shifted);
+        }
+
+        AVX2_KERNEL inline uint32_t avx2_byte_mask(__m256i bytes, char value) {
+            return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(value)));
+        }
+
+        AVX2_KERNEL std::size_t avx2_skip_whitespace(const char* data, std::size_t position, std::size_t end) {
+            while (position + 32 <= end) {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+                __m256i whitespace = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), avx2_in_range(bytes, '\t', '\r' - '\t'));
+                uint32_t stop_mask = ~(uint32_t)_mm256_movemask_epi8(whitespace);
+
+                if (stop_mask != 0) {
+                    return position + __builtin_ctz(stop_mask);
+                }
+                position += 32;
+            }
+            return sse2_skip_whitespace(data, position, end);
+        }
+
+        AVX2_KERNEL std::size_t avx2_skip_identifier(const char* data, std::size_t position, std::size_t end) {
+            while (position + 32 <= end) {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+                __m256i letters = avx2_in_range(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 25);
+                __m256i digits = avx2_in_range(bytes, '0', 9);
+                __m256i underscores = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('_'));
+                uint32_t stop_mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letters, digits), underscores));
+
+                if (stop_mask != 0) {
+                    return position + __builtin_ctz(stop_mask);
+                }
+                position += 32;
+            }
+            return sse2_skip_identifier(data, position, end);
+        }
+
+        AVX2_KERNEL std::size_t avx2_find_newline(const char* data, std::size_t position, std::size_t end) {
+            while (position + 32 <= end) {
+                uint32_t newline_mask = avx2_byte_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position)), '\n');
+                if (newline_mask != 0) {
+                    return position + __builtin_ctz(newline_mask);
+                }
+                position += 32;
+            }
+            return sse2_find_newline(data, position, end);
+        }
+
+        AVX2_KERNEL std::size_t avx2_find_comment_end(const char* data, std::size_t position, std::size_t end) {
+            while (position + 33 <= end) {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+                __m256i next_bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position + 1));
+                uint32_t close_mask = avx2_byte_mask(bytes, '*') & avx2_byte_mask(next_bytes, '/');
+
+                if (close_mask != 0) {
+                    return position + __builtin_ctz(close_mask);
+                }
+                position += 32;
+            }
+            return sse2_find_comment_end(data, position, end);
+        }
+
+        AVX2_KERNEL std::size_t avx2_count_newlines(const char* data, std::size_t position, std::size_t end) {
+            std::size_t count = 0;
+            while (position + 32 <= end) {
+                count += __builtin_popcount(avx2_byte_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position)), '\n'));
+                position += 32;
+            }
+            return count + sse2_count_newlines(data, position, end);
+        }
+
+        #undef AVX2_KERNEL
+
+        const kernel_table avx2_kernels = {
+            avx2_skip_whitespace,
+            avx2_skip_identifier,
+            avx2_find_newline,
+            avx2_find_comment_end,
+            avx2_count_newlines
+        };
+
+    #endif
+    }
+
+    /**
+     * @par Picks the widest kernels the running CPU supports. SSE2 is part of the x86-64 baseline, and anything else uses the scalar kernels.
+     * @code
+        #if SCAN_KERNELS_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("bmi")) {
+                return level_avx2;
+            }
+            return level_sse2;
+        #else
+            return level_scalar;
+        #endif
+     * @endcode
+     */
+    kernel_level detect_level() {
+    #if SCAN_KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("bmi")) {
+            return level_avx2;
+        }
+        return level_sse2;
+    #else
+        return level_scalar;
+    #endif
+    }
+
+    namespace {
+        /**
+         * @par Returns the kernels for `level`, clamped to what this build and CPU support.
+         */
+        const kernel_table* table_for(kernel_level level) {
+            kernel_level supported = detect_level();
+            if (level > supported) {
+                level = supported;
+            }
+
+            switch (level) {
+            #if SCAN_KERNELS_X86
+                case level_avx2:
+                    return &avx2_kernels;
+                case level_sse2:
+                    return &sse2_kernels;
+            #endif
+                default:
+                    return &scalar_kernels;
+            }
+        }
+    }
+
+    /**
+     * @par Switches the lexer to the kernels for `level`, clamped to what this build and CPU support (used by the benchmarks to compare levels). This is a setup call: make it before any thread lexes.
+     * @param level The requested instruction set.
+     * @code
+     *  active.store(table_for(level), std::memory_order_release);
+     * @endcode
+     */
+    void use_level(kernel_level level) {
+        active.store(table_for(level), std::memory_order_release);
+    }
+
+    /**
+     * @par Selects the kernels for the CPU the first time any thread needs them. The detection runs once, and a level set with `use_level()` in the meantime is kept.
+     * @code
+     *  static const kernel_table* detected = table_for(detect_level());
+        const kernel_table* unset = nullptr;
+        active.compare_exchange_strong(unset, detected, std::memory_order_acq_rel);
+        return *active.load(std::memory_order_acquire);
+     * @endcode
+     */
+    const kernel_table& detected_kernels() {
+        static const kernel_table* detected = table_for(detect_level());
+        const kernel_table* unset = nullptr;
+        active.compare_exchange_strong(unset, detected, std::memory_order_acq_rel);
+        return *active.load(std::memory_order_acquire);
+    }
+
+    kernel_level active_level() {
+        const kernel_table* table = &kernels();
+    #if SCAN_KERNELS_X86
+        if (table == &avx2_kernels) {
+            return level_avx2;
+        }
+        if (table == &sse2_kernels) {
+            return level_sse2;
+        }
+    #endif
+        return level_scalar;
+    }
+
+    const char* level_name(kernel_level level) {
+        switch (level) {
+            case level_avx2: return "avx2";
+            case level_sse2: return "sse2";
+            default: return "scalar";
+        }
+    }
+}
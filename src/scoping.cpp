@@ -1,149 +1,489 @@
 #include "../include/scoping/scoping.h"
+#include <algorithm>
 
 namespace scope {
-    std::vector<std::map<std::string, llvm_var_info>> scoping_stack;
-
-    std::vector<std::map<std::string, std::set<std::string>>> valid_dot_calls;
+    thread_local std::vector<llvm::Value*> global_slots;
+    thread_local std::vector<llvm::Value*> local_slots;
+    thread_local std::size_t frame_start = 0;
+    thread_local int scope_depth = 0;
 
     /**
-     * @par Simply adds a new scope to the scope stack
+     * @par Enters a block. Variables need nothing from a scope (semantic analysis already resolved every use of them to a slot), so this only tracks how deep codegen is.
      * @code
-     * scoping_stack.emplace_back();
+     * scope_depth++;
      * @endcode
      */
     void create_scope() {
-        scoping_stack.emplace_back();
+        scope_depth++;
     }
 
     /**
-     * @par Simply removes the most recent scope from the stack.
+     * @par Leaves the innermost block.
      * @code
-     *  if (!scoping_stack.empty()) {
-            scoping_stack.pop_back();
+     *  if (scope_depth > 0) {
+            scope_depth--;
         } else {
-            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_line);
+            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_location);
         }
      * @endcode
      */
     void exit_scope() {
-        if (!scoping_stack.empty()) {
-            scoping_stack.pop_back();
+        if (scope_depth > 0) {
+            scope_depth--;
         } else {
-            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_line);
+            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_location);
         }
     }
 
     /**
-     * @par Takes in a variable allocation and adds it to the current scope.
-     * @param name The name of the variable.
-     * @param allocation A pointer to the llvm variable allocation.
-     * @param type A pointer to the variable type.
-     * @param is_init Indicates whether the variable has been initialized yet.
-     * @code 
-     * scoping_stack.back()[name] = {allocation, Variable, type, is_init};
+     * @par Starts a new frame of local slots for a function, above those of the code it is generated from, and returns where the enclosing frame starts so `exit_function()` can go back to it.
+     * @code
+     *  std::size_t enclosing_frame_start = frame_start;
+        frame_start = local_slots.size();
+        return enclosing_frame_start;
      * @endcode
      */
-    void add_var_to_current_scope(const std::string &name, llvm::AllocaInst* allocation, llvm::Type* type, bool is_init) {
-        scoping_stack.back()[name] = {allocation, Variable, type, is_init};
+    std::size_t enter_function() {
+        std::size_t enclosing_frame_start = frame_start;
+        frame_start = local_slots.size();
+        return enclosing_frame_start;
     }
 
     /**
-     * @par Takes a function argument and adds it to the current scope.
-     * @param name The name of the variable.
-     * @param allocation A pointer to the llvm argument allocation.
-     * @param type A pointer to the variable type.
+     * @par Drops the frame of the function just generated, and goes back to the frame it was entered from.
+     * @param enclosing_frame_start What `enter_function()` returned.
      * @code
-     * scoping_stack.back()[name] = {allocation, Argument, type, true};
+     *  local_slots.resize(frame_start);
+        frame_start = enclosing_frame_start;
      * @endcode
      */
-    void add_var_to_current_scope(const std::string &name, llvm::Argument* allocation, llvm::Type* type) {
-        scoping_stack.back()[name] = {allocation, Argument, type, true};
+    void exit_function(std::size_t enclosing_frame_start) {
+        local_slots.resize(frame_start);
+        frame_start = enclosing_frame_start;
     }
 
     /**
-     * @par Checks if a variable exists in scope. Does implicit variable shadowing by selecting the highest entry on the stack.
-     * @param var_name The name of the variable being searched for in the stack.
+     * @par Records the storage of a variable (an llvm::AllocaInst*, llvm::Argument* or llvm::GlobalVariable*) in its slot.
+     * @param slot The slot semantic analysis gave the variable.
+     * @param storage Where the variable's value lives.
      * @code
-     * for (auto it = scoping_stack.rbegin(); it != scoping_stack.rend(); ++it) {
-            auto variable = it->find(var_name);  
-            if (variable != it->end()) {
-                return &variable->second;  
-            }
+     *  std::vector<llvm::Value*>& slots = (slot & ast::global_slot) ? global_slots : local_slots;
+        std::size_t index = (slot & ast::global_slot) ? (slot & ~ast::global_slot) : frame_start + slot;
+        if (index >= slots.size()) {
+            slots.resize(index + 1, nullptr);
+        }
+        slots[index] = storage;
+     * @endcode
+     */
+    void bind_slot(ast::variable_slot slot, llvm::Value* storage) {
+        std::vector<llvm::Value*>& slots = (slot & ast::global_slot) ? global_slots : local_slots;
+        std::size_t index = (slot & ast::global_slot) ? (slot & ~ast::global_slot) : frame_start + slot;
+        if (index >= slots.size()) {
+            slots.resize(index + 1, nullptr);
         }
+        slots[index] = storage;
+    }
 
-        utility::scoping_error("Variable not found in current scope", parser::current_line);
+    /**
+     * @par Returns the storage of the variable in a slot, or nullptr if nothing has been generated for it.
+     * @param slot The slot semantic analysis resolved the variable to.
+     * @code
+     *  if (slot == ast::no_slot) {
+            return nullptr;
+        }
+        if (slot & ast::global_slot) {
+            std::size_t index = slot & ~ast::global_slot;
+            return index < global_slots.size() ? global_slots[index] : nullptr;
+        }
+        std::size_t index = frame_start + slot;
+        return index < local_slots.size() ? local_slots[index] : nullptr;
      * @endcode
      */
-    llvm_var_info* variable_lookup(const std::string &var_name) {
-        for (auto it = scoping_stack.rbegin(); it != scoping_stack.rend(); ++it) {
-            auto variable = it->find(var_name);  
-            if (variable != it->end()) {
-                return &variable->second;  
-            }
+    llvm::Value* slot_storage(ast::variable_slot slot) {
+        if (slot == ast::no_slot) {
+            return nullptr;
+        }
+        if (slot & ast::global_slot) {
+            std::size_t index = slot & ~ast::global_slot;
+            return index < global_slots.size() ? global_slots[index] : nullptr;
         }
-        utility::scoping_error("(Lookup) Variable not found in current scope", parser::current_line);
+        std::size_t index = frame_start + slot;
+        return index < local_slots.size() ? local_slots[index] : nullptr;
     }
 
     /**
-     * @par Checks if the variable exists in the current scope
-     * @param name The name of the variable being checked.
+     * @par Returns the type of the value kept in a variable's storage: what a stack allocation allocates, what a global holds, or an argument's own type.
      * @code
-     *  if (!scoping_stack.empty()) {
-            const auto& current_scope = scoping_stack.back();
-            return current_scope.find(name) != current_scope.end();
+     *  if (llvm::AllocaInst* allocation = llvm::dyn_cast<llvm::AllocaInst>(storage)) {
+            return allocation->getAllocatedType();
         }
-        return false; 
+        if (llvm::GlobalVariable* global = llvm::dyn_cast<llvm::GlobalVariable>(storage)) {
+            return global->getValueType();
+        }
+        return storage->getType();
      * @endcode
      */
-    bool variable_exists_in_current_scope(const std::string &name) {
-        if (!scoping_stack.empty()) {
-            const auto& current_scope = scoping_stack.back();
-            return current_scope.find(name) != current_scope.end();
+    llvm::Type* stored_type(llvm::Value* storage) {
+        if (llvm::AllocaInst* allocation = llvm::dyn_cast<llvm::AllocaInst>(storage)) {
+            return allocation->getAllocatedType();
+        }
+        if (llvm::GlobalVariable* global = llvm::dyn_cast<llvm::GlobalVariable>(storage)) {
+            return global->getValueType();
         }
-        return false;   
+        return storage->getType();
     }
 
     /**
      * @par Informs the user if the we are in global scope.
      * @code
-     * return scoping_stack.size() == 0;
+     * return scope_depth == 0;
      * @endcode
      */
     bool is_llvm_scope_global() {
-        return scoping_stack.size() == 0;
+        return scope_depth == 0;
+    }
+
+    /**
+     * @par Forgets every slot and scope, before a translation unit is generated.
+     * @code
+     *  global_slots.clear();
+        local_slots.clear();
+        frame_start = 0;
+        scope_depth = 0;
+     * @endcode
+     */
+    void reset() {
+        global_slots.clear();
+        local_slots.clear();
+        frame_start = 0;
+        scope_depth = 0;
     }
 }
 
 namespace sem_analysis_scope {
-    std::map<std::string, std::pair<type_enum::types /* return type */, std::map<int /* arg number */, type_enum::types /* arg type */>>> defined_functions;
-    std::vector<std::map<std::string, sem_analysis_info>> sem_analysis_stack;
-    std::map<std::string, std::set<std::pair<std::string, type_enum::types>>> valid_dot_calls;
+    thread_local function_table defined_functions;
+    thread_local scope_table sem_analysis_stack;
+    thread_local dot_call_table valid_dot_calls;
+
+    namespace {
+        /**
+         * @par The function and method tables semantic analysis reads on this thread: its own, unless a `shared_scope` has pointed it at another thread's. Also the record of the function body being analyzed, if any.
+         */
+        thread_local const function_table* shared_functions = nullptr;
+        thread_local const dot_call_table* shared_dot_calls = nullptr;
+        thread_local body_analysis* current_body = nullptr;
+
+        const function_table& visible_functions() {
+            return shared_functions != nullptr ? *shared_functions : defined_functions;
+        }
+
+        const dot_call_table& visible_dot_calls() {
+            return shared_dot_calls != nullptr ? *shared_dot_calls : valid_dot_calls;
+        }
+    }
+
+    /**
+     * @par Opens a new scope. Bindings made from here on belong to it, and are undone when it is popped.
+     * @code
+     * scope_starts.push_back(bindings.size());
+     * @endcode
+     */
+    void scope_table::push_scope() {
+        scope_starts.push_back(bindings.size());
+    }
+
+    /**
+     * @par Closes the innermost scope, popping the bindings made in it off the undo log and pointing each name back at the binding it shadowed. Returns false if no scope is open.
+     * @code
+     *  if (scope_starts.empty()) {
+            return false;
+        }
+
+        const std::size_t scope_start = scope_starts.back();
+        while (bindings.size() > scope_start) {
+            const scoped_variable& binding = bindings.back();
+            slots[binding.table_index].binding = binding.shadowed;
+            bindings.pop_back();
+        }
+        scope_starts.pop_back();
+        return true;
+     * @endcode
+     */
+    bool scope_table::pop_scope() {
+        if (scope_starts.empty()) {
+            return false;
+        }
+
+        const std::size_t scope_start = scope_starts.back();
+        while (bindings.size() > scope_start) {
+            const scoped_variable& binding = bindings.back();
+            slots[binding.table_index].binding = binding.shadowed;
+            bindings.pop_back();
+        }
+        scope_starts.pop_back();
+        return true;
+    }
+
+    /**
+     * @par Binds a name in the innermost scope, and returns the slot it is stored in. A name already bound in that scope is overwritten in place (and keeps its slot); a name bound further out is shadowed until the scope exits.
+     * A binding in the global scope gets the next global slot, and any other the next slot of the function being analyzed.
+     * @param name The name of the variable.
+     * @param info Its type and initialization information.
+     * @code
+     *  if ((used_slots + 1) * 4 > slots.size() * 3) {
+            grow();
+        }
+
+        const uint32_t slot_index = find_slot(name);
+        slot& name_slot = slots[slot_index];
+        if (name_slot.name == interner::no_symbol) {
+            name_slot = {name, no_binding};
+            used_slots++;
+        }
+
+        const int scope_level = depth() - 1;
+        if (name_slot.binding != no_binding && bindings[name_slot.binding].scope_level == scope_level) {
+            bindings[name_slot.binding].info = info;
+            return bindings[name_slot.binding].slot;
+        }
+
+        const ast::variable_slot slot = (scope_level == 0) ? (ast::global_slot | next_global_slot++) : next_local_slot++;
+        bindings.push_back({info, scope_level, slot, name_slot.binding, slot_index});
+        name_slot.binding = static_cast<uint32_t>(bindings.size() - 1);
+        return slot;
+     * @endcode
+     */
+    ast::variable_slot scope_table::bind(interner::symbol_id name, const sem_analysis_info& info) {
+        if ((used_slots + 1) * 4 > slots.size() * 3) {
+            grow();
+        }
+
+        const uint32_t slot_index = find_slot(name);
+        slot& name_slot = slots[slot_index];
+        if (name_slot.name == interner::no_symbol) {
+            name_slot = {name, no_binding};
+            used_slots++;
+        }
+
+        const int scope_level = depth() - 1;
+        if (name_slot.binding != no_binding && bindings[name_slot.binding].scope_level == scope_level) {
+            bindings[name_slot.binding].info = info;
+            return bindings[name_slot.binding].slot;
+        }
+
+        const ast::variable_slot slot = (scope_level == 0) ? (ast::global_slot | next_global_slot++) : next_local_slot++;
+        bindings.push_back({info, scope_level, slot, name_slot.binding, slot_index});
+        name_slot.binding = static_cast<uint32_t>(bindings.size() - 1);
+        return slot;
+    }
+
+    /**
+     * @par Returns the binding a name currently refers to, i.e. the one in the innermost scope that binds it, or nullptr if no open scope does. A name the table does not bind itself is looked for among the globals it has been shown, if any.
+     * @param name The name of the variable.
+     * @code
+     *  if (!slots.empty()) {
+            const slot& name_slot = slots[find_slot(name)];
+            if (name_slot.name != interner::no_symbol && name_slot.binding != no_binding) {
+                return &bindings[name_slot.binding];
+            }
+        }
+
+        if (shared_globals != nullptr) {
+            const scoped_variable* global = shared_globals->lookup(name);
+            if (global != nullptr && static_cast<std::size_t>(global - shared_globals->bindings.data()) < visible_globals) {
+                return global;
+            }
+        }
+        return nullptr;
+     * @endcode
+     */
+    const scoped_variable* scope_table::lookup(interner::symbol_id name) const {
+        if (!slots.empty()) {
+            const slot& name_slot = slots[find_slot(name)];
+            if (name_slot.name != interner::no_symbol && name_slot.binding != no_binding) {
+                return &bindings[name_slot.binding];
+            }
+        }
+
+        if (shared_globals != nullptr) {
+            const scoped_variable* global = shared_globals->lookup(name);
+            if (global != nullptr && static_cast<std::size_t>(global - shared_globals->bindings.data()) < visible_globals) { // declared before the function being analyzed
+                return global;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @par Marks the binding a name refers to as initialized. Returns false, changing nothing, if the name is not bound in this table itself (it is one of the globals it has been shown, or not bound at all).
+     * @param name The name of the variable.
+     * @code
+     *  if (slots.empty()) {
+            return false;
+        }
+
+        const slot& name_slot = slots[find_slot(name)];
+        if (name_slot.name == interner::no_symbol || name_slot.binding == no_binding) {
+            return false;
+        }
+        bindings[name_slot.binding].info.is_init = true;
+        return true;
+     * @endcode
+     */
+    bool scope_table::mark_initialized(interner::symbol_id name) {
+        if (slots.empty()) {
+            return false;
+        }
+
+        const slot& name_slot = slots[find_slot(name)];
+        if (name_slot.name == interner::no_symbol || name_slot.binding == no_binding) {
+            return false;
+        }
+        bindings[name_slot.binding].info.is_init = true;
+        return true;
+    }
+
+    /**
+     * @par Starts numbering local slots from 0 for a function about to be analyzed, and returns where the numbering of the enclosing code was so `exit_function()` can carry on from there.
+     * @code
+     *  ast::variable_slot enclosing_next_slot = next_local_slot;
+        next_local_slot = 0;
+        return enclosing_next_slot;
+     * @endcode
+     */
+    ast::variable_slot scope_table::enter_function() {
+        ast::variable_slot enclosing_next_slot = next_local_slot;
+        next_local_slot = 0;
+        return enclosing_next_slot;
+    }
+
+    /**
+     * @par Drops every scope and binding (and any globals it was shown), leaving the table as it was before the first scope was pushed.
+     * @code
+     *  slots.clear();
+        used_slots = 0;
+        bindings.clear();
+        scope_starts.clear();
+        next_global_slot = 0;
+        next_local_slot = 0;
+        shared_globals = nullptr;
+        visible_globals = 0;
+     * @endcode
+     */
+    void scope_table::clear() {
+        slots.clear();
+        used_slots = 0;
+        bindings.clear();
+        scope_starts.clear();
+        next_global_slot = 0;
+        next_local_slot = 0;
+        shared_globals = nullptr;
+        visible_globals = 0;
+    }
+
+    /**
+     * @par Returns the slot holding a name, or the free slot it would be placed in. The table size is a power of two, names are spread over it by Fibonacci hashing of their id, and collisions probe linearly.
+     * @param name The name being searched for.
+     * @code
+     *  const uint32_t mask = static_cast<uint32_t>(slots.size() - 1);
+        uint32_t index = static_cast<uint32_t>((name.value * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (slots[index].name != interner::no_symbol && slots[index].name != name) {
+            index = (index + 1) & mask;
+        }
+        return index;
+     * @endcode
+     */
+    uint32_t scope_table::find_slot(interner::symbol_id name) const {
+        const uint32_t mask = static_cast<uint32_t>(slots.size() - 1);
+        uint32_t index = static_cast<uint32_t>((name.value * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (slots[index].name != interner::no_symbol && slots[index].name != name) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    /**
+     * @par Doubles the table, and moves every name that is still bound over to it. The bindings of each moved name are told its new slot.
+     * @code
+     *  std::vector<slot> old_slots(std::max<std::size_t>(slots.size() * 2, 64), slot{interner::no_symbol, no_binding});
+        old_slots.swap(slots);
+        used_slots = 0;
+
+        for (const slot& old_slot : old_slots) {
+            if (old_slot.name == interner::no_symbol || old_slot.binding == no_binding) {
+                continue;
+            }
+
+            const uint32_t slot_index = find_slot(old_slot.name);
+            slots[slot_index] = old_slot;
+            used_slots++;
+            for (uint32_t binding = old_slot.binding; binding != no_binding; binding = bindings[binding].shadowed) {
+                bindings[binding].table_index = slot_index;
+            }
+        }
+     * @endcode
+     */
+    void scope_table::grow() {
+        std::vector<slot> old_slots(std::max<std::size_t>(slots.size() * 2, 64), slot{interner::no_symbol, no_binding});
+        old_slots.swap(slots);
+        used_slots = 0;
+
+        for (const slot& old_slot : old_slots) {
+            if (old_slot.name == interner::no_symbol || old_slot.binding == no_binding) {
+                continue;
+            }
+
+            const uint32_t slot_index = find_slot(old_slot.name);
+            slots[slot_index] = old_slot;
+            used_slots++;
+            for (uint32_t binding = old_slot.binding; binding != no_binding; binding = bindings[binding].shadowed) {
+                bindings[binding].table_index = slot_index;
+            }
+        }
+    }
 
     /**
-     * @par Generates a new scope (crreates and adds a new hashmap) to the semantic analysis stack.
+     * @par Generates a new scope on the semantic analysis stack.
      * @code
-     * sem_analysis_stack.emplace_back();  
+     * sem_analysis_stack.push_scope();
      * @endcode
      */
     void create_scope() {
-        sem_analysis_stack.emplace_back();   
+        sem_analysis_stack.push_scope();
     }
 
     /**
-     * @par Exits a semantic analysis scope frame by popping from the stack.
+     * @par Numbers the variables of a function from slot 0. Returns what `exit_function()` needs to carry on numbering the enclosing code afterwards.
      * @code
-     *  if (!sem_analysis_stack.empty()) {
-            sem_analysis_stack.pop_back();
-        } else {
-            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_line);
+     * return sem_analysis_stack.enter_function();
+     * @endcode
+     */
+    ast::variable_slot enter_function() {
+        return sem_analysis_stack.enter_function();
+    }
+
+    /**
+     * @par Goes back to numbering the slots of the code a function was analyzed from.
+     * @param enclosing_next_slot What `enter_function()` returned.
+     * @code
+     * sem_analysis_stack.exit_function(enclosing_next_slot);
+     * @endcode
+     */
+    void exit_function(ast::variable_slot enclosing_next_slot) {
+        sem_analysis_stack.exit_function(enclosing_next_slot);
+    }
+
+    /**
+     * @par Exits a semantic analysis scope frame, undoing the bindings made in it.
+     * @code
+     *  if (!sem_analysis_stack.pop_scope()) {
+            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_location);
         }
      * @endcode
      */
     void exit_scope() {
-        if (!sem_analysis_stack.empty()) {
-            sem_analysis_stack.pop_back();
-        } else {
-            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_line);
+        if (!sem_analysis_stack.pop_scope()) {
+            utility::scoping_error("Attempted to exit scope when no scopes exist", parser::current_location);
         }
     }
 
@@ -154,17 +494,17 @@ namespace sem_analysis_scope {
      * @param argument_types The argument types of a function definitions
      * @code
      *  std::map<int, type_enum::types> argument_type_map;
-        for (int i = 0; i < argument_types.size(); i++) {
-            argument_type_map.insert({i + 1, argument_types.at(i)});
+        for (std::size_t i = 0; i < argument_types.size(); i++) {
+            argument_type_map.insert({static_cast<int>(i) + 1, argument_types.at(i)});
         }
 
         defined_functions[name] = std::make_pair(ret_type, argument_type_map);
      * @endcode
      */
-    void add_function_defn(std::string name, type_enum::types ret_type, std::vector<type_enum::types> argument_types) {
+    void add_function_defn(interner::symbol_id name, type_enum::types ret_type, std::vector<type_enum::types> argument_types) {
         std::map<int, type_enum::types> argument_type_map;
-        for (int i = 0; i < argument_types.size(); i++) {
-            argument_type_map.insert({i + 1, argument_types.at(i)});
+        for (std::size_t i = 0; i < argument_types.size(); i++) {
+            argument_type_map.insert({static_cast<int>(i) + 1, argument_types.at(i)});
         }
 
         defined_functions[name] = std::make_pair(ret_type, argument_type_map);
@@ -174,47 +514,53 @@ namespace sem_analysis_scope {
      * @par Grabs the return type of a function.
      * @param name The name of the function
      * @code
-     *  if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_line);
+     *  const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_location);
         }
-        return defined_functions[name].first;
+        return functions.at(name).first;
      * @endcode
      */
-    type_enum::types get_func_ret_type(const std::string& name) {
-        if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_line);
+    type_enum::types get_func_ret_type(interner::symbol_id name) {
+        const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_location);
         }
-        return defined_functions[name].first;
+        return functions.at(name).first;
     }
 
     /**
      * @par Simply returns whether a function already exists in the global symbol table.
      * @param name The name of the function.
      * @code
-     * if (defined_functions.empty()) return false;
-       return defined_functions.find(name) != defined_functions.end();
+     * const function_table& functions = visible_functions();
+        if (functions.empty()) return false;
+       return functions.find(name) != functions.end();
      * @endcode
      */
-    bool global_contains_func_defn(const std::string& name) {
-        if (defined_functions.empty()) return false;
-        return defined_functions.find(name) != defined_functions.end();
+    bool global_contains_func_defn(interner::symbol_id name) {
+        const function_table& functions = visible_functions();
+        if (functions.empty()) return false;
+        return functions.find(name) != functions.end();
     }
 
     /**
      * @par Returns the map corresponding to the arguments and their respective types from the defined functions map.
      * @param name Simply the name of the function
      * @code
-     *  if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_line);
+     *  const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_location);
         }
-        return defined_functions[name].second;
+        return functions.at(name).second;
      * @endcode
      */
-    const std::map<int, type_enum::types>& get_arg_type_map(const std::string& name) {
-        if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_line);
+    const std::map<int, type_enum::types>& get_arg_type_map(interner::symbol_id name) {
+        const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Function type unaquirable as the function is undeclared", parser::current_location);
         }
-        return defined_functions[name].second;
+        return functions.at(name).second;
     }
 
     /**
@@ -222,87 +568,85 @@ namespace sem_analysis_scope {
      * @param name The name of the function.
      * @param arg_number The parameter whose type we are trying to access.
      * @code
-     *  if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Parameter type unaquirable as the function is undeclared", parser::current_line);
+     *  const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Parameter type unaquirable as the function is undeclared", parser::current_location);
         }
 
         if (arg_number > get_num_params(name) + 1 || arg_number <= 0) {
-            utility::scoping_error("Argument number inaccessible as function does not specify " + arg_number + " arguments, or argument number less than or equal to 0", parser::current_line);
+            utility::scoping_error("Argument number inaccessible as function does not specify " + arg_number + " arguments, or argument number less than or equal to 0", parser::current_location);
         }
 
-        return defined_functions[name].second[arg_number];
+        return functions.at(name).second.at(arg_number);
      * @endcode
      */
-    type_enum::types get_param_type(const std::string& name, int arg_number) {
-        if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Parameter type unaquirable as the function is undeclared", parser::current_line);
+    type_enum::types get_param_type(interner::symbol_id name, int arg_number) {
+        const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Parameter type unaquirable as the function is undeclared", parser::current_location);
         }
 
         if (arg_number > get_num_params(name) + 1 || arg_number <= 0) {
-            utility::scoping_error("Argument number inaccessible, as it is <= 0, or it does not exist", parser::current_line);
+            utility::scoping_error("Argument number inaccessible, as it is <= 0, or it does not exist", parser::current_location);
         }
 
-        return defined_functions[name].second[arg_number];
+        return functions.at(name).second.at(arg_number);
     }
 
     /**
      * @par Returns the number of arguments in a function definition.
      * @param name The name of the function.
      * @code
-     *  if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Function parameters unaquirable as the function is undeclared", parser::current_line);
+     *  const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Function parameters unaquirable as the function is undeclared", parser::current_location);
         }
-        return defined_functions[name].second.size();
+        return functions.at(name).second.size();
         @endcode
      */
-    int get_num_params(const std::string& name) {
-        if (defined_functions.find(name) == defined_functions.end()) {
-            utility::scoping_error("Function parameters unaquirable as the function is undeclared", parser::current_line);
+    int get_num_params(interner::symbol_id name) {
+        const function_table& functions = visible_functions();
+        if (functions.find(name) == functions.end()) {
+            utility::scoping_error("Function parameters unaquirable as the function is undeclared", parser::current_location);
         }
-        return defined_functions[name].second.size();
+        return functions.at(name).second.size();
     }
 
     /**
      * @par Grabs the type of the top most decl/defn of a variable on the scope stack.
      * @param name The name of the variable.
      * @code
-     *  for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return variable->second.type;  
-            }
+     *  if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->info.type;
         }
-        utility::scoping_error("Variable not found in current scope", parser::current_line);
+        utility::scoping_error("(Type) Variable not found in current scope", parser::current_location);
      * @endcode
      */
-    type_enum::types get_var_type(const std::string &name) {
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return variable->second.type;  
-            }
+    type_enum::types get_var_type(interner::symbol_id name) {
+        if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->info.type;
         }
-        utility::scoping_error("(Type) Variable not found in current scope", parser::current_line);
+        utility::scoping_error("(Type) Variable not found in current scope", parser::current_location);
     }
 
     /**
-     * @par Adds a variable to the current scope on the semantic analysis stack.
+     * @par Adds a variable to the current scope on the semantic analysis stack, and returns the slot codegen is to store it in.
      * @param name The name of the new variable.
      * @param type The type of the variable.
      * @param is_init Has the variable just been declared or defined.
      * @param complex_dt Stores the name of the complex data type.
      * @code
         if (sem_analysis_stack.empty()) {
-            utility::scoping_error("Semantic analysis scope stack is empty", parser::current_line);
+            utility::scoping_error("Semantic analysis scope stack is empty", parser::current_location);
         }
-        sem_analysis_stack.back()[name] = {type, complex_dt, is_init};
+        return sem_analysis_stack.bind(name, {type, complex_dt, is_init});
      * @endcode
      */
-    void add_var_to_current_scope(const std::string &name, type_enum::types type, bool is_init, const std::string &complex_dt) {
+    ast::variable_slot add_var_to_current_scope(interner::symbol_id name, type_enum::types type, bool is_init, interner::symbol_id complex_dt) {
         if (sem_analysis_stack.empty()) {
-            utility::scoping_error("Semantic analysis scope stack is empty", parser::current_line);
+            utility::scoping_error("Semantic analysis scope stack is empty", parser::current_location);
         }
-        sem_analysis_stack.back()[name] = {type, complex_dt, is_init};
+        return sem_analysis_stack.bind(name, {type, complex_dt, is_init});
     }
 
     /**
@@ -310,244 +654,245 @@ namespace sem_analysis_scope {
      * @param name The name of the variable.
      * 
      * @code
-     *  for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return variable->second.complex_dt;
-            }
-        }      
-        utility::scoping_error("Complex data type not found on scope stack", parser::current_line);
+     *  if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->info.complex_dt;
+        }
+        utility::scoping_error("Complex data type not found on scope stack", parser::current_location);
      * @endcode
      */
-    std::string get_var_complex_dt(const std::string& name) {
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return variable->second.complex_dt;
-            }
-        }      
-        utility::scoping_error("Complex data type not found on scope stack", parser::current_line);
+    interner::symbol_id get_var_complex_dt(interner::symbol_id name) {
+        if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->info.complex_dt;
+        }
+        utility::scoping_error("Complex data type not found on scope stack", parser::current_location);
     }
 
     /**
-     * @par Checks whether the variable has been declared in the current scope.
+     * @par Returns the binding a variable currently refers to, or nullptr if it is not in scope. Lets a caller that needs several facts about a variable look it up once.
      * @param name The name of the variable.
      * @code
-     *  if (!sem_analysis_stack.empty()) {
-            const auto& current_scope = sem_analysis_stack.back();
-            return current_scope.find(name) != current_scope.end();
-        }
-        return false;  
+     * return sem_analysis_stack.lookup(name);
      * @endcode
      */
-    bool variable_exists_in_current_scope(const std::string& name) {
-        if (!sem_analysis_stack.empty()) {
-            const auto& current_scope = sem_analysis_stack.back();
-            return current_scope.find(name) != current_scope.end();
-        }
-        return false;   
+    const scoped_variable* lookup_var(interner::symbol_id name) {
+        return sem_analysis_stack.lookup(name);
     }
 
     /**
-     * @par Checks if a variable (the highest in the scope stack) has been initialized with a value.
-     * @param name The name of the variable.
+     * @par Decides whether reading a global declared without a value is fine, in the function body being analyzed. If the body has assigned the global already it is; otherwise the read is recorded, and it is up to the bodies before this one (see `body_analysis`). Outside of a function body it is not.
+     * @param variable The binding of the global being read.
+     * @param location Where it is read.
      * @code
-     *  for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return variable->second.is_init;  
-            }
+     *  if (current_body == nullptr || variable->scope_level != 0) {
+            return false;
         }
 
-        utility::scoping_error("Variable does not exist in current scope", parser::current_line);
+        const std::vector<ast::variable_slot>& initialized = current_body->initialized_globals;
+        if (std::find(initialized.begin(), initialized.end(), variable->slot) == initialized.end()) {
+            current_body->deferred_reads.push_back({variable->slot, location});
+        }
+        return true;
      * @endcode
      */
-    bool var_initialized(const std::string& name) {
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return variable->second.is_init;  
-            }
+    bool global_initialized(const scoped_variable* variable, lexer::source_location location) {
+        if (current_body == nullptr || variable->scope_level != 0) {
+            return false;
         }
 
-        utility::scoping_error("Variable does not exist in current scope", parser::current_line);
+        const std::vector<ast::variable_slot>& initialized = current_body->initialized_globals;
+        if (std::find(initialized.begin(), initialized.end(), variable->slot) == initialized.end()) {
+            current_body->deferred_reads.push_back({variable->slot, location});
+        }
+        return true;
     }
 
     /**
-     * @par Check if the variable exists at all in the entire semantic analysis scope stack.
-     * @param name The name of the variable.
+     * @par Points semantic analysis on this thread at the global scope and tables of another thread's unit, setting its own aside.
+     * @param globals The scope table of the unit, with its global scope complete.
+     * @param functions The functions of the unit.
+     * @param dot_calls The methods of the unit.
      * @code
-     *  for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return true;  
-            }
-        }
-        return false;
+     *  saved_stack = std::move(sem_analysis_stack);
+        sem_analysis_stack = scope_table();
+        shared_functions = &functions;
+        shared_dot_calls = &dot_calls;
      * @endcode
      */
-    bool var_exists(const std::string& name) {
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return true;  
-            }
-        }
-        return false;
+    shared_scope::shared_scope(const scope_table& globals, const function_table& functions, const dot_call_table& dot_calls) :
+        globals(globals),
+        saved_stack(std::move(sem_analysis_stack)),
+        saved_functions(shared_functions),
+        saved_dot_calls(shared_dot_calls),
+        saved_body(current_body)
+    {
+        sem_analysis_stack = scope_table();
+        shared_functions = &functions;
+        shared_dot_calls = &dot_calls;
     }
 
     /**
-     * @par When a variable is assigned a value after declaration, we can change it's initialization value (boolean) on the scope stack.
-     * @param name The name of the variable.
+     * @par Puts back the scope stack and tables the thread had before.
      * @code
-     *  for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                variable->second.is_init = true;
-                return;
-            } 
-        }
-
-        utility::scoping_error("Variabale not found", parser::current_line);
+     *  sem_analysis_stack = std::move(saved_stack);
+        shared_functions = saved_functions;
+        shared_dot_calls = saved_dot_calls;
+        current_body = saved_body;
      * @endcode
      */
-    void set_var_init(const std::string& name) {
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                variable->second.is_init = true;
-                return;
-            } 
-        }
-
-        utility::scoping_error("Variabale not found", parser::current_line);
+    shared_scope::~shared_scope() {
+        sem_analysis_stack = std::move(saved_stack);
+        shared_functions = saved_functions;
+        shared_dot_calls = saved_dot_calls;
+        current_body = saved_body;
     }
 
     /**
-     * @par Returns the scope level of a particular variable to set the global parameter (min scope is 0)
-     * @param name The name of the variable.
+     * @par Gets ready to analyze a function body: an empty scope stack whose global scope is the first bindings of the unit's (the globals declared before the function), and a record for what the body does with them.
+     * @param visible_globals How many of the unit's bindings the body can see.
+     * @param record Where to record what the body does with its globals.
      * @code
-     *  int loc = sem_analysis_stack.size() - 1;
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return loc;
-            } 
-            loc--;
-        }  
+     *  sem_analysis_stack.clear();
+        sem_analysis_stack.push_scope();
+        sem_analysis_stack.see_globals(&globals, visible_globals);
+        current_body = &record;
      * @endcode
      */
-    int get_var_scope_level(const std::string& name) {
-        int loc = sem_analysis_stack.size() - 1;
-        for (auto it = sem_analysis_stack.rbegin(); it != sem_analysis_stack.rend(); ++it) {
-            auto variable = it->find(name);  
-            if (variable != it->end()) {
-                return loc;
-            } 
-            loc--;
-        }  
+    void shared_scope::enter_body(std::size_t visible_globals, body_analysis& record) {
+        sem_analysis_stack.clear(); // a body that failed may have left scopes open
+        sem_analysis_stack.push_scope();
+        sem_analysis_stack.see_globals(&globals, visible_globals);
+        current_body = &record;
     }
 
     /**
-     * @par Returns the size of the scope stack. If the value is 0, we are currently operating in the global scope.
+     * @par Checks whether the variable has been declared in the current scope.
+     * @param name The name of the variable.
      * @code
-     * return sem_analysis_stack.size();
+     *  const scoped_variable* variable = sem_analysis_stack.lookup(name);
+        return variable != nullptr && variable->scope_level == sem_analysis_stack.depth() - 1;
      * @endcode
-     * 
      */
-    int get_scope_stack_size() {
-        return sem_analysis_stack.size();
+    bool variable_exists_in_current_scope(interner::symbol_id name) {
+        const scoped_variable* variable = sem_analysis_stack.lookup(name);
+        return variable != nullptr && variable->scope_level == sem_analysis_stack.depth() - 1;
     }
 
     /**
-     * @par Adds methods to valid dot calls for complex data types for checking later.
+     * @par Checks if a variable (the highest in the scope stack) has been initialized with a value.
+     * @param name The name of the variable.
      * @code
-        if (valid_dot_calls.find(aggregate_type) != valid_dot_calls.end()) {
-            //std::cout << "Adding method " << method << "to type " << aggregate_type << "\n";
-            valid_dot_calls[aggregate_type].insert({method, type});
-            return;
+     *  if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->info.is_init;
         }
-    
-        std::set<std::string> methods;
-        methods.insert({method, type});
-        valid_dot_calls.insert({aggregate_type, methods});
-        return;
+
+        utility::scoping_error("Variable does not exist in current scope", parser::current_location);
      * @endcode
      */
-    void add_method_to_valid_dot_calls(const std::string &aggregate_type, const std::string &method, const type_enum::types type) {
-        // find the correct map if it exists
-        if (valid_dot_calls.find(aggregate_type) != valid_dot_calls.end()) {
-            //std::cout << "Adding method " << method << "to type " << aggregate_type << "\n";
-            valid_dot_calls[aggregate_type].insert({method, type});
-            return;
+    bool var_initialized(interner::symbol_id name) {
+        if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->info.is_init;
         }
-    
-        std::set<std::pair<std::string, type_enum::types>> methods;
-        methods.insert({method, type});
-        valid_dot_calls.insert({aggregate_type, methods});
-        return;
-        // if it exists...
-            // grab the correct map
-            // add a particular method to the set of valid dot calls
 
-        // if it doesnt exist...
-            // instantiate a set with the valid method signiature of the new method
-            // create a new corresponding map, and add the set
-            // add a new map to the back of the vector  
+        utility::scoping_error("Variable does not exist in current scope", parser::current_location);
+    }
 
-        
+    /**
+     * @par Check if the variable exists at all in the entire semantic analysis scope stack.
+     * @param name The name of the variable.
+     * @code
+     * return sem_analysis_stack.lookup(name) != nullptr;
+     * @endcode
+     */
+    bool var_exists(interner::symbol_id name) {
+        return sem_analysis_stack.lookup(name) != nullptr;
     }
 
     /**
-     * @par Checks if a method dot call is in fact valid.
+     * @par When a variable is assigned a value after declaration, we can change it's initialization value (boolean) on the scope stack. A global assigned in a function body is only recorded as initialized by that body (see `body_analysis`).
+     * @param name The name of the variable.
      * @code
-        if (valid_dot_calls.find(aggregate_type) == valid_dot_calls.end()) {
-            return false;
+     *  if (sem_analysis_stack.mark_initialized(name)) {
+            return;
         }
 
-        const auto& methods = valid_dot_calls[aggregate_type];
-        for (const auto &methods_and_returns : methods) {
-            if (methods_and_returns.first == method) {
-                return true;
-            }
+        const scoped_variable* variable = sem_analysis_stack.lookup(name);
+        if (variable == nullptr) {
+            utility::scoping_error("Variabale not found", parser::current_location);
+        }
+        if (current_body != nullptr) {
+            current_body->initialized_globals.push_back(variable->slot);
         }
-
-        return false;
      * @endcode
      */
-    bool method_valid_dot_call(const std::string &aggregate_type, const std::string &method) {
-        if (valid_dot_calls.find(aggregate_type) == valid_dot_calls.end()) {
-            return false;
+    void set_var_init(interner::symbol_id name) {
+        if (sem_analysis_stack.mark_initialized(name)) {
+            return;
         }
 
-        const auto& methods = valid_dot_calls[aggregate_type];
-        for (const auto &methods_and_returns : methods) {
-            if (methods_and_returns.first == method) {
-                return true;
-            }
+        const scoped_variable* variable = sem_analysis_stack.lookup(name);
+        if (variable == nullptr) {
+            utility::scoping_error("Variabale not found", parser::current_location);
+        }
+        if (current_body != nullptr) {
+            current_body->initialized_globals.push_back(variable->slot);
         }
-
-        return false;
     }
 
     /**
-     * @par Gives back the return type of a method dot call.
+     * @par Returns the scope level of a particular variable to set the global parameter (min scope is 0)
+     * @param name The name of the variable.
      * @code
-     *  const auto& methods = valid_dot_calls[aggregate_type];
-        for (const auto &methods_and_returns : methods) {
-            if (methods_and_returns.first == method) {
-                return methods_and_returns.second;
-            }
+     *  if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->scope_level;
         }
+        return -1;
      * @endcode
      */
-    type_enum::types get_dot_call_type(const std::string &aggregate_type, const std::string &method) {
-        const auto& methods = valid_dot_calls[aggregate_type];
-        for (const auto &methods_and_returns : methods) {
-            if (methods_and_returns.first == method) {
-                return methods_and_returns.second;
-            }
+    int get_var_scope_level(interner::symbol_id name) {
+        if (const scoped_variable* variable = sem_analysis_stack.lookup(name)) {
+            return variable->scope_level;
         }
+        return -1;
+    }
+
+    /**
+     * @par Returns the size of the scope stack. If the value is 0, we are currently operating in the global scope.
+     * @code
+     * return sem_analysis_stack.depth();
+     * @endcode
+     * 
+     */
+    int get_scope_stack_size() {
+        return sem_analysis_stack.depth();
+    }
+
+    /**
+     * @par Adds a method of a complex data type, instantiated for one element type, to the methods of the unit.
+     * @param key The data type, element type and name of the method.
+     * @param return_type What a call of the method evaluates to.
+     * @param parameter_types The types of the arguments the method takes, not counting the object.
+     * @param function The function implementing the method, or `nullptr` if the linked library has none.
+     * @code
+     *  valid_dot_calls[key] = {return_type, std::move(parameter_types), function};
+     * @endcode
+     */
+    void add_method_to_valid_dot_calls(const dot_call_key& key, type_enum::types return_type, std::vector<type_enum::types> parameter_types, llvm::Function* function) {
+        valid_dot_calls[key] = {return_type, std::move(parameter_types), function};
+    }
+
+    /**
+     * @par Finds the method a dot call resolves to, or returns `nullptr` if the data type has no such method for its element type.
+     * @param key The data type and element type of the object, and the name of the called method.
+     * @code
+     *  const dot_call_table& dot_calls = visible_dot_calls();
+        auto method = dot_calls.find(key);
+        return method != dot_calls.end() ? &method->second : nullptr;
+     * @endcode
+     */
+    const dot_call_target* find_dot_call(const dot_call_key& key) {
+        const dot_call_table& dot_calls = visible_dot_calls();
+        auto method = dot_calls.find(key);
+        return method != dot_calls.end() ? &method->second : nullptr;
     }
 
     /** 
@@ -0,0 +1,202 @@
+/*
+MIT License
+Copyright (c) 2024 Daniel Gunther
+
+For the full license text, see the LICENSE.md file in the root directory.
+If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+*/
+
+#include "../include/thread_pool/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace thread_pool {
+
+    namespace {
+
+        /**
+         * @par Set on the pool's worker threads (and on the caller while it helps), so that nested calls run inline instead of deadlocking.
+         */
+        thread_local bool inside_task = false;
+
+        /**
+         * @struct job
+         * @par A single `parallel_for()` call. Up to `max_helpers` workers join the caller, threads claim task indices from `next_task`, and the caller waits for `remaining_tasks` to reach zero.
+         */
+        struct job {
+            const std::function<void(std::size_t)>* task;
+            std::size_t task_count;
+            unsigned max_helpers;
+            unsigned helpers_joined = 0;
+            std::atomic<std::size_t> next_task{0};
+            std::atomic<std::size_t> remaining_tasks{0};
+        };
+
+        /**
+         * @par A fixed set of worker threads that sleep until a job is posted. The pool is intentionally never destroyed, so `exit()` from any thread (as the error reporters do) cannot deadlock joining workers.
+         * The number of threads is `$PYRX_THREADS` when it is set to a positive number (so the parallel paths can be exercised on any machine), otherwise the hardware's.
+         * The pool runs one job at a time: threads outside the pool that call `parallel_for()` at once take turns on `run_mutex`, which is held until their job has finished, so a job is never replaced or cleared while another caller is still waiting on it.
+         */
+        class pool {
+            public:
+                pool() {
+                    unsigned total_threads = std::max(1u, std::thread::hardware_concurrency());
+                    if (const char* requested = std::getenv("PYRX_THREADS"); requested != nullptr && *requested != '\0') {
+                        char* end;
+                        unsigned long parsed = std::strtoul(requested, &end, 10);
+                        if (*end == '\0' && parsed > 0) {
+                            total_threads = static_cast<unsigned>(std::min(parsed, 256ul));
+                        }
+                    }
+                    for (unsigned i = 1; i < total_threads; i++) {
+                        workers.emplace_back([this]() { worker_loop(); });
+                    }
+                }
+
+                unsigned thread_count() const {
+                    return static_cast<unsigned>(workers.size()) + 1;
+                }
+
+                void run(job& current_job) {
+                    std::lock_guard<std::mutex> turn(run_mutex);
+                    {
+                        std::lock_guard<std::mutex> lock(pool_mutex);
+                        active_job = &current_job;
+                        generation++;
+                    }
+                    work_available.notify_all();
+
+                    inside_task = true;
+                    work_on(current_job);
+                    inside_task = false;
+
+                    std::unique_lock<std::mutex> lock(pool_mutex);
+                    job_finished.wait(lock, [&]() { return current_job.remaining_tasks.load() == 0 && busy_workers == 0; });
+                    active_job = nullptr;
+                }
+
+            private:
+                std::vector<std::thread> workers;
+                std::mutex run_mutex;
+                std::mutex pool_mutex;
+                std::condition_variable work_available;
+                std::condition_variable job_finished;
+                job* active_job = nullptr;
+                std::size_t generation = 0;
+                unsigned busy_workers = 0;
+
+                static void work_on(job& current_job) {
+                    while (true) {
+                        std::size_t task_index = current_job.next_task.fetch_add(1);
+                        if (task_index >= current_job.task_count) {
+                            return;
+                        }
+                        (*current_job.task)(task_index);
+                        current_job.remaining_tasks.fetch_sub(1);
+                    }
+                }
+
+                void worker_loop() {
+                    inside_task = true;
+                    std::size_t seen_generation = 0;
+
+                    while (true) {
+                        job* current_job;
+                        {
+                            std::unique_lock<std::mutex> lock(pool_mutex);
+                            work_available.wait(lock, [&]() { return generation != seen_generation && active_job != nullptr; });
+                            seen_generation = generation;
+                            current_job = active_job;
+
+                            if (current_job->helpers_joined >= current_job->max_helpers) {
+                                continue;
+                            }
+                            current_job->helpers_joined++;
+                            busy_workers++;
+                        }
+
+                        work_on(*current_job);
+
+                        {
+                            std::lock_guard<std::mutex> lock(pool_mutex);
+                            busy_workers--;
+                        }
+                        job_finished.notify_all();
+                    }
+                }
+        };
+
+        pool& shared_pool() {
+            static pool* instance = new pool();
+            return *instance;
+        }
+
+        unsigned worker_limit = 0;
+    }
+
+    unsigned worker_count() {
+        unsigned available = shared_pool().thread_count();
+        return (worker_limit == 0) ? available : std::min(available, worker_limit);
+    }
+
+    void set_worker_limit(unsigned limit) {
+        worker_limit = limit;
+    }
+
+    /**
+     * @par Spreads the tasks over the pool, or runs them in order on the calling thread when there is nothing to gain (one task, one thread, or a nested call).
+     * @code
+        if (task_count <= 1 || worker_count() <= 1 || inside_task) {
+            for (std::size_t i = 0; i < task_count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        job current_job;
+        current_job.task = &task;
+        current_job.task_count = task_count;
+        current_job.max_helpers = worker_count() - 1;
+        current_job.remaining_tasks = task_count;
+        shared_pool().run(current_job);
+     * @endcode
+     */
+    void parallel_for(std::size_t task_count, const std::function<void(std::size_t)>& task) {
+        if (task_count <= 1 || worker_count() <= 1 || inside_task) {
+            for (std::size_t i = 0; i < task_count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        job current_job;
+        current_job.task = &task;
+        current_job.task_count = task_count;
+        current_job.max_helpers = worker_count() - 1;
+        current_job.remaining_tasks = task_count;
+        shared_pool().run(current_job);
+    }
+
+    /**
+     * @par Hands the caller's task flag to the new thread, so that it nests like the caller would (see the declaration).
+     * @code
+        bool nested = inside_task;
+        std::thread([&work, nested]() {
+            inside_task = nested;
+            work();
+        }).join();
+     * @endcode
+     */
+    void run_on_new_thread(const std::function<void()>& work) {
+        bool nested = inside_task;
+        std::thread([&work, nested]() {
+            inside_task = nested;
+            work();
+        }).join();
+    }
+}
@@ -11,47 +11,131 @@ If LICENSE.md is not included, this version of the source code is provided in br
 
 namespace ast {
 
-    /**
-     * @fn ast::binary_expr::semantic_analysis()
-     * @par Recurse the tree setting types as necessary, and performing semantic analysis on sub-expression, then set the type of the binary expression.
-     * @code
-     *  if (left->get_ast_class() != "int" && left->get_ast_class() != "float" && left->get_ast_class() != "char" && left->get_ast_class() != "string" && left->get_ast_class() != "bool") {
-            left->semantic_analysis();
-        }
+    namespace {
+
+        /**
+         * @par Checks a binary expression whose operands have been analyzed, and sets its type. Both sides have to have the same type.
+         * @code
+            type_enum::types left_type = node.get_left()->get_expr_type();
+            type_enum::types right_type = node.get_right()->get_expr_type();
 
-        if (right->get_ast_class() != "int" && right->get_ast_class() != "float" && right->get_ast_class() != "char" && right->get_ast_class() != "string" && right->get_ast_class() != "bool") {
-            right->semantic_analysis();
+            if (left_type != right_type) {
+                utility::sem_analysis_error("Invalid types connected in binary expression", node.get_location());
+            }
+         * @endcode
+         *
+         * @par Comparisons and logical operators produce booleans, and logical operators only take booleans. Arithmetic only takes ints and floats, and has the type of its operands.
+         * @code
+            if (node.is_logical()) {
+                if (left_type != type_enum::bool_type) {
+                    utility::sem_analysis_error("Logical operators require boolean operands", node.get_location());
+                }
+                node.set_expr_type(type_enum::bool_type);
+            } else if (node.is_comparison()) {
+                if (left_type == type_enum::string_type) {
+                    utility::sem_analysis_error("Cannot compare string values", node.get_location());
+                }
+                node.set_expr_type(type_enum::bool_type);
+            } else {
+                if (left_type != type_enum::int_type && left_type != type_enum::float_type) {
+                    utility::sem_analysis_error("Arithmetic operators require integer or float operands", node.get_location());
+                }
+                node.set_expr_type(left_type);
+            }
+         * @endcode
+         */
+        void check_binary(ast::binary_expr& node) {
+            type_enum::types left_type = node.get_left()->get_expr_type();
+            type_enum::types right_type = node.get_right()->get_expr_type();
+
+            if (left_type != right_type) {
+                utility::sem_analysis_error("Invalid types connected in binary expression", node.get_location());
+            }
+
+            if (node.is_logical()) {
+                if (left_type != type_enum::bool_type) {
+                    utility::sem_analysis_error("Logical operators require boolean operands", node.get_location());
+                }
+                node.set_expr_type(type_enum::bool_type);
+            } else if (node.is_comparison()) {
+                if (left_type == type_enum::string_type) {
+                    utility::sem_analysis_error("Cannot compare string values", node.get_location());
+                }
+                node.set_expr_type(type_enum::bool_type);
+            } else {
+                if (left_type != type_enum::int_type && left_type != type_enum::float_type) {
+                    utility::sem_analysis_error("Arithmetic operators require integer or float operands", node.get_location());
+                }
+                node.set_expr_type(left_type);
+            }
         }
 
-        type_enum::types left_type = left->get_expr_type();
-        type_enum::types right_type = right->get_expr_type();
+        /**
+         * @par Checks that the analyzed operand of a prefix operator suits it: `!` takes a boolean, and `-` an integer or float. The result has the operand's type.
+         * @code
+            type_enum::types operand_type = node.get_operand()->get_expr_type();
+            if (node.get_op_token() == lexer::tok_not && operand_type != type_enum::bool_type) {
+                utility::sem_analysis_error("Logical not requires a boolean operand", node.get_location());
+            }
+            if (node.get_op_token() == lexer::tok_minus && operand_type != type_enum::int_type && operand_type != type_enum::float_type) {
+                utility::sem_analysis_error("Negation requires an integer or float operand", node.get_location());
+            }
 
-        if (left_type != right_type) {
-            utility::sem_analysis_error("Invalid types connected in binary expression", parser::current_line);
+            node.set_expr_type(operand_type);
+         * @endcode
+         */
+        void check_unary(ast::unary_expr& node) {
+            type_enum::types operand_type = node.get_operand()->get_expr_type();
+            if (node.get_op_token() == lexer::tok_not && operand_type != type_enum::bool_type) {
+                utility::sem_analysis_error("Logical not requires a boolean operand", node.get_location());
+            }
+            if (node.get_op_token() == lexer::tok_minus && operand_type != type_enum::int_type && operand_type != type_enum::float_type) {
+                utility::sem_analysis_error("Negation requires an integer or float operand", node.get_location());
+            }
+
+            node.set_expr_type(operand_type);
+        }
+
+        /**
+         * @par Analyzes the whole operator tree under `root` bottom up with `ast::walk_operator_tree()`: every operand that is not a literal or an operator is analyzed on its own, then each operator is checked once its operands are.
+         */
+        void analyze_operators(ast::top_level_expr* root) {
+            ast::walk_operator_tree(root,
+                [](ast::top_level_expr* operand) {
+                    if (!ast::is_literal(operand)) {
+                        operand->semantic_analysis();
+                    }
+                },
+                [](ast::top_level_expr* node) {
+                    if (node->get_kind() == ast::kind_binary) {
+                        check_binary(*ast::cast<ast::binary_expr>(node));
+                    } else {
+                        check_unary(*ast::cast<ast::unary_expr>(node));
+                    }
+                });
         }
+    }
 
-        set_expr_type(left->get_expr_type());
+    /**
+     * @fn ast::binary_expr::semantic_analysis()
+     * @par Analyzes the sub-expressions, then sets the type of the binary expression (see `check_binary()`). Operators nested under this one are handled in the same non recursive walk.
+     * @code
+        analyze_operators(this);
      * @endcode
      */
     void ast::binary_expr::semantic_analysis() {
-        if (left->get_ast_class() != "int" && left->get_ast_class() != "float" && left->get_ast_class() != "char" && left->get_ast_class() != "string" && left->get_ast_class() != "bool") {
-            left->semantic_analysis();
-        }
-
-        if (right->get_ast_class() != "int" && right->get_ast_class() != "float" && right->get_ast_class() != "char" && right->get_ast_class() != "string" && right->get_ast_class() != "bool") {
-            right->semantic_analysis();
-        }
-
-        type_enum::types left_type = left->get_expr_type();
-        //std::cout << ast::get_type_as_string(left_type) << " " << left->get_ast_class() << "\n";
-        type_enum::types right_type = right->get_expr_type();
-        //std::cout << ast::get_type_as_string(right_type) << " " << right->get_ast_class() << "\n";
-
-        if (left_type != right_type) {
-            utility::sem_analysis_error("Invalid types connected in binary expression", parser::current_line);
-        }
+        analyze_operators(this);
+    }
 
-        set_expr_type(left->get_expr_type());
+    /**
+     * @fn ast::unary_expr::semantic_analysis()
+     * @par Analyzes the operand, then checks it suits the operator (see `check_unary()`).
+     * @code
+        analyze_operators(this);
+     * @endcode
+     */
+    void ast::unary_expr::semantic_analysis() {
+        analyze_operators(this);
     }
 
     /**
@@ -60,33 +144,35 @@ namespace ast {
      * 
      * @code
      *  if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot assign identifier value to global variables", parser::current_line);
+            utility::sem_analysis_error("Cannot assign identifier value to global variables", get_location());
         }
-     *  if (sem_analysis_scope::var_initialized(identifier_name) == false) {
-            utility::sem_analysis_error("Value attempting to access not initialized", parser::current_line);
+        const sem_analysis_scope::scoped_variable* variable = sem_analysis_scope::lookup_var(identifier_name);
+        if (variable == nullptr) {
+            utility::scoping_error("Variable does not exist in current scope", get_location());
         }
-        set_expr_type(sem_analysis_scope::get_var_type(identifier_name));
-        if (sem_analysis_scope::get_var_scope_level(identifier_name) == 0) {
-            set_is_global(true);
-        } else {
-            set_is_global(false);
+        if (!variable->info.is_init && !sem_analysis_scope::global_initialized(variable, get_location())) {
+            utility::sem_analysis_error("Value attempting to access not initialized", get_location());
         }
+        set_expr_type(variable->info.type);
+        set_is_global(variable->scope_level == 0);
+        set_slot(variable->slot);
      * @endcode
      */
     void ast::identifier_expr::semantic_analysis() {
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot assign identifier value to global variables", parser::current_line);
+            utility::sem_analysis_error("Cannot assign identifier value to global variables", get_location());
         }
 
-        if (sem_analysis_scope::var_initialized(identifier_name) == false) {
-            utility::sem_analysis_error("Value attempting to access not initialized", parser::current_line);
+        const sem_analysis_scope::scoped_variable* variable = sem_analysis_scope::lookup_var(identifier_name);
+        if (variable == nullptr) {
+            utility::scoping_error("Variable does not exist in current scope", get_location());
         }
-        set_expr_type(sem_analysis_scope::get_var_type(identifier_name));
-        if (sem_analysis_scope::get_var_scope_level(identifier_name) == 0) {
-            set_is_global(true);
-        } else {
-            set_is_global(false);
+        if (!variable->info.is_init && !sem_analysis_scope::global_initialized(variable, get_location())) {
+            utility::sem_analysis_error("Value attempting to access not initialized", get_location());
         }
+        set_expr_type(variable->info.type);
+        set_is_global(variable->scope_level == 0);
+        set_slot(variable->slot);
     }
 
     /**
@@ -95,9 +181,9 @@ namespace ast {
      * 
      * @code
      *  if (sem_analysis_scope::variable_exists_in_current_scope(identifier_name)) {
-            utility::sem_analysis_error("Variable already declared or defined in the current scope", parser::current_line);
+            utility::sem_analysis_error("Variable already declared or defined in the current scope", get_location());
         }
-        sem_analysis_scope::add_var_to_current_scope(identifier_name, type, false, "base_literal");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(identifier_name, type, false, interner::intern("base_literal")));
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
             set_is_global(true);
         } else {
@@ -107,9 +193,9 @@ namespace ast {
      */
     void ast::variable_declaration::semantic_analysis() {
         if (sem_analysis_scope::variable_exists_in_current_scope(identifier_name)) {
-            utility::sem_analysis_error("Variable already declared or defined in the current scope", parser::current_line);
+            utility::sem_analysis_error("Variable already declared or defined in the current scope", get_location());
         }
-        sem_analysis_scope::add_var_to_current_scope(identifier_name, type, false, "base_literal");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(identifier_name, type, false, interner::intern("base_literal")));
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
             set_is_global(true);
         } else {
@@ -122,18 +208,18 @@ namespace ast {
      * @par Validate that the declared type and the type of the expression match. Also validate that the variable does not yet exist in the current scope.
      * @code
      *  if (sem_analysis_scope::variable_exists_in_current_scope(identifier_name)) {
-            utility::sem_analysis_error("Variable already declared or defined in the current scope", parser::current_line);
+            utility::sem_analysis_error("Variable already declared or defined in the current scope", get_location());
         }
 
-        if (assigned_value->get_ast_class() != "int" && assigned_value->get_ast_class() != "float" && assigned_value->get_ast_class() != "char" && assigned_value->get_ast_class() != "string" && assigned_value->get_ast_class() != "bool") {
+        if (!ast::is_literal(assigned_value.get())) {
             assigned_value->semantic_analysis();
         }
 
         if (assigned_value->get_expr_type() != type) {
-            utility::sem_analysis_error("Invalid value provided to variable definition", parser::current_line);
+            utility::sem_analysis_error("Invalid value provided to variable definition", get_location());
         }   
 
-        sem_analysis_scope::add_var_to_current_scope(identifier_name, type, true, "base_literal");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(identifier_name, type, true, interner::intern("base_literal")));
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
             set_is_global(true);
         } else {
@@ -143,18 +229,18 @@ namespace ast {
      */
     void ast::variable_definition::semantic_analysis() {
         if (sem_analysis_scope::variable_exists_in_current_scope(identifier_name)) {
-            utility::sem_analysis_error("Variable already declared or defined in the current scope", parser::current_line);
+            utility::sem_analysis_error("Variable already declared or defined in the current scope", get_location());
         }
 
-        if (assigned_value->get_ast_class() != "int" && assigned_value->get_ast_class() != "float" && assigned_value->get_ast_class() != "char" && assigned_value->get_ast_class() != "string" && assigned_value->get_ast_class() != "bool") {
+        if (!ast::is_literal(assigned_value.get())) {
             assigned_value->semantic_analysis();
         }
 
         if (assigned_value->get_expr_type() != type) {
-            utility::sem_analysis_error("Invalid value provided to variable definition", parser::current_line);
+            utility::sem_analysis_error("Invalid value provided to variable definition", get_location());
         }   
 
-        sem_analysis_scope::add_var_to_current_scope(identifier_name, type, true, "base_literal");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(identifier_name, type, true, interner::intern("base_literal")));
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
             set_is_global(true);
         } else {
@@ -167,118 +253,186 @@ namespace ast {
      * @par Validate that the type of variable being reassigned matches the type of the expression. Also validate that the variable exists in the scope stack.
      * @code
      *  if (sem_analysis_scope::var_exists(identifier_name) == false) {
-            utility::sem_analysis_error("Variable being assigned does not exist in the current scope", parser::current_line);
+            utility::sem_analysis_error("Variable being assigned does not exist in the current scope", get_location());
         }
 
-        if (assigned_value->get_ast_class() != "int" && assigned_value->get_ast_class() != "float" && assigned_value->get_ast_class() != "char" && assigned_value->get_ast_class() != "string" && assigned_value->get_ast_class() != "bool") {
+        if (!ast::is_literal(assigned_value.get())) {
             assigned_value->semantic_analysis();
         }
 
-        if (assigned_value->get_expr_type() != sem_analysis_scope::get_var_type(identifier_name)) {
-            utility::sem_analysis_error("Assigned value does not match the type of the identifier", parser::current_line);
+        const sem_analysis_scope::scoped_variable* variable = sem_analysis_scope::lookup_var(identifier_name);
+        if (assigned_value->get_expr_type() != variable->info.type) {
+            utility::sem_analysis_error("Assigned value does not match the type of the identifier", get_location());
         }
 
         sem_analysis_scope::set_var_init(identifier_name);
-        if (sem_analysis_scope::get_var_scope_level(identifier_name) == 0) {
-            set_is_global(true);
-        } else {
-            set_is_global(false);
-        }
+        set_is_global(variable->scope_level == 0);
+        set_slot(variable->slot);
      * @endcode
      */
     void ast::variable_assignment::semantic_analysis() {
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot reassign variables in the global scope", parser::current_line);
+            utility::sem_analysis_error("Cannot reassign variables in the global scope", get_location());
         }
         if (sem_analysis_scope::var_exists(identifier_name) == false) {
-            utility::sem_analysis_error("Variable being assigned does not exist in the current scope", parser::current_line);
+            utility::sem_analysis_error("Variable being assigned does not exist in the current scope", get_location());
         }
 
-        if (assigned_value->get_ast_class() != "int" && assigned_value->get_ast_class() != "float" && assigned_value->get_ast_class() != "char" && assigned_value->get_ast_class() != "string" && assigned_value->get_ast_class() != "bool") {
+        if (!ast::is_literal(assigned_value.get())) {
             assigned_value->semantic_analysis();
         }
 
-        if (assigned_value->get_expr_type() != sem_analysis_scope::get_var_type(identifier_name)) {
-            utility::sem_analysis_error("Assigned value does not match the type of the identifier", parser::current_line);
+        // looked up again after the value, since analyzing it may bind names and move the scope table's bindings
+        const sem_analysis_scope::scoped_variable* variable = sem_analysis_scope::lookup_var(identifier_name);
+        if (assigned_value->get_expr_type() != variable->info.type) {
+            utility::sem_analysis_error("Assigned value does not match the type of the identifier", get_location());
         }
 
         sem_analysis_scope::set_var_init(identifier_name);
-        if (sem_analysis_scope::get_var_scope_level(identifier_name) == 0) {
-            set_is_global(true);
-        } else {
-            set_is_global(false);
-        }
+        set_is_global(variable->scope_level == 0);
+        set_slot(variable->slot);
     }
 
-    /**
-     * @fn ast::if_expr::semantic_analysis() 
-     * @par Semantically analyze if expressions.
-     * 
-     * @par Validate we are not in the global scope, and create a new scope.
-     * @code
-     *  if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot have conditionals in the global scope", parser::current_line);
-        }
-        sem_analysis_scope::create_scope();
-     * @endcode
+    namespace {
+
+        /**
+         * @par An if or else block being analyzed, and the index of its next statement.
+         */
+        struct open_conditional {
+            ast::top_level_expr* node;
+            std::size_t next_statement;
+        };
+
+        /**
+         * @par Shared by every if statement analyzed on this thread, so analyzing one does not allocate.
+         */
+        thread_local std::vector<open_conditional> open_conditionals;
+
+        /**
+         * @par Starts analyzing an if (checks it is not in the global scope, opens its scope, and checks its condition is a boolean) or an else (opens its scope).
+         * An else if holds nothing but its if, so rather than opening an empty scope of its own it goes straight to the if. Otherwise every link of an else if chain would leave a scope open until the end of the chain.
+         * @code
+            if (node->get_kind() == ast::kind_else && node->is_elif()) {
+                node = ast::cast<ast::else_expr>(node)->get_body().front().get();
+            }
 
-     @par Semantically analyze the condition and verify that it is a boolean type.
-     @code
-        condition->semantic_analysis();
-        if (condition->get_expr_type() != type_enum::bool_type) {
-            utility::sem_analysis_error("If statement does not contain a boolean condition", parser::current_line);
-        }
-     @endcode
+            if (node->get_kind() == ast::kind_if) {
+                if (sem_analysis_scope::get_scope_stack_size() == 1) {
+                    utility::sem_analysis_error("Cannot have conditionals in the global scope", node->get_location());
+                }
+                sem_analysis_scope::create_scope();
+                ast::top_level_expr* condition = ast::cast<ast::if_expr>(node)->get_condition();
+                condition->semantic_analysis();
+                if (condition->get_expr_type() != type_enum::bool_type) {
+                    utility::sem_analysis_error("If statement does not contain a boolean condition", condition->get_location());
+                }
+            } else {
+                sem_analysis_scope::create_scope();
+            }
 
-     @par Semantically analyze each expression in the if block, and then exit the scope.
-     @code
-        for (auto const& ast_node : expressions) {
-            ast_node->semantic_analysis();
-        }
-        sem_analysis_scope::exit_scope(); 
-     @endcode
-     */
-    void ast::if_expr::semantic_analysis() {
-        if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot have conditionals in the global scope", parser::current_line);
-        }
-        sem_analysis_scope::create_scope();
-        condition->semantic_analysis();
-        if (condition->get_expr_type() != type_enum::bool_type) {
-            utility::sem_analysis_error("If statement does not contain a boolean condition", parser::current_line);
-        }
+            open_conditionals.push_back({node, 0});
+         * @endcode
+         */
+        void enter_conditional(ast::top_level_expr* node) {
+            if (node->get_kind() == ast::kind_else && node->is_elif()) {
+                node = ast::cast<ast::else_expr>(node)->get_body().front().get();
+            }
 
-        for (auto const& ast_node : expressions) {
-            ast_node->semantic_analysis();
-        }
+            if (node->get_kind() == ast::kind_if) {
+                if (sem_analysis_scope::get_scope_stack_size() == 1) {
+                    utility::sem_analysis_error("Cannot have conditionals in the global scope", node->get_location());
+                }
+                sem_analysis_scope::create_scope();
+                ast::top_level_expr* condition = ast::cast<ast::if_expr>(node)->get_condition();
+                condition->semantic_analysis();
+                if (condition->get_expr_type() != type_enum::bool_type) {
+                    utility::sem_analysis_error("If statement does not contain a boolean condition", condition->get_location());
+                }
+            } else {
+                sem_analysis_scope::create_scope();
+            }
 
-        sem_analysis_scope::exit_scope();
+            open_conditionals.push_back({node, 0});
+        }
+
+        /**
+         * @par Analyzes an if statement (with its else if chain and everything nested in it) or an else, keeping the blocks being analyzed on `open_conditionals` instead of recursing into them.
+         * An if or else nested in a block is entered in place of being analyzed, and once a block's statements are done its scope is exited and the else after an if is entered.
+         * @code
+            enter_conditional(root);
+            while (open_conditionals.size() > base) {
+                open_conditional& top = open_conditionals.back();
+                const ast::node_list& body = (top.node->get_kind() == ast::kind_if) ? ast::cast<ast::if_expr>(top.node)->get_body() : ast::cast<ast::else_expr>(top.node)->get_body();
+
+                if (top.next_statement < body.size()) {
+                    ast::top_level_expr* statement = body[top.next_statement++].get();
+                    if (statement->get_kind() == ast::kind_if || statement->get_kind() == ast::kind_else) {
+                        enter_conditional(statement);
+                    } else {
+                        statement->semantic_analysis();
+                    }
+                    continue;
+                }
 
-        if (else_stmt != nullptr) {
-            else_stmt->semantic_analysis();
-        }
+                ast::top_level_expr* finished = top.node;
+                open_conditionals.pop_back();
+                sem_analysis_scope::exit_scope();
+
+                if (finished->get_kind() == ast::kind_if && ast::cast<ast::if_expr>(finished)->get_else() != nullptr) {
+                    enter_conditional(ast::cast<ast::if_expr>(finished)->get_else());
+                }
+            }
+         * @endcode
+         */
+        void analyze_conditionals(ast::top_level_expr* root) {
+            const std::size_t base = open_conditionals.size();
+            enter_conditional(root);
+
+            while (open_conditionals.size() > base) {
+                open_conditional& top = open_conditionals.back();
+                const ast::node_list& body = (top.node->get_kind() == ast::kind_if) ? ast::cast<ast::if_expr>(top.node)->get_body() : ast::cast<ast::else_expr>(top.node)->get_body();
+
+                if (top.next_statement < body.size()) {
+                    ast::top_level_expr* statement = body[top.next_statement++].get();
+                    if (statement->get_kind() == ast::kind_if || statement->get_kind() == ast::kind_else) {
+                        enter_conditional(statement);
+                    } else {
+                        statement->semantic_analysis();
+                    }
+                    continue;
+                }
+
+                ast::top_level_expr* finished = top.node;
+                open_conditionals.pop_back();
+                sem_analysis_scope::exit_scope();
 
+                if (finished->get_kind() == ast::kind_if && ast::cast<ast::if_expr>(finished)->get_else() != nullptr) {
+                    enter_conditional(ast::cast<ast::if_expr>(finished)->get_else());
+                }
+            }
+        }
     }
 
     /**
      * @fn ast::if_expr::semantic_analysis() 
-     * @par Semantically analyze else expressions.
-     * 
-     * @par Create a scope, semantically analyze each expression in the else expression, and then exit the scope.
+     * @par Semantically analyze if expressions: outside the global scope, with a boolean condition, and with the block (and the else after it) analyzed in scopes of their own. See `analyze_conditionals()`, which does this without recursing into nested blocks.
      * @code
-        sem_analysis_scope::create_scope();
-        for (auto const& ast_node : expressions) {
-            ast_node->semantic_analysis();
-        }
-        sem_analysis_scope::exit_scope();
+        analyze_conditionals(this);
+     * @endcode
+     */
+    void ast::if_expr::semantic_analysis() {
+        analyze_conditionals(this);
+    }
+
+    /**
+     * @fn ast::else_expr::semantic_analysis() 
+     * @par Semantically analyze else expressions, in a scope of their own. See `analyze_conditionals()`.
+     * @code
+        analyze_conditionals(this);
      * @endcode
      */
     void ast::else_expr::semantic_analysis() {
-        sem_analysis_scope::create_scope();
-        for (auto const& ast_node : expressions) {
-            ast_node->semantic_analysis();
-        }
-        sem_analysis_scope::exit_scope();
+        analyze_conditionals(this);
     }
 
     /**
@@ -292,7 +446,7 @@ namespace ast {
      * @fn ast::return_expr::semantic_analysis()
      * @par Sets the type of the expression and recursively semantically analyzes the attached expression.
      * @code
-     *  if (returned_value->get_ast_class() != "int" && returned_value->get_ast_class() != "float" && returned_value->get_ast_class() != "char" && returned_value->get_ast_class() != "string" && returned_value->get_ast_class() != "bool") {
+     *  if (!ast::is_literal(returned_value.get())) {
             returned_value->semantic_analysis();
         }
 
@@ -300,7 +454,7 @@ namespace ast {
      * @endcode
      */
     void ast::return_expr::semantic_analysis() {
-        if (returned_value->get_ast_class() != "int" && returned_value->get_ast_class() != "float" && returned_value->get_ast_class() != "char" && returned_value->get_ast_class() != "string" && returned_value->get_ast_class() != "bool") {
+        if (!ast::is_literal(returned_value.get())) {
             returned_value->semantic_analysis();
         }
 
@@ -308,71 +462,92 @@ namespace ast {
     }
 
     /**
-     * @fn ast::func_defn::semantic_analysis()
-     * @par Creates a new level of scope and then recursively analyzes the contained expressions. Also validate the type of all return expressions.
+     * @fn ast::func_defn::analyze_signature()
+     * @par Checks the name and parameters of a function and enters it into the global symbol table. Every signature in a file is analyzed before any body, so a function can be called from a body that comes before it.
      * 
      * @code
      *  if (sem_analysis_scope::global_contains_func_defn(func_name)) {
-            utility::sem_analysis_error("Function already defined", parser::current_line);
+            utility::sem_analysis_error("Function already defined", get_location());
         }
 
-        sem_analysis_scope::add_function_defn(func_name, return_type);
+        std::vector<type_enum::types> arg_types;
+        for (std::size_t i = 0; i < parameters.size(); i++) {
+            for (std::size_t j = 0; j < i; j++) {
+                if (parameters[j]->get_name() == parameters[i]->get_name()) {
+                    utility::sem_analysis_error("Parameter already exists in current scope", parameters[i]->get_location());
+                }
+            }
+            arg_types.emplace_back(parameters[i]->get_expr_type());
+        }
 
-        sem_analysis_scope::create_scope();
+        sem_analysis_scope::add_function_defn(func_name, return_type, arg_types);
+     * @endcode
+     */
+    void ast::func_defn::analyze_signature() {
+        if (sem_analysis_scope::global_contains_func_defn(func_name)) {
+            utility::sem_analysis_error("Function already defined", get_location());
+        }
 
         std::vector<type_enum::types> arg_types;
-        for (auto const& paramter : parameters) {
-            if (sem_analysis_scope::variable_exists_in_current_scope(paramter->get_name())) {
-                utility::sem_analysis_error("Parameter already exists in current scope", parser::current_line);
+        for (std::size_t i = 0; i < parameters.size(); i++) {
+            for (std::size_t j = 0; j < i; j++) {
+                if (parameters[j]->get_name() == parameters[i]->get_name()) {
+                    utility::sem_analysis_error("Parameter already exists in current scope", parameters[i]->get_location());
+                }
             }
-            arg_types.emplace_back(paramter->get_expr_type());
-            sem_analysis_scope::add_var_to_current_scope(paramter->get_name(), paramter->get_expr_type(), true, "base_literal");
+            arg_types.emplace_back(parameters[i]->get_expr_type());
         }
 
         sem_analysis_scope::add_function_defn(func_name, return_type, arg_types);
+    }
+
+    /**
+     * @fn ast::func_defn::semantic_analysis()
+     * @par Creates a new level of scope for the parameters and then recursively analyzes the contained expressions. Also validate the type of all return expressions. The signature has been analyzed already (see `analyze_signature()`).
+     * 
+     * @code
+     *  sem_analysis_scope::create_scope();
+        const ast::variable_slot enclosing_next_slot = sem_analysis_scope::enter_function();
+
+        for (auto const& paramter : parameters) {
+            ast::variable_slot slot = sem_analysis_scope::add_var_to_current_scope(paramter->get_name(), paramter->get_expr_type(), true, interner::intern("base_literal"));
+            ast::set_parameter_slot(paramter.get(), slot);
+        }
 
         for (auto const& ast_node : expressions) {
-            if (ast_node->get_ast_class() == "return") {
+            if (ast::isa<ast::return_expr>(ast_node)) {
                 ast_node->semantic_analysis();
                 if (ast_node->get_expr_type() != return_type) {
-                    utility::sem_analysis_error("Return type does not match type of the function", parser::current_line);
+                    utility::sem_analysis_error("Return type does not match type of the function", ast_node->get_location());
                 }
-            } else if (ast_node->get_ast_class() != "int" && ast_node->get_ast_class() != "float" && ast_node->get_ast_class() != "char" && ast_node->get_ast_class() != "string" && ast_node->get_ast_class() != "bool") {
+            } else if (!ast::is_literal(ast_node.get())) {
                 ast_node->semantic_analysis();
             }
         }
+        sem_analysis_scope::exit_function(enclosing_next_slot);
         sem_analysis_scope::exit_scope();
      * @endcode
      */
     void ast::func_defn::semantic_analysis() {
-        if (sem_analysis_scope::global_contains_func_defn(func_name)) {
-            utility::sem_analysis_error("Function already defined", parser::current_line);
-        }
-
         sem_analysis_scope::create_scope();
+        const ast::variable_slot enclosing_next_slot = sem_analysis_scope::enter_function();
 
-        std::vector<type_enum::types> arg_types;
         for (auto const& paramter : parameters) {
-            if (sem_analysis_scope::variable_exists_in_current_scope(paramter->get_name())) {
-                utility::sem_analysis_error("Parameter already exists in current scope", parser::current_line);
-            }
-            arg_types.emplace_back(paramter->get_expr_type());
-            sem_analysis_scope::add_var_to_current_scope(paramter->get_name(), paramter->get_expr_type(), true, "base_literal");
+            ast::variable_slot slot = sem_analysis_scope::add_var_to_current_scope(paramter->get_name(), paramter->get_expr_type(), true, interner::intern("base_literal"));
+            ast::set_parameter_slot(paramter.get(), slot);
         }
 
-        sem_analysis_scope::add_function_defn(func_name, return_type, arg_types);
-
-
         for (auto const& ast_node : expressions) {
-            if (ast_node->get_ast_class() == "return") {
+            if (ast::isa<ast::return_expr>(ast_node)) {
                 ast_node->semantic_analysis();
                 if (ast_node->get_expr_type() != return_type) {
-                    utility::sem_analysis_error("Return type does not match type of the function", parser::current_line);
+                    utility::sem_analysis_error("Return type does not match type of the function", ast_node->get_location());
                 }
-            } else if (ast_node->get_ast_class() != "int" && ast_node->get_ast_class() != "float" && ast_node->get_ast_class() != "char" && ast_node->get_ast_class() != "string" && ast_node->get_ast_class() != "bool") {
+            } else if (!ast::is_literal(ast_node.get())) {
                 ast_node->semantic_analysis();
             }
         }
+        sem_analysis_scope::exit_function(enclosing_next_slot);
         sem_analysis_scope::exit_scope();
     }
 
@@ -381,34 +556,30 @@ namespace ast {
      * @par Validate the the function exists in the global symbol table, and that the number of arguments and argument types match what is expected.
      * @code
      *  if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot assign globals with function calls", parser::current_line);
+            utility::sem_analysis_error("Cannot assign globals with function calls", get_location());
         }
         if (!sem_analysis_scope::global_contains_func_defn(func_name)) {
-            utility::sem_analysis_error("Function not found in the global symbol table", parser::current_line);
+            utility::sem_analysis_error("Function not found in the global symbol table", get_location());
         }
 
         set_expr_type(sem_analysis_scope::get_func_ret_type(func_name)); // set the type of the expression correctly
         //std::cout << ast::get_type_as_string(get_expr_type()) << "\n";
 
 
-        if (arguments.size() != sem_analysis_scope::get_num_params(func_name)) {
-            utility::sem_analysis_error("Number of arguments in function call do not match number of arguments in function definition", parser::current_line);
+        if (arguments.size() != static_cast<std::size_t>(sem_analysis_scope::get_num_params(func_name))) {
+            utility::sem_analysis_error("Number of arguments in function call do not match number of arguments in function definition", get_location());
         }
 
         int current_param = 1;
 
         for (auto const& argument : arguments) {
-            if (argument->get_ast_class() != "int" && 
-                argument->get_ast_class() != "float" && 
-                argument->get_ast_class() != "char" && 
-                argument->get_ast_class() != "string" && 
-                argument->get_ast_class() != "bool") 
+            if (!ast::is_literal(argument.get())) 
             {
                 argument->semantic_analysis();
             }
 
             if(argument->get_expr_type() != sem_analysis_scope::get_param_type(func_name, current_param)) {
-                utility::sem_analysis_error("Argument in function call does not match exprected parameter type", parser::current_line);
+                utility::sem_analysis_error("Argument in function call does not match exprected parameter type", get_location());
             }
 
             current_param++;
@@ -417,34 +588,30 @@ namespace ast {
      */
     void ast::func_call_expr::semantic_analysis() {
         if (sem_analysis_scope::get_scope_stack_size() == 1) {
-            utility::sem_analysis_error("Cannot assign globals with function calls", parser::current_line);
+            utility::sem_analysis_error("Cannot assign globals with function calls", get_location());
         }
         if (!sem_analysis_scope::global_contains_func_defn(func_name)) {
-            utility::sem_analysis_error("Function not found in the global symbol table", parser::current_line);
+            utility::sem_analysis_error("Function not found in the global symbol table", get_location());
         }
 
         set_expr_type(sem_analysis_scope::get_func_ret_type(func_name)); // set the type of the expression correctly
         //std::cout << ast::get_type_as_string(get_expr_type()) << "\n";
 
 
-        if (arguments.size() != sem_analysis_scope::get_num_params(func_name)) {
-            utility::sem_analysis_error("Number of arguments in function call do not match number of arguments in function definition", parser::current_line);
+        if (arguments.size() != static_cast<std::size_t>(sem_analysis_scope::get_num_params(func_name))) {
+            utility::sem_analysis_error("Number of arguments in function call do not match number of arguments in function definition", get_location());
         }
 
         int current_param = 1;
 
         for (auto const& argument : arguments) {
-            if (argument->get_ast_class() != "int" && 
-                argument->get_ast_class() != "float" && 
-                argument->get_ast_class() != "char" && 
-                argument->get_ast_class() != "string" && 
-                argument->get_ast_class() != "bool") 
+            if (!ast::is_literal(argument.get())) 
             {
                 argument->semantic_analysis();
             }
 
             if(argument->get_expr_type() != sem_analysis_scope::get_param_type(func_name, current_param)) {
-                utility::sem_analysis_error("Argument in function call does not match exprected parameter type", parser::current_line);
+                utility::sem_analysis_error("Argument in function call does not match exprected parameter type", get_location());
             }
 
             current_param++;
@@ -467,9 +634,9 @@ namespace ast {
      */
     void ast::graph_decl_expr::semantic_analysis() {
         if (sem_analysis_scope::variable_exists_in_current_scope(graph_name)) {
-            utility::sem_analysis_error("Graph defined as another identifier in the current scope", parser::current_line);
+            utility::sem_analysis_error("Graph defined as another identifier in the current scope", get_location());
         }   
-        sem_analysis_scope::add_var_to_current_scope(graph_name, type, true, "graph");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(graph_name, type, true, interner::intern("graph")));
     }
 
     /**
@@ -477,51 +644,78 @@ namespace ast {
      * @par Simply adds a list declaration to the current semantic analysis scope.
      * @code
         if (sem_analysis_scope::variable_exists_in_current_scope(identifier_name)) {
-            utility::sem_analysis_error("List defined as another identifier in the current scope", parser::current_line);
+            utility::sem_analysis_error("List defined as another identifier in the current scope", get_location());
         }   
-        sem_analysis_scope::add_var_to_current_scope(name, type, true, "list");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(name, type, true, interner::intern("list")));
      * @endcode
      */
     void ast::list_decl::semantic_analysis() {
         if (sem_analysis_scope::variable_exists_in_current_scope(name)) {
-            utility::sem_analysis_error("List defined as another identifier in the current scope", parser::current_line);
+            utility::sem_analysis_error("List defined as another identifier in the current scope", get_location());
         }   
-        sem_analysis_scope::add_var_to_current_scope(name, type, true, "list");
+        set_slot(sem_analysis_scope::add_var_to_current_scope(name, type, true, interner::intern("list")));
     }
 
     /**
      * @fn ast::method_dot_call::semantic_analysis()
-     * @par Semantically analyzes method dot calls to resolve type and make sure that they are valid by checking if the variable exists, and making sure that the method corresponds to the correct type.
+     * @par Semantically analyzes method dot calls by resolving the method from the object's data type, the type of the values it holds and the method name in one lookup, which gives the type of the call, the types its arguments must have and the function codegen calls.
      * @code
-        if(!sem_analysis_scope::var_exists(item_name)) {
-            utility::sem_analysis_error("Complex variable not found in scope stack", parser::current_line);
+        const sem_analysis_scope::scoped_variable* variable = sem_analysis_scope::lookup_var(item_name);
+        if (variable == nullptr) {
+            utility::sem_analysis_error("Complex variable not found in scope stack", get_location());
+        }
+        aggregate_type = variable->info.complex_dt;
+        obj_type = variable->info.type;
+        slot = variable->slot;
+
+        const sem_analysis_scope::dot_call_target* method = sem_analysis_scope::find_dot_call({aggregate_type, obj_type, called});
+        if (method == nullptr) {
+            utility::sem_analysis_error("Invalid method called on type (" + interner::name(aggregate_type) + ")", get_location());
         }
+        if (args.size() != method->parameter_types.size()) {
+            utility::sem_analysis_error("Number of arguments in method call do not match the method (" + interner::name(called) + ")", get_location());
+        }
+        type = method->return_type;
+        callee = method->function;
+
+        for (std::size_t i = 0; i < args.size(); i++) {
+            if (!ast::is_literal(args[i].get())) {
+                args[i]->semantic_analysis();
+            }
 
-        aggregate_type = sem_analysis_scope::get_var_complex_dt(item_name);
-        type = sem_analysis_scope::get_var_type(item_name);
-        //std::cout << aggregate_type << " " << called << "\n";
-        if (!sem_analysis_scope::method_valid_dot_call(aggregate_type, called)) {
-            utility::sem_analysis_error("Invalid method called on type (" + aggregate_type + ")", parser::current_line);
+            if (args[i]->get_expr_type() != method->parameter_types[i]) {
+                utility::sem_analysis_error("Argument in method call does not match expected parameter type of the method (" + interner::name(called) + ")", get_location());
+            }
         }
      * @endcode
      */
     void ast::method_dot_call::semantic_analysis() {
-        if(!sem_analysis_scope::var_exists(item_name)) {
-            utility::sem_analysis_error("Complex variable not found in scope stack", parser::current_line);
+        const sem_analysis_scope::scoped_variable* variable = sem_analysis_scope::lookup_var(item_name);
+        if (variable == nullptr) {
+            utility::sem_analysis_error("Complex variable not found in scope stack", get_location());
         }
-        aggregate_type = sem_analysis_scope::get_var_complex_dt(item_name);
+        aggregate_type = variable->info.complex_dt;
+        obj_type = variable->info.type;
+        slot = variable->slot;
 
-        type_enum::types intermediate_type = sem_analysis_scope::get_dot_call_type(aggregate_type, called);
-        if (intermediate_type == type_enum::obj_type) {
-            type = sem_analysis_scope::get_var_type(item_name);
-        } else {
-            type = intermediate_type;
+        const sem_analysis_scope::dot_call_target* method = sem_analysis_scope::find_dot_call({aggregate_type, obj_type, called});
+        if (method == nullptr) {
+            utility::sem_analysis_error("Invalid method called on type (" + interner::name(aggregate_type) + ")", get_location());
         }
+        if (args.size() != method->parameter_types.size()) {
+            utility::sem_analysis_error("Number of arguments in method call do not match the method (" + interner::name(called) + ")", get_location());
+        }
+        type = method->return_type;
+        callee = method->function;
+
+        for (std::size_t i = 0; i < args.size(); i++) {
+            if (!ast::is_literal(args[i].get())) {
+                args[i]->semantic_analysis();
+            }
 
-        obj_type = sem_analysis_scope::get_var_type(item_name);
-        //std::cout << aggregate_type << " " << called << "\n";
-        if (!sem_analysis_scope::method_valid_dot_call(aggregate_type, called)) {
-            utility::sem_analysis_error("Invalid method called on type (" + aggregate_type + ")", parser::current_line);
+            if (args[i]->get_expr_type() != method->parameter_types[i]) {
+                utility::sem_analysis_error("Argument in method call does not match expected parameter type of the method (" + interner::name(called) + ")", get_location());
+            }
         }
     }
 
@@ -8,15 +8,21 @@ If LICENSE.md is not included, this version of the source code is provided in br
 
 
 #include "../include/utility/utility.h"
+#include <algorithm>
 #include <csignal>
 #include <unistd.h>
 #include <cstdlib>  
 #include <iostream> 
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include "../include/thread_pool/thread_pool.h"
+#include "../include/ast_cache/ast_cache.h"
+#include "../include/module_interface/module_interface.h"
 
 namespace utility {
 
-    std::set<std::string> library_and_include;
-
     /**
      * @par Gets called to abort if input file does not have a .pyrx extension.
      * 
@@ -32,33 +38,79 @@ namespace utility {
         exit(1);
     }
 
+    /**
+     * @par Gets called to abort if an included module cannot be found, read or built.
+     * 
+     * @code
+        std::cout <<"\033[1;31m";
+        std::cout << "Module error: " << message << file_name << "\n";
+        exit(1);
+     * @endcode
+     */
+    void module_error(const std::string& message, const std::string& file_name) {
+        std::cout <<"\033[1;31m";
+        std::cout << "Module error: " << message << file_name << "\n";
+        exit(1);
+    }
+
     /**
      * @par Gets called to abort if the number of arguments provided in CMD line is invalid.
      * 
      * @code
      *  std::cout <<"\033[1;31m";
-        std::cout << "Driver error: " << num_args - 1 << " provided, but only expected relative path to .pyrx file.\n";
+        std::cout << "Driver error: " << num_args - 1 << " provided, but expected relative paths to one or more .pyrx files.\n";
         exit(1);
      * @endcode
      */
     void driver_args_error(const int num_args) {
         std::cout <<"\033[1;31m";
-        std::cout << "Driver error: " << num_args - 1 << " provided, but only expected relative path to .pyrx file.\n";
+        std::cout << "Driver error: " << num_args - 1 << " provided, but expected relative paths to one or more .pyrx files.\n";
         exit(1);
     }
     
+    thread_local lexer::lexer_state* diagnostic_source = nullptr;
+    thread_local bool defer_lexer_errors = false;
+    thread_local bool defer_parser_errors = false;
+    thread_local bool defer_sem_analysis_errors = false;
+
+    namespace {
+        /**
+         * @par Formats where an error happened, resolving the location against `diagnostic_source`. Errors without a location (or once the source is gone) just leave it out.
+         * @code
+            if (location == lexer::no_location || diagnostic_source == nullptr || location > diagnostic_source->source.size()) {
+                return "";
+            }
+            lexer::source_position position = lexer::locate(*diagnostic_source, location);
+            return " on line " + std::to_string(position.line) + ", column " + std::to_string(position.column);
+         * @endcode
+         */
+        std::string describe_location(lexer::source_location location) {
+            if (location == lexer::no_location || diagnostic_source == nullptr || location > diagnostic_source->source.size()) {
+                return "";
+            }
+            lexer::source_position position = lexer::locate(*diagnostic_source, location);
+            return " on line " + std::to_string(position.line) + ", column " + std::to_string(position.column);
+        }
+    }
+
     /**
      * @par Thrown to abort if lexing fails.
      * 
      * @code
+        if (defer_lexer_errors) {
+            throw deferred_lexer_error{message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Lexer error: " << message << " on line " << line << "\n";
+        std::cout << "Lexer error: " << message << describe_location(location) << "\n";
         exit(1);
      * @endcode
      */
-    void lexer_error(const std::string& message, int line) {
+    void lexer_error(const std::string& message, lexer::source_location location) {
+        if (defer_lexer_errors) {
+            throw deferred_lexer_error{message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Lexer error: " << message << " on line " << line << "\n";
+        std::cout << "Lexer error: " << message << describe_location(location) << "\n";
         exit(1);
     }
 
@@ -66,14 +118,20 @@ namespace utility {
      * @par Thrown to abort if parsing fails.
      * 
      * @code
+        if (defer_parser_errors) {
+            throw deferred_parser_error{message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Parser error: " << message << " on line " << line << "\n";
+        std::cout << "Parser error: " << message << describe_location(location) << "\n";
         exit(1);
      * @endcode
      */
-    void parser_error(const std::string& message, int line) {
+    void parser_error(const std::string& message, lexer::source_location location) {
+        if (defer_parser_errors) {
+            throw deferred_parser_error{message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Parser error: " << message << " on line " << line << "\n";
+        std::cout << "Parser error: " << message << describe_location(location) << "\n";
         exit(1);
     }
 
@@ -82,13 +140,13 @@ namespace utility {
      * 
      * @code
         std::cout <<"\033[1;31m";
-        std::cout << "Codegen error: " << message << " on line " << line << "\n";
+        std::cout << "Codegen error: " << message << describe_location(location) << "\n";
         exit(1);
      * @endcode
      */
-    void codegen_error(const std::string& message, int line) {
+    void codegen_error(const std::string& message, lexer::source_location location) {
         std::cout <<"\033[1;31m";
-        std::cout << "Codegen error: " << message << " on line " << line << "\n";
+        std::cout << "Codegen error: " << message << describe_location(location) << "\n";
         exit(1);
     }
 
@@ -96,20 +154,41 @@ namespace utility {
      * @par Thrown to abort if scoping fails.
      * 
      * @code
+        if (defer_sem_analysis_errors) {
+            throw deferred_sem_analysis_error{true, message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Scoping error: " << message << " on line " << line << "\n";
+        std::cout << "Scoping error: " << message << describe_location(location) << "\n";
         exit(1);
      * @endcode
      */
-    void scoping_error(const std::string& message, int line) {
+    void scoping_error(const std::string& message, lexer::source_location location) {
+        if (defer_sem_analysis_errors) {
+            throw deferred_sem_analysis_error{true, message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Scoping error: " << message << " on line " << line << "\n";
+        std::cout << "Scoping error: " << message << describe_location(location) << "\n";
         exit(1);
     }
 
-    void sem_analysis_error(const std::string& message, int line) {
+    /**
+     * @par Thrown to abort if semantic analysis fails.
+     * 
+     * @code
+        if (defer_sem_analysis_errors) {
+            throw deferred_sem_analysis_error{false, message, location};
+        }
         std::cout <<"\033[1;31m";
-        std::cout << "Semantic analysis error: " << message << " on line " << line << "\n";
+        std::cout << "Semantic analysis error: " << message << describe_location(location) << "\n";
+        exit(1);
+     * @endcode
+     */
+    void sem_analysis_error(const std::string& message, lexer::source_location location) {
+        if (defer_sem_analysis_errors) {
+            throw deferred_sem_analysis_error{false, message, location};
+        }
+        std::cout <<"\033[1;31m";
+        std::cout << "Semantic analysis error: " << message << describe_location(location) << "\n";
         exit(1);
     }
 
@@ -117,28 +196,46 @@ namespace utility {
      * @par Spits out the current token to OStream.
      * 
      * @code
-        std::cout << parser::current_token << "\n";
+        std::cout << ctx.parser.current_token << "\n";
      * @endcode
      */
-    void output_current_token() {
-        std::cout << parser::current_token << "\n";
+    void output_current_token(const context::compilation_context& ctx) {
+        std::cout << ctx.parser.current_token << "\n";
     }
 
     /**
-     * @par Where operator precednce map is defined (Higher values called later)
+     * @par Where operator precedence is defined (higher values bind tighter). Operators sharing a level are left associative.
      * 
      * @code
-        parser::operator_precedence.insert({lexer::tok_plus, 100});
-        parser::operator_precedence.insert({lexer::tok_minus, 200});
-        parser::operator_precedence.insert({lexer::tok_mult, 300});
-        parser::operator_precedence.insert({lexer::tok_div, 400});
+        parser::operator_precedence[parser::precedence_index(lexer::tok_or)] = 10;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_and)] = 20;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_equal)] = 30;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_not_equal)] = 30;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_less)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_less_equal)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_greater)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_greater_equal)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_plus)] = 50;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_minus)] = 50;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_mult)] = 60;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_div)] = 60;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_mod)] = 60;
      * @endcode
      */
     void initialize_operator_precendence() {
-        parser::operator_precedence.insert({lexer::tok_plus, 100});
-        parser::operator_precedence.insert({lexer::tok_minus, 200});
-        parser::operator_precedence.insert({lexer::tok_mult, 300});
-        parser::operator_precedence.insert({lexer::tok_div, 400});
+        parser::operator_precedence[parser::precedence_index(lexer::tok_or)] = 10;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_and)] = 20;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_equal)] = 30;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_not_equal)] = 30;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_less)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_less_equal)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_greater)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_greater_equal)] = 40;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_plus)] = 50;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_minus)] = 50;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_mult)] = 60;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_div)] = 60;
+        parser::operator_precedence[parser::precedence_index(lexer::tok_mod)] = 60;
     }
 
     /**
@@ -179,77 +276,494 @@ namespace utility {
      * @par Initializes all values in the parser token getter method.
      * 
      * @code
-        parser::current_token_index = 0;
-        parser::current_token_as_token = lexer::token_stream.at(parser::current_token_index);
-        parser::current_value = lexer::stored_values.at(parser::current_token_index);
-        parser::current_line = lexer::line_count_vec.at(parser::current_token_index);
-        parser::current_token = parser::current_token_as_token;
+        diagnostic_source = &ctx.lexer;
+        ctx.parser.source = &ctx.lexer;
+        ctx.parser.current_token_index = 0;
+        ctx.parser.current_token_record = ctx.lexer.token_stream.data();
+        ctx.parser.current_token_as_token = ctx.parser.current_token_record->kind;
+        parser::current_location = ctx.parser.current_token_record->location;
+        ctx.parser.current_token = ctx.parser.current_token_as_token;
+        ctx.parser.token_index_max = ctx.lexer.token_stream.size();
      * @endcode
      */
-    void init_parser() {
-        parser::current_token_index = 0;
-        parser::current_token_as_token = lexer::token_stream.at(parser::current_token_index);
-        parser::current_value = lexer::stored_values.at(parser::current_token_index);
-        parser::current_line = lexer::line_count_vec.at(parser::current_token_index);
-        parser::current_token = parser::current_token_as_token;
+    void init_parser(context::compilation_context& ctx) {
+        diagnostic_source = &ctx.lexer;
+        ctx.parser.source = &ctx.lexer;
+        ctx.parser.current_token_index = 0;
+        ctx.parser.current_token_record = ctx.lexer.token_stream.data();
+        ctx.parser.current_token_as_token = ctx.parser.current_token_record->kind;
+        parser::current_location = ctx.parser.current_token_record->location;
+        ctx.parser.current_token = ctx.parser.current_token_as_token;
+        ctx.parser.token_index_max = ctx.lexer.token_stream.size();
     }
 
     /**
-     * @par This is called in both drivers (entrypoints), that takes in the current token stored in `parser::current_token`, and calls the correct parsing function and codegen if applicable.
+     * @par This is called in both drivers (entrypoints), that takes in the current token stored in `ctx.parser.current_token`, and calls the correct parsing function and codegen if applicable.
      * 
      * @code
-     *  process_includes();
+     *  process_includes(ctx);
      * 
         sem_analysis_scope::create_scope();
-        parser::get_next_token();
+        for (const module_interface::interface* module : ctx.modules) {
+            module_interface::import_semantics(*module);
+            module_interface::declare_exports(*module);
+        }
 
-        std::vector<std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>> parsing_output = parse_top_level();
+        std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parsing_output = parse_top_level(ctx);
 
-        for (auto const& ast_node : parsing_output) {
-            call_sem_analysis(ast_node);
-        }
+        analyze_program(parsing_output);
+
+        passes::pass_manager<passes::constant_folding, passes::purity_analysis> analyses;
+        analyses.run(parsing_output);
+        #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+            report_pass_timings(analyses.timings(), analyses.node_count(), analyses.total_seconds());
+        #endif
+
+        ctx.pure_functions = analyses.get<passes::purity_analysis>().pure();
 
         sem_analysis_scope::exit_scope();
+        module_interface::collect_exports(ctx, parsing_output);
+
+        if (!ctx.cache_key.empty()) {
+            ast_cache::store(ctx, parsing_output);
+        }
 
         for (auto const& ast_node : parsing_output) {
             call_codegen(ast_node);
         }
+        mark_pure_functions(ctx.pure_functions);
      * @endcode
      */
 
-    void primary_driver_loop() {
-        parser::get_next_token();
-        process_includes();
-        link_bc_module();
+    void primary_driver_loop(context::compilation_context& ctx) {
+        parser::get_next_token(ctx);
+        process_includes(ctx);
+        link_bc_module(ctx);
 
         sem_analysis_scope::create_scope();
+        for (const module_interface::interface* module : ctx.modules) {
+            module_interface::import_semantics(*module);
+            module_interface::declare_exports(*module);
+        }
 
-        std::vector<std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>> parsing_output = parse_top_level();
+        std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parsing_output = parse_top_level(ctx);
 
-        for (auto const& ast_node : parsing_output) {
-            call_sem_analysis(ast_node);
-        }
+        analyze_program(parsing_output);
+
+        passes::pass_manager<passes::constant_folding, passes::purity_analysis> analyses; // every pass over the checked tree shares this one walk
+        analyses.run(parsing_output); // codegen and the cache only ever see the folded tree
+        #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+            report_pass_timings(analyses.timings(), analyses.node_count(), analyses.total_seconds());
+        #endif
+
+        ctx.pure_functions = analyses.get<passes::purity_analysis>().pure();
 
         sem_analysis_scope::exit_scope();
+        module_interface::collect_exports(ctx, parsing_output);
+
+        if (!ctx.cache_key.empty()) {
+            ast_cache::store(ctx, parsing_output); // the tree is complete and checked, so the next compile of this source can start from here
+        }
 
         for (auto const& ast_node : parsing_output) {
             call_codegen(ast_node);
         }
+        mark_pure_functions(ctx.pure_functions);
+    }
+
+    /**
+     * @par The counterpart of `primary_driver_loop()` for a unit whose analyzed tree came out of the AST cache: the included libraries are still built and linked (and included modules declared), but lexing, parsing and semantic analysis are skipped and codegen runs on `program` directly. The functions to mark pure are the ones `ast_cache::load()` found in the flat tree.
+     * @code
+        build_includes(ctx);
+        link_bc_module(ctx);
+        for (const module_interface::interface* module : ctx.modules) {
+            module_interface::declare_exports(*module);
+        }
+        module_interface::collect_exports(ctx, program);
+
+        for (auto const& ast_node : program) {
+            call_codegen(ast_node);
+        }
+        mark_pure_functions(ctx.pure_functions); // worked out from the flat tree as it was loaded
+     * @endcode
+     */
+    void cached_driver_loop(context::compilation_context& ctx, const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        build_includes(ctx);
+        link_bc_module(ctx);
+        for (const module_interface::interface* module : ctx.modules) {
+            module_interface::declare_exports(*module);
+        }
+        module_interface::collect_exports(ctx, program);
+
+        for (auto const& ast_node : program) {
+            call_codegen(ast_node);
+        }
+        mark_pure_functions(ctx.pure_functions); // worked out from the flat tree as it was loaded
+    }
+
+    /**
+     * @par Compiles one file whose source has already been loaded into `ctx.lexer`, leaving the finished LLVM context and module in `ctx`. Codegen and semantic analysis state is thread local, so several units can be compiled at once as long as each one stays on a single thread.
+     * If the AST cache holds the analyzed tree of this exact source (for this build of the compiler), codegen starts from it; otherwise the file is compiled from scratch and its tree is cached on the way through.
+     * 
+     * @code
+        scope::reset();
+        sem_analysis_scope::sem_analysis_stack.clear();
+        sem_analysis_scope::defined_functions.clear();
+        sem_analysis_scope::valid_dot_calls.clear();
+
+        ctx.cache_key = ast_cache::cache_key(ctx.lexer.source, ctx.file_name);
+
+        init_llvm_mods();
+        {
+            arena::arena_scope ast_scope(ctx.ast_arena);
+            std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> cached_program;
+            if (!ctx.cache_key.empty() && ast_cache::load(ctx, cached_program)) {
+                diagnostic_source = &ctx.lexer;
+                cached_driver_loop(ctx, cached_program);
+            } else {
+                lexer::tokenize_file(ctx.lexer);
+                init_parser(ctx);
+                primary_driver_loop(ctx);
+            }
+        }
+        ctx.ast_arena.release();
+
+        lexer::release_source(ctx.lexer);
+
+        ctx.LLVM_Module = std::move(codegen::LLVM_Module);
+        ctx.LLVM_Context = std::move(codegen::LLVM_Context);
+        codegen::IR_Builder.reset();
+     * @endcode
+     */
+    void compile_translation_unit(context::compilation_context& ctx) {
+        scope::reset(); // a worker thread may have compiled another unit before this one
+        sem_analysis_scope::sem_analysis_stack.clear();
+        sem_analysis_scope::defined_functions.clear();
+        sem_analysis_scope::valid_dot_calls.clear();
+
+        ctx.cache_key = ast_cache::cache_key(ctx.lexer.source, ctx.file_name);
+
+        init_llvm_mods();
+        {
+            arena::arena_scope ast_scope(ctx.ast_arena); // the AST is built in this unit's arena...
+            std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> cached_program;
+            if (!ctx.cache_key.empty() && ast_cache::load(ctx, cached_program)) {
+                diagnostic_source = &ctx.lexer; // codegen errors still point into the source
+                cached_driver_loop(ctx, cached_program);
+            } else {
+                lexer::tokenize_file(ctx.lexer);
+                init_parser(ctx);
+                primary_driver_loop(ctx);
+            }
+        }
+        ctx.ast_arena.release(); // ...and freed all at once here, without visiting a single node
+
+        lexer::release_source(ctx.lexer); // only kept this long so that codegen errors can still be resolved to lines and columns
+
+        ctx.LLVM_Module = std::move(codegen::LLVM_Module);
+        ctx.LLVM_Context = std::move(codegen::LLVM_Context);
+        codegen::IR_Builder.reset();
+    }
+
+    /**
+     * @par Parses a single top level statement or function definition starting at the current token, appending it to `parsing_output`. Stray semicolons are consumed without producing a node. Returns false once the current token is EOF.
+     * The statement is parsed from the tokens alone, so parsing from the first token of any statement gives the same nodes `parse_top_level()` would.
+     * @code
+            #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+                if (ctx.parser.current_token != lexer::tok_eof && ctx.parser.current_token != lexer::tok_semicolon && ctx.parser.current_token != lexer::tok_def) {
+                    std::cout << "\033[32m\nParsing New Statement:\033[0m\n";
+                } else if (ctx.parser.current_token == lexer::tok_def) {
+                    std::cout << "\033[32m\nParsing New Function:\033[0m\n";
+                }
+            #endif
+            
+            ast::node_ptr<ast::top_level_expr> expr = nullptr;  
+            ast::node_ptr<ast::func_defn> func = nullptr;  
+            lexer::source_location statement_location = ctx.parser.current_token_record->location;
+            std::size_t output_size = parsing_output.size();
+
+            switch(ctx.parser.current_token) {
+                case lexer::tok_eof: // if its the end of the file, there is nothing left to parse
+                    return false;
+                case lexer::tok_semicolon:
+                    parser::get_next_token(ctx); // ignore semicolons and get the next token...
+                    break; 
+                case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool:
+                    expr = parser::parse_var_decl_defn(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                case lexer::tok_identifier: 
+                    if (parser::peek_next_token(ctx) == lexer::tok_assignment) {
+                        expr = parser::parse_var_assign(ctx);
+                        parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                        break;
+                    } else if (parser::peek_next_token(ctx) == lexer::tok_dot) {
+                        expr = parser::parse_method_dot_call(ctx);
+                        parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                        break;
+                    } else{
+                        expr = parser::parse_expression(ctx);
+                        parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                        break;
+                    }
+                case lexer::tok_def:
+                    func = parser::parse_function(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(func)));
+                    break;     
+                case lexer::tok_return:
+                    expr = parser::parse_return(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                case lexer::tok_if:
+                    expr = parser::parse_if(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                case lexer::tok_print:
+                    expr = parser::parse_print(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                default:
+                    expr = parser::parse_expression(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+            }
+
+            if (parsing_output.size() > output_size && std::holds_alternative<ast::node_ptr<ast::top_level_expr>>(parsing_output.back())) {
+                std::get<0>(parsing_output.back())->set_location(statement_location);
+            }
+
+            return true;
+     * @endcode
+     */
+    bool parse_top_level_statement(context::compilation_context& ctx, std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& parsing_output) {
+        #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+            if (ctx.parser.current_token != lexer::tok_eof && ctx.parser.current_token != lexer::tok_semicolon && ctx.parser.current_token != lexer::tok_def) {
+                std::cout << "\033[32m\nParsing New Statement:\033[0m\n";
+            } else if (ctx.parser.current_token == lexer::tok_def) {
+                std::cout << "\033[32m\nParsing New Function:\033[0m\n";
+            }
+        #endif
+        
+        ast::node_ptr<ast::top_level_expr> expr = nullptr;  
+        ast::node_ptr<ast::func_defn> func = nullptr;  
+        lexer::source_location statement_location = ctx.parser.current_token_record->location;
+        std::size_t output_size = parsing_output.size();
+
+        switch(ctx.parser.current_token) {
+            case lexer::tok_eof: // if its the end of the file, there is nothing left to parse
+                return false;
+            case lexer::tok_semicolon:
+                parser::get_next_token(ctx); // ignore semicolons and get the next token...
+                break; 
+            case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool:
+                expr = parser::parse_var_decl_defn(ctx);
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                break;
+            case lexer::tok_identifier: 
+                if (parser::peek_next_token(ctx) == lexer::tok_assignment) {
+                    expr = parser::parse_var_assign(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                } else if (parser::peek_next_token(ctx) == lexer::tok_dot) {
+                    expr = parser::parse_method_dot_call(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                } else{
+                    expr = parser::parse_expression(ctx);
+                    parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                    break;
+                }
+            case lexer::tok_def:
+                func = parser::parse_function(ctx);
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(func)));
+                break;     
+            case lexer::tok_return:
+                expr = parser::parse_return(ctx);
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                break;
+            case lexer::tok_if:
+                expr = parser::parse_if(ctx);
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                break;
+            case lexer::tok_print:
+                expr = parser::parse_print(ctx);
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                break;
+            default:
+                expr = parser::parse_expression(ctx);
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(expr)));
+                break;
+        }
+
+        if (parsing_output.size() > output_size && std::holds_alternative<ast::node_ptr<ast::top_level_expr>>(parsing_output.back())) {
+            std::get<0>(parsing_output.back())->set_location(statement_location); // where diagnostics about the statement point
+        }
+
+        return true;
     }
 
     namespace {
 
         /**
-         * TODO: docs
+         * @par Serializes standard library builds and links between units compiled at the same time, and remembers which libraries have already been built and linked by this process.
          */
-        void link_bc_module() {
+        std::mutex include_mutex;
+        std::set<std::string> built_includes;
+        std::set<std::string> linked_includes;
+
+        /**
+         * @par Every unit that includes a library links in its own copy. The first copy keeps strong definitions, and later copies are made weak so the JIT resolves every unit to a single definition.
+         * @code
+            std::lock_guard<std::mutex> lock(include_mutex);
+            if (linked_includes.insert(library).second) {
+                return;
+            }
+            for (llvm::Function& function : library_module) {
+                if (!function.isDeclaration() && !function.hasLocalLinkage()) {
+                    function.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+                }
+            }
+            for (llvm::GlobalVariable& global : library_module.globals()) {
+                if (!global.isDeclaration() && !global.hasLocalLinkage()) {
+                    global.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+                }
+            }
+         * @endcode
+         */
+        void weaken_duplicate_library(const std::string& library, llvm::Module& library_module) {
+            std::lock_guard<std::mutex> lock(include_mutex);
+            if (linked_includes.insert(library).second) {
+                return;
+            }
+            for (llvm::Function& function : library_module) {
+                if (!function.isDeclaration() && !function.hasLocalLinkage()) {
+                    function.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+                }
+            }
+            for (llvm::GlobalVariable& global : library_module.globals()) {
+                if (!global.isDeclaration() && !global.hasLocalLinkage()) {
+                    global.setLinkage(llvm::GlobalValue::WeakODRLinkage);
+                }
+            }
+        }
+
+        /**
+         * @par Prints what each pass of the driver's pass manager cost, out of the walk they shared.
+         * @code
+            std::cout << "\033[32m\nPasses over " << node_count << " nodes: " << total_seconds * 1e3 << " ms\033[0m\n";
+            for (const passes::pass_timing& timing : timings) {
+                std::cout << "  " << timing.name << ": " << timing.seconds * 1e3 << " ms\n";
+            }
+         * @endcode
+         */
+        void report_pass_timings(const std::vector<passes::pass_timing>& timings, std::size_t node_count, double total_seconds) {
+            std::cout << "\033[32m\nPasses over " << node_count << " nodes: " << total_seconds * 1e3 << " ms\033[0m\n";
+            for (const passes::pass_timing& timing : timings) {
+                std::cout << "  " << timing.name << ": " << timing.seconds * 1e3 << " ms\n";
+            }
+        }
+
+        /**
+         * @par Tells LLVM which of the functions just generated never touch memory their callers can see, as `passes::purity_analysis` found them. Their locals are allocas of their own, which that still allows.
+         * @code
+            for (interner::symbol_id function_name : pure_functions) {
+                llvm::Function* function = codegen::LLVM_Module->getFunction(interner::name(function_name));
+                if (function != nullptr && !function->isDeclaration()) {
+                    function->setDoesNotAccessMemory();
+                }
+            }
+         * @endcode
+         */
+        void mark_pure_functions(const std::unordered_set<interner::symbol_id>& pure_functions) {
+            for (interner::symbol_id function_name : pure_functions) {
+                llvm::Function* function = codegen::LLVM_Module->getFunction(interner::name(function_name));
+                if (function != nullptr && !function->isDeclaration()) {
+                    function->setDoesNotAccessMemory();
+                }
+            }
+        }
+
+        /**
+         * @struct library_method
+         * @par A method of a standard library data type: its name, what a call of it evaluates to, the types of the arguments it takes (`type_enum::obj_type` for an element of the object, in both), and the mangled name of the function implementing it for each of `library_element_types`.
+         */
+        typedef struct {
+            const char* name;
+            type_enum::types return_type;
+            std::vector<type_enum::types> parameter_types;
+            const char* functions[4];
+        } library_method;
+
+        constexpr type_enum::types library_element_types[4] = {type_enum::int_type, type_enum::float_type, type_enum::char_type, type_enum::bool_type};
+
+        const library_method list_methods[] = {
+            {"add", type_enum::void_type, {type_enum::obj_type, type_enum::int_type}, {"_ZN9slib_listIiE6insertEii", "_ZN9slib_listIdE6insertEdi", "_ZN9slib_listIcE6insertEci", "_ZN9slib_listIbE6insertEbi"}},
+            {"at", type_enum::obj_type, {type_enum::int_type}, {"_ZN9slib_listIiE2atEi", "_ZN9slib_listIdE2atEi", "_ZN9slib_listIcE2atEi", "_ZN9slib_listIbE2atEi"}},
+            {"remove", type_enum::obj_type, {type_enum::int_type}, {"_ZN9slib_listIiE6removeEi", "_ZN9slib_listIdE6removeEi", "_ZN9slib_listIcE6removeEi", "_ZN9slib_listIbE6removeEi"}},
+            {"size", type_enum::int_type, {}, {"_ZN9slib_listIiE4sizeEv", "_ZN9slib_listIdE4sizeEv", "_ZN9slib_listIcE4sizeEv", "_ZN9slib_listIbE4sizeEv"}},
+        };
+
+        const library_method graph_methods[] = {
+            {"addNode", type_enum::void_type, {type_enum::obj_type}, {"_ZN10slib_graphIiE6insertEi", "_ZN10slib_graphIdE6insertEd", "_ZN10slib_graphIcE6insertEc", "_ZN10slib_graphIbE6insertEb"}},
+            {"addEdge", type_enum::void_type, {type_enum::obj_type, type_enum::obj_type}, {"_ZN10slib_graphIiE8add_edgeEii", "_ZN10slib_graphIdE8add_edgeEdd", "_ZN10slib_graphIcE8add_edgeEcc", "_ZN10slib_graphIbE8add_edgeEbb"}},
+            {"removeNode", type_enum::void_type, {type_enum::obj_type}, {"_ZN10slib_graphIiE6removeEi", "_ZN10slib_graphIdE6removeEd", "_ZN10slib_graphIcE6removeEc", "_ZN10slib_graphIbE6removeEb"}},
+            {"removeEdge", type_enum::void_type, {type_enum::obj_type, type_enum::obj_type}, {"_ZN10slib_graphIiE11remove_edgeEii", "_ZN10slib_graphIdE11remove_edgeEdd", "_ZN10slib_graphIcE11remove_edgeEcc", "_ZN10slib_graphIbE11remove_edgeEbb"}},
+            {"numEdges", type_enum::int_type, {}, {"_ZN10slib_graphIiE9num_edgesEv", "_ZN10slib_graphIdE9num_edgesEv", "_ZN10slib_graphIcE9num_edgesEv", "_ZN10slib_graphIbE9num_edgesEv"}},
+            {"printBFS", type_enum::void_type, {type_enum::obj_type}, {"_ZN10slib_graphIiE9print_BFSEi", "_ZN10slib_graphIdE9print_BFSEd", "_ZN10slib_graphIcE9print_BFSEc", "_ZN10slib_graphIbE9print_BFSEb"}},
+            {"printDFS", type_enum::void_type, {type_enum::obj_type}, {"_ZN10slib_graphIiE9print_DFSEi", "_ZN10slib_graphIdE9print_DFSEd", "_ZN10slib_graphIcE9print_DFSEc", "_ZN10slib_graphIbE9print_DFSEb"}},
+            {"size", type_enum::int_type, {}, {"_ZN10slib_graphIiE4sizeEv", "_ZN10slib_graphIdE4sizeEv", "_ZN10slib_graphIcE4sizeEv", "_ZN10slib_graphIbE4sizeEv"}},
+            {"containsNode", type_enum::bool_type, {type_enum::obj_type}, {"_ZN10slib_graphIiE13contains_nodeEi", "_ZN10slib_graphIdE13contains_nodeEd", "_ZN10slib_graphIcE13contains_nodeEc", "_ZN10slib_graphIbE13contains_nodeEb"}},
+        };
+
+        /**
+         * @par Makes the methods of a data type callable, once its library has been linked into the unit's module. Each method is added for every element type along with the function implementing it, so neither semantic analysis nor codegen has to look anything up by name again.
+         * @param aggregate_type The name of the data type ("list", "graph").
+         * @param methods The methods of the data type.
+         * @code
+         *  interner::symbol_id aggregate = interner::intern(aggregate_type);
+            for (const library_method& method : methods) {
+                interner::symbol_id method_name = interner::intern(method.name);
+                for (std::size_t i = 0; i < std::size(library_element_types); i++) {
+                    type_enum::types element_type = library_element_types[i];
+                    type_enum::types return_type = method.return_type == type_enum::obj_type ? element_type : method.return_type;
+                    std::vector<type_enum::types> parameter_types;
+                    for (type_enum::types parameter_type : method.parameter_types) {
+                        parameter_types.push_back(parameter_type == type_enum::obj_type ? element_type : parameter_type);
+                    }
+                    sem_analysis_scope::add_method_to_valid_dot_calls({aggregate, element_type, method_name}, return_type, std::move(parameter_types), codegen::LLVM_Module->getFunction(method.functions[i]));
+                }
+            }
+         * @endcode
+         */
+        template <std::size_t method_count>
+        void register_library_methods(const char* aggregate_type, const library_method (&methods)[method_count]) {
+            interner::symbol_id aggregate = interner::intern(aggregate_type);
+            for (const library_method& method : methods) {
+                interner::symbol_id method_name = interner::intern(method.name);
+                for (std::size_t i = 0; i < std::size(library_element_types); i++) {
+                    type_enum::types element_type = library_element_types[i];
+                    type_enum::types return_type = method.return_type == type_enum::obj_type ? element_type : method.return_type;
+                    std::vector<type_enum::types> parameter_types;
+                    for (type_enum::types parameter_type : method.parameter_types) {
+                        parameter_types.push_back(parameter_type == type_enum::obj_type ? element_type : parameter_type);
+                    }
+                    sem_analysis_scope::add_method_to_valid_dot_calls({aggregate, element_type, method_name}, return_type, std::move(parameter_types), codegen::LLVM_Module->getFunction(method.functions[i]));
+                }
+            }
+        }
+
+        /**
+         * @par Links the standard library modules the unit includes into its module, and registers the methods of each of their data types (see `register_library_methods()`).
+         */
+        void link_bc_module(context::compilation_context& ctx) {
             llvm::SMDiagnostic error;
-            for (const std::string& include_item : library_and_include) {
+            for (const std::string& include_item : ctx.library_and_include) {
                 std::string bc_path;
                 if (include_item == "list") {
                     
-                    if (library_and_include.find("graph") != library_and_include.end()) {
-                        return;
+                    if (ctx.library_and_include.find("graph") != ctx.library_and_include.end()) {
+                        register_library_methods("list", list_methods); // the graph module links the list in with it
+                        continue;
                     }
                     bc_path = "../pyroxene_slib/llvm_modules/list.bc";
                     //std::system("[ -e ./pyroxene_slib/llvm_modules/list.bc ] && echo 'here'");
@@ -261,17 +775,14 @@ namespace utility {
                         std::abort(); // add actually dedicated error function
                     }
 
-                    
+                    weaken_duplicate_library(include_item, *list_mod);
                     bool failed = llvm::Linker::linkModules(*codegen::LLVM_Module, std::move(list_mod));
                     if (failed) {
                         llvm::errs() << "Error linking module: " << bc_path << "\n";
                         std::abort();
                     }
                     
-                    sem_analysis_scope::add_method_to_valid_dot_calls("list", "add", type_enum::void_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("list", "at", type_enum::obj_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("list", "remove", type_enum::obj_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("list", "size", type_enum::int_type);
+                    register_library_methods("list", list_methods);
                 }
                 if (include_item == "graph") {
                     bc_path = "../pyroxene_slib/llvm_modules/graph.bc";
@@ -284,24 +795,14 @@ namespace utility {
                         std::abort(); // add actually dedicated error function
                     }
 
-                    
+                    weaken_duplicate_library(include_item, *graph_mod);
                     bool failed = llvm::Linker::linkModules(*codegen::LLVM_Module, std::move(graph_mod));
                     if (failed) {
                         llvm::errs() << "Error linking module: " << bc_path << "\n";
                         std::abort();
                     }
 
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "addNode", type_enum::void_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "addEdge", type_enum::void_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "removeNode", type_enum::void_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "removeEdge", type_enum::void_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "numEdges", type_enum::int_type);
-                    //sem_analysis_scope::add_method_to_valid_dot_calls("graph", "BFS");
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "printBFS", type_enum::void_type);
-                    //sem_analysis_scope::add_method_to_valid_dot_calls("graph", "DFS");
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "printDFS", type_enum::void_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "size", type_enum::int_type);
-                    sem_analysis_scope::add_method_to_valid_dot_calls("graph", "containsNode", type_enum::bool_type);
+                    register_library_methods("graph", graph_methods);
                 }
             }
         }
@@ -309,23 +810,54 @@ namespace utility {
         /**
          * TODO: docs
          */
-        void process_includes() {
-            while (parser::current_token == lexer::tok_include) {
-                std::string include_statement = parser::parse_include();
-                library_and_include.insert(include_statement);
+        void process_includes(context::compilation_context& ctx) {
+            while (ctx.parser.current_token == lexer::tok_include) {
+                std::string include_statement = parser::parse_include(ctx);
+                ctx.library_and_include.insert(include_statement);
             }
 
-            for (const std::string& include_item : library_and_include) {
-                compile_include_ir(include_item);
+            build_includes(ctx);
+        }
+
+        /**
+         * @par Builds the IR of every library the unit includes, and loads the interface of every module it includes (building the module first if its interface is missing or stale).
+         * @code
+            for (const std::string& include_item : ctx.library_and_include) {
+                if (module_interface::is_module_include(include_item)) {
+                    const module_interface::interface& module = module_interface::require(module_interface::resolve_path(ctx.file_name, include_item), ctx.module_chain);
+                    if (std::find(ctx.modules.begin(), ctx.modules.end(), &module) == ctx.modules.end()) {
+                        ctx.modules.push_back(&module);
+                    }
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(include_mutex);
+                compile_include_ir(ctx, include_item);
+            }
+         * @endcode
+         */
+        void build_includes(context::compilation_context& ctx) {
+            for (const std::string& include_item : ctx.library_and_include) {
+                if (module_interface::is_module_include(include_item)) {
+                    const module_interface::interface& module = module_interface::require(module_interface::resolve_path(ctx.file_name, include_item), ctx.module_chain);
+                    if (std::find(ctx.modules.begin(), ctx.modules.end(), &module) == ctx.modules.end()) { // one module included under two spellings
+                        ctx.modules.push_back(&module);
+                    }
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(include_mutex); // a unit that needs a library another unit is building waits for it
+                compile_include_ir(ctx, include_item);
             }
         }
 
         /**
          * TODO: docs
          */
-        void compile_include_ir(const std::string& item) {
+        void compile_include_ir(context::compilation_context& ctx, const std::string& item) {
             if (item == "list") {
-                if (library_and_include.find("graph") != library_and_include.end()) {
+                if (ctx.library_and_include.find("graph") != ctx.library_and_include.end()) {
+                    return;
+                }
+                if (!built_includes.insert(item).second) { // already built for another unit
                     return;
                 }
                 std::system("echo Emitting IR For List Module.");
@@ -334,6 +866,9 @@ namespace utility {
                 return;
             }
             if (item == "graph") {
+                if (!built_includes.insert(item).second) {
+                    return;
+                }
                 std::system("echo Emitting IR For Graph Module.");
                 std::system("chmod u+x ../pyroxene_slib/graph/build_module/build.sh");
                 std::system("../pyroxene_slib/graph/build_module/build.sh");
@@ -342,209 +877,472 @@ namespace utility {
             std::abort();
         }
 
+    }
+
+    namespace {
+
+        /**
+         * @struct function_span
+         * @par The tokens of one top level function definition, from its `def` to the `}` that closes its body.
+         */
+        struct function_span {
+            std::size_t def_index;
+            std::size_t close_index;
+        };
+
+        /**
+         * @par Fewest function definitions a file needs before its functions are parsed in parallel; below this, handing them out costs more than it saves.
+         */
+        constexpr std::size_t parallel_parse_threshold = 8;
 
         /**
-         * @par Primary parsing loop for the program that returns a vector of AST nodes in variant form to allow for multiple types.
+         * @par Makes token `index` the current token of the parser.
+         */
+        void seek_token(context::compilation_context& ctx, std::size_t index) {
+            ctx.parser.token_index_max = ctx.parser.source->token_stream.size();
+            ctx.parser.current_token_index = index;
+            parser::get_next_token(ctx);
+        }
+
+        /**
+         * @par Finds every function definition at the top level of the token stream from `first_token` on, by matching braces rather than parsing. A `def` that is missing its body, or braces that do not balance, end the scan early; whatever was not found is simply parsed in order.
          * @code
-            bool not_eof = true;
-            std::vector<std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>> parsing_output;
-            while (not_eof) {
-                
-                #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
-                    if (parser::current_token != lexer::tok_eof && parser::current_token != lexer::tok_semicolon && parser::current_token != lexer::tok_def) {
-                        std::cout << "\033[32m\nParsing New Statement:\033[0m\n";
-                    } else if (parser::current_token == lexer::tok_def) {
-                        std::cout << "\033[32m\nParsing New Function:\033[0m\n";
-                    }
-                #endif
-                
-                std::unique_ptr<ast::top_level_expr> expr = nullptr;  
-                std::unique_ptr<ast::func_defn> func = nullptr;  
-
-                switch(parser::current_token) {
-                    case lexer::tok_eof: // if its the end of the file, exit the loop
-                        not_eof = false;
-                        break;
-                    case lexer::tok_semicolon:
-                        parser::get_next_token(); // ignore semicolons and get the next token...
-                        break; 
-                    case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool:
-                        expr = parser::parse_var_decl_defn();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    case lexer::tok_identifier: 
-                        if (lexer::peek_token(parser::current_token_index) == lexer::tok_assignment) {
-                            expr = parser::parse_var_assign();
-                            parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                            break;
-                        } else if (lexer::peek_token(parser::current_token_index) == lexer::tok_dot) {
-                            expr = parser::parse_method_dot_call();
-                            parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                            break;
-                        } else{
-                            expr = parser::parse_expression();
-                            parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                            break;
-                        }
-                    case lexer::tok_def:
-                        func = parser::parse_function();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(func)));
-                        break;   
-                    case lexer::tok_return:
-                        expr = parser::parse_return();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    case lexer::tok_if:
-                        expr = parser::parse_if();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    case lexer::tok_print:
-                        expr = parser::parse_print();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    default:
-                        expr = parser::parse_expression();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
+            int depth = 0;
+            for (std::size_t i = first_token; i < tokens.size() && tokens[i].kind != lexer::tok_eof; i++) {
+                if (tokens[i].kind == lexer::tok_open_brack) {
+                    depth++;
+                } else if (tokens[i].kind == lexer::tok_close_brack) {
+                    if (--depth < 0) {
                         break;
+                    }
+                } else if (tokens[i].kind == lexer::tok_def && depth == 0) {
+                    // skip the signature to the "{" and find the "}" matching it, recording the span (or stopping if there isn't one)
+                    ...
                 }
             }
-
-            return std::move(parsing_output);
+            return functions;
          * @endcode
          */
-        std::vector<std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>> parse_top_level() {
-            bool not_eof = true;
-            std::vector<std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>> parsing_output;
-            while (not_eof) {
-                
-                #if (DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
-                    if (parser::current_token != lexer::tok_eof && parser::current_token != lexer::tok_semicolon && parser::current_token != lexer::tok_def) {
-                        std::cout << "\033[32m\nParsing New Statement:\033[0m\n";
-                    } else if (parser::current_token == lexer::tok_def) {
-                        std::cout << "\033[32m\nParsing New Function:\033[0m\n";
-                    }
-                #endif
-                
-                std::unique_ptr<ast::top_level_expr> expr = nullptr;  
-                std::unique_ptr<ast::func_defn> func = nullptr;  
-
-                switch(parser::current_token) {
-                    case lexer::tok_eof: // if its the end of the file, exit the loop
-                        not_eof = false;
+        std::vector<function_span> find_top_level_functions(const lexer::lexer_state& source, std::size_t first_token) {
+            const std::vector<lexer::token>& tokens = source.token_stream;
+            std::vector<function_span> functions;
+
+            int depth = 0;
+            for (std::size_t i = first_token; i < tokens.size() && tokens[i].kind != lexer::tok_eof; i++) {
+                if (tokens[i].kind == lexer::tok_open_brack) {
+                    depth++;
+                } else if (tokens[i].kind == lexer::tok_close_brack) {
+                    if (--depth < 0) {
                         break;
-                    case lexer::tok_semicolon:
-                        parser::get_next_token(); // ignore semicolons and get the next token...
-                        break; 
-                    case lexer::tok_int: case lexer::tok_float: case lexer::tok_char: case lexer::tok_string: case lexer::tok_bool:
-                        expr = parser::parse_var_decl_defn();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
+                    }
+                } else if (tokens[i].kind == lexer::tok_def && depth == 0) {
+                    std::size_t body = i + 1;
+                    while (body < tokens.size() && tokens[body].kind != lexer::tok_open_brack && tokens[body].kind != lexer::tok_close_brack && tokens[body].kind != lexer::tok_def && tokens[body].kind != lexer::tok_eof) {
+                        body++;
+                    }
+                    if (body == tokens.size() || tokens[body].kind != lexer::tok_open_brack) {
                         break;
-                    case lexer::tok_identifier: 
-                        if (lexer::peek_token(parser::current_token_index) == lexer::tok_assignment) {
-                            expr = parser::parse_var_assign();
-                            parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                            break;
-                        } else if (lexer::peek_token(parser::current_token_index) == lexer::tok_dot) {
-                            expr = parser::parse_method_dot_call();
-                            parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                            break;
-                        } else{
-                            expr = parser::parse_expression();
-                            parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
+                    }
+
+                    int body_depth = 0;
+                    std::size_t close = body;
+                    for (; close < tokens.size() && tokens[close].kind != lexer::tok_eof; close++) {
+                        if (tokens[close].kind == lexer::tok_open_brack) {
+                            body_depth++;
+                        } else if (tokens[close].kind == lexer::tok_close_brack && --body_depth == 0) {
                             break;
                         }
-                    case lexer::tok_def:
-                        func = parser::parse_function();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(func)));
-                        break;     
-                    case lexer::tok_return:
-                        expr = parser::parse_return();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    case lexer::tok_if:
-                        expr = parser::parse_if();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    case lexer::tok_print:
-                        expr = parser::parse_print();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
-                        break;
-                    default:
-                        expr = parser::parse_expression();
-                        parsing_output.push_back(std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>(std::move(expr)));
+                    }
+                    if (close == tokens.size() || tokens[close].kind != lexer::tok_close_brack) {
                         break;
+                    }
+
+                    functions.push_back({i, close});
+                    i = close;
                 }
             }
-
-            return std::move(parsing_output);
+            return functions;
         }
 
         /**
-         * @par Extracts the correct AST node type, and calls the respective semantic analysis function.
-         * @param ast_node A reference to an AST node.
+         * @par Parses the given function definitions on the worker threads, in contiguous runs so each thread reads its own stretch of the token stream. Every run gets its own parser state (with the file's includes, which come before any function) and a worker arena of the active arena, which frees it along with the rest of the tree, and its parser errors are deferred instead of reported.
+         * A definition only counts if it parsed cleanly and ended exactly at its closing brace; otherwise its slot is left empty and the caller parses it again in order, which reports any error exactly as a sequential parse would.
          * @code
-            if (std::holds_alternative<std::unique_ptr<ast::top_level_expr>>(ast_node)) {
-                if (std::get<0>(ast_node)->get_ast_class() != "int" && 
-                    std::get<0>(ast_node)->get_ast_class() != "float" && 
-                    std::get<0>(ast_node)->get_ast_class() != "char" && 
-                    std::get<0>(ast_node)->get_ast_class() != "string" && 
-                    std::get<0>(ast_node)->get_ast_class() != "bool") 
-                {
-                    std::get<0>(ast_node)->semantic_analysis();
-                }
-            } else if (std::holds_alternative<std::unique_ptr<ast::func_defn>>(ast_node)) {
-                std::get<1>(ast_node)->semantic_analysis();
+            std::vector<ast::node_ptr<ast::func_defn>> parsed(functions.size());
+            std::size_t run_count = std::min(functions.size(), static_cast<std::size_t>(thread_pool::worker_count()) * 4);
+            std::vector<arena::bump_arena*> run_arenas(run_count);
+            for (arena::bump_arena*& run_arena : run_arenas) {
+                run_arena = &arena::current().add_worker();
             }
+
+            thread_pool::parallel_for(run_count, [&](std::size_t run) {
+                context::compilation_context worker;
+                worker.parser = ctx.parser;
+                worker.library_and_include = ctx.library_and_include; // lists and graphs are only parsed once their include is seen
+                arena::arena_scope ast_scope(*run_arenas[run]);
+                defer_parser_errors = true;
+
+                for (std::size_t i = functions.size() * run / run_count; i < functions.size() * (run + 1) / run_count; i++) {
+                    try {
+                        seek_token(worker, functions[i].def_index);
+                        ast::node_ptr<ast::func_defn> func = parser::parse_function(worker);
+                        if (static_cast<std::size_t>(worker.parser.current_token_index - 1) == functions[i].close_index + 1) {
+                            parsed[i] = std::move(func);
+                        }
+                    } catch (const deferred_parser_error&) {
+                    } catch (const std::out_of_range&) {} // the parser ran off the end of the tokens
+                }
+
+                defer_parser_errors = false;
+            });
+
+            return parsed;
          * @endcode
          */
-        void call_sem_analysis(const std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>& ast_node) {
-            if (std::holds_alternative<std::unique_ptr<ast::top_level_expr>>(ast_node)) {
-                if (std::get<0>(ast_node)->get_ast_class() != "int" && 
-                    std::get<0>(ast_node)->get_ast_class() != "float" && 
-                    std::get<0>(ast_node)->get_ast_class() != "char" && 
-                    std::get<0>(ast_node)->get_ast_class() != "string" && 
-                    std::get<0>(ast_node)->get_ast_class() != "bool") 
-                {
-                    std::get<0>(ast_node)->semantic_analysis();
+        std::vector<ast::node_ptr<ast::func_defn>> parse_functions_in_parallel(context::compilation_context& ctx, const std::vector<function_span>& functions) {
+            std::vector<ast::node_ptr<ast::func_defn>> parsed(functions.size());
+            std::size_t run_count = std::min(functions.size(), static_cast<std::size_t>(thread_pool::worker_count()) * 4);
+            std::vector<arena::bump_arena*> run_arenas(run_count);
+            for (arena::bump_arena*& run_arena : run_arenas) {
+                run_arena = &arena::current().add_worker();
+            }
+
+            thread_pool::parallel_for(run_count, [&](std::size_t run) {
+                context::compilation_context worker;
+                worker.parser = ctx.parser;
+                worker.library_and_include = ctx.library_and_include; // lists and graphs are only parsed once their include is seen
+                arena::arena_scope ast_scope(*run_arenas[run]);
+                defer_parser_errors = true;
+
+                for (std::size_t i = functions.size() * run / run_count; i < functions.size() * (run + 1) / run_count; i++) {
+                    try {
+                        seek_token(worker, functions[i].def_index);
+                        ast::node_ptr<ast::func_defn> func = parser::parse_function(worker);
+                        if (static_cast<std::size_t>(worker.parser.current_token_index - 1) == functions[i].close_index + 1) {
+                            parsed[i] = std::move(func);
+                        }
+                    } catch (const deferred_parser_error&) {
+                    } catch (const std::out_of_range&) {} // the parser ran off the end of the tokens
                 }
-            } else if (std::holds_alternative<std::unique_ptr<ast::func_defn>>(ast_node)) {
-                std::get<1>(ast_node)->semantic_analysis();
+
+                defer_parser_errors = false;
+            });
+
+            return parsed;
+        }
+    }
+
+    /**
+     * @par Primary parsing loop for the program that returns a vector of AST nodes in variant form to allow for multiple types.
+     * When there are enough top level functions (and more than one thread), their definitions are found ahead of time and parsed in parallel, while the statements between them are parsed here in order; reaching a definition then only means taking its node and skipping its tokens. The output is the same either way, in source order. The debug build, which prints as it parses, always parses in order.
+     * @code
+        std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parsing_output;
+        std::vector<function_span> functions;
+        #if !(DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+            if (thread_pool::worker_count() > 1) {
+                functions = find_top_level_functions(*ctx.parser.source, ctx.parser.current_token_index - 1);
             }
+        #endif
+
+        if (functions.size() < parallel_parse_threshold) {
+            while (parse_top_level_statement(ctx, parsing_output)) {}
+            return parsing_output;
         }
 
+        std::vector<ast::node_ptr<ast::func_defn>> parsed_functions = parse_functions_in_parallel(ctx, functions);
+
+        std::size_t next_function = 0;
+        while (true) {
+            std::size_t position = ctx.parser.current_token_index - 1;
+            while (next_function < functions.size() && functions[next_function].def_index < position) {
+                next_function++;
+            }
+
+            if (next_function < functions.size() && functions[next_function].def_index == position && parsed_functions[next_function] != nullptr) {
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(parsed_functions[next_function])));
+                seek_token(ctx, functions[next_function].close_index + 1);
+            } else if (!parse_top_level_statement(ctx, parsing_output)) {
+                break;
+            }
+        }
+
+        return parsing_output;
+     * @endcode
+     */
+    std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parse_top_level(context::compilation_context& ctx) {
+        std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>> parsing_output;
+        std::vector<function_span> functions;
+        #if !(DEBUG_MODE == 1 && PARSER_PRINT_UTIL == 1)
+            if (thread_pool::worker_count() > 1) {
+                functions = find_top_level_functions(*ctx.parser.source, ctx.parser.current_token_index - 1);
+            }
+        #endif
+
+        if (functions.size() < parallel_parse_threshold) {
+            while (parse_top_level_statement(ctx, parsing_output)) {}
+            return parsing_output;
+        }
+
+        std::vector<ast::node_ptr<ast::func_defn>> parsed_functions = parse_functions_in_parallel(ctx, functions);
+
+        std::size_t next_function = 0;
+        while (true) {
+            std::size_t position = ctx.parser.current_token_index - 1;
+            while (next_function < functions.size() && functions[next_function].def_index < position) {
+                next_function++;
+            }
+
+            if (next_function < functions.size() && functions[next_function].def_index == position && parsed_functions[next_function] != nullptr) {
+                parsing_output.push_back(std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>(std::move(parsed_functions[next_function])));
+                seek_token(ctx, functions[next_function].close_index + 1);
+            } else if (!parse_top_level_statement(ctx, parsing_output)) {
+                break;
+            }
+        }
+
+        return parsing_output;
+    }
+
+    namespace {
+        /**
+         * @par Fewest function bodies a file needs before they are analyzed in parallel; below this, they are analyzed on the calling thread.
+         */
+        constexpr std::size_t parallel_analysis_threshold = 8;
+
+        /**
+         * @struct node_analysis
+         * @par How the semantic analysis of one top level node went: the first error in it, if any, and for a function, how many of the unit's bindings its body can see and what it did with them.
+         */
+        struct node_analysis {
+            std::optional<deferred_sem_analysis_error> error;
+            std::size_t visible_globals = 0;
+            sem_analysis_scope::body_analysis body;
+        };
+
         /**
-         * @par Extracts the variant type in the reference, and calls the correct codegen method.
-         * @param ast_node A reference to an AST node.
+         * @par Reports an error that was held back by `defer_sem_analysis_errors`, as it would have been reported straight away.
          * @code
-            if (std::holds_alternative<std::unique_ptr<ast::top_level_expr>>(ast_node)) {
-                if (std::get<0>(ast_node)->get_ast_class() != "int" && 
-                    std::get<0>(ast_node)->get_ast_class() != "float" && 
-                    std::get<0>(ast_node)->get_ast_class() != "char" && 
-                    std::get<0>(ast_node)->get_ast_class() != "string" && 
-                    std::get<0>(ast_node)->get_ast_class() != "bool")
-                {
-                    std::get<0>(ast_node)->codegen();
-                }
-            } else if (std::holds_alternative<std::unique_ptr<ast::func_defn>>(ast_node)) {
-                std::get<1>(ast_node)->codegen();
-            }    
+            if (error.is_scoping_error) {
+                scoping_error(error.message, error.location);
+            }
+            sem_analysis_error(error.message, error.location);
          * @endcode
          */
-        void call_codegen(const std::variant<std::unique_ptr<ast::top_level_expr>, std::unique_ptr<ast::func_defn>>& ast_node) {
-            if (std::holds_alternative<std::unique_ptr<ast::top_level_expr>>(ast_node)) {
-                if (std::get<0>(ast_node)->get_ast_class() != "int" && 
-                    std::get<0>(ast_node)->get_ast_class() != "float" && 
-                    std::get<0>(ast_node)->get_ast_class() != "char" && 
-                    std::get<0>(ast_node)->get_ast_class() != "string" && 
-                    std::get<0>(ast_node)->get_ast_class() != "bool")
-                {
-                    std::get<0>(ast_node)->codegen();
+        void report(const deferred_sem_analysis_error& error) {
+            if (error.is_scoping_error) {
+                scoping_error(error.message, error.location);
+            }
+            sem_analysis_error(error.message, error.location);
+        }
+    }
+
+    /**
+     * @par Semantically analyzes a whole program, in the global scope that is open on the scope stack.
+     * First every function signature is entered into the symbol table, so a body may call a function defined after it. Then the statements outside of functions are analyzed in order, which completes the global scope; each function is shown the globals declared before it. Last, the function bodies are analyzed, in parallel when there are enough of them, each against its own scope stack with read-only access to the global scope and tables (see `sem_analysis_scope::shared_scope`).
+     * Errors are held back while this happens, and the one that comes first in the source is reported afterwards, whatever order the bodies were analyzed in. That is also when a body's reads of globals declared without a value are checked against the bodies before it.
+     * @param program The top level nodes of the program, in source order.
+     * @code
+        std::vector<node_analysis> analysis(program.size());
+        defer_sem_analysis_errors = true;
+
+        for (std::size_t i = 0; i < program.size(); i++) {
+            if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(program[i])) {
+                try {
+                    std::get<1>(program[i])->analyze_signature();
+                } catch (const deferred_sem_analysis_error& error) {
+                    analysis[i].error = error;
                 }
-            } else if (std::holds_alternative<std::unique_ptr<ast::func_defn>>(ast_node)) {
-                std::get<1>(ast_node)->codegen();
-            }       
+            }
         }
 
+        std::vector<std::size_t> bodies;
+        for (std::size_t i = 0; i < program.size(); i++) {
+            if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(program[i])) {
+                if (!analysis[i].error) {
+                    analysis[i].visible_globals = sem_analysis_scope::sem_analysis_stack.binding_count();
+                    bodies.push_back(i);
+                }
+                continue;
+            }
+
+            try {
+                call_sem_analysis(program[i]);
+            } catch (const deferred_sem_analysis_error& error) {
+                analysis[i].error = error;
+                break;
+            }
+        }
+        defer_sem_analysis_errors = false;
+
+        sem_analysis_scope::scope_table globals = std::move(sem_analysis_scope::sem_analysis_stack);
+        const sem_analysis_scope::function_table& functions = sem_analysis_scope::defined_functions;
+        const sem_analysis_scope::dot_call_table& dot_calls = sem_analysis_scope::valid_dot_calls;
+        const lexer::source_location location = parser::current_location;
+
+        std::size_t run_count = std::min<std::size_t>(bodies.size(), 1);
+        if (bodies.size() >= parallel_analysis_threshold) {
+            run_count = std::min(bodies.size(), static_cast<std::size_t>(thread_pool::worker_count()) * 4);
+        }
+
+        thread_pool::parallel_for(run_count, [&](std::size_t run) {
+            sem_analysis_scope::shared_scope unit(globals, functions, dot_calls);
+            parser::current_location = location;
+            defer_sem_analysis_errors = true;
+
+            for (std::size_t i = bodies.size() * run / run_count; i < bodies.size() * (run + 1) / run_count; i++) {
+                node_analysis& body = analysis[bodies[i]];
+                unit.enter_body(body.visible_globals, body.body);
+                try {
+                    std::get<1>(program[bodies[i]])->semantic_analysis();
+                } catch (const deferred_sem_analysis_error& error) {
+                    body.error = error;
+                }
+            }
+
+            defer_sem_analysis_errors = false;
+        });
+
+        sem_analysis_scope::sem_analysis_stack = std::move(globals);
+
+        std::set<ast::variable_slot> initialized_globals;
+        for (const node_analysis& node : analysis) {
+            for (const std::pair<ast::variable_slot, lexer::source_location>& read : node.body.deferred_reads) {
+                if (initialized_globals.count(read.first) == 0) {
+                    sem_analysis_error("Value attempting to access not initialized", read.second);
+                }
+            }
+            if (node.error) {
+                report(*node.error);
+            }
+            initialized_globals.insert(node.body.initialized_globals.begin(), node.body.initialized_globals.end());
+        }
+     * @endcode
+     */
+    void analyze_program(const std::vector<std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>>& program) {
+        std::vector<node_analysis> analysis(program.size());
+        defer_sem_analysis_errors = true;
+
+        for (std::size_t i = 0; i < program.size(); i++) {
+            if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(program[i])) {
+                try {
+                    std::get<1>(program[i])->analyze_signature();
+                } catch (const deferred_sem_analysis_error& error) {
+                    analysis[i].error = error;
+                }
+            }
+        }
+
+        std::vector<std::size_t> bodies;
+        for (std::size_t i = 0; i < program.size(); i++) {
+            if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(program[i])) {
+                if (!analysis[i].error) {
+                    analysis[i].visible_globals = sem_analysis_scope::sem_analysis_stack.binding_count(); // only the global scope is open here
+                    bodies.push_back(i);
+                }
+                continue;
+            }
+
+            try {
+                call_sem_analysis(program[i]);
+            } catch (const deferred_sem_analysis_error& error) {
+                analysis[i].error = error;
+                break; // nothing after this would ever be reached
+            }
+        }
+        defer_sem_analysis_errors = false;
+
+        // the unit's tables are read by every thread from here on, so they are taken by reference on this one
+        sem_analysis_scope::scope_table globals = std::move(sem_analysis_scope::sem_analysis_stack);
+        const sem_analysis_scope::function_table& functions = sem_analysis_scope::defined_functions;
+        const sem_analysis_scope::dot_call_table& dot_calls = sem_analysis_scope::valid_dot_calls;
+        const lexer::source_location location = parser::current_location;
+
+        std::size_t run_count = std::min<std::size_t>(bodies.size(), 1);
+        if (bodies.size() >= parallel_analysis_threshold) {
+            run_count = std::min(bodies.size(), static_cast<std::size_t>(thread_pool::worker_count()) * 4);
+        }
+
+        thread_pool::parallel_for(run_count, [&](std::size_t run) {
+            sem_analysis_scope::shared_scope unit(globals, functions, dot_calls);
+            parser::current_location = location; // errors are located the same on every thread
+            defer_sem_analysis_errors = true;
+
+            for (std::size_t i = bodies.size() * run / run_count; i < bodies.size() * (run + 1) / run_count; i++) {
+                node_analysis& body = analysis[bodies[i]];
+                unit.enter_body(body.visible_globals, body.body);
+                try {
+                    std::get<1>(program[bodies[i]])->semantic_analysis();
+                } catch (const deferred_sem_analysis_error& error) {
+                    body.error = error;
+                }
+            }
+
+            defer_sem_analysis_errors = false;
+        });
+
+        sem_analysis_scope::sem_analysis_stack = std::move(globals);
+
+        std::set<ast::variable_slot> initialized_globals;
+        for (const node_analysis& node : analysis) {
+            for (const std::pair<ast::variable_slot, lexer::source_location>& read : node.body.deferred_reads) {
+                if (initialized_globals.count(read.first) == 0) {
+                    sem_analysis_error("Value attempting to access not initialized", read.second);
+                }
+            }
+            if (node.error) {
+                report(*node.error);
+            }
+            initialized_globals.insert(node.body.initialized_globals.begin(), node.body.initialized_globals.end());
+        }
     }
 
-}
\ No newline at end of file
+    /**
+     * @par Extracts the correct AST node type, and calls the respective semantic analysis function.
+     * @param ast_node A reference to an AST node.
+     * @code
+        if (std::holds_alternative<ast::node_ptr<ast::top_level_expr>>(ast_node)) {
+            if (!ast::is_literal(std::get<0>(ast_node).get())) 
+            {
+                std::get<0>(ast_node)->semantic_analysis();
+            }
+        } else if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(ast_node)) {
+            std::get<1>(ast_node)->semantic_analysis();
+        }
+     * @endcode
+     */
+    void call_sem_analysis(const std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>& ast_node) {
+        if (std::holds_alternative<ast::node_ptr<ast::top_level_expr>>(ast_node)) {
+            if (!ast::is_literal(std::get<0>(ast_node).get())) 
+            {
+                std::get<0>(ast_node)->semantic_analysis();
+            }
+        } else if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(ast_node)) {
+            std::get<1>(ast_node)->semantic_analysis();
+        }
+    }
+
+    /**
+     * @par Extracts the variant type in the reference, and calls the correct codegen method.
+     * @param ast_node A reference to an AST node.
+     * @code
+        if (std::holds_alternative<ast::node_ptr<ast::top_level_expr>>(ast_node)) {
+            if (!ast::is_literal(std::get<0>(ast_node).get()))
+            {
+                std::get<0>(ast_node)->codegen();
+            }
+        } else if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(ast_node)) {
+            std::get<1>(ast_node)->codegen();
+        }    
+     * @endcode
+     */
+    void call_codegen(const std::variant<ast::node_ptr<ast::top_level_expr>, ast::node_ptr<ast::func_defn>>& ast_node) {
+        if (std::holds_alternative<ast::node_ptr<ast::top_level_expr>>(ast_node)) {
+            if (!ast::is_literal(std::get<0>(ast_node).get()))
+            {
+                std::get<0>(ast_node)->codegen();
+            }
+        } else if (std::holds_alternative<ast::node_ptr<ast::func_defn>>(ast_node)) {
+            std::get<1>(ast_node)->codegen();
+        }       
+    }
+}
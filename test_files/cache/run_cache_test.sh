@@ -0,0 +1,68 @@
+#MIT License
+#Copyright (c) 2024 Daniel Gunther
+
+#For the full license text, see the LICENSE.md file in the root directory.
+#If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+
+#******************************************************
+
+#!/usr/bin/env bash
+
+# Checks that the build cache is reused for an unchanged file, and rebuilt when the file or a module it includes changes.
+# Usage: run_cache_test.sh <path to driver>
+
+DRIVER="$1"
+SOURCE_DIR="$(cd "$(dirname "$0")" && pwd)"
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+cp "$SOURCE_DIR/main.pyrx" "$SOURCE_DIR/lib.pyrx" "$WORK_DIR"
+export PYRX_CACHE_DIR="$WORK_DIR/cache"
+FAILED=0
+
+expect_output() {
+    local expected="$1"
+    local description="$2"
+    local output
+    output="$("$DRIVER" "$WORK_DIR/main.pyrx" 2>&1)"
+    if [ "$output" != "$expected" ]; then
+        echo "FAIL: $description: expected '$expected', got '$output'"
+        FAILED=1
+    fi
+}
+
+entry_times() {
+    stat -c '%n %y' "$PYRX_CACHE_DIR"/* 2>/dev/null | sort
+}
+
+unset PYRX_CACHE_DIR
+expect_output "1" "compile without a cache"
+if [ -e "$WORK_DIR/cache" ]; then
+    echo "FAIL: the cache was written without being turned on"
+    FAILED=1
+fi
+export PYRX_CACHE_DIR="$WORK_DIR/cache"
+
+expect_output "1" "first compile"
+FIRST_ENTRIES="$(entry_times)"
+if [ -z "$FIRST_ENTRIES" ]; then
+    echo "FAIL: nothing was written to the cache"
+    FAILED=1
+fi
+
+expect_output "1" "unchanged compile"
+if [ "$(entry_times)" != "$FIRST_ENTRIES" ]; then
+    echo "FAIL: an unchanged file was compiled again instead of read from the cache"
+    FAILED=1
+fi
+
+sed -i 's/return 1;/return 2;/' "$WORK_DIR/lib.pyrx"
+expect_output "2" "compile after the included module changed"
+
+sed -i 's/print(value());/print(value() + 40);/' "$WORK_DIR/main.pyrx"
+expect_output "42" "compile after the file changed"
+
+if [ $FAILED -eq 0 ]; then
+    echo "Cache test passed."
+fi
+exit $FAILED
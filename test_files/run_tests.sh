@@ -0,0 +1,69 @@
+#MIT License
+#Copyright (c) 2024 Daniel Gunther
+
+#For the full license text, see the LICENSE.md file in the root directory.
+#If LICENSE.md is not included, this version of the source code is provided in breach of this license.
+
+#******************************************************
+
+#!/usr/bin/env bash
+
+# Compiles and runs every program in the test_files subdirectories that states what it should do, and checks it did.
+# A program lists the lines it should print, in order, as "// expect: <line>" comments, or the error it should stop with as "// expect error: <message>".
+# A program that cannot hold those comments (an empty file) lists them in a <name>.expect file beside it instead.
+# Programs that include the standard library are skipped when clang++, which builds it, is not installed.
+# Usage: run_tests.sh <path to driver>
+
+DRIVER="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+TEST_DIR="$(cd "$(dirname "$0")" && pwd)"
+OUTPUT="$(mktemp)"
+trap 'rm -f "$OUTPUT"' EXIT
+
+cd "$TEST_DIR" # the driver looks for the standard library in ../pyroxene_slib
+unset PYRX_CACHE_DIR PYRX_CACHE
+PASSED=0
+FAILED=0
+SKIPPED=0
+
+for TEST in */*.pyrx; do
+    EXPECTATIONS="$TEST"
+    if [ -f "${TEST%.pyrx}.expect" ]; then
+        EXPECTATIONS="${TEST%.pyrx}.expect"
+    fi
+    if ! grep -q '^// expect' "$EXPECTATIONS"; then
+        continue
+    fi
+    if grep -Eq '^include (list|graph)' "$TEST" && ! command -v clang++ > /dev/null; then
+        echo "SKIP: $TEST (clang++ is needed to build the standard library)"
+        SKIPPED=$((SKIPPED + 1))
+        continue
+    fi
+
+    "$DRIVER" "$TEST" > "$OUTPUT" 2>&1
+    STATUS=$?
+    ACTUAL="$(sed 's/\x1b\[[0-9;]*m//g' "$OUTPUT")"
+    EXPECTED_ERROR="$(sed -n 's|^// expect error: ||p' "$EXPECTATIONS")"
+
+    if [ -n "$EXPECTED_ERROR" ]; then
+        if [ $STATUS -eq 0 ] || [[ "$ACTUAL" != *"$EXPECTED_ERROR"* ]]; then
+            echo "FAIL: $TEST: expected the error '$EXPECTED_ERROR', got:"
+            echo "$ACTUAL"
+            FAILED=$((FAILED + 1))
+            continue
+        fi
+    else
+        EXPECTED="$(sed -n 's|^// expect: ||p' "$EXPECTATIONS")"
+        if [ $STATUS -ne 0 ] || [ "$ACTUAL" != "$EXPECTED" ]; then
+            echo "FAIL: $TEST: expected:"
+            echo "$EXPECTED"
+            echo "got (exit status $STATUS):"
+            echo "$ACTUAL"
+            FAILED=$((FAILED + 1))
+            continue
+        fi
+    fi
+    PASSED=$((PASSED + 1))
+done
+
+echo "$PASSED passed, $FAILED failed, $SKIPPED skipped."
+[ $FAILED -eq 0 ]